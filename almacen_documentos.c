@@ -0,0 +1,442 @@
+/*
+ * almacen_documentos.c - Implementacion del archivo empaquetado de documentos
+ *
+ * Descripcion: Este archivo implementa el almacen de solo-anexar para
+ *              comprobantes y certificados, incluyendo:
+ *              - Agregado de documentos con una sola escritura
+ *              - Indice en memoria (tabla hash) por numero de comprobante
+ *              - Recuperacion del indice si el programa se cerro a medias
+ *              - Exportacion de un documento individual a archivo
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "almacen_documentos.h"
+#include "vehiculos.h"   // Para limpiar_pantalla y convertir_a_mayusculas
+#include <stdint.h>
+#include <direct.h>      // Para _mkdir en Windows
+#include <sys/stat.h>    // Para verificar si existe la carpeta
+
+// Posicionamiento de 64 bits para archivos mayores a 2 GB
+#ifdef _WIN32
+#define BUSCAR_64(archivo, pos) _fseeki64((archivo), (pos), SEEK_SET)
+#define POSICION_64(archivo) _ftelli64(archivo)
+#else
+#define BUSCAR_64(archivo, pos) fseeko((archivo), (off_t)(pos), SEEK_SET)
+#define POSICION_64(archivo) ((long long)ftello(archivo))
+#endif
+
+// Cabecera de cada registro del archivo empaquetado (16 bytes)
+#define MAGIA_DOCUMENTO "DOC1"
+#define TAMANO_CABECERA 16
+
+/*
+ * Estructura: CabeceraDocumento
+ * Descripcion: Cabecera binaria que precede a cada documento en el .pak.
+ *              Le sigue la clave (sin '\0') y luego el documento
+ */
+typedef struct {
+	char magia[4];                 // "DOC1"
+	uint8_t tipo;                  // DOCUMENTO_*
+	uint8_t longitud_clave;        // Bytes de la clave
+	uint8_t reservado[2];          // Sin uso (cero)
+	uint32_t longitud_datos;       // Bytes del documento
+	uint32_t suma_verificacion;    // FNV-1a del documento
+} CabeceraDocumento;
+
+// ===================================================================
+// INDICE EN MEMORIA
+// ===================================================================
+
+static EntradaIndiceDocumento* tabla_indice = NULL;   // Tabla hash con sondeo lineal
+static int capacidad_indice = 0;                      // Siempre potencia de 2
+static int cantidad_indice = 0;                       // Entradas ocupadas
+static int indice_cargado = 0;                        // 1 si ya se leyo el indice
+
+/*
+ * Funcion: suma_fnv1a
+ * Descripcion: Calcula el hash FNV-1a de 32 bits de un bloque de bytes
+ * Parametros: datos, longitud
+ * Retorno: Valor del hash
+ */
+static uint32_t suma_fnv1a(const char* datos, size_t longitud) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < longitud; i++) {
+		hash ^= (unsigned char)datos[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Funcion: ranura_indice
+ * Descripcion: Busca la ranura de una clave en la tabla hash
+ * Parametros: clave
+ * Retorno: Indice de la ranura (ocupada por la clave o vacia)
+ */
+static int ranura_indice(const char* clave) {
+	int mascara = capacidad_indice - 1;
+	int i = (int)(suma_fnv1a(clave, strlen(clave)) & (uint32_t)mascara);
+	while (tabla_indice[i].clave[0] != '\0' && strcmp(tabla_indice[i].clave, clave) != 0) {
+		i = (i + 1) & mascara;
+	}
+	return i;
+}
+
+/*
+ * Funcion: insertar_en_indice
+ * Descripcion: Agrega o reemplaza una entrada del indice en memoria,
+ *              duplicando la tabla cuando supera el 70% de ocupacion
+ * Parametros: entrada - Datos de la entrada
+ * Retorno: 1 si fue exitoso, 0 si no hubo memoria
+ */
+static int insertar_en_indice(const EntradaIndiceDocumento* entrada) {
+	if ((cantidad_indice + 1) * 10 > capacidad_indice * 7) {
+		int capacidad_anterior = capacidad_indice;
+		EntradaIndiceDocumento* anterior = tabla_indice;
+		int nueva_capacidad = capacidad_indice ? capacidad_indice * 2 : 1024;
+
+		tabla_indice = calloc((size_t)nueva_capacidad, sizeof(EntradaIndiceDocumento));
+		if (tabla_indice == NULL) {
+			tabla_indice = anterior;
+			return 0;
+		}
+		capacidad_indice = nueva_capacidad;
+		for (int i = 0; i < capacidad_anterior; i++) {
+			if (anterior[i].clave[0] != '\0') {
+				tabla_indice[ranura_indice(anterior[i].clave)] = anterior[i];
+			}
+		}
+		free(anterior);
+	}
+
+	int ranura = ranura_indice(entrada->clave);
+	if (tabla_indice[ranura].clave[0] == '\0') cantidad_indice++;
+	tabla_indice[ranura] = *entrada;
+	return 1;
+}
+
+/*
+ * Funcion: leer_cabecera
+ * Descripcion: Lee y valida la cabecera de un registro del .pak
+ * Parametros: archivo, cabecera, clave (buffer de MAX_CLAVE_DOCUMENTO)
+ * Retorno: 1 si se leyo un registro valido, 0 si no
+ */
+static int leer_cabecera(FILE* archivo, CabeceraDocumento* cabecera, char* clave) {
+	if (fread(cabecera, 1, TAMANO_CABECERA, archivo) != TAMANO_CABECERA) return 0;
+	if (memcmp(cabecera->magia, MAGIA_DOCUMENTO, 4) != 0) return 0;
+	if (cabecera->longitud_clave == 0 || cabecera->longitud_clave >= MAX_CLAVE_DOCUMENTO) return 0;
+	if (fread(clave, 1, cabecera->longitud_clave, archivo) != cabecera->longitud_clave) return 0;
+	clave[cabecera->longitud_clave] = '\0';
+	return 1;
+}
+
+/*
+ * Funcion: recuperar_indice_desde
+ * Descripcion: Recorre el .pak desde una posicion y agrega al indice los
+ *              documentos que no estaban en documentos.idx (por ejemplo
+ *              si el programa se cerro entre las dos escrituras)
+ * Parametros: desde - Posicion donde termina lo ya indexado
+ * Retorno: void
+ */
+static void recuperar_indice_desde(long long desde) {
+	FILE* archivo = fopen(ARCHIVO_ALMACEN_DOCUMENTOS, "rb");
+	if (!archivo) return;
+
+	FILE* indice = fopen(ARCHIVO_INDICE_DOCUMENTOS, "a");
+	BUSCAR_64(archivo, desde);
+
+	CabeceraDocumento cabecera;
+	char clave[MAX_CLAVE_DOCUMENTO];
+	long long posicion = desde;
+	while (leer_cabecera(archivo, &cabecera, clave)) {
+		EntradaIndiceDocumento entrada;
+		strcpy(entrada.clave, clave);
+		entrada.tipo = cabecera.tipo;
+		entrada.desplazamiento = posicion;
+		entrada.longitud = (long)cabecera.longitud_datos;
+		insertar_en_indice(&entrada);
+		if (indice) {
+			fprintf(indice, "%s|%d|%lld|%ld\n", entrada.clave, entrada.tipo,
+					entrada.desplazamiento, entrada.longitud);
+		}
+
+		posicion += TAMANO_CABECERA + cabecera.longitud_clave + cabecera.longitud_datos;
+		if (BUSCAR_64(archivo, posicion) != 0) break;
+	}
+
+	if (indice) fclose(indice);
+	fclose(archivo);
+}
+
+/*
+ * Funcion: cargar_indice
+ * Descripcion: Carga documentos.idx en memoria la primera vez que se usa
+ *              el almacen y completa lo que falte leyendo el .pak
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+static void cargar_indice(void) {
+	if (indice_cargado) return;
+	indice_cargado = 1;
+
+	long long fin_indexado = 0;
+	FILE* indice = fopen(ARCHIVO_INDICE_DOCUMENTOS, "r");
+	if (indice) {
+		char linea[200];
+		while (fgets(linea, sizeof(linea), indice)) {
+			EntradaIndiceDocumento entrada;
+			if (sscanf(linea, "%49[^|]|%d|%lld|%ld", entrada.clave, &entrada.tipo,
+					   &entrada.desplazamiento, &entrada.longitud) == 4) {
+				insertar_en_indice(&entrada);
+				long long fin = entrada.desplazamiento + TAMANO_CABECERA +
+					(long long)strlen(entrada.clave) + entrada.longitud;
+				if (fin > fin_indexado) fin_indexado = fin;
+			}
+		}
+		fclose(indice);
+	}
+
+	recuperar_indice_desde(fin_indexado);
+}
+
+// ===================================================================
+// FUNCIONES PRINCIPALES DEL ALMACEN
+// ===================================================================
+
+/*
+ * Funcion: almacen_agregar_documento
+ * Descripcion: Agrega un documento renderizado al final del .pak con una
+ *              sola escritura (cabecera + clave + documento) y registra
+ *              su posicion en el indice
+ * Parametros:
+ *   - clave: Numero de comprobante o certificado
+ *   - tipo: DOCUMENTO_COMPROBANTE, DOCUMENTO_CERTIFICADO, ...
+ *   - documento: Texto del documento
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int almacen_agregar_documento(const char* clave, int tipo, const BufferTexto* documento) {
+	size_t longitud_clave = strlen(clave);
+	if (longitud_clave == 0 || longitud_clave >= MAX_CLAVE_DOCUMENTO) return 0;
+
+	cargar_indice();
+
+	// Crear carpeta de comprobantes si no existe
+	struct stat st = {0};
+	if (stat("comprobantes", &st) == -1) {
+		_mkdir("comprobantes");
+	}
+
+	// Armar el registro completo en un solo bloque
+	CabeceraDocumento cabecera;
+	memset(&cabecera, 0, sizeof(cabecera));
+	memcpy(cabecera.magia, MAGIA_DOCUMENTO, 4);
+	cabecera.tipo = (uint8_t)tipo;
+	cabecera.longitud_clave = (uint8_t)longitud_clave;
+	cabecera.longitud_datos = (uint32_t)documento->longitud;
+	cabecera.suma_verificacion = suma_fnv1a(documento->datos, documento->longitud);
+
+	BufferTexto registro;
+	buffer_iniciar(&registro);
+	if (!buffer_agregar(&registro, (const char*)&cabecera, TAMANO_CABECERA) ||
+		!buffer_agregar(&registro, clave, longitud_clave) ||
+		!buffer_agregar(&registro, documento->datos, documento->longitud)) {
+		buffer_liberar(&registro);
+		return 0;
+	}
+
+	FILE* archivo = fopen(ARCHIVO_ALMACEN_DOCUMENTOS, "ab");
+	if (!archivo) {
+		buffer_liberar(&registro);
+		return 0;
+	}
+	setvbuf(archivo, NULL, _IONBF, 0);   // Sin buffer de stdio: una sola escritura
+
+	fseek(archivo, 0, SEEK_END);
+	long long desplazamiento = POSICION_64(archivo);
+	size_t escritos = fwrite(registro.datos, 1, registro.longitud, archivo);
+	int ok = (escritos == registro.longitud);
+	if (fclose(archivo) == EOF) ok = 0;
+	buffer_liberar(&registro);
+	if (!ok) return 0;
+
+	// Registrar en el indice (memoria y archivo)
+	EntradaIndiceDocumento entrada;
+	strcpy(entrada.clave, clave);
+	entrada.tipo = tipo;
+	entrada.desplazamiento = desplazamiento;
+	entrada.longitud = (long)documento->longitud;
+	insertar_en_indice(&entrada);
+
+	FILE* indice = fopen(ARCHIVO_INDICE_DOCUMENTOS, "a");
+	if (indice) {
+		fprintf(indice, "%s|%d|%lld|%ld\n", entrada.clave, entrada.tipo,
+				entrada.desplazamiento, entrada.longitud);
+		fclose(indice);
+	}
+	return 1;
+}
+
+/*
+ * Funcion: almacen_buscar_documento
+ * Descripcion: Busca la ubicacion de un documento por su clave
+ * Parametros: clave, entrada - Donde se copia la ubicacion (puede ser NULL)
+ * Retorno: 1 si existe, 0 si no existe
+ */
+int almacen_buscar_documento(const char* clave, EntradaIndiceDocumento* entrada) {
+	cargar_indice();
+	if (capacidad_indice == 0) return 0;
+
+	int ranura = ranura_indice(clave);
+	if (tabla_indice[ranura].clave[0] == '\0') return 0;
+	if (entrada) *entrada = tabla_indice[ranura];
+	return 1;
+}
+
+/*
+ * Funcion: almacen_obtener_documento
+ * Descripcion: Lee un documento del .pak con acceso directo a su posicion
+ *              y verifica su suma de control
+ * Parametros:
+ *   - clave: Numero de comprobante o certificado
+ *   - salida: Buffer donde se agrega el documento
+ *   - tipo: Donde se guarda el tipo de documento (puede ser NULL)
+ * Retorno: 1 si fue exitoso, 0 si no existe o esta danado
+ */
+int almacen_obtener_documento(const char* clave, BufferTexto* salida, int* tipo) {
+	EntradaIndiceDocumento entrada;
+	if (!almacen_buscar_documento(clave, &entrada)) return 0;
+
+	FILE* archivo = fopen(ARCHIVO_ALMACEN_DOCUMENTOS, "rb");
+	if (!archivo) return 0;
+
+	CabeceraDocumento cabecera;
+	char clave_leida[MAX_CLAVE_DOCUMENTO];
+	if (BUSCAR_64(archivo, entrada.desplazamiento) != 0 ||
+		!leer_cabecera(archivo, &cabecera, clave_leida) ||
+		strcmp(clave_leida, clave) != 0 ||
+		!buffer_reservar(salida, cabecera.longitud_datos)) {
+		fclose(archivo);
+		return 0;
+	}
+
+	char* destino = salida->datos + salida->longitud;
+	size_t leidos = fread(destino, 1, cabecera.longitud_datos, archivo);
+	fclose(archivo);
+	if (leidos != cabecera.longitud_datos ||
+		suma_fnv1a(destino, leidos) != cabecera.suma_verificacion) {
+		return 0;
+	}
+
+	salida->longitud += leidos;
+	if (tipo) *tipo = cabecera.tipo;
+	return 1;
+}
+
+/*
+ * Funcion: almacen_exportar_documento
+ * Descripcion: Exporta un documento del almacen a un archivo de texto
+ * Parametros: clave, ruta_destino
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int almacen_exportar_documento(const char* clave, const char* ruta_destino) {
+	BufferTexto documento;
+	buffer_iniciar(&documento);
+
+	int ok = almacen_obtener_documento(clave, &documento, NULL) &&
+		escribir_buffer_archivo(ruta_destino, &documento, 0);
+
+	buffer_liberar(&documento);
+	return ok;
+}
+
+/*
+ * Funcion: almacen_cantidad_documentos
+ * Descripcion: Cantidad de documentos registrados en el indice
+ * Parametros: Ninguno
+ * Retorno: Numero de documentos
+ */
+int almacen_cantidad_documentos(void) {
+	cargar_indice();
+	return cantidad_indice;
+}
+
+/*
+ * Funcion: almacen_cerrar
+ * Descripcion: Libera el indice en memoria
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void almacen_cerrar(void) {
+	free(tabla_indice);
+	tabla_indice = NULL;
+	capacidad_indice = 0;
+	cantidad_indice = 0;
+	indice_cargado = 0;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+/*
+ * Funcion: menu_exportar_documento
+ * Descripcion: Muestra un comprobante o certificado del almacen y permite
+ *              exportarlo a un archivo individual
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_exportar_documento(void) {
+	char clave[MAX_CLAVE_DOCUMENTO];
+	char buffer[100];
+
+	limpiar_pantalla();
+	printf("=== EXPORTAR COMPROBANTE O CERTIFICADO ===\n");
+	printf("Documentos en el almacen: %d\n\n", almacen_cantidad_documentos());
+	printf("Ingrese el numero (MAT-... o CERT-...): ");
+	if (!fgets(buffer, sizeof(buffer), stdin) || sscanf(buffer, "%49s", clave) != 1) {
+		printf("Error al leer el numero del documento.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+	convertir_a_mayusculas(clave);
+
+	BufferTexto documento;
+	buffer_iniciar(&documento);
+	int tipo = 0;
+	if (!almacen_obtener_documento(clave, &documento, &tipo)) {
+		printf("\nNo se encontro el documento '%s' en el almacen.\n", clave);
+		buffer_liberar(&documento);
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+
+	printf("\n");
+	fwrite(documento.datos, 1, documento.longitud, stdout);
+	buffer_liberar(&documento);
+
+	printf("\nDesea exportar este documento a un archivo? (S/N): ");
+	if (fgets(buffer, sizeof(buffer), stdin) && (buffer[0] == 'S' || buffer[0] == 's')) {
+		char ruta[120];
+		if (tipo == DOCUMENTO_CERTIFICADO) {
+			system("mkdir certificados 2>nul");
+			sprintf(ruta, "certificados/%s.txt", clave);
+		} else {
+			sprintf(ruta, "comprobantes/%s.txt", clave);
+		}
+
+		if (almacen_exportar_documento(clave, ruta)) {
+			printf("Documento exportado en '%s'\n", ruta);
+		} else {
+			printf("Error: No se pudo exportar el documento.\n");
+		}
+	}
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
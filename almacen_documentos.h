@@ -0,0 +1,68 @@
+/*
+ * almacen_documentos.h - Libreria del archivo empaquetado de documentos
+ *
+ * Descripcion: Este archivo contiene las constantes, estructuras y
+ *              prototipos del almacen de documentos. Los comprobantes y
+ *              certificados renderizados se agregan a un unico archivo
+ *              de solo-anexar (documentos.pak) en lugar de crear un
+ *              archivo por documento. Un indice por numero de comprobante
+ *              permite recuperar y exportar cualquier documento.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef ALMACEN_DOCUMENTOS_H
+#define ALMACEN_DOCUMENTOS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "plantillas.h"
+
+// ===================================================================
+// CONSTANTES DEL ALMACEN
+// ===================================================================
+
+#define ARCHIVO_ALMACEN_DOCUMENTOS "comprobantes/documentos.pak"   // Documentos empaquetados
+#define ARCHIVO_INDICE_DOCUMENTOS "comprobantes/documentos.idx"    // Indice numero -> posicion
+#define MAX_CLAVE_DOCUMENTO 50                                     // Igual que numero_comprobante
+
+// Tipos de documento guardados en el almacen
+#define DOCUMENTO_COMPROBANTE 1
+#define DOCUMENTO_CERTIFICADO 2
+#define DOCUMENTO_RECIBO_LOTE 3
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: EntradaIndiceDocumento
+ * Descripcion: Ubicacion de un documento dentro del archivo empaquetado
+ */
+typedef struct {
+	char clave[MAX_CLAVE_DOCUMENTO];   // Numero de comprobante o certificado
+	int tipo;                          // DOCUMENTO_*
+	long long desplazamiento;          // Inicio del registro en documentos.pak
+	long longitud;                     // Longitud del documento (sin cabecera)
+} EntradaIndiceDocumento;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones principales del almacen
+int almacen_agregar_documento(const char* clave, int tipo, const BufferTexto* documento);
+int almacen_obtener_documento(const char* clave, BufferTexto* salida, int* tipo);
+int almacen_exportar_documento(const char* clave, const char* ruta_destino);
+int almacen_buscar_documento(const char* clave, EntradaIndiceDocumento* entrada);
+int almacen_cantidad_documentos(void);
+void almacen_cerrar(void);
+
+// Funciones de interfaz
+void menu_exportar_documento(void);
+
+#endif // ALMACEN_DOCUMENTOS_H
@@ -0,0 +1,42 @@
+/*
+ * archivos.c - Implementacion de utilidades de archivos
+ *
+ * Descripcion: Este archivo implementa las operaciones sobre archivos
+ *              abiertos usadas por los registros que deben sobrevivir a
+ *              un corte:
+ *              - Sincronizacion con el disco (_commit o fsync)
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "archivos.h"
+
+#ifdef _WIN32
+#include <io.h>          // Para _commit
+#else
+#include <unistd.h>      // Para fsync
+#endif
+
+// ===================================================================
+// ESCRITURA DURADERA
+// ===================================================================
+
+/*
+ * Funcion: sincronizar_archivo
+ * Descripcion: Vacia el buffer del archivo y espera a que el sistema lo
+ *              guarde en el disco (fsync). Despues de esta llamada lo
+ *              escrito sobrevive a un corte de energia
+ * Parametros: archivo - Archivo abierto para escritura
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int sincronizar_archivo(FILE* archivo) {
+	if (fflush(archivo) != 0) return 0;
+#ifdef _WIN32
+	return _commit(_fileno(archivo)) == 0;
+#else
+	return fsync(fileno(archivo)) == 0;
+#endif
+}
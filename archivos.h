@@ -0,0 +1,26 @@
+/*
+ * archivos.h - Libreria minima de utilidades de archivos
+ *
+ * Descripcion: Este archivo contiene los prototipos de las operaciones
+ *              sobre archivos abiertos que no dependen de su contenido,
+ *              con la misma interfaz en Windows y en sistemas POSIX.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef ARCHIVOS_H
+#define ARCHIVOS_H
+
+#include <stdio.h>
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Escritura duradera
+int sincronizar_archivo(FILE* archivo);
+
+#endif // ARCHIVOS_H
@@ -0,0 +1,196 @@
+/*
+ * compresion_lz.c - Implementacion del compresor LZ por bloques
+ *
+ * Descripcion: Este archivo implementa un compresor LZ77 rapido con
+ *              tabla hash de una entrada, pensado para texto con muchos
+ *              campos repetidos (placas, fechas, tipos de vehiculo).
+ *
+ *              Formato de cada secuencia:
+ *              - token: 4 bits altos = literales, 4 bits bajos = coincidencia - 4
+ *              - si un campo vale 15 se extiende con bytes de 255 + resto
+ *              - literales
+ *              - distancia de 2 bytes (little endian) y extension de coincidencia
+ *              La ultima secuencia solo lleva literales.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "compresion_lz.h"
+#include <string.h>
+#include <stdint.h>
+
+#define LZ_BITS_HASH 13
+#define LZ_TAMANO_HASH (1 << LZ_BITS_HASH)
+#define LZ_MAX_DISTANCIA 65535
+
+/*
+ * Funcion: leer32
+ * Descripcion: Lee 4 bytes sin requerir alineacion
+ * Parametros: p - Posicion a leer
+ * Retorno: Valor de 32 bits
+ */
+static uint32_t leer32(const unsigned char* p) {
+	uint32_t valor;
+	memcpy(&valor, p, sizeof(valor));
+	return valor;
+}
+
+/*
+ * Funcion: hash_secuencia
+ * Descripcion: Hash multiplicativo de los 4 bytes siguientes
+ * Parametros: p - Posicion de los bytes
+ * Retorno: Posicion en la tabla hash
+ */
+static uint32_t hash_secuencia(const unsigned char* p) {
+	return (leer32(p) * 2654435761u) >> (32 - LZ_BITS_HASH);
+}
+
+/*
+ * Funcion: escribir_longitud
+ * Descripcion: Escribe la extension de una longitud (bytes de 255 + resto)
+ * Parametros: destino, resto - Longitud menos 15
+ * Retorno: Puntero despues de lo escrito
+ */
+static unsigned char* escribir_longitud(unsigned char* destino, size_t resto) {
+	while (resto >= 255) {
+		*destino++ = 255;
+		resto -= 255;
+	}
+	*destino++ = (unsigned char)resto;
+	return destino;
+}
+
+/*
+ * Funcion: lz_comprimir
+ * Descripcion: Comprime un bloque de hasta LZ_MAX_BLOQUE bytes
+ * Parametros:
+ *   - origen, longitud: Datos originales
+ *   - destino, capacidad: Buffer de salida (usar LZ_LIMITE_COMPRIMIDO)
+ * Retorno: Bytes comprimidos, o 0 si hubo error
+ */
+size_t lz_comprimir(const unsigned char* origen, size_t longitud, unsigned char* destino, size_t capacidad) {
+	if (longitud > LZ_MAX_BLOQUE || capacidad < LZ_LIMITE_COMPRIMIDO(longitud)) return 0;
+
+	uint16_t tabla[LZ_TAMANO_HASH];
+	memset(tabla, 0, sizeof(tabla));
+
+	const unsigned char* ip = origen;
+	const unsigned char* anclaje = origen;                  // Inicio de literales pendientes
+	const unsigned char* fin = origen + longitud;
+	const unsigned char* limite = longitud > 12 ? fin - 12 : origen; // Ultimos bytes van como literales
+	unsigned char* op = destino;
+
+	if (ip < limite) ip++;
+	while (ip < limite) {
+		uint32_t h = hash_secuencia(ip);
+		const unsigned char* candidato = origen + tabla[h];
+		tabla[h] = (uint16_t)(ip - origen);
+
+		if (candidato >= ip || ip - candidato > LZ_MAX_DISTANCIA || leer32(candidato) != leer32(ip)) {
+			ip++;
+			continue;
+		}
+
+		// Extender la coincidencia hacia adelante
+		const unsigned char* m = ip + LZ_MIN_COINCIDENCIA;
+		const unsigned char* c = candidato + LZ_MIN_COINCIDENCIA;
+		while (m < limite && *m == *c) {
+			m++;
+			c++;
+		}
+
+		size_t literales = (size_t)(ip - anclaje);
+		size_t coincidencia = (size_t)(m - ip) - LZ_MIN_COINCIDENCIA;
+		unsigned char* token = op++;
+		*token = (unsigned char)(((literales >= 15 ? 15 : literales) << 4) |
+								 (coincidencia >= 15 ? 15 : coincidencia));
+
+		if (literales >= 15) op = escribir_longitud(op, literales - 15);
+		memcpy(op, anclaje, literales);
+		op += literales;
+
+		uint16_t distancia = (uint16_t)(ip - candidato);
+		*op++ = (unsigned char)(distancia & 0xFF);
+		*op++ = (unsigned char)(distancia >> 8);
+		if (coincidencia >= 15) op = escribir_longitud(op, coincidencia - 15);
+
+		ip = m;
+		anclaje = ip;
+	}
+
+	// Ultima secuencia: solo literales
+	size_t literales = (size_t)(fin - anclaje);
+	*op++ = (unsigned char)((literales >= 15 ? 15 : literales) << 4);
+	if (literales >= 15) op = escribir_longitud(op, literales - 15);
+	memcpy(op, anclaje, literales);
+	op += literales;
+
+	return (size_t)(op - destino);
+}
+
+/*
+ * Funcion: lz_descomprimir
+ * Descripcion: Descomprime un bloque verificando todos los limites, de
+ *              modo que un archivo danado no escriba fuera del buffer
+ * Parametros:
+ *   - origen, longitud: Datos comprimidos
+ *   - destino, capacidad: Buffer de salida
+ * Retorno: Bytes descomprimidos, o 0 si los datos son invalidos
+ */
+size_t lz_descomprimir(const unsigned char* origen, size_t longitud, unsigned char* destino, size_t capacidad) {
+	const unsigned char* ip = origen;
+	const unsigned char* fin = origen + longitud;
+	unsigned char* op = destino;
+	unsigned char* op_fin = destino + capacidad;
+
+	while (ip < fin) {
+		unsigned token = *ip++;
+
+		// Literales
+		size_t literales = token >> 4;
+		if (literales == 15) {
+			unsigned char b;
+			do {
+				if (ip >= fin) return 0;
+				b = *ip++;
+				literales += b;
+			} while (b == 255);
+		}
+		if ((size_t)(fin - ip) < literales || (size_t)(op_fin - op) < literales) return 0;
+		memcpy(op, ip, literales);
+		ip += literales;
+		op += literales;
+
+		if (ip == fin) break;   // Ultima secuencia
+
+		// Coincidencia
+		if (fin - ip < 2) return 0;
+		size_t distancia = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if (distancia == 0 || distancia > (size_t)(op - destino)) return 0;
+
+		size_t coincidencia = token & 0x0F;
+		if (coincidencia == 15) {
+			unsigned char b;
+			do {
+				if (ip >= fin) return 0;
+				b = *ip++;
+				coincidencia += b;
+			} while (b == 255);
+		}
+		coincidencia += LZ_MIN_COINCIDENCIA;
+		if ((size_t)(op_fin - op) < coincidencia) return 0;
+
+		// Copia byte a byte: la coincidencia puede solaparse con la salida
+		const unsigned char* copia = op - distancia;
+		for (size_t i = 0; i < coincidencia; i++) {
+			op[i] = copia[i];
+		}
+		op += coincidencia;
+	}
+
+	return (size_t)(op - destino);
+}
@@ -0,0 +1,38 @@
+/*
+ * compresion_lz.h - Libreria de compresion LZ sin dependencias externas
+ *
+ * Descripcion: Este archivo contiene los prototipos del compresor de la
+ *              familia LZ77 usado por el historico comprimido. Cada bloque
+ *              se comprime de forma independiente (no comparte diccionario
+ *              con otros bloques), con un formato de secuencias similar a
+ *              LZ4: token, literales, distancia de 16 bits y coincidencia.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef COMPRESION_LZ_H
+#define COMPRESION_LZ_H
+
+#include <stddef.h>
+
+// ===================================================================
+// CONSTANTES DEL COMPRESOR
+// ===================================================================
+
+#define LZ_MAX_BLOQUE 65536            // Maximo de bytes originales por bloque
+#define LZ_MIN_COINCIDENCIA 4          // Coincidencia minima que se codifica
+
+// Espacio de salida que garantiza que la compresion no falle
+#define LZ_LIMITE_COMPRIMIDO(n) ((n) + (n) / 255 + 16)
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+size_t lz_comprimir(const unsigned char* origen, size_t longitud, unsigned char* destino, size_t capacidad);
+size_t lz_descomprimir(const unsigned char* origen, size_t longitud, unsigned char* destino, size_t capacidad);
+
+#endif // COMPRESION_LZ_H
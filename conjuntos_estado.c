@@ -0,0 +1,393 @@
+/*
+ * conjuntos_estado.c - Implementacion de los conjuntos de vehiculos por estado
+ *
+ * Descripcion: Este archivo arma los conjuntos de vehiculos por estado,
+ *              incluyendo:
+ *              - Identificadores densos de placa (0, 1, 2, ...) con una
+ *                tabla hash, en el orden en que aparecen las placas
+ *              - Una sola lectura de vehiculos, comprobantes, revisiones y
+ *                matriculados para llenar los mapas de bits
+ *              - Una firma con el tamano y la fecha de cada archivo (y el
+ *                dia actual, por los comprobantes que vencen) para saber
+ *                cuando hay que rehacerlos
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "conjuntos_estado.h"
+#include "vehiculos.h"
+#include "pagos.h"
+#include "particiones.h"
+#include "eventos.h"
+#include "repositorio.h"
+#include <sys/stat.h>    // Para la firma de los archivos
+#include <time.h>
+
+#define SIN_COMPROBANTE -1
+#define MARCA_VENCIDO 4              // Se suma al estado del comprobante si ya vencio
+
+static struct {
+	MapaBits conjuntos[NUM_CONJUNTOS_ESTADO];
+	CategoriaEstado categorias[MAX_CATEGORIAS_ESTADO];
+	int cantidad_categorias;
+	char (*placas)[10];          // Placa de cada identificador
+	signed char* recientes;      // Estado del comprobante mas reciente de cada placa (al armar)
+	uint32_t* tabla;             // Hash de placas: identificador + 1 (0 = libre)
+	uint32_t cantidad_placas;
+	uint32_t capacidad_placas;
+	uint32_t capacidad_tabla;    // Potencia de 2
+	uint64_t firma;
+	int cargado;
+} conjuntos;
+
+// ===================================================================
+// IDENTIFICADORES DE PLACA
+// ===================================================================
+
+static uint32_t hash_placa(const char* placa) {
+	uint32_t hash = 2166136261u;
+	for (; *placa; placa++) {
+		hash = (hash ^ (uint8_t)*placa) * 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Funcion: agrandar_tabla
+ * Descripcion: Duplica la tabla hash y vuelve a ubicar las placas
+ */
+static int agrandar_tabla(void) {
+	uint32_t capacidad = conjuntos.capacidad_tabla ? conjuntos.capacidad_tabla * 2 : 1024;
+	uint32_t* tabla = calloc(capacidad, sizeof(uint32_t));
+	if (!tabla) return 0;
+
+	for (uint32_t id = 0; id < conjuntos.cantidad_placas; id++) {
+		uint32_t i = hash_placa(conjuntos.placas[id]) & (capacidad - 1);
+		while (tabla[i]) i = (i + 1) & (capacidad - 1);
+		tabla[i] = id + 1;
+	}
+	free(conjuntos.tabla);
+	conjuntos.tabla = tabla;
+	conjuntos.capacidad_tabla = capacidad;
+	return 1;
+}
+
+/*
+ * Funcion: id_de_placa
+ * Descripcion: Identificador de una placa, creandolo si es nueva
+ * Retorno: 1 si fue exitoso, 0 si la placa no es valida o falto memoria
+ */
+static int id_de_placa(const char* placa, uint32_t* id) {
+	if (placa[0] == '\0' || strlen(placa) >= sizeof(conjuntos.placas[0])) return 0;
+	if (conjuntos.cantidad_placas * 2 >= conjuntos.capacidad_tabla && !agrandar_tabla()) return 0;
+
+	uint32_t i = hash_placa(placa) & (conjuntos.capacidad_tabla - 1);
+	while (conjuntos.tabla[i]) {
+		if (strcmp(conjuntos.placas[conjuntos.tabla[i] - 1], placa) == 0) {
+			*id = conjuntos.tabla[i] - 1;
+			return 1;
+		}
+		i = (i + 1) & (conjuntos.capacidad_tabla - 1);
+	}
+
+	if (conjuntos.cantidad_placas == conjuntos.capacidad_placas) {
+		uint32_t capacidad = conjuntos.capacidad_placas ? conjuntos.capacidad_placas * 2 : 1024;
+		char (*placas)[10] = realloc(conjuntos.placas, capacidad * sizeof(conjuntos.placas[0]));
+		if (!placas) return 0;
+		conjuntos.placas = placas;
+		signed char* recientes = realloc(conjuntos.recientes, capacidad);
+		if (!recientes) return 0;
+		conjuntos.recientes = recientes;
+		conjuntos.capacidad_placas = capacidad;
+	}
+	*id = conjuntos.cantidad_placas++;
+	strcpy(conjuntos.placas[*id], placa);
+	conjuntos.recientes[*id] = SIN_COMPROBANTE;
+	conjuntos.tabla[i] = *id + 1;
+	return 1;
+}
+
+// ===================================================================
+// LECTURA DE LOS ARCHIVOS
+// ===================================================================
+
+/*
+ * Funcion: agregar_a_categoria
+ * Descripcion: Agrega un vehiculo al conjunto de su tipo o subtipo
+ */
+static int agregar_a_categoria(const char* nombre, int es_subtipo, uint32_t id) {
+	if (nombre[0] == '\0') return 1;
+	for (int i = 0; i < conjuntos.cantidad_categorias; i++) {
+		CategoriaEstado* categoria = &conjuntos.categorias[i];
+		if (categoria->es_subtipo == es_subtipo && strcmp(categoria->nombre, nombre) == 0) {
+			return mapa_agregar(&categoria->vehiculos, id);
+		}
+	}
+	if (conjuntos.cantidad_categorias == MAX_CATEGORIAS_ESTADO) return 1;
+
+	CategoriaEstado* categoria = &conjuntos.categorias[conjuntos.cantidad_categorias++];
+	snprintf(categoria->nombre, sizeof(categoria->nombre), "%s", nombre);
+	categoria->es_subtipo = es_subtipo;
+	mapa_iniciar(&categoria->vehiculos);
+	return mapa_agregar(&categoria->vehiculos, id);
+}
+
+static int leer_vehiculo(const char* clave, const char* linea, void* contexto) {
+	(void)clave;
+	int* exito = contexto;
+	DatosVehiculo vehiculo;
+	uint32_t id;
+	if (!leer_linea_vehiculo(linea, &vehiculo) || !id_de_placa(vehiculo.placa, &id)) return 1;
+
+	if (!mapa_agregar(&conjuntos.conjuntos[CONJUNTO_REGISTRADO], id) ||
+		!agregar_a_categoria(vehiculo.tipo, 0, id) || !agregar_a_categoria(vehiculo.subtipo, 1, id)) {
+		*exito = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Funcion: leer_comprobantes
+ * Descripcion: Recorre las particiones de comprobantes en orden y guarda
+ *              el estado de la ultima linea de cada placa. Las placas sin
+ *              registro en vehiculos.txt toman el tipo del comprobante
+ */
+static int leer_comprobantes(void) {
+	int periodos[MAX_PARTICIONES];
+	int cantidad = particion_listar(PARTICION_COMPROBANTES, 0, 0, periodos, MAX_PARTICIONES);
+
+	for (int p = 0; p < cantidad; p++) {
+		char ruta[MAX_RUTA_PARTICION], linea[500];
+		particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[p]);
+		FILE* archivo = fopen(ruta, "r");
+		if (!archivo) continue;
+
+		while (fgets(linea, sizeof(linea), archivo)) {
+			char placa[20], numero[50], propietario[100], tipo[50], subtipo[50];
+			char fecha_emision[20], fecha_vencimiento[20];
+			int estado;
+			uint32_t id;
+
+			if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%*[^|]|%d",
+					   placa, numero, propietario, tipo, subtipo,
+					   fecha_emision, fecha_vencimiento, &estado) != 8 ||
+				estado < ESTADO_PENDIENTE || estado > ESTADO_VENCIDO || !id_de_placa(placa, &id)) {
+				continue;
+			}
+
+			int vencido = estado == ESTADO_VENCIDO ||
+						  (estado == ESTADO_PENDIENTE && !comprobante_vigente(fecha_vencimiento));
+			conjuntos.recientes[id] = (signed char)(estado + (vencido ? MARCA_VENCIDO : 0));
+
+			if (!mapa_contiene(&conjuntos.conjuntos[CONJUNTO_REGISTRADO], id) &&
+				(!agregar_a_categoria(tipo, 0, id) || !agregar_a_categoria(subtipo, 1, id))) {
+				fclose(archivo);
+				return 0;
+			}
+		}
+		fclose(archivo);
+	}
+
+	// Los identificadores se recorren en orden: cada mapa crece por el final
+	for (uint32_t id = 0; id < conjuntos.cantidad_placas; id++) {
+		int reciente = conjuntos.recientes[id];
+		if (reciente == SIN_COMPROBANTE) continue;
+
+		int estado = reciente % MARCA_VENCIDO;
+		int exito = 1;
+		if (estado == ESTADO_PAGADO) exito = mapa_agregar(&conjuntos.conjuntos[CONJUNTO_PAGADO], id);
+		if (estado == ESTADO_PENDIENTE) exito = mapa_agregar(&conjuntos.conjuntos[CONJUNTO_PENDIENTE], id);
+		if (exito && reciente >= MARCA_VENCIDO) exito = mapa_agregar(&conjuntos.conjuntos[CONJUNTO_VENCIDO], id);
+		if (!exito) return 0;
+	}
+	return 1;
+}
+
+/*
+ * Funcion: leer_revisiones
+ * Descripcion: Agrega las placas con revision tecnica aprobada
+ */
+static int leer_revisiones(void) {
+	FILE* archivo = fopen(ARCHIVO_REVISIONES, "r");
+	if (!archivo) return 1;
+
+	char linea[200];
+	int exito = 1;
+	while (exito && fgets(linea, sizeof(linea), archivo)) {
+		char placa[10];
+		int aprobada;
+		uint32_t id;
+		if (sscanf(linea, "%9[^,],%*[^,],%d", placa, &aprobada) == 2 && aprobada == 1 && id_de_placa(placa, &id)) {
+			exito = mapa_agregar(&conjuntos.conjuntos[CONJUNTO_REVISION_APROBADA], id);
+		}
+	}
+	fclose(archivo);
+	return exito;
+}
+
+static int leer_matriculado(const char* clave, const char* linea, void* contexto) {
+	(void)clave;
+	int* exito = contexto;
+	char placa[20];
+	uint32_t id;
+
+	// Formato: certificado|placa|...
+	if (sscanf(linea, "%*[^|]|%19[^|]", placa) == 1 && id_de_placa(placa, &id) &&
+		!mapa_agregar(&conjuntos.conjuntos[CONJUNTO_MATRICULADO], id)) {
+		*exito = 0;
+		return 0;
+	}
+	return 1;
+}
+
+// ===================================================================
+// FUNCIONES DE CONJUNTOS
+// ===================================================================
+
+static void firmar_archivo(uint64_t* firma, const char* ruta) {
+	struct stat st;
+	long long datos[2] = {-1, -1};
+	if (stat(ruta, &st) == 0) {
+		datos[0] = (long long)st.st_size;
+		datos[1] = (long long)st.st_mtime;
+	}
+	for (size_t i = 0; i < sizeof(datos); i++) {
+		*firma = (*firma ^ ((const uint8_t*)datos)[i]) * 1099511628211ull;
+	}
+}
+
+/*
+ * Funcion: calcular_firma
+ * Descripcion: Resume el tamano y la fecha de los archivos leidos, y el
+ *              dia actual, en un numero
+ */
+static uint64_t calcular_firma(void) {
+	uint64_t firma = 14695981039346656037ull;
+	int periodos[MAX_PARTICIONES];
+	int cantidad = particion_listar(PARTICION_COMPROBANTES, 0, 0, periodos, MAX_PARTICIONES);
+
+	firmar_archivo(&firma, ARCHIVO_VEHICULOS);
+	firmar_archivo(&firma, ARCHIVO_REVISIONES);
+	firmar_archivo(&firma, ARCHIVO_VEHICULOS_MATRICULADOS);
+	for (int p = 0; p < cantidad; p++) {
+		char ruta[MAX_RUTA_PARTICION];
+		particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[p]);
+		firmar_archivo(&firma, ruta);
+	}
+
+	time_t t = time(NULL);
+	struct tm* hoy = localtime(&t);
+	return (firma ^ (uint64_t)((hoy->tm_year + 1900) * 1000 + hoy->tm_yday)) * 1099511628211ull;
+}
+
+/*
+ * Funcion: conjuntos_estado_liberar
+ * Descripcion: Libera los conjuntos y los identificadores de placa
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void conjuntos_estado_liberar(void) {
+	for (int i = 0; i < NUM_CONJUNTOS_ESTADO; i++) {
+		mapa_liberar(&conjuntos.conjuntos[i]);
+	}
+	for (int i = 0; i < conjuntos.cantidad_categorias; i++) {
+		mapa_liberar(&conjuntos.categorias[i].vehiculos);
+	}
+	free(conjuntos.placas);
+	free(conjuntos.recientes);
+	free(conjuntos.tabla);
+	memset(&conjuntos, 0, sizeof(conjuntos));
+}
+
+/*
+ * Funcion: conjuntos_estado_actualizar
+ * Descripcion: Arma los conjuntos si es la primera vez o si cambio algun
+ *              archivo desde la ultima vez
+ * Parametros: Ninguno
+ * Retorno: 1 si los conjuntos estan al dia, 0 si falto memoria
+ */
+int conjuntos_estado_actualizar(void) {
+	uint64_t firma = calcular_firma();
+	if (conjuntos.cargado && conjuntos.firma == firma) {
+		return 1;
+	}
+
+	conjuntos_estado_liberar();
+	int exito = 1;
+	repositorio_recorrer(TABLA_VEHICULOS, leer_vehiculo, &exito);
+	if (exito) exito = leer_comprobantes() && leer_revisiones();
+	if (exito) repositorio_recorrer(TABLA_MATRICULADOS, leer_matriculado, &exito);
+
+	free(conjuntos.recientes);
+	conjuntos.recientes = NULL;
+	if (!exito) {
+		conjuntos_estado_liberar();
+		return 0;
+	}
+	conjuntos.firma = firma;
+	conjuntos.cargado = 1;
+	return 1;
+}
+
+/*
+ * Funcion: conjunto_estado
+ * Descripcion: Conjunto de vehiculos de un estado
+ * Parametros: conjunto - CONJUNTO_*
+ * Retorno: Mapa del conjunto (vacio si no se han armado)
+ */
+const MapaBits* conjunto_estado(int conjunto) {
+	return &conjuntos.conjuntos[conjunto];
+}
+
+/*
+ * Funcion: conjuntos_cantidad_categorias
+ * Descripcion: Tipos y subtipos encontrados al armar los conjuntos
+ * Parametros: Ninguno
+ * Retorno: Cantidad de categorias
+ */
+int conjuntos_cantidad_categorias(void) {
+	return conjuntos.cantidad_categorias;
+}
+
+/*
+ * Funcion: conjuntos_categoria
+ * Descripcion: Categoria de la posicion dada
+ * Parametros: indice - 0 .. conjuntos_cantidad_categorias() - 1
+ * Retorno: Categoria
+ */
+const CategoriaEstado* conjuntos_categoria(int indice) {
+	return &conjuntos.categorias[indice];
+}
+
+/*
+ * Funcion: conjuntos_id_placa
+ * Descripcion: Identificador de una placa ya vista al armar los conjuntos
+ * Parametros: placa, id (salida)
+ * Retorno: 1 si la placa tiene identificador, 0 si no
+ */
+int conjuntos_id_placa(const char* placa, uint32_t* id) {
+	if (!conjuntos.capacidad_tabla) return 0;
+	uint32_t i = hash_placa(placa) & (conjuntos.capacidad_tabla - 1);
+	while (conjuntos.tabla[i]) {
+		if (strcmp(conjuntos.placas[conjuntos.tabla[i] - 1], placa) == 0) {
+			*id = conjuntos.tabla[i] - 1;
+			return 1;
+		}
+		i = (i + 1) & (conjuntos.capacidad_tabla - 1);
+	}
+	return 0;
+}
+
+/*
+ * Funcion: conjuntos_placa
+ * Descripcion: Placa de un identificador
+ * Parametros: id
+ * Retorno: Placa, o "" si el identificador no existe
+ */
+const char* conjuntos_placa(uint32_t id) {
+	return id < conjuntos.cantidad_placas ? conjuntos.placas[id] : "";
+}
@@ -0,0 +1,68 @@
+/*
+ * conjuntos_estado.h - Libreria de conjuntos de vehiculos por estado
+ *
+ * Descripcion: Este archivo contiene las constantes y prototipos de los
+ *              conjuntos de vehiculos por estado (pagado, pendiente,
+ *              vencido, revision aprobada, matriculado) y por tipo y
+ *              subtipo. Cada placa recibe un identificador denso y cada
+ *              conjunto es un mapa de bits comprimido, asi que preguntas
+ *              como "pagados sin revision aprobada" son operaciones
+ *              AND / OR / ANDNOT y un conteo, sin recorrer los archivos
+ *              una vez por vehiculo. Los conjuntos se arman con una sola
+ *              lectura de los archivos y se rehacen cuando alguno cambia.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef CONJUNTOS_ESTADO_H
+#define CONJUNTOS_ESTADO_H
+
+#include "mapa_bits.h"
+
+// ===================================================================
+// CONSTANTES DE CONJUNTOS
+// ===================================================================
+
+// Conjuntos por estado (el estado de un vehiculo es el de su comprobante mas reciente)
+#define CONJUNTO_REGISTRADO 0            // Vehiculos de vehiculos.txt
+#define CONJUNTO_PAGADO 1                // Comprobante pagado
+#define CONJUNTO_PENDIENTE 2             // Comprobante pendiente de pago
+#define CONJUNTO_VENCIDO 3               // Comprobante vencido, o pendiente con la fecha pasada
+#define CONJUNTO_REVISION_APROBADA 4     // Revision tecnica aprobada (revisiones.txt)
+#define CONJUNTO_MATRICULADO 5           // Con certificado de matricula
+#define NUM_CONJUNTOS_ESTADO 6
+
+#define MAX_CATEGORIAS_ESTADO 16         // Tipos y subtipos distintos
+#define MAX_NOMBRE_CATEGORIA 20
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: CategoriaEstado
+ * Descripcion: Vehiculos de un tipo (PARTICULAR, COMERCIAL) o de un
+ *              subtipo (LIVIANO, PESADO, MOTOCICLETA)
+ */
+typedef struct {
+	char nombre[MAX_NOMBRE_CATEGORIA];
+	int es_subtipo;
+	MapaBits vehiculos;
+} CategoriaEstado;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+int conjuntos_estado_actualizar(void);
+void conjuntos_estado_liberar(void);
+const MapaBits* conjunto_estado(int conjunto);
+int conjuntos_cantidad_categorias(void);
+const CategoriaEstado* conjuntos_categoria(int indice);
+int conjuntos_id_placa(const char* placa, uint32_t* id);
+const char* conjuntos_placa(uint32_t id);
+
+#endif // CONJUNTOS_ESTADO_H
@@ -0,0 +1,174 @@
+/*
+ * dinero.c - Implementacion de los montos en centavos enteros
+ *
+ * Descripcion: Este archivo implementa las operaciones con montos,
+ *              incluyendo:
+ *              - Conversion desde y hacia valores decimales (tarifas.cfg,
+ *                entrada del usuario, impresion en pantalla)
+ *              - Porcentajes y prorrateos enteros redondeados al centavo
+ *              - Suma exacta de muchos montos en varios carriles
+ *              - Lectura y escritura de montos como texto sin pasar por
+ *                float, para que los archivos conserven cada centavo
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "dinero.h"
+#include <ctype.h>
+
+#define CARRILES_DINERO 4           // Sumas parciales independientes
+#define MAX_DIGITOS_DINERO 16       // Parte entera que cabe en centavos de 64 bits
+
+// ===================================================================
+// CONVERSIONES
+// ===================================================================
+
+/*
+ * Funcion: dinero_desde_decimal
+ * Descripcion: Convierte dolares con decimales a centavos, redondeando
+ *              al centavo mas cercano (la mitad se aleja de cero)
+ * Parametros: valor - Monto en dolares
+ * Retorno: Monto en centavos
+ */
+Dinero dinero_desde_decimal(double valor) {
+	return (Dinero)(valor * CENTAVOS_POR_DOLAR + (valor < 0 ? -0.5 : 0.5));
+}
+
+/*
+ * Funcion: dinero_a_decimal
+ * Descripcion: Convierte centavos a dolares para mostrarlos con "%.2f"
+ * Parametros: monto
+ * Retorno: Monto en dolares
+ */
+double dinero_a_decimal(Dinero monto) {
+	return (double)monto / CENTAVOS_POR_DOLAR;
+}
+
+/*
+ * Funcion: tasa_desde_porcentaje
+ * Descripcion: Convierte un porcentaje de tarifas.cfg (1.50 = 1.5%) a
+ *              tasa entera
+ * Parametros: porcentaje
+ * Retorno: Tasa en millonesimas
+ */
+TasaDinero tasa_desde_porcentaje(double porcentaje) {
+	double escalado = porcentaje * (ESCALA_TASA / 100);
+	return (TasaDinero)(escalado + (escalado < 0 ? -0.5 : 0.5));
+}
+
+// ===================================================================
+// ARITMETICA
+// ===================================================================
+
+/*
+ * Funcion: dinero_escalar
+ * Descripcion: Calcula monto * numerador / denominador redondeado al
+ *              centavo. El producto debe caber en 64 bits (con montos de
+ *              hasta mil millones de dolares sobra espacio para tasas por
+ *              cientos de meses)
+ * Parametros: monto, numerador, denominador - Mayor que cero
+ * Retorno: Monto escalado
+ */
+Dinero dinero_escalar(Dinero monto, int64_t numerador, int64_t denominador) {
+	int64_t producto = monto * numerador;
+	int64_t cociente = producto / denominador;
+	int64_t resto = producto % denominador;
+
+	if (resto < 0) resto = -resto;
+	if (resto * 2 >= denominador) cociente += (producto < 0) ? -1 : 1;
+	return cociente;
+}
+
+/*
+ * Funcion: dinero_porcentaje
+ * Descripcion: Porcentaje de un monto redondeado al centavo
+ * Parametros: base, tasa - Millonesimas (ESCALA_TASA = 100%)
+ * Retorno: base * tasa / ESCALA_TASA
+ */
+Dinero dinero_porcentaje(Dinero base, TasaDinero tasa) {
+	return dinero_escalar(base, tasa, ESCALA_TASA);
+}
+
+/*
+ * Funcion: dinero_sumar
+ * Descripcion: Suma exacta de un arreglo de montos. Usa CARRILES_DINERO
+ *              sumas parciales sin dependencias entre si para que el
+ *              compilador use instrucciones vectoriales; como la suma de
+ *              enteros es exacta, el resultado no depende del orden
+ * Parametros: montos, cantidad
+ * Retorno: Suma de todos los montos
+ */
+Dinero dinero_sumar(const Dinero* montos, size_t cantidad) {
+	Dinero parcial[CARRILES_DINERO] = {0};
+	size_t i = 0;
+
+	for (; i + CARRILES_DINERO <= cantidad; i += CARRILES_DINERO) {
+		for (int c = 0; c < CARRILES_DINERO; c++) {
+			parcial[c] += montos[i + c];
+		}
+	}
+	for (; i < cantidad; i++) {
+		parcial[0] += montos[i];
+	}
+	return parcial[0] + parcial[1] + parcial[2] + parcial[3];
+}
+
+// ===================================================================
+// TEXTO
+// ===================================================================
+
+/*
+ * Funcion: dinero_leer
+ * Descripcion: Lee un monto escrito en dolares ("161.00", "-3.5", "25000")
+ *              sin pasar por float. Con mas de dos decimales se redondea
+ *              al centavo. Se permiten espacios antes y despues
+ * Parametros: texto, monto (salida)
+ * Retorno: 1 si el texto es un monto valido, 0 si no
+ */
+int dinero_leer(const char* texto, Dinero* monto) {
+	int negativo = 0;
+	int digitos = 0;
+	Dinero centavos = 0;
+
+	while (isspace((unsigned char)*texto)) texto++;
+	if (*texto == '-' || *texto == '+') negativo = (*texto++ == '-');
+
+	for (; isdigit((unsigned char)*texto); texto++) {
+		if (++digitos > MAX_DIGITOS_DINERO) return 0;
+		centavos = centavos * 10 + (*texto - '0');
+	}
+	centavos *= CENTAVOS_POR_DOLAR;
+
+	if (*texto == '.') {
+		int decimales = 0;
+		for (texto++; isdigit((unsigned char)*texto); texto++, decimales++) {
+			if (decimales == 0) centavos += (*texto - '0') * 10;
+			else if (decimales == 1) centavos += *texto - '0';
+			else if (decimales == 2 && *texto >= '5') centavos++;
+		}
+		digitos += decimales;
+	}
+
+	while (isspace((unsigned char)*texto)) texto++;
+	if (digitos == 0 || *texto != '\0') return 0;
+
+	*monto = negativo ? -centavos : centavos;
+	return 1;
+}
+
+/*
+ * Funcion: dinero_formatear
+ * Descripcion: Escribe un monto con dos decimales (equivale a "%.2f")
+ * Parametros: monto, destino - Buffer de MAX_TEXTO_DINERO caracteres
+ * Retorno: destino, para usarlo directamente como argumento "%s"
+ */
+char* dinero_formatear(Dinero monto, char* destino) {
+	uint64_t absoluto = (monto < 0) ? (uint64_t)0 - (uint64_t)monto : (uint64_t)monto;
+
+	snprintf(destino, MAX_TEXTO_DINERO, "%s%llu.%02u", monto < 0 ? "-" : "",
+			 (unsigned long long)(absoluto / CENTAVOS_POR_DOLAR), (unsigned int)(absoluto % CENTAVOS_POR_DOLAR));
+	return destino;
+}
@@ -0,0 +1,62 @@
+/*
+ * dinero.h - Libreria de montos en centavos enteros
+ *
+ * Descripcion: Este archivo contiene el tipo y los prototipos usados para
+ *              todos los montos de dinero del sistema. Un monto es un
+ *              entero de 64 bits en centavos, de modo que las sumas son
+ *              exactas sin importar cuantos valores se acumulen y los
+ *              porcentajes se redondean una sola vez, al centavo. Los
+ *              porcentajes de las tarifas se expresan como tasas enteras
+ *              (millonesimas: 1.00% = 10000).
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef DINERO_H
+#define DINERO_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// ===================================================================
+// CONSTANTES DE DINERO
+// ===================================================================
+
+#define CENTAVOS_POR_DOLAR 100
+#define ESCALA_TASA 1000000              // Tasa que equivale al 100%
+#define MAX_TEXTO_DINERO 24              // "-92233720368547758.08" y '\0'
+
+// ===================================================================
+// TIPOS DE DATOS
+// ===================================================================
+
+// Monto en centavos
+typedef int64_t Dinero;
+
+// Porcentaje en millonesimas (ESCALA_TASA = 100%)
+typedef int64_t TasaDinero;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Conversiones
+Dinero dinero_desde_decimal(double valor);
+double dinero_a_decimal(Dinero monto);
+TasaDinero tasa_desde_porcentaje(double porcentaje);
+
+// Aritmetica con redondeo al centavo
+Dinero dinero_escalar(Dinero monto, int64_t numerador, int64_t denominador);
+Dinero dinero_porcentaje(Dinero base, TasaDinero tasa);
+Dinero dinero_sumar(const Dinero* montos, size_t cantidad);
+
+// Texto
+int dinero_leer(const char* texto, Dinero* monto);
+char* dinero_formatear(Dinero monto, char* destino);
+
+#endif // DINERO_H
@@ -0,0 +1,1162 @@
+/*
+ * eventos.c - Implementacion del registro unico de eventos por placa
+ *
+ * Descripcion: Este archivo implementa el registro de eventos, incluyendo:
+ *              - Escritura de eventos en lote: una sola escritura en
+ *                eventos.log (con sincronizacion opcional) y despues la
+ *                actualizacion de cada archivo de proyeccion
+ *              - Importacion de los archivos existentes la primera vez,
+ *                para que el registro empiece con toda la historia
+ *              - Indice en memoria placa -> posiciones en eventos.log, que
+ *                se pone al dia solo leyendo los eventos nuevos
+ *              - Historial completo de una placa con una busqueda en el
+ *                indice y lecturas directas de cada evento
+ *              - Reconstruccion de todas las proyecciones desde el registro
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "eventos.h"
+#include "vehiculos.h"
+#include "pagos.h"
+#include "particiones.h"
+#include "repositorio.h"
+#include "historico.h"
+#include "indice_vehiculos.h"
+#include "matriculas_pagadas.h"
+#include "resumenes.h"
+#include "archivos.h"
+#include <sys/stat.h>
+#include <stdint.h>
+#include <time.h>
+
+#define ARCHIVO_TEMPORAL_EVENTOS "eventos.tmp"
+#define FECHA_EVENTO_DESCONOCIDA "000000000000"
+#define TAMANO_ESCRITURA_EVENTOS 65536   // Bytes acumulados antes de escribir al importar
+
+// ===================================================================
+// ESTRUCTURAS INTERNAS
+// ===================================================================
+
+/*
+ * Estructura: DescripcionEvento
+ * Descripcion: Proyeccion de cada tipo de evento y donde estan la placa y
+ *              la fecha dentro de su linea
+ */
+typedef struct {
+	const char* nombre;
+	const char* archivo;         // Proyeccion de un solo archivo (NULL = particionada)
+	int tabla;                   // PARTICION_* si la proyeccion es particionada
+	int campo_placa;
+	int campo_fecha;             // -1 si la linea no tiene fecha
+	int tabla_repositorio;       // TABLA_* del repositorio, -1 si no tiene
+	int tabla_resumen;           // RESUMEN_* si la proyeccion tiene resumen, 0 si no
+} DescripcionEvento;
+
+static const DescripcionEvento tipos_evento[NUM_TIPOS_EVENTO] = {
+	{"", NULL, 0, 0, -1, -1, 0},
+	{"REGISTRO", ARCHIVO_VEHICULOS, 0, 0, -1, TABLA_VEHICULOS, RESUMEN_VEHICULOS},
+	{"REVISION", ARCHIVO_REVISIONES, 0, 0, 1, -1, 0},
+	{"COMPROBANTE", NULL, PARTICION_COMPROBANTES, 0, 5, TABLA_COMPROBANTES, 0},
+	{"PAGO", NULL, PARTICION_PAGOS, 1, 2, TABLA_PAGOS, RESUMEN_PAGOS},
+	{"MATRICULA PAGADA", ARCHIVO_MATRICULAS_PAGADAS, 0, 1, 2, -1, 0},
+	{"MATRICULA", ARCHIVO_VEHICULOS_MATRICULADOS, 0, 1, 9, TABLA_MATRICULADOS, 0}
+};
+
+/*
+ * Estructura: Proyecciones
+ * Descripcion: Archivo de proyeccion abierto por cada tipo de evento. Los
+ *              eventos seguidos del mismo tipo y mes se escriben sin
+ *              volver a abrir el archivo. Las matriculas pagadas se juntan
+ *              y se agregan de una vez al cerrar (el archivo tiene cerrojo
+ *              por la migracion de formato). Al cerrar un archivo con
+ *              resumen, el resumen se pone al dia con las lineas escritas
+ */
+typedef struct {
+	FILE* archivos[NUM_TIPOS_EVENTO];
+	BufferTexto pagadas;
+	char rutas[NUM_TIPOS_EVENTO][MAX_RUTA_PARTICION];
+	int periodos[NUM_TIPOS_EVENTO];      // Periodo de la ruta abierta
+	ResumenParticion* resumen;           // Espacio de trabajo de los resumenes
+	int omitir[NUM_TIPOS_EVENTO];        // La ruta abierta es de un ano ya archivado
+	int omitir_archivados;               // Solo al reconstruir
+} Proyecciones;
+
+/*
+ * Estructura: EntradaEvento
+ * Descripcion: Entrada del indice placa -> evento
+ */
+typedef struct {
+	uint64_t clave;              // clave_placa_evento()
+	long posicion;               // Inicio de la linea en eventos.log
+} EntradaEvento;
+
+static struct {
+	EntradaEvento* entradas;     // Ordenado por (clave, posicion)
+	int cantidad;
+	int capacidad;
+	long tamano_indexado;        // Bytes de eventos.log ya leidos
+	time_t modificacion;
+	int cargado;
+} indice_eventos;
+
+static int registro_iniciado = 0;
+
+// ===================================================================
+// FUNCIONES DE LINEAS
+// ===================================================================
+
+/*
+ * Funcion: campo_de_linea
+ * Descripcion: Copia el campo numero 'indice' de una linea separada por
+ *              '|' (o por ',' si la linea no tiene '|')
+ * Parametros: linea, indice, destino, tamano
+ * Retorno: 1 si el campo existe, 0 si no
+ */
+static int campo_de_linea(const char* linea, int indice, char* destino, size_t tamano) {
+	char separador = strchr(linea, '|') ? '|' : ',';
+	const char* inicio = linea;
+
+	for (int i = 0; i < indice; i++) {
+		inicio = strchr(inicio, separador);
+		if (!inicio) {
+			destino[0] = '\0';
+			return 0;
+		}
+		inicio++;
+	}
+
+	size_t largo = strcspn(inicio, separador == '|' ? "|\r\n" : ",\r\n");
+	if (largo >= tamano) largo = tamano - 1;
+	memcpy(destino, inicio, largo);
+	destino[largo] = '\0';
+	return 1;
+}
+
+/*
+ * Funcion: fecha_evento_de_texto
+ * Descripcion: Convierte DD/MM/AAAA (o DD-MM-AAAA), con hora HH:MM
+ *              opcional, al formato AAAAMMDDHHMM de los eventos
+ * Parametros: texto, fecha (buffer de 13)
+ * Retorno: 1 si la fecha es valida, 0 si no (queda la fecha desconocida)
+ */
+static int fecha_evento_de_texto(const char* texto, char* fecha) {
+	int dia, mes, ano, hora = 0, minuto = 0;
+	char sep1, sep2;
+
+	strcpy(fecha, FECHA_EVENTO_DESCONOCIDA);
+	if (sscanf(texto, "%d%c%d%c%d %d:%d", &dia, &sep1, &mes, &sep2, &ano, &hora, &minuto) < 5) return 0;
+	if ((sep1 != '/' && sep1 != '-') || sep2 != sep1) return 0;
+	if (dia < 1 || dia > 31 || mes < 1 || mes > 12 || ano < 1900 || ano > 9999) return 0;
+	if (hora < 0 || hora > 23 || minuto < 0 || minuto > 59) hora = minuto = 0;
+
+	snprintf(fecha, 13, "%04d%02d%02d%02d%02d", ano, mes, dia, hora, minuto);
+	return 1;
+}
+
+/*
+ * Funcion: fecha_evento_actual
+ * Descripcion: Fecha y hora actual en formato AAAAMMDDHHMM
+ */
+static void fecha_evento_actual(char* fecha) {
+	time_t t = time(NULL);
+	struct tm* ahora = localtime(&t);
+	strftime(fecha, 13, "%Y%m%d%H%M", ahora);
+}
+
+/*
+ * Funcion: leer_linea_evento
+ * Descripcion: Separa una linea del registro (tipo|placa|fecha|datos)
+ * Parametros: linea, evento
+ * Retorno: 1 si la linea es un evento valido, 0 si no
+ */
+static int leer_linea_evento(const char* linea, Evento* evento) {
+	const char* placa = strchr(linea, '|');
+	const char* fecha = placa ? strchr(placa + 1, '|') : NULL;
+	const char* datos = fecha ? strchr(fecha + 1, '|') : NULL;
+	if (!datos) return 0;
+
+	evento->tipo = atoi(linea);
+	if (evento->tipo <= 0 || evento->tipo >= NUM_TIPOS_EVENTO) return 0;
+	if (fecha - placa - 1 >= (long)sizeof(evento->placa) || datos - fecha - 1 != 12) return 0;
+
+	memcpy(evento->placa, placa + 1, (size_t)(fecha - placa - 1));
+	evento->placa[fecha - placa - 1] = '\0';
+	memcpy(evento->fecha, fecha + 1, 12);
+	evento->fecha[12] = '\0';
+
+	size_t largo = strcspn(datos + 1, "\r\n");
+	if (largo >= sizeof(evento->datos)) return 0;
+	memcpy(evento->datos, datos + 1, largo);
+	evento->datos[largo] = '\0';
+	return 1;
+}
+
+// ===================================================================
+// FUNCIONES DE PROYECCIONES
+// ===================================================================
+
+/*
+ * Funcion: periodo_de_evento
+ * Descripcion: Particion (AAAAMM) a la que va un comprobante o un pago,
+ *              con la misma regla que usan guardar_comprobante_sistema y
+ *              guardar_registro_pago
+ */
+static int periodo_de_evento(const Evento* evento) {
+	char campo[MAX_COMPROBANTE];
+
+	if (evento->tipo == EVENTO_COMPROBANTE) {
+		campo_de_linea(evento->datos, 1, campo, sizeof(campo));
+		int periodo = periodo_de_numero_comprobante(campo);
+		if (periodo != 0) return periodo;
+	}
+	campo_de_linea(evento->datos, tipos_evento[evento->tipo].campo_fecha, campo, sizeof(campo));
+	return periodo_de_fecha(campo);
+}
+
+/*
+ * Funcion: ano_archivado
+ * Descripcion: Indica si los registros de un ano ya se movieron al historico
+ */
+static int ano_archivado(int tabla, int ano) {
+	char ruta[MAX_RUTA_PARTICION];
+	struct stat st;
+	historico_ruta(ruta, tabla, ano);
+	return stat(ruta, &st) == 0;
+}
+
+/*
+ * Funcion: actualizar_resumen_proyeccion
+ * Descripcion: Pone al dia el resumen del archivo de proyeccion que se
+ *              acaba de cerrar. Si no se puede, la proxima consulta lee
+ *              las lineas que falten: no es un error de la proyeccion
+ */
+static void actualizar_resumen_proyeccion(Proyecciones* proyecciones, int tipo) {
+	int tabla = tipos_evento[tipo].tabla_resumen;
+	if (tabla == 0) return;
+	if (!proyecciones->resumen) proyecciones->resumen = resumen_crear();
+	if (proyecciones->resumen) resumen_actualizar(tabla, proyecciones->periodos[tipo], proyecciones->resumen);
+}
+
+/*
+ * Funcion: abrir_proyeccion
+ * Descripcion: Devuelve el archivo de proyeccion de un evento. Se reutiliza
+ *              el archivo abierto del tipo si la ruta es la misma
+ * Parametros: proyecciones, evento
+ * Retorno: Archivo abierto, NULL si hubo error o si el evento se omite
+ */
+static FILE* abrir_proyeccion(Proyecciones* proyecciones, const Evento* evento) {
+	const DescripcionEvento* descripcion = &tipos_evento[evento->tipo];
+	char ruta[MAX_RUTA_PARTICION];
+	int periodo = 0;
+
+	if (descripcion->archivo) {
+		snprintf(ruta, sizeof(ruta), "%s", descripcion->archivo);
+	} else {
+		periodo = periodo_de_evento(evento);
+		particion_ruta(ruta, descripcion->tabla, periodo);
+	}
+
+	int tipo = evento->tipo;
+	if ((proyecciones->archivos[tipo] || proyecciones->omitir[tipo]) && strcmp(proyecciones->rutas[tipo], ruta) == 0) {
+		return proyecciones->archivos[tipo];
+	}
+
+	if (proyecciones->archivos[tipo]) {
+		fclose(proyecciones->archivos[tipo]);
+		actualizar_resumen_proyeccion(proyecciones, tipo);
+	}
+	proyecciones->archivos[tipo] = NULL;
+	strcpy(proyecciones->rutas[tipo], ruta);
+	proyecciones->periodos[tipo] = periodo;
+
+	// Al reconstruir, los anos archivados ya estan completos en el historico
+	proyecciones->omitir[tipo] = proyecciones->omitir_archivados && !descripcion->archivo &&
+		periodo != PERIODO_LEGADO && ano_archivado(descripcion->tabla, periodo / 100);
+	if (proyecciones->omitir[tipo]) return NULL;
+
+	if (descripcion->archivo) {
+		proyecciones->archivos[tipo] = fopen(ruta, "a");
+	} else {
+		proyecciones->archivos[tipo] = particion_abrir_anexar(descripcion->tabla, periodo);
+	}
+	return proyecciones->archivos[tipo];
+}
+
+/*
+ * Funcion: escribir_proyeccion
+ * Descripcion: Agrega la linea de un evento a su archivo de proyeccion
+ * Parametros: proyecciones, evento
+ * Retorno: 1 si fue exitoso u omitido, 0 si hubo error
+ */
+static int escribir_proyeccion(Proyecciones* proyecciones, const Evento* evento) {
+	if (evento->tipo == EVENTO_MATRICULA_PAGADA) {
+		// Los eventos anteriores a la version 2 pueden tener la linea separada por ','
+		char linea[MAX_DATOS_EVENTO];
+		if (!normalizar_linea_matricula_pagada(evento->datos, linea, sizeof(linea))) return 0;
+		return buffer_agregar(&proyecciones->pagadas, linea, strlen(linea)) &&
+			   buffer_agregar(&proyecciones->pagadas, "\n", 1);
+	}
+
+	FILE* archivo = abrir_proyeccion(proyecciones, evento);
+	if (!archivo) return proyecciones->omitir[evento->tipo];
+	if (fprintf(archivo, "%s\n", evento->datos) <= 0) return 0;
+
+	// Los motores que no son de texto reciben una copia de la linea
+	int tabla = tipos_evento[evento->tipo].tabla_repositorio;
+	return tabla < 0 || repositorio_proyectar(tabla, evento->datos);
+}
+
+/*
+ * Funcion: cerrar_proyecciones
+ * Descripcion: Cierra los archivos de proyeccion abiertos
+ * Retorno: 1 si todos se cerraron bien, 0 si alguno fallo
+ */
+static int cerrar_proyecciones(Proyecciones* proyecciones) {
+	int exito = 1;
+	for (int i = 0; i < NUM_TIPOS_EVENTO; i++) {
+		if (proyecciones->archivos[i]) {
+			if (fclose(proyecciones->archivos[i]) != 0) exito = 0;
+			else actualizar_resumen_proyeccion(proyecciones, i);
+		}
+		proyecciones->archivos[i] = NULL;
+	}
+	free(proyecciones->resumen);
+	proyecciones->resumen = NULL;
+	if (!matriculas_pagadas_anexar(proyecciones->pagadas.datos, proyecciones->pagadas.longitud)) exito = 0;
+	buffer_liberar(&proyecciones->pagadas);
+	return exito;
+}
+
+/*
+ * Funcion: agregar_numero_pagado
+ * Descripcion: Agrega el numero de comprobante de un pago a un arreglo dinamico
+ */
+static int agregar_numero_pagado(char (**numeros)[MAX_COMPROBANTE], int* cantidad, int* capacidad,
+								 const Evento* evento) {
+	if (*cantidad == *capacidad) {
+		int nueva = *capacidad ? *capacidad * 2 : 64;
+		char (*ampliado)[MAX_COMPROBANTE] = realloc(*numeros, (size_t)nueva * sizeof(**numeros));
+		if (!ampliado) return 0;
+		*numeros = ampliado;
+		*capacidad = nueva;
+	}
+	campo_de_linea(evento->datos, 0, (*numeros)[*cantidad], MAX_COMPROBANTE);
+	(*cantidad)++;
+	return 1;
+}
+
+/*
+ * Funcion: proyectar_lote
+ * Descripcion: Aplica a las proyecciones los eventos de un lote ya
+ *              confirmado. Los comprobantes de todos los pagos del lote se
+ *              marcan como pagados con una sola actualizacion
+ * Parametros: lote - Lineas del registro
+ * Retorno: 1 si fue exitoso, 0 si alguna proyeccion no se pudo actualizar
+ */
+static int proyectar_lote(const BufferTexto* lote) {
+	Proyecciones proyecciones;
+	char (*pagados)[MAX_COMPROBANTE] = NULL;
+	int cantidad_pagados = 0, capacidad_pagados = 0;
+	int exito = 1;
+	size_t inicio = 0;
+
+	memset(&proyecciones, 0, sizeof(proyecciones));
+	while (inicio < lote->longitud) {
+		const char* fin = memchr(lote->datos + inicio, '\n', lote->longitud - inicio);
+		size_t largo = fin ? (size_t)(fin - (lote->datos + inicio)) : lote->longitud - inicio;
+		char linea[MAX_LINEA_EVENTO];
+		Evento evento;
+
+		if (largo < sizeof(linea)) {
+			memcpy(linea, lote->datos + inicio, largo);
+			linea[largo] = '\0';
+			if (leer_linea_evento(linea, &evento)) {
+				if (!escribir_proyeccion(&proyecciones, &evento)) exito = 0;
+				if (evento.tipo == EVENTO_PAGO &&
+					!agregar_numero_pagado(&pagados, &cantidad_pagados, &capacidad_pagados, &evento)) {
+					exito = 0;
+				}
+			}
+		}
+		inicio += largo + 1;
+	}
+	if (!cerrar_proyecciones(&proyecciones)) exito = 0;
+
+	if (cantidad_pagados > 0 && !actualizar_estado_comprobantes(pagados, cantidad_pagados, ESTADO_PAGADO)) {
+		exito = 0;
+	}
+	if (!repositorio_confirmar()) exito = 0;
+	free(pagados);
+	return exito;
+}
+
+// ===================================================================
+// FUNCIONES DE ESCRITURA
+// ===================================================================
+
+/*
+ * Funcion: escribir_registro
+ * Descripcion: Agrega bytes a eventos.log con una sola escritura
+ * Parametros: datos, longitud, sincronizar - 1 para esperar al disco
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int escribir_registro(const char* datos, size_t longitud, int sincronizar) {
+	FILE* archivo = fopen(ARCHIVO_EVENTOS, "ab");
+	if (!archivo) return 0;
+
+	// Buffer del tamano del lote: fwrite no lo parte en varias escrituras
+	setvbuf(archivo, NULL, _IOFBF, longitud + 1);
+	int exito = fwrite(datos, 1, longitud, archivo) == longitud;
+	if (exito && sincronizar) exito = sincronizar_archivo(archivo);
+	if (fclose(archivo) != 0) exito = 0;
+	return exito;
+}
+
+/*
+ * Funcion: agregar_evento_de_linea
+ * Descripcion: Agrega al lote el evento de una linea de un archivo de
+ *              proyeccion, tomando la placa y la fecha de la propia linea
+ */
+static int agregar_evento_de_linea(BufferTexto* lote, int tipo, const char* linea) {
+	const DescripcionEvento* descripcion = &tipos_evento[tipo];
+	char placa[10], campo[40], fecha[13];
+
+	strcpy(fecha, FECHA_EVENTO_DESCONOCIDA);
+	if (tipo == EVENTO_MATRICULA_PAGADA) {
+		// Se importa despues de migrar el archivo: las lineas tienen el formato
+		// vigente, salvo los registros anteriores que se conservaron sin
+		// cambios, que se anotan como cualquier otra linea
+		MatriculaPagada registro;
+		if (leer_matricula_pagada(linea, &registro)) {
+			fecha_evento_de_texto(registro.fecha_pago, fecha);
+			return eventos_agregar(lote, tipo, registro.placa, fecha, linea);
+		}
+	}
+
+	campo_de_linea(linea, descripcion->campo_placa, placa, sizeof(placa));
+	if (descripcion->campo_fecha >= 0 && campo_de_linea(linea, descripcion->campo_fecha, campo, sizeof(campo))) {
+		fecha_evento_de_texto(campo, fecha);
+	}
+	return eventos_agregar(lote, tipo, placa, fecha, linea);
+}
+
+/*
+ * Funcion: linea_sin_evento
+ * Descripcion: Lineas de un archivo de proyeccion que no son registros:
+ *              vacias o la cabecera de version
+ */
+static int linea_sin_evento(const char* linea) {
+	return linea[0] == '\0' || strncmp(linea, PREFIJO_CABECERA_VERSION, strlen(PREFIJO_CABECERA_VERSION)) == 0;
+}
+
+/*
+ * Funcion: anotar_archivo
+ * Descripcion: Agrega a un registro abierto un evento por cada linea
+ *              completa de un archivo de proyeccion desde una posicion
+ * Parametros:
+ *   - destino: Registro abierto para agregar
+ *   - ruta: Archivo de proyeccion
+ *   - desde: Posicion inicial
+ *   - tipo: Tipo de evento de las lineas
+ * Retorno: Posicion despues de la ultima linea completa, -1 si hubo error
+ *          (incluida una linea demasiado larga para un evento: no se puede
+ *          saltar sin que se pierda al reconstruir)
+ */
+static long anotar_archivo(FILE* destino, const char* ruta, long desde, int tipo) {
+	FILE* archivo = fopen(ruta, "rb");
+	if (!archivo) return desde;
+	fseek(archivo, desde, SEEK_SET);
+
+	BufferTexto lote;
+	char linea[MAX_LINEA_EVENTO];
+	long posicion = desde;
+	int exito = 1;
+
+	buffer_iniciar(&lote);
+	while (exito && fgets(linea, sizeof(linea), archivo)) {
+		size_t largo = strlen(linea);
+		if (linea[largo - 1] != '\n') {
+			if (feof(archivo)) break;   // Linea cortada: se anota cuando se complete
+			printf("ERROR: '%s' tiene una linea de mas de %d caracteres (posicion %ld).\n",
+				   ruta, MAX_DATOS_EVENTO - 1, posicion);
+			exito = 0;
+			break;
+		}
+		posicion += (long)largo;
+
+		linea[strcspn(linea, "\r\n")] = '\0';
+		if (linea_sin_evento(linea)) continue;
+		if (!agregar_evento_de_linea(&lote, tipo, linea)) exito = 0;
+
+		if (lote.longitud >= TAMANO_ESCRITURA_EVENTOS) {
+			exito = exito && fwrite(lote.datos, 1, lote.longitud, destino) == lote.longitud;
+			buffer_vaciar(&lote);
+		}
+	}
+	fclose(archivo);
+
+	if (exito && lote.longitud > 0) {
+		exito = fwrite(lote.datos, 1, lote.longitud, destino) == lote.longitud;
+	}
+	buffer_liberar(&lote);
+	return exito ? posicion : -1;
+}
+
+/*
+ * Funcion: importar_archivos_existentes
+ * Descripcion: Crea eventos.log con un evento por cada linea de los
+ *              archivos que ya existen. Se escribe en un temporal y se
+ *              renombra al final, asi una importacion cortada se repite
+ *              completa la proxima vez
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int importar_archivos_existentes(void) {
+	FILE* destino = fopen(ARCHIVO_TEMPORAL_EVENTOS, "wb");
+	if (!destino) return 0;
+
+	int exito = anotar_archivo(destino, ARCHIVO_VEHICULOS, 0, EVENTO_REGISTRO) >= 0 &&
+				anotar_archivo(destino, ARCHIVO_REVISIONES, 0, EVENTO_REVISION) >= 0;
+
+	int tablas[2] = {PARTICION_COMPROBANTES, PARTICION_PAGOS};
+	int tipos[2] = {EVENTO_COMPROBANTE, EVENTO_PAGO};
+	for (int t = 0; t < 2 && exito; t++) {
+		int periodos[MAX_PARTICIONES];
+		int cantidad = particion_listar(tablas[t], 0, 0, periodos, MAX_PARTICIONES);
+		for (int i = 0; i < cantidad && exito; i++) {
+			char ruta[MAX_RUTA_PARTICION];
+			particion_ruta(ruta, tablas[t], periodos[i]);
+			exito = anotar_archivo(destino, ruta, 0, tipos[t]) >= 0;
+		}
+	}
+
+	exito = exito && migrar_matriculas_pagadas() >= 0 &&
+			anotar_archivo(destino, ARCHIVO_MATRICULAS_PAGADAS, 0, EVENTO_MATRICULA_PAGADA) >= 0 &&
+			anotar_archivo(destino, ARCHIVO_VEHICULOS_MATRICULADOS, 0, EVENTO_MATRICULA) >= 0;
+	exito = exito && sincronizar_archivo(destino);
+	if (fclose(destino) != 0) exito = 0;
+
+	if (!exito || rename(ARCHIVO_TEMPORAL_EVENTOS, ARCHIVO_EVENTOS) != 0) {
+		remove(ARCHIVO_TEMPORAL_EVENTOS);
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Funcion: eventos_iniciar
+ * Descripcion: Prepara el registro de eventos. La primera vez (si no
+ *              existe eventos.log) importa los archivos existentes
+ * Parametros: Ninguno
+ * Retorno: 1 si el registro ya existia, 2 si se acaba de importar,
+ *          0 si hubo error
+ */
+int eventos_iniciar(void) {
+	struct stat st;
+	if (registro_iniciado && stat(ARCHIVO_EVENTOS, &st) == 0) return 1;
+	registro_iniciado = 0;
+
+	if (stat(ARCHIVO_EVENTOS, &st) == 0) {
+		registro_iniciado = 1;
+		return 1;
+	}
+
+	printf("Creando el registro de eventos '%s' con los archivos existentes...\n", ARCHIVO_EVENTOS);
+	if (!importar_archivos_existentes()) {
+		printf("ERROR: No se pudo crear el registro de eventos.\n");
+		return 0;
+	}
+	registro_iniciado = 1;
+	return 2;
+}
+
+/*
+ * Funcion: eventos_agregar
+ * Descripcion: Agrega un evento a un lote en memoria. Nada se guarda
+ *              hasta llamar a eventos_confirmar
+ * Parametros:
+ *   - lote: Buffer del lote
+ *   - tipo: EVENTO_*
+ *   - placa: Placa del vehiculo
+ *   - fecha: AAAAMMDDHHMM, NULL para la fecha actual
+ *   - datos: Linea de la proyeccion (sin salto de linea)
+ * Retorno: 1 si fue exitoso, 0 si los datos no son validos o no hay memoria
+ */
+int eventos_agregar(BufferTexto* lote, int tipo, const char* placa, const char* fecha, const char* datos) {
+	char ahora[13];
+	char cabecera[40];
+
+	if (tipo <= 0 || tipo >= NUM_TIPOS_EVENTO || strlen(placa) >= 10 || strchr(placa, '|')) return 0;
+	if (!fecha) {
+		fecha_evento_actual(ahora);
+		fecha = ahora;
+	}
+
+	size_t largo = strcspn(datos, "\r\n");
+	if (largo >= MAX_DATOS_EVENTO) return 0;
+
+	int longitud = snprintf(cabecera, sizeof(cabecera), "%d|%s|%s|", tipo, placa, fecha);
+	return buffer_agregar(lote, cabecera, (size_t)longitud) &&
+		   buffer_agregar(lote, datos, largo) &&
+		   buffer_agregar(lote, "\n", 1);
+}
+
+/*
+ * Funcion: eventos_confirmar
+ * Descripcion: Guarda un lote de eventos. El lote se agrega a eventos.log
+ *              con una sola escritura (ese es el punto de confirmacion) y
+ *              despues se actualizan los archivos de proyeccion
+ * Parametros:
+ *   - lote: Eventos armados con eventos_agregar
+ *   - sincronizar: 1 para esperar a que el registro llegue al disco
+ * Retorno: 1 si los eventos quedaron registrados, 0 si no se guardo ninguno
+ */
+int eventos_confirmar(const BufferTexto* lote, int sincronizar) {
+	if (lote->longitud == 0) return 1;
+	if (!eventos_iniciar()) return 0;
+
+	if (!escribir_registro(lote->datos, lote->longitud, sincronizar)) {
+		printf("ERROR: No se pudo escribir en '%s'.\n", ARCHIVO_EVENTOS);
+		return 0;
+	}
+
+	// Si una proyeccion falla, el evento ya esta registrado y se recupera al reconstruir
+	if (!proyectar_lote(lote)) {
+		printf("Advertencia: Algunos archivos no se actualizaron. Use 'Reconstruir archivos desde eventos'.\n");
+	}
+	return 1;
+}
+
+/*
+ * Funcion: evento_registrar
+ * Descripcion: Registra un solo evento con la fecha actual
+ * Parametros: tipo, placa, datos
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int evento_registrar(int tipo, const char* placa, const char* datos) {
+	BufferTexto lote;
+	buffer_iniciar(&lote);
+	int exito = eventos_agregar(&lote, tipo, placa, NULL, datos) && eventos_confirmar(&lote, 0);
+	buffer_liberar(&lote);
+	return exito;
+}
+
+/*
+ * Funcion: proyectar_archivo_en_repositorio
+ * Descripcion: Copia al repositorio las lineas recien anotadas de un
+ *              archivo de proyeccion (solo con los motores que no son de texto)
+ */
+static int proyectar_archivo_en_repositorio(const char* ruta, long desde, long hasta, int tipo) {
+	int tabla = tipos_evento[tipo].tabla_repositorio;
+	if (tabla < 0 || repositorio_usa_proyecciones(tabla)) return 1;
+
+	FILE* archivo = fopen(ruta, "rb");
+	if (!archivo) return 0;
+	fseek(archivo, desde, SEEK_SET);
+
+	char linea[MAX_LINEA_EVENTO];
+	int exito = 1;
+	while (exito && ftell(archivo) < hasta && fgets(linea, sizeof(linea), archivo)) {
+		linea[strcspn(linea, "\r\n")] = '\0';
+		if (linea[0] != '\0') exito = repositorio_proyectar(tabla, linea);
+	}
+	fclose(archivo);
+	return exito && repositorio_confirmar();
+}
+
+/*
+ * Funcion: eventos_anotar_archivo
+ * Descripcion: Registra como eventos las lineas que otro proceso ya
+ *              escribio directamente en un archivo de proyeccion (la
+ *              renovacion escribe los comprobantes en la particion desde
+ *              varios hilos). Solo se anotan las lineas completas
+ * Parametros: ruta, desde - Posicion de la primera linea sin anotar, tipo
+ * Retorno: Posicion hasta donde se anoto, -1 si hubo error
+ */
+long eventos_anotar_archivo(const char* ruta, long desde, int tipo) {
+	if (tipo <= 0 || tipo >= NUM_TIPOS_EVENTO || !eventos_iniciar()) return -1;
+
+	FILE* destino = fopen(ARCHIVO_EVENTOS, "ab");
+	if (!destino) return -1;
+	setvbuf(destino, NULL, _IOFBF, TAMANO_ESCRITURA_EVENTOS);
+
+	long posicion = anotar_archivo(destino, ruta, desde, tipo);
+	if (posicion >= 0 && !sincronizar_archivo(destino)) posicion = -1;
+	if (fclose(destino) != 0) posicion = -1;
+	if (posicion > desde && !proyectar_archivo_en_repositorio(ruta, desde, posicion, tipo)) posicion = -1;
+	return posicion;
+}
+
+/*
+ * Funcion: eventos_posicion_registro
+ * Descripcion: Tamano actual de eventos.log. Quien anota archivos lo
+ *              guarda para saber despues que eventos agrego a partir de ahi
+ * Parametros: Ninguno
+ * Retorno: Tamano en bytes, -1 si el registro no existe
+ */
+long eventos_posicion_registro(void) {
+	struct stat st;
+	if (stat(ARCHIVO_EVENTOS, &st) != 0) return -1;
+	return (long)st.st_size;
+}
+
+/*
+ * Funcion: eventos_anotados_hasta
+ * Descripcion: Averigua hasta donde ya se anoto un archivo de proyeccion
+ *              cuando una anotacion pudo quedar sin confirmar (el proceso
+ *              se corto despues de escribir los eventos y antes de guardar
+ *              su avance). Compara, en orden, las lineas del archivo desde
+ *              'desde' con los eventos del tipo escritos en eventos.log
+ *              desde 'posicion_registro'
+ * Parametros:
+ *   - ruta, desde: Archivo de proyeccion y primera posicion sin confirmar
+ *   - posicion_registro: Tamano de eventos.log al confirmar 'desde' (-1 = desconocido)
+ *   - tipo: Tipo de evento de las lineas
+ * Retorno: Posicion de la primera linea que todavia no tiene evento
+ */
+long eventos_anotados_hasta(const char* ruta, long desde, long posicion_registro, int tipo) {
+	if (posicion_registro < 0) return desde;
+
+	FILE* registro = fopen(ARCHIVO_EVENTOS, "rb");
+	FILE* archivo = fopen(ruta, "rb");
+	long posicion = desde;
+
+	if (registro && archivo && fseek(registro, posicion_registro, SEEK_SET) == 0 &&
+		fseek(archivo, desde, SEEK_SET) == 0) {
+		char linea_registro[MAX_LINEA_EVENTO];
+		char linea[MAX_LINEA_EVENTO];
+		Evento evento;
+
+		while (fgets(linea_registro, sizeof(linea_registro), registro)) {
+			if (!leer_linea_evento(linea_registro, &evento) || evento.tipo != tipo) continue;
+
+			// Siguiente linea que anotar_archivo habria convertido en evento
+			int coincide = 0;
+			long siguiente = posicion;
+			while (fgets(linea, sizeof(linea), archivo)) {
+				size_t largo = strlen(linea);
+				if (linea[largo - 1] != '\n') break;
+				siguiente += (long)largo;
+				linea[strcspn(linea, "\r\n")] = '\0';
+				if (linea_sin_evento(linea)) continue;
+				coincide = strcmp(linea, evento.datos) == 0;
+				break;
+			}
+			if (!coincide) break;
+			posicion = siguiente;
+		}
+	}
+
+	if (registro) fclose(registro);
+	if (archivo) fclose(archivo);
+	return posicion;
+}
+
+// ===================================================================
+// INDICE POR PLACA
+// ===================================================================
+
+/*
+ * Funcion: clave_placa_evento
+ * Descripcion: Clave de una placa en el indice de eventos. Las placas
+ *              ABC-1234 usan codigo_placa(); las demas un hash FNV-1a
+ *              marcado en el bit 32 (se comprueba la placa al leer)
+ */
+static uint64_t clave_placa_evento(const char* placa) {
+	uint32_t codigo = codigo_placa(placa);
+	if (codigo != CODIGO_PLACA_INVALIDO) return codigo;
+
+	uint32_t hash = 2166136261u;
+	for (const char* c = placa; *c; c++) {
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	return (1ull << 32) | hash;
+}
+
+/*
+ * Funcion: comparar_entradas_evento
+ * Descripcion: Compara entradas por clave y luego por posicion
+ */
+static int comparar_entradas_evento(const void* a, const void* b) {
+	const EntradaEvento* x = (const EntradaEvento*)a;
+	const EntradaEvento* y = (const EntradaEvento*)b;
+	if (x->clave != y->clave) return x->clave < y->clave ? -1 : 1;
+	return (x->posicion > y->posicion) - (x->posicion < y->posicion);
+}
+
+/*
+ * Funcion: vaciar_indice_eventos
+ * Descripcion: Descarta el indice para reconstruirlo desde cero
+ */
+static void vaciar_indice_eventos(void) {
+	free(indice_eventos.entradas);
+	memset(&indice_eventos, 0, sizeof(indice_eventos));
+}
+
+/*
+ * Funcion: indice_eventos_actualizar
+ * Descripcion: Pone el indice al dia con eventos.log. Como el registro
+ *              solo crece, normalmente se leen unicamente los eventos
+ *              nuevos; si se acorto o se reescribio, se reconstruye
+ * Parametros: Ninguno
+ * Retorno: 1 si el indice esta al dia, 0 si hubo error
+ */
+int indice_eventos_actualizar(void) {
+	struct stat st;
+	if (stat(ARCHIVO_EVENTOS, &st) != 0) {
+		vaciar_indice_eventos();
+		return 0;
+	}
+
+	if (indice_eventos.cargado && (long)st.st_size == indice_eventos.tamano_indexado &&
+		st.st_mtime == indice_eventos.modificacion) {
+		return 1;
+	}
+	if (!indice_eventos.cargado || (long)st.st_size <= indice_eventos.tamano_indexado) {
+		vaciar_indice_eventos();
+	}
+
+	FILE* archivo = fopen(ARCHIVO_EVENTOS, "rb");
+	if (!archivo) {
+		vaciar_indice_eventos();
+		return 0;
+	}
+	fseek(archivo, indice_eventos.tamano_indexado, SEEK_SET);
+
+	int antes = indice_eventos.cantidad;
+	long posicion = indice_eventos.tamano_indexado;
+	char linea[MAX_LINEA_EVENTO];
+	int exito = 1;
+
+	while (fgets(linea, sizeof(linea), archivo)) {
+		size_t largo = strlen(linea);
+		if (linea[largo - 1] != '\n') break;   // Evento a medio escribir
+
+		char* placa = strchr(linea, '|');
+		char* fin = placa ? strchr(placa + 1, '|') : NULL;
+		if (fin) {
+			if (indice_eventos.cantidad == indice_eventos.capacidad) {
+				int nueva = indice_eventos.capacidad ? indice_eventos.capacidad * 2 : 4096;
+				EntradaEvento* ampliado = realloc(indice_eventos.entradas, (size_t)nueva * sizeof(EntradaEvento));
+				if (!ampliado) {
+					exito = 0;
+					break;
+				}
+				indice_eventos.entradas = ampliado;
+				indice_eventos.capacidad = nueva;
+			}
+			*fin = '\0';
+			indice_eventos.entradas[indice_eventos.cantidad].clave = clave_placa_evento(placa + 1);
+			indice_eventos.entradas[indice_eventos.cantidad].posicion = posicion;
+			indice_eventos.cantidad++;
+		}
+		posicion += (long)largo;
+	}
+	fclose(archivo);
+
+	if (!exito) {
+		vaciar_indice_eventos();
+		return 0;
+	}
+
+	// Pocas entradas nuevas se insertan en orden; muchas se reordenan todas
+	if (indice_eventos.cantidad - antes > MAX_INSERCIONES_INDICE) {
+		qsort(indice_eventos.entradas, (size_t)indice_eventos.cantidad, sizeof(EntradaEvento),
+			  comparar_entradas_evento);
+	} else {
+		for (int i = antes; i < indice_eventos.cantidad; i++) {
+			EntradaEvento nueva = indice_eventos.entradas[i];
+			int j = i;
+			while (j > 0 && comparar_entradas_evento(&indice_eventos.entradas[j - 1], &nueva) > 0) {
+				indice_eventos.entradas[j] = indice_eventos.entradas[j - 1];
+				j--;
+			}
+			indice_eventos.entradas[j] = nueva;
+		}
+	}
+
+	indice_eventos.tamano_indexado = posicion;
+	indice_eventos.modificacion = st.st_mtime;
+	indice_eventos.cargado = 1;
+	return 1;
+}
+
+// ===================================================================
+// FUNCIONES DE CONSULTA
+// ===================================================================
+
+/*
+ * Funcion: eventos_de_placa
+ * Descripcion: Historial completo de una placa: el indice da las
+ *              posiciones de todos sus eventos y cada uno se lee
+ *              directamente. Se devuelven en orden cronologico
+ * Parametros:
+ *   - placa: Placa del vehiculo
+ *   - eventos, max: Arreglo de salida (si hay mas, se devuelven los
+ *     max mas recientes)
+ * Retorno: Cantidad de eventos, -1 si no se pudo leer el registro
+ */
+int eventos_de_placa(const char* placa, Evento* eventos, int max) {
+	if (!eventos_iniciar() || !indice_eventos_actualizar()) return -1;
+
+	uint64_t clave = clave_placa_evento(placa);
+	int desde = 0, hasta = indice_eventos.cantidad;
+	while (desde < hasta) {
+		int medio = desde + (hasta - desde) / 2;
+		if (indice_eventos.entradas[medio].clave < clave) desde = medio + 1;
+		else hasta = medio;
+	}
+	hasta = desde;
+	while (hasta < indice_eventos.cantidad && indice_eventos.entradas[hasta].clave == clave) hasta++;
+	if (hasta - desde > max) desde = hasta - max;
+	if (desde == hasta) return 0;
+
+	FILE* archivo = fopen(ARCHIVO_EVENTOS, "rb");
+	if (!archivo) return -1;
+
+	int cantidad = 0;
+	char linea[MAX_LINEA_EVENTO];
+	for (int i = desde; i < hasta; i++) {
+		if (fseek(archivo, indice_eventos.entradas[i].posicion, SEEK_SET) != 0 ||
+			!fgets(linea, sizeof(linea), archivo)) {
+			continue;
+		}
+		if (leer_linea_evento(linea, &eventos[cantidad]) && strcmp(eventos[cantidad].placa, placa) == 0) {
+			cantidad++;
+		}
+	}
+	fclose(archivo);
+
+	// Los eventos importados no estan en orden de fecha; se ordenan sin perder el orden del registro
+	for (int i = 1; i < cantidad; i++) {
+		Evento actual = eventos[i];
+		int j = i;
+		while (j > 0 && strcmp(eventos[j - 1].fecha, actual.fecha) > 0) {
+			eventos[j] = eventos[j - 1];
+			j--;
+		}
+		eventos[j] = actual;
+	}
+	return cantidad;
+}
+
+/*
+ * Funcion: eventos_nombre_tipo
+ * Descripcion: Nombre de un tipo de evento para mostrar
+ */
+const char* eventos_nombre_tipo(int tipo) {
+	if (tipo <= 0 || tipo >= NUM_TIPOS_EVENTO) return "DESCONOCIDO";
+	return tipos_evento[tipo].nombre;
+}
+
+/*
+ * Funcion: comparar_numeros
+ * Descripcion: Compara numeros de comprobante (qsort/bsearch)
+ */
+static int comparar_numeros(const void* a, const void* b) {
+	return strcmp((const char*)a, (const char*)b);
+}
+
+/*
+ * Funcion: vaciar_proyecciones
+ * Descripcion: Deja vacios todos los archivos de proyeccion, incluidas
+ *              todas las particiones del manifiesto, y borra sus
+ *              resumenes (se vuelven a armar al reescribir los archivos)
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int vaciar_proyecciones(void) {
+	int exito = 1;
+
+	for (int tipo = 1; tipo < NUM_TIPOS_EVENTO; tipo++) {
+		const DescripcionEvento* descripcion = &tipos_evento[tipo];
+		if (tipo == EVENTO_MATRICULA_PAGADA) {
+			if (!matriculas_pagadas_vaciar()) exito = 0;
+			continue;
+		}
+		if (descripcion->archivo) {
+			FILE* archivo = fopen(descripcion->archivo, "w");
+			if (!archivo) exito = 0;
+			else fclose(archivo);
+			if (descripcion->tabla_resumen) {
+				char ruta[MAX_RUTA_PARTICION];
+				resumen_ruta(ruta, descripcion->tabla_resumen, 0);
+				remove(ruta);
+			}
+			continue;
+		}
+
+		int periodos[MAX_PARTICIONES];
+		int cantidad = particion_listar(descripcion->tabla, 0, 0, periodos, MAX_PARTICIONES);
+		for (int i = 0; i < cantidad; i++) {
+			char ruta[MAX_RUTA_PARTICION];
+			particion_ruta(ruta, descripcion->tabla, periodos[i]);
+			FILE* archivo = fopen(ruta, "w");
+			if (!archivo) exito = 0;
+			else fclose(archivo);
+			if (descripcion->tabla_resumen) {
+				resumen_ruta(ruta, descripcion->tabla_resumen, periodos[i]);
+				remove(ruta);
+			}
+		}
+	}
+	if (!repositorio_vaciar_proyecciones()) exito = 0;
+	return exito;
+}
+
+/*
+ * Funcion: eventos_reconstruir_proyecciones
+ * Descripcion: Vuelve a generar todos los archivos de proyeccion desde
+ *              eventos.log. Primero se juntan los comprobantes pagados,
+ *              para escribir cada comprobante ya con su estado final; los
+ *              anos archivados en el historico no se regeneran
+ * Parametros: Ninguno
+ * Retorno: Cantidad de eventos aplicados, -1 si hubo error
+ */
+int eventos_reconstruir_proyecciones(void) {
+	if (!eventos_iniciar()) return -1;
+
+	FILE* archivo = fopen(ARCHIVO_EVENTOS, "rb");
+	if (!archivo) return -1;
+
+	// Primera pasada: comprobantes pagados
+	char (*pagados)[MAX_COMPROBANTE] = NULL;
+	int cantidad_pagados = 0, capacidad_pagados = 0;
+	char linea[MAX_LINEA_EVENTO];
+	Evento evento;
+	int exito = 1;
+
+	while (exito && fgets(linea, sizeof(linea), archivo)) {
+		if (strchr(linea, '\n') && leer_linea_evento(linea, &evento) && evento.tipo == EVENTO_PAGO) {
+			exito = agregar_numero_pagado(&pagados, &cantidad_pagados, &capacidad_pagados, &evento);
+		}
+	}
+	if (!exito || !vaciar_proyecciones()) {
+		fclose(archivo);
+		free(pagados);
+		return -1;
+	}
+	if (cantidad_pagados > 1) {
+		qsort(pagados, (size_t)cantidad_pagados, sizeof(*pagados), comparar_numeros);
+	}
+
+	// Segunda pasada: proyecciones
+	Proyecciones proyecciones;
+	memset(&proyecciones, 0, sizeof(proyecciones));
+	proyecciones.omitir_archivados = 1;
+	int aplicados = 0;
+
+	rewind(archivo);
+	while (exito && fgets(linea, sizeof(linea), archivo)) {
+		if (strchr(linea, '\n') == NULL || !leer_linea_evento(linea, &evento)) continue;
+
+		if (evento.tipo == EVENTO_COMPROBANTE && cantidad_pagados > 0) {
+			char numero[MAX_COMPROBANTE];
+			char* estado = strrchr(evento.datos, '|');
+			campo_de_linea(evento.datos, 1, numero, sizeof(numero));
+			if (estado && bsearch(numero, pagados, (size_t)cantidad_pagados, sizeof(*pagados), comparar_numeros)) {
+				snprintf(estado + 1, sizeof(evento.datos) - (size_t)(estado + 1 - evento.datos), "%d", ESTADO_PAGADO);
+			}
+		}
+
+		exito = escribir_proyeccion(&proyecciones, &evento);
+		if (exito && !proyecciones.omitir[evento.tipo]) aplicados++;
+	}
+	fclose(archivo);
+	if (!cerrar_proyecciones(&proyecciones)) exito = 0;
+	if (!repositorio_confirmar()) exito = 0;
+	free(pagados);
+
+	// Los datos de vehiculos pudieron cambiar
+	invalidar_cache_matricula_completa();
+	indice_vehiculos_actualizar();
+	return exito ? aplicados : -1;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+/*
+ * Funcion: menu_historial_placa
+ * Descripcion: Muestra todos los eventos de una placa en orden
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_historial_placa(void) {
+	char buffer[100];
+	char placa[10] = "";
+
+	limpiar_pantalla();
+	printf("=== HISTORIAL DE EVENTOS POR PLACA ===\n\n");
+	printf("Placa: ");
+	if (!fgets(buffer, sizeof(buffer), stdin) || sscanf(buffer, "%9s", placa) != 1) {
+		printf("\nERROR: Placa invalida.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+	convertir_a_mayusculas(placa);
+
+	Evento* eventos = malloc(MAX_EVENTOS_PLACA * sizeof(Evento));
+	int cantidad = eventos ? eventos_de_placa(placa, eventos, MAX_EVENTOS_PLACA) : -1;
+
+	if (cantidad < 0) {
+		printf("\nERROR: No se pudo leer el registro de eventos.\n");
+	} else if (cantidad == 0) {
+		printf("\nNo hay eventos registrados para la placa %s.\n", placa);
+	} else {
+		printf("\n%-16s %-17s\n", "FECHA", "EVENTO");
+		printf("-------------------------------------------------------\n");
+		for (int i = 0; i < cantidad; i++) {
+			const char* f = eventos[i].fecha;
+			if (strcmp(f, FECHA_EVENTO_DESCONOCIDA) == 0) {
+				printf("%-16s ", "(sin fecha)");
+			} else {
+				printf("%.2s/%.2s/%.4s %.2s:%.2s ", f + 6, f + 4, f, f + 8, f + 10);
+			}
+			printf("%-17s\n    %s\n", eventos_nombre_tipo(eventos[i].tipo), eventos[i].datos);
+		}
+		printf("-------------------------------------------------------\n");
+		printf("Eventos: %d\n", cantidad);
+	}
+	free(eventos);
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
+
+/*
+ * Funcion: menu_reconstruir_proyecciones
+ * Descripcion: Regenera los archivos de datos desde el registro de eventos
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_reconstruir_proyecciones(void) {
+	char buffer[100];
+
+	limpiar_pantalla();
+	printf("=== RECONSTRUIR ARCHIVOS DESDE EVENTOS ===\n");
+	printf("Se volveran a generar vehiculos, revisiones, comprobantes, pagos y\n");
+	printf("matriculas desde '%s'. El contenido actual se reemplaza.\n\n", ARCHIVO_EVENTOS);
+	printf("Continuar? (S/N): ");
+	if (!fgets(buffer, sizeof(buffer), stdin) || (buffer[0] != 'S' && buffer[0] != 's')) {
+		printf("\nOperacion cancelada.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+
+	int aplicados = eventos_reconstruir_proyecciones();
+	if (aplicados < 0) {
+		printf("\nERROR: No se pudieron reconstruir los archivos.\n");
+	} else {
+		printf("\nArchivos reconstruidos con %d eventos.\n", aplicados);
+	}
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
@@ -0,0 +1,89 @@
+/*
+ * eventos.h - Libreria del registro unico de eventos por placa
+ *
+ * Descripcion: Este archivo contiene las constantes, estructuras y
+ *              prototipos del registro de eventos. Todo lo que le pasa a
+ *              una placa (registro, revision, comprobante, pago y
+ *              matricula) se agrega como un evento tipado a eventos.log,
+ *              que es la fuente de verdad. Los archivos de siempre
+ *              (vehiculos.txt, revisiones.txt, particiones de comprobantes
+ *              y pagos, matriculas_pagadas.txt y vehiculos_matriculados.txt)
+ *              son proyecciones de ese registro: se actualizan al confirmar
+ *              cada evento y se pueden reconstruir desde cero.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef EVENTOS_H
+#define EVENTOS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "plantillas.h"
+
+// ===================================================================
+// CONSTANTES DE EVENTOS
+// ===================================================================
+
+#define ARCHIVO_EVENTOS "eventos.log"    // Registro de eventos: tipo|placa|AAAAMMDDHHMM|datos
+#define ARCHIVO_VEHICULOS_MATRICULADOS "vehiculos_matriculados.txt"
+
+#define MAX_DATOS_EVENTO 500             // Linea de la proyeccion guardada en el evento
+#define MAX_LINEA_EVENTO 540
+#define MAX_EVENTOS_PLACA 200            // Eventos mostrados en el historial de una placa
+
+// Tipos de evento y la proyeccion que actualiza cada uno
+enum {
+	EVENTO_REGISTRO = 1,         // vehiculos.txt
+	EVENTO_REVISION,             // revisiones.txt
+	EVENTO_COMPROBANTE,          // comprobantes/comprobantes_AAAAMM.txt
+	EVENTO_PAGO,                 // pagos/pagos_AAAAMM.txt y estado PAGADO del comprobante
+	EVENTO_MATRICULA_PAGADA,     // matriculas_pagadas.txt
+	EVENTO_MATRICULA,            // vehiculos_matriculados.txt
+	NUM_TIPOS_EVENTO
+};
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: Evento
+ * Descripcion: Un evento del registro. Los datos son la linea que el
+ *              evento agrega a su proyeccion, en el formato de ese archivo
+ */
+typedef struct {
+	int tipo;                    // EVENTO_*
+	char placa[10];
+	char fecha[13];              // AAAAMMDDHHMM ("000000000000" si no se conoce)
+	char datos[MAX_DATOS_EVENTO];
+} Evento;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de escritura
+int eventos_iniciar(void);
+int eventos_agregar(BufferTexto* lote, int tipo, const char* placa, const char* fecha, const char* datos);
+int eventos_confirmar(const BufferTexto* lote, int sincronizar);
+int evento_registrar(int tipo, const char* placa, const char* datos);
+long eventos_anotar_archivo(const char* ruta, long desde, int tipo);
+long eventos_posicion_registro(void);
+long eventos_anotados_hasta(const char* ruta, long desde, long posicion_registro, int tipo);
+
+// Funciones de consulta
+int indice_eventos_actualizar(void);
+int eventos_de_placa(const char* placa, Evento* eventos, int max);
+const char* eventos_nombre_tipo(int tipo);
+int eventos_reconstruir_proyecciones(void);
+
+// Funciones de interfaz
+void menu_historial_placa(void);
+void menu_reconstruir_proyecciones(void);
+
+#endif // EVENTOS_H
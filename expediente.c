@@ -0,0 +1,170 @@
+/*
+ * expediente.c - Implementacion del expediente de un vehiculo
+ *
+ * Descripcion: Este archivo implementa la consulta del expediente,
+ *              incluyendo:
+ *              - Precarga en segundo plano: apenas se pide la placa, un
+ *                hilo pone al dia el indice de vehiculos y el de eventos
+ *                (en un archivo grande es lo que mas tarda) mientras la
+ *                persona escribe
+ *              - Consulta del expediente con una busqueda en cada indice:
+ *                el vehiculo y el historial completo de la placa
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "expediente.h"
+#include "eventos.h"
+#include "indice_vehiculos.h"
+#include "repositorio.h"
+#include "hilos.h"
+
+// ===================================================================
+// ESTADO DE LA PRECARGA
+// ===================================================================
+
+// Los indices no admiten dos hilos a la vez: mientras la precarga esta en
+// curso nadie mas los usa, y expediente_obtener la espera antes de consultar
+static Hilo hilo_precarga;
+static int precarga_en_curso = 0;
+
+/*
+ * Funcion: precargar_indices
+ * Descripcion: Hilo de precarga: pone al dia los dos indices. No escribe
+ *              en pantalla; si eventos.log todavia no existe, la
+ *              importacion (que informa su avance) queda para
+ *              expediente_obtener, en el hilo del menu
+ */
+static void precargar_indices(void* argumento) {
+	(void)argumento;
+	indice_vehiculos_actualizar();
+	indice_eventos_actualizar();
+}
+
+/*
+ * Funcion: expediente_esperar_precarga
+ * Descripcion: Espera a que termine la precarga, si hay una en curso. Se
+ *              llama antes de usar los indices por otro camino (por
+ *              ejemplo si se cancela antes de consultar el expediente)
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void expediente_esperar_precarga(void) {
+	if (precarga_en_curso) {
+		hilo_esperar(hilo_precarga);
+		precarga_en_curso = 0;
+	}
+}
+
+/*
+ * Funcion: expediente_precargar
+ * Descripcion: Empieza a poner al dia los indices en segundo plano. Se
+ *              llama justo antes de pedir la placa; si no se puede crear
+ *              el hilo, los indices se ponen al dia en expediente_obtener
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void expediente_precargar(void) {
+	if (precarga_en_curso) return;
+	precarga_en_curso = hilo_crear(&hilo_precarga, precargar_indices, NULL);
+}
+
+// ===================================================================
+// CONSULTA DEL EXPEDIENTE
+// ===================================================================
+
+/*
+ * Funcion: aplicar_evento
+ * Descripcion: Actualiza el expediente con un evento de la placa. Los
+ *              eventos llegan en orden cronologico
+ */
+static void aplicar_evento(ExpedienteVehiculo* expediente, const Evento* evento,
+						   char (*pagados)[MAX_COMPROBANTE], int* cantidad_pagados) {
+	char numero[MAX_COMPROBANTE];
+	RevisionTecnicaSimple revision;
+	char total[MAX_TEXTO_DINERO];
+
+	switch (evento->tipo) {
+	case EVENTO_REVISION:
+		// Formato: placa,fecha,aprobada,observaciones
+		memset(&revision, 0, sizeof(revision));
+		if (sscanf(evento->datos, "%9[^,],%19[^,],%d,%99[^\n]", revision.placa,
+				   revision.fecha_revision, &revision.aprobada, revision.observaciones) >= 3) {
+			expediente->ultima_revision = revision;
+			expediente->revisiones++;
+			if (revision.aprobada == 1) expediente->revision_aprobada = 1;
+		}
+		break;
+	case EVENTO_COMPROBANTE:
+		// Formato: placa|numero|propietario|tipo|subtipo|emision|vencimiento|total|estado
+		if (sscanf(evento->datos, "%*[^|]|%49[^|]|%*[^|]|%*[^|]|%*[^|]|%*[^|]|%*[^|]|%23[^|]",
+				   numero, total) == 2 && dinero_leer(total, &expediente->monto_ultimo_comprobante)) {
+			snprintf(expediente->ultimo_comprobante, MAX_COMPROBANTE, "%s", numero);
+			expediente->comprobantes_pendientes++;
+		}
+		break;
+	case EVENTO_PAGO:
+		// Formato: numero|placa|fecha|monto|...; el comprobante ya se conto como pendiente
+		if (sscanf(evento->datos, "%49[^|]", numero) == 1 && *cantidad_pagados < MAX_EVENTOS_PLACA) {
+			strcpy(pagados[(*cantidad_pagados)++], numero);
+		}
+		break;
+	case EVENTO_MATRICULA_PAGADA:
+		expediente->pago_registrado = 1;
+		break;
+	case EVENTO_MATRICULA:
+		expediente->matriculado = 1;
+		sscanf(evento->datos, "%49[^|]", expediente->ultimo_certificado);
+		break;
+	}
+}
+
+/*
+ * Funcion: expediente_obtener
+ * Descripcion: Arma el expediente de una placa: el vehiculo sale del
+ *              repositorio (el indice de placas con el motor de texto) y
+ *              todo lo demas del historial de eventos de la placa, leido
+ *              de una sola vez
+ * Parametros: placa, expediente (salida)
+ * Retorno: 1 si el vehiculo esta registrado, 0 si no
+ */
+int expediente_obtener(const char* placa, ExpedienteVehiculo* expediente) {
+	expediente_esperar_precarga();
+
+	memset(expediente, 0, sizeof(*expediente));
+	snprintf(expediente->placa, sizeof(expediente->placa), "%s", placa);
+	expediente->registrado = repositorio_buscar_vehiculo(placa, &expediente->vehiculo);
+	if (!expediente->registrado) return 0;
+
+	Evento* eventos = malloc(MAX_EVENTOS_PLACA * sizeof(Evento));
+	char (*pagados)[MAX_COMPROBANTE] = malloc(MAX_EVENTOS_PLACA * sizeof(*pagados));
+	int cantidad = (eventos && pagados) ? eventos_de_placa(placa, eventos, MAX_EVENTOS_PLACA) : -1;
+	int cantidad_pagados = 0;
+
+	for (int i = 0; i < cantidad; i++) {
+		aplicar_evento(expediente, &eventos[i], pagados, &cantidad_pagados);
+	}
+
+	// Los comprobantes con pago pasan de pendientes a pagados
+	for (int i = 0; i < cantidad; i++) {
+		char numero[MAX_COMPROBANTE];
+		if (eventos[i].tipo != EVENTO_COMPROBANTE ||
+			sscanf(eventos[i].datos, "%*[^|]|%49[^|]", numero) != 1) {
+			continue;
+		}
+		for (int j = 0; j < cantidad_pagados; j++) {
+			if (strcmp(pagados[j], numero) == 0) {
+				expediente->comprobantes_pendientes--;
+				expediente->comprobantes_pagados++;
+				break;
+			}
+		}
+	}
+
+	free(eventos);
+	free(pagados);
+	return 1;
+}
@@ -0,0 +1,63 @@
+/*
+ * expediente.h - Libreria del expediente de un vehiculo
+ *
+ * Descripcion: Este archivo contiene la estructura y los prototipos del
+ *              expediente que usa la matriculacion: datos del vehiculo,
+ *              ultima revision tecnica, comprobantes pendientes y pagados
+ *              y estado de matriculacion, todo en una sola consulta (el
+ *              indice de placas y el historial de eventos de la placa) en
+ *              vez de recorrer matriculas_pagadas.txt, revisiones.txt y
+ *              vehiculos.txt uno tras otro. Los indices se pueden poner al
+ *              dia en segundo plano mientras se escribe la placa.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef EXPEDIENTE_H
+#define EXPEDIENTE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "vehiculos.h"
+#include "pagos.h"
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: ExpedienteVehiculo
+ * Descripcion: Todo lo que la matriculacion necesita saber de una placa
+ */
+typedef struct {
+	char placa[10];
+	int registrado;                        // 1 si el vehiculo esta en vehiculos.txt
+	DatosVehiculo vehiculo;
+
+	int revisiones;                        // Revisiones registradas
+	int revision_aprobada;                 // 1 si alguna revision fue aprobada
+	RevisionTecnicaSimple ultima_revision;
+
+	int comprobantes_pendientes;
+	int comprobantes_pagados;
+	char ultimo_comprobante[MAX_COMPROBANTE];
+	Dinero monto_ultimo_comprobante;
+
+	int pago_registrado;                   // 1 si hay una matricula pagada
+	int matriculado;                       // 1 si ya tiene certificado
+	char ultimo_certificado[50];
+} ExpedienteVehiculo;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+void expediente_precargar(void);
+void expediente_esperar_precarga(void);
+int expediente_obtener(const char* placa, ExpedienteVehiculo* expediente);
+
+#endif // EXPEDIENTE_H
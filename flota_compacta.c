@@ -0,0 +1,307 @@
+/*
+ * flota_compacta.c - Implementacion de los registros compactos de vehiculos
+ *
+ * Descripcion: Este archivo implementa la flota compacta, incluyendo:
+ *              - Textos internos: un arreglo con todos los textos
+ *                seguidos y una tabla hash abierta de identificadores
+ *              - Conversion de DatosVehiculo a VehiculoCompacto y de
+ *                vuelta, sin perder datos (las placas y cedulas fuera de
+ *                formato se guardan como texto)
+ *              - Consultas por manejador que no copian el registro
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "flota_compacta.h"
+#include "indice_vehiculos.h"   // Para codigo_placa y clave_cedula
+
+#define SIN_TEXTO UINT32_MAX
+
+// ===================================================================
+// TEXTOS INTERNOS
+// ===================================================================
+
+static uint32_t hash_texto(const char* texto) {
+	uint32_t hash = 2166136261u;
+	for (; *texto; texto++) {
+		hash = (hash ^ (uint8_t)*texto) * 16777619u;
+	}
+	return hash;
+}
+
+static void textos_liberar(TextosInternos* textos) {
+	free(textos->datos);
+	free(textos->inicios);
+	free(textos->tabla);
+	memset(textos, 0, sizeof(*textos));
+}
+
+/*
+ * Funcion: textos_vaciar
+ * Descripcion: Olvida los textos sin liberar la memoria reservada
+ */
+static void textos_vaciar(TextosInternos* textos) {
+	textos->usado = 0;
+	textos->cantidad = 0;
+	if (textos->tabla) memset(textos->tabla, 0, textos->capacidad_tabla * sizeof(uint32_t));
+}
+
+static const char* textos_obtener(const TextosInternos* textos, uint32_t id) {
+	return id < textos->cantidad ? textos->datos + textos->inicios[id] : "";
+}
+
+/*
+ * Funcion: textos_agrandar_tabla
+ * Descripcion: Duplica la tabla hash y vuelve a ubicar los textos
+ */
+static int textos_agrandar_tabla(TextosInternos* textos) {
+	uint32_t capacidad = textos->capacidad_tabla ? textos->capacidad_tabla * 2 : 256;
+	uint32_t* tabla = calloc(capacidad, sizeof(uint32_t));
+	if (!tabla) return 0;
+
+	for (uint32_t id = 0; id < textos->cantidad; id++) {
+		uint32_t i = hash_texto(textos_obtener(textos, id)) & (capacidad - 1);
+		while (tabla[i]) i = (i + 1) & (capacidad - 1);
+		tabla[i] = id + 1;
+	}
+	free(textos->tabla);
+	textos->tabla = tabla;
+	textos->capacidad_tabla = capacidad;
+	return 1;
+}
+
+/*
+ * Funcion: textos_internar
+ * Descripcion: Identificador de un texto, guardandolo si es nuevo
+ * Retorno: Identificador, o SIN_TEXTO si falto memoria
+ */
+static uint32_t textos_internar(TextosInternos* textos, const char* texto) {
+	if (textos->cantidad * 2 >= textos->capacidad_tabla && !textos_agrandar_tabla(textos)) return SIN_TEXTO;
+
+	uint32_t i = hash_texto(texto) & (textos->capacidad_tabla - 1);
+	while (textos->tabla[i]) {
+		uint32_t id = textos->tabla[i] - 1;
+		if (strcmp(textos_obtener(textos, id), texto) == 0) return id;
+		i = (i + 1) & (textos->capacidad_tabla - 1);
+	}
+
+	size_t largo = strlen(texto) + 1;
+	if (textos->usado + largo > UINT32_MAX) return SIN_TEXTO;
+	if (textos->usado + largo > textos->capacidad) {
+		size_t capacidad = textos->capacidad ? textos->capacidad * 2 : 4096;
+		while (capacidad < textos->usado + largo) capacidad *= 2;
+		char* datos = realloc(textos->datos, capacidad);
+		if (!datos) return SIN_TEXTO;
+		textos->datos = datos;
+		textos->capacidad = capacidad;
+	}
+	if (textos->cantidad == textos->capacidad_inicios) {
+		uint32_t capacidad = textos->capacidad_inicios ? textos->capacidad_inicios * 2 : 256;
+		uint32_t* inicios = realloc(textos->inicios, capacidad * sizeof(uint32_t));
+		if (!inicios) return SIN_TEXTO;
+		textos->inicios = inicios;
+		textos->capacidad_inicios = capacidad;
+	}
+
+	uint32_t id = textos->cantidad++;
+	textos->inicios[id] = (uint32_t)textos->usado;
+	memcpy(textos->datos + textos->usado, texto, largo);
+	textos->usado += largo;
+	textos->tabla[i] = id + 1;
+	return id;
+}
+
+// ===================================================================
+// FUNCIONES DE LA FLOTA
+// ===================================================================
+
+/*
+ * Funcion: sembrar_categorias
+ * Descripcion: Guarda los tipos y subtipos conocidos para que reciban
+ *              los codigos TIPO_VEHICULO_* y SUBTIPO_VEHICULO_*
+ */
+static int sembrar_categorias(FlotaCompacta* flota) {
+	return textos_internar(&flota->tipos, "PARTICULAR") == TIPO_VEHICULO_PARTICULAR &&
+		   textos_internar(&flota->tipos, "COMERCIAL") == TIPO_VEHICULO_COMERCIAL &&
+		   textos_internar(&flota->subtipos, "LIVIANO") == SUBTIPO_VEHICULO_LIVIANO &&
+		   textos_internar(&flota->subtipos, "PESADO") == SUBTIPO_VEHICULO_PESADO &&
+		   textos_internar(&flota->subtipos, "MOTOCICLETA") == SUBTIPO_VEHICULO_MOTOCICLETA;
+}
+
+/*
+ * Funcion: flota_iniciar
+ * Descripcion: Deja una flota vacia
+ * Parametros: flota
+ * Retorno: 1 si fue exitoso, 0 si falto memoria
+ */
+int flota_iniciar(FlotaCompacta* flota) {
+	memset(flota, 0, sizeof(*flota));
+	if (!sembrar_categorias(flota)) {
+		flota_liberar(flota);
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Funcion: flota_vaciar
+ * Descripcion: Quita todos los vehiculos y textos pero conserva la memoria
+ *              reservada, para llenar la flota otra vez (un lote nuevo)
+ * Parametros: flota
+ * Retorno: void
+ */
+void flota_vaciar(FlotaCompacta* flota) {
+	flota->cantidad = 0;
+	textos_vaciar(&flota->textos);
+	textos_vaciar(&flota->tipos);
+	textos_vaciar(&flota->subtipos);
+	sembrar_categorias(flota);
+}
+
+/*
+ * Funcion: flota_liberar
+ * Descripcion: Libera la memoria de la flota
+ * Parametros: flota
+ * Retorno: void
+ */
+void flota_liberar(FlotaCompacta* flota) {
+	free(flota->vehiculos);
+	textos_liberar(&flota->textos);
+	textos_liberar(&flota->tipos);
+	textos_liberar(&flota->subtipos);
+	memset(flota, 0, sizeof(*flota));
+}
+
+/*
+ * Funcion: monto_compacto
+ * Descripcion: Guarda un monto en 32 bits si cabe
+ */
+static int monto_compacto(Dinero monto, int32_t* compacto) {
+	if (monto < INT32_MIN || monto > INT32_MAX) return 0;
+	*compacto = (int32_t)monto;
+	return 1;
+}
+
+/*
+ * Funcion: flota_agregar
+ * Descripcion: Agrega un vehiculo a la flota en formato compacto
+ * Parametros: flota, vehiculo, manejador (salida)
+ * Retorno: 1 si fue exitoso, 0 si falto memoria, -1 si un valor no cabe
+ *          en el registro compacto (el vehiculo no se agrega)
+ */
+int flota_agregar(FlotaCompacta* flota, const DatosVehiculo* vehiculo, ManejadorVehiculo* manejador) {
+	VehiculoCompacto compacto;
+	memset(&compacto, 0, sizeof(compacto));
+
+	if (vehiculo->ano < 0 || vehiculo->ano > UINT16_MAX || vehiculo->cilindraje < 0 ||
+		vehiculo->cilindraje > UINT16_MAX || vehiculo->meses_retraso < 0 || vehiculo->meses_retraso > UINT8_MAX ||
+		!monto_compacto(vehiculo->avaluo, &compacto.avaluo) || !monto_compacto(vehiculo->valor_multas, &compacto.multas)) {
+		return -1;
+	}
+	compacto.ano = (uint16_t)vehiculo->ano;
+	compacto.cilindraje = (uint16_t)vehiculo->cilindraje;
+	compacto.meses_retraso = (uint8_t)vehiculo->meses_retraso;
+	if (vehiculo->tiene_multas) compacto.banderas |= BANDERA_TIENE_MULTAS;
+
+	// Placa y cedula como enteros; si no tienen el formato, como texto
+	compacto.placa = codigo_placa(vehiculo->placa);
+	if (compacto.placa == CODIGO_PLACA_INVALIDO) {
+		compacto.placa = textos_internar(&flota->textos, vehiculo->placa);
+		compacto.banderas |= BANDERA_PLACA_TEXTO;
+		if (compacto.placa == SIN_TEXTO) return 0;
+	}
+	compacto.cedula = clave_cedula(vehiculo->cedula);
+	if (compacto.cedula == CLAVE_CEDULA_INVALIDA) {
+		uint32_t id = textos_internar(&flota->textos, vehiculo->cedula);
+		if (id == SIN_TEXTO) return 0;
+		compacto.cedula = id;
+		compacto.banderas |= BANDERA_CEDULA_TEXTO;
+	}
+
+	compacto.propietario = textos_internar(&flota->textos, vehiculo->propietario);
+	uint32_t tipo = textos_internar(&flota->tipos, vehiculo->tipo);
+	uint32_t subtipo = textos_internar(&flota->subtipos, vehiculo->subtipo);
+	if (compacto.propietario == SIN_TEXTO || tipo == SIN_TEXTO || subtipo == SIN_TEXTO) return 0;
+	if (tipo >= MAX_CATEGORIAS_FLOTA || subtipo >= MAX_CATEGORIAS_FLOTA) return -1;
+	compacto.tipo = (uint8_t)tipo;
+	compacto.subtipo = (uint8_t)subtipo;
+
+	if (flota->cantidad == flota->capacidad) {
+		uint32_t capacidad = flota->capacidad ? flota->capacidad * 2 : 1024;
+		VehiculoCompacto* vehiculos = realloc(flota->vehiculos, capacidad * sizeof(VehiculoCompacto));
+		if (!vehiculos) return 0;
+		flota->vehiculos = vehiculos;
+		flota->capacidad = capacidad;
+	}
+	*manejador = flota->cantidad;
+	flota->vehiculos[flota->cantidad++] = compacto;
+	return 1;
+}
+
+// ===================================================================
+// CONSULTAS POR MANEJADOR
+// ===================================================================
+
+/*
+ * Funcion: flota_placa
+ * Descripcion: Escribe la placa de un vehiculo
+ * Parametros: flota, manejador, placa - Buffer de al menos 10 caracteres
+ * Retorno: void
+ */
+void flota_placa(const FlotaCompacta* flota, ManejadorVehiculo manejador, char* placa) {
+	const VehiculoCompacto* compacto = &flota->vehiculos[manejador];
+	if (compacto->banderas & BANDERA_PLACA_TEXTO) {
+		snprintf(placa, 10, "%s", textos_obtener(&flota->textos, compacto->placa));
+	} else {
+		placa_de_codigo(compacto->placa, placa);
+	}
+}
+
+/*
+ * Funcion: flota_propietario
+ * Descripcion: Nombre del propietario de un vehiculo (sin copiarlo)
+ * Parametros: flota, manejador
+ * Retorno: Nombre guardado en la flota
+ */
+const char* flota_propietario(const FlotaCompacta* flota, ManejadorVehiculo manejador) {
+	return textos_obtener(&flota->textos, flota->vehiculos[manejador].propietario);
+}
+
+const char* flota_tipo(const FlotaCompacta* flota, ManejadorVehiculo manejador) {
+	return textos_obtener(&flota->tipos, flota->vehiculos[manejador].tipo);
+}
+
+const char* flota_subtipo(const FlotaCompacta* flota, ManejadorVehiculo manejador) {
+	return textos_obtener(&flota->subtipos, flota->vehiculos[manejador].subtipo);
+}
+
+/*
+ * Funcion: flota_expandir
+ * Descripcion: Arma el DatosVehiculo de un vehiculo de la flota, para las
+ *              funciones de calculo que lo reciben
+ * Parametros: flota, manejador, vehiculo (salida)
+ * Retorno: void
+ */
+void flota_expandir(const FlotaCompacta* flota, ManejadorVehiculo manejador, DatosVehiculo* vehiculo) {
+	const VehiculoCompacto* compacto = &flota->vehiculos[manejador];
+
+	flota_placa(flota, manejador, vehiculo->placa);
+	if (compacto->banderas & BANDERA_CEDULA_TEXTO) {
+		snprintf(vehiculo->cedula, sizeof(vehiculo->cedula), "%s",
+				 textos_obtener(&flota->textos, (uint32_t)compacto->cedula));
+	} else {
+		cedula_de_clave(compacto->cedula, vehiculo->cedula);
+	}
+	snprintf(vehiculo->propietario, sizeof(vehiculo->propietario), "%s", flota_propietario(flota, manejador));
+	snprintf(vehiculo->tipo, sizeof(vehiculo->tipo), "%s", flota_tipo(flota, manejador));
+	snprintf(vehiculo->subtipo, sizeof(vehiculo->subtipo), "%s", flota_subtipo(flota, manejador));
+	vehiculo->ano = compacto->ano;
+	vehiculo->avaluo = compacto->avaluo;
+	vehiculo->cilindraje = compacto->cilindraje;
+	vehiculo->tiene_multas = (compacto->banderas & BANDERA_TIENE_MULTAS) ? 1 : 0;
+	vehiculo->valor_multas = compacto->multas;
+	vehiculo->meses_retraso = compacto->meses_retraso;
+}
@@ -0,0 +1,119 @@
+/*
+ * flota_compacta.h - Libreria de registros compactos de vehiculos
+ *
+ * Descripcion: Este archivo contiene las estructuras y prototipos de la
+ *              flota compacta: vehiculos en memoria en 32 bytes cada uno,
+ *              frente a los ~150 de DatosVehiculo. La placa y la cedula
+ *              son enteros (codigo_placa, clave_cedula), el nombre del
+ *              propietario se guarda una sola vez y se referencia por un
+ *              identificador, el tipo y el subtipo son codigos de un byte
+ *              y el avaluo y las multas son centavos enteros. Diez
+ *              millones de vehiculos ocupan unos 320 MB mas los nombres
+ *              distintos. Los vehiculos se identifican por un manejador;
+ *              solo se arma un DatosVehiculo cuando hace falta.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef FLOTA_COMPACTA_H
+#define FLOTA_COMPACTA_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "matricula.h"
+
+// ===================================================================
+// CONSTANTES DE LA FLOTA
+// ===================================================================
+
+// Codigos de tipo y subtipo (otros textos reciben codigos siguientes)
+#define TIPO_VEHICULO_PARTICULAR 0
+#define TIPO_VEHICULO_COMERCIAL 1
+#define SUBTIPO_VEHICULO_LIVIANO 0
+#define SUBTIPO_VEHICULO_PESADO 1
+#define SUBTIPO_VEHICULO_MOTOCICLETA 2
+#define MAX_CATEGORIAS_FLOTA 256         // Codigos de un byte
+
+// Banderas del registro
+#define BANDERA_PLACA_TEXTO 0x01         // La placa no es ABC-1234: 'placa' es un texto interno
+#define BANDERA_CEDULA_TEXTO 0x02        // La cedula no es numerica: 'cedula' es un texto interno
+#define BANDERA_TIENE_MULTAS 0x04
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+// Manejador de un vehiculo de la flota (posicion del registro)
+typedef uint32_t ManejadorVehiculo;
+
+/*
+ * Estructura: VehiculoCompacto
+ * Descripcion: Registro de 32 bytes de un vehiculo
+ */
+typedef struct {
+	uint64_t cedula;             // clave_cedula, o identificador de texto
+	uint32_t placa;              // codigo_placa, o identificador de texto
+	uint32_t propietario;        // Identificador del nombre
+	int32_t avaluo;              // Centavos
+	int32_t multas;              // Centavos
+	uint16_t ano;
+	uint16_t cilindraje;
+	uint8_t tipo;                // TIPO_VEHICULO_*
+	uint8_t subtipo;             // SUBTIPO_VEHICULO_*
+	uint8_t meses_retraso;
+	uint8_t banderas;            // BANDERA_*
+} VehiculoCompacto;
+
+/*
+ * Estructura: TextosInternos
+ * Descripcion: Textos guardados una sola vez. Cada texto distinto recibe
+ *              un identificador (0, 1, 2, ...) y una tabla hash encuentra
+ *              el identificador de un texto ya guardado
+ */
+typedef struct {
+	char* datos;                 // Textos seguidos, cada uno con su '\0'
+	size_t usado;
+	size_t capacidad;
+	uint32_t* inicios;           // Posicion de cada texto en 'datos'
+	uint32_t cantidad;
+	uint32_t capacidad_inicios;
+	uint32_t* tabla;             // Identificador + 1 (0 = libre)
+	uint32_t capacidad_tabla;    // Potencia de 2
+} TextosInternos;
+
+/*
+ * Estructura: FlotaCompacta
+ * Descripcion: Vehiculos compactos y los textos que referencian
+ */
+typedef struct {
+	VehiculoCompacto* vehiculos;
+	uint32_t cantidad;
+	uint32_t capacidad;
+	TextosInternos textos;       // Nombres, y placas o cedulas fuera de formato
+	TextosInternos tipos;
+	TextosInternos subtipos;
+} FlotaCompacta;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de la flota
+int flota_iniciar(FlotaCompacta* flota);
+void flota_vaciar(FlotaCompacta* flota);
+void flota_liberar(FlotaCompacta* flota);
+int flota_agregar(FlotaCompacta* flota, const DatosVehiculo* vehiculo, ManejadorVehiculo* manejador);
+
+// Consultas por manejador
+void flota_expandir(const FlotaCompacta* flota, ManejadorVehiculo manejador, DatosVehiculo* vehiculo);
+void flota_placa(const FlotaCompacta* flota, ManejadorVehiculo manejador, char* placa);
+const char* flota_propietario(const FlotaCompacta* flota, ManejadorVehiculo manejador);
+const char* flota_tipo(const FlotaCompacta* flota, ManejadorVehiculo manejador);
+const char* flota_subtipo(const FlotaCompacta* flota, ManejadorVehiculo manejador);
+
+#endif // FLOTA_COMPACTA_H
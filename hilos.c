@@ -0,0 +1,176 @@
+/*
+ * hilos.c - Implementacion de hilos y cerrojos
+ *
+ * Descripcion: Este archivo implementa la capa de hilos usada por los
+ *              procesos en lote y por la publicacion de tarifas:
+ *              - Creacion y espera de hilos (Win32 o pthreads)
+ *              - Cantidad de procesadores disponibles
+ *              - Cerrojos (CRITICAL_SECTION o pthread_mutex_t)
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "hilos.h"
+#include <stdlib.h>
+#ifndef _WIN32
+#include <sched.h>       // Para sched_yield
+#include <unistd.h>      // Para sysconf
+#endif
+
+// ===================================================================
+// FUNCIONES DE HILOS
+// ===================================================================
+
+/*
+ * Estructura: InicioHilo
+ * Descripcion: Funcion y argumento que recibe el hilo nuevo. Las APIs de
+ *              Win32 y pthreads usan firmas distintas, asi que el hilo
+ *              empieza en un puente que llama a la funcion del usuario
+ */
+typedef struct {
+	FuncionHilo funcion;
+	void* argumento;
+} InicioHilo;
+
+#ifdef _WIN32
+static DWORD WINAPI puente_hilo(LPVOID dato) {
+#else
+static void* puente_hilo(void* dato) {
+#endif
+	InicioHilo inicio = *(InicioHilo*)dato;
+	free(dato);
+	inicio.funcion(inicio.argumento);
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+/*
+ * Funcion: hilo_crear
+ * Descripcion: Crea un hilo que ejecuta funcion(argumento)
+ * Parametros: hilo (salida), funcion, argumento
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int hilo_crear(Hilo* hilo, FuncionHilo funcion, void* argumento) {
+	InicioHilo* inicio = malloc(sizeof(InicioHilo));
+	if (!inicio) return 0;
+	inicio->funcion = funcion;
+	inicio->argumento = argumento;
+
+#ifdef _WIN32
+	*hilo = CreateThread(NULL, 0, puente_hilo, inicio, 0, NULL);
+	if (*hilo == NULL) {
+		free(inicio);
+		return 0;
+	}
+#else
+	if (pthread_create(hilo, NULL, puente_hilo, inicio) != 0) {
+		free(inicio);
+		return 0;
+	}
+#endif
+	return 1;
+}
+
+/*
+ * Funcion: hilo_esperar
+ * Descripcion: Espera a que un hilo termine y libera sus recursos
+ * Parametros: hilo
+ * Retorno: void
+ */
+void hilo_esperar(Hilo hilo) {
+#ifdef _WIN32
+	WaitForSingleObject(hilo, INFINITE);
+	CloseHandle(hilo);
+#else
+	pthread_join(hilo, NULL);
+#endif
+}
+
+/*
+ * Funcion: hilos_disponibles
+ * Descripcion: Cantidad de procesadores logicos del equipo
+ * Parametros: Ninguno
+ * Retorno: Procesadores (al menos 1)
+ */
+int hilos_disponibles(void) {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int cantidad = (int)info.dwNumberOfProcessors;
+#else
+	int cantidad = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return cantidad > 0 ? cantidad : 1;
+}
+
+/*
+ * Funcion: ceder_procesador
+ * Descripcion: Cede el procesador mientras se espera a otro hilo
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void ceder_procesador(void) {
+#ifdef _WIN32
+	Sleep(0);
+#else
+	sched_yield();
+#endif
+}
+
+// ===================================================================
+// FUNCIONES DE CERROJOS
+// ===================================================================
+
+/*
+ * Funcion: cerrojo_iniciar
+ * Descripcion: Prepara un cerrojo antes de su primer uso
+ */
+void cerrojo_iniciar(Cerrojo* cerrojo) {
+#ifdef _WIN32
+	InitializeCriticalSection(cerrojo);
+#else
+	pthread_mutex_init(cerrojo, NULL);
+#endif
+}
+
+/*
+ * Funcion: cerrojo_tomar
+ * Descripcion: Espera hasta obtener el cerrojo
+ */
+void cerrojo_tomar(Cerrojo* cerrojo) {
+#ifdef _WIN32
+	EnterCriticalSection(cerrojo);
+#else
+	pthread_mutex_lock(cerrojo);
+#endif
+}
+
+/*
+ * Funcion: cerrojo_soltar
+ * Descripcion: Libera el cerrojo obtenido con cerrojo_tomar
+ */
+void cerrojo_soltar(Cerrojo* cerrojo) {
+#ifdef _WIN32
+	LeaveCriticalSection(cerrojo);
+#else
+	pthread_mutex_unlock(cerrojo);
+#endif
+}
+
+/*
+ * Funcion: cerrojo_destruir
+ * Descripcion: Libera los recursos del cerrojo
+ */
+void cerrojo_destruir(Cerrojo* cerrojo) {
+#ifdef _WIN32
+	DeleteCriticalSection(cerrojo);
+#else
+	pthread_mutex_destroy(cerrojo);
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * hilos.h - Libreria minima de hilos y cerrojos
+ *
+ * Descripcion: Este archivo contiene los tipos y prototipos para crear
+ *              hilos, protegerlos con cerrojos y ceder el procesador, con
+ *              la misma interfaz en Windows (API Win32) y en sistemas con
+ *              pthreads.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef HILOS_H
+#define HILOS_H
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// ===================================================================
+// TIPOS DE HILOS
+// ===================================================================
+
+#ifdef _WIN32
+typedef HANDLE Hilo;
+typedef CRITICAL_SECTION Cerrojo;
+#else
+typedef pthread_t Hilo;
+typedef pthread_mutex_t Cerrojo;
+#endif
+
+// Funcion que ejecuta un hilo
+typedef void (*FuncionHilo)(void* argumento);
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de hilos
+int hilo_crear(Hilo* hilo, FuncionHilo funcion, void* argumento);
+void hilo_esperar(Hilo hilo);
+int hilos_disponibles(void);
+void ceder_procesador(void);
+
+// Funciones de cerrojos
+void cerrojo_iniciar(Cerrojo* cerrojo);
+void cerrojo_tomar(Cerrojo* cerrojo);
+void cerrojo_soltar(Cerrojo* cerrojo);
+void cerrojo_destruir(Cerrojo* cerrojo);
+
+#endif // HILOS_H
@@ -0,0 +1,530 @@
+/*
+ * historico.c - Implementacion del historico comprimido
+ *
+ * Descripcion: Este archivo implementa el archivado y la consulta de
+ *              anos fiscales cerrados, incluyendo:
+ *              - Traslado de los registros de un ano a los archivos historico/<tabla>_AAAA.hlz
+ *              - Compresion por bloques independientes (compresion_lz.c)
+ *              - Consultas de auditoria que saltan bloques por placa/fecha
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "historico.h"
+#include "compresion_lz.h"
+#include "repositorio.h"
+#include "vehiculos.h"   // Para limpiar_pantalla y convertir_a_mayusculas
+#include <time.h>
+#include <direct.h>      // Para _mkdir en Windows
+#include <sys/stat.h>    // Para verificar si existe la carpeta
+#include <unistd.h>      // Para ftruncate
+
+#define MAX_LINEA_HISTORICO 500
+
+/*
+ * Estructura: RegistroHistorico
+ * Descripcion: Linea a archivar junto con su clave de ordenamiento
+ */
+typedef struct {
+	char placa[10];
+	uint32_t fecha;
+	char* linea;                 // Linea completa terminada en '\n'
+	size_t longitud;
+} RegistroHistorico;
+
+// ===================================================================
+// FUNCIONES AUXILIARES
+// ===================================================================
+
+/*
+ * Funcion: suma_fnv1a_historico
+ * Descripcion: Hash FNV-1a de 32 bits para verificar bloques
+ * Parametros: datos, longitud
+ * Retorno: Valor del hash
+ */
+static uint32_t suma_fnv1a_historico(const unsigned char* datos, size_t longitud) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < longitud; i++) {
+		hash ^= datos[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Funcion: fecha_a_entero
+ * Descripcion: Convierte una fecha DD/MM/AAAA (con o sin hora) a AAAAMMDD
+ * Parametros: fecha - Texto de la fecha
+ * Retorno: Fecha como entero, 0 si el formato no es valido
+ */
+uint32_t fecha_a_entero(const char* fecha) {
+	int dia, mes, ano;
+	if (sscanf(fecha, "%d/%d/%d", &dia, &mes, &ano) != 3) return 0;
+	return (uint32_t)(ano * 10000 + mes * 100 + dia);
+}
+
+/*
+ * Funcion: historico_ruta
+ * Descripcion: Arma la ruta del archivo historico de una tabla y ano
+ * Parametros: ruta (buffer de al menos 64 bytes), tabla, ano
+ * Retorno: void
+ */
+void historico_ruta(char* ruta, int tabla, int ano) {
+	sprintf(ruta, "%s/%s_%04d.hlz", CARPETA_HISTORICO,
+			tabla == TABLA_HISTORICO_PAGOS ? "pagos" : "comprobantes", ano);
+}
+
+/*
+ * Funcion: extraer_placa_fecha
+ * Descripcion: Obtiene placa y fecha de una linea segun su tabla
+ *              pagos:        numero|placa|fecha_pago|...
+ *              comprobantes: placa|numero|propietario|tipo|subtipo|fecha_emision|...
+ * Parametros: linea, tabla, placa (buffer de 10), fecha
+ * Retorno: 1 si la linea es valida, 0 si no
+ */
+static int extraer_placa_fecha(const char* linea, int tabla, char* placa, uint32_t* fecha) {
+	int campo_placa = (tabla == TABLA_HISTORICO_PAGOS) ? 1 : 0;
+	int campo_fecha = (tabla == TABLA_HISTORICO_PAGOS) ? 2 : 5;
+	const char* p = linea;
+
+	placa[0] = '\0';
+	*fecha = 0;
+	for (int campo = 0; *p && campo <= campo_fecha; campo++) {
+		const char* fin = strchr(p, '|');
+		if (fin == NULL) fin = p + strlen(p);
+		if (campo == campo_placa) {
+			size_t n = (size_t)(fin - p);
+			if (n > 9) n = 9;
+			memcpy(placa, p, n);
+			placa[n] = '\0';
+		}
+		if (campo == campo_fecha) *fecha = fecha_a_entero(p);
+		if (*fin == '\0') break;
+		p = fin + 1;
+	}
+	return placa[0] != '\0' && *fecha != 0;
+}
+
+/*
+ * Funcion: comparar_registros_historico
+ * Descripcion: Orden por placa y luego por fecha (para qsort)
+ */
+static int comparar_registros_historico(const void* a, const void* b) {
+	const RegistroHistorico* ra = a;
+	const RegistroHistorico* rb = b;
+	int c = strcmp(ra->placa, rb->placa);
+	if (c != 0) return c;
+	return (ra->fecha > rb->fecha) - (ra->fecha < rb->fecha);
+}
+
+/*
+ * Funcion: escribir_bloque
+ * Descripcion: Comprime los registros [inicio, fin) y agrega el bloque
+ * Parametros: archivo, registros, inicio, fin
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int escribir_bloque(FILE* archivo, const RegistroHistorico* registros, int inicio, int fin) {
+	static unsigned char original[LZ_MAX_BLOQUE];
+	static unsigned char comprimido[LZ_LIMITE_COMPRIMIDO(LZ_MAX_BLOQUE)];
+	CabeceraBloqueHistorico cabecera;
+	size_t usado = 0;
+
+	memset(&cabecera, 0, sizeof(cabecera));
+	cabecera.fecha_min = 0xFFFFFFFFu;
+	strcpy(cabecera.placa_min, registros[inicio].placa);
+	strcpy(cabecera.placa_max, registros[fin - 1].placa);   // Registros ordenados por placa
+
+	for (int i = inicio; i < fin; i++) {
+		memcpy(original + usado, registros[i].linea, registros[i].longitud);
+		usado += registros[i].longitud;
+		if (registros[i].fecha < cabecera.fecha_min) cabecera.fecha_min = registros[i].fecha;
+		if (registros[i].fecha > cabecera.fecha_max) cabecera.fecha_max = registros[i].fecha;
+	}
+
+	size_t longitud = lz_comprimir(original, usado, comprimido, sizeof(comprimido));
+	if (longitud == 0) return 0;
+
+	cabecera.longitud_original = (uint32_t)usado;
+	cabecera.longitud_comprimida = (uint32_t)longitud;
+	cabecera.registros = (uint32_t)(fin - inicio);
+	cabecera.suma_verificacion = suma_fnv1a_historico(original, usado);
+
+	return fwrite(&cabecera, sizeof(cabecera), 1, archivo) == 1 &&
+		fwrite(comprimido, 1, longitud, archivo) == longitud;
+}
+
+// ===================================================================
+// FUNCIONES DE ARCHIVADO
+// ===================================================================
+
+/*
+ * Funcion: historico_archivar_archivo
+ * Descripcion: Mueve las lineas de un ano fiscal desde un archivo activo
+ *              al historico comprimido. Primero se escribe el historico
+ *              y solo despues se reescribe el archivo activo, para no
+ *              perder registros si algo falla a mitad del proceso. Si
+ *              falla cualquier paso el archivo activo queda intacto y el
+ *              historico se recorta a su tamano inicial, asi un nuevo
+ *              intento no archiva dos veces los mismos registros
+ * Parametros:
+ *   - origen: Archivo activo (pagos o comprobantes)
+ *   - tabla: TABLA_HISTORICO_PAGOS o TABLA_HISTORICO_COMPROBANTES
+ *   - ano: Ano fiscal a archivar
+ * Retorno: Cantidad de registros archivados, -1 si hubo error
+ */
+int historico_archivar_archivo(const char* origen, int tabla, int ano) {
+	FILE* archivo = fopen(origen, "r");
+	if (!archivo) return 0;
+
+	char ruta_temporal[120];
+	sprintf(ruta_temporal, "%s.tmp", origen);
+	FILE* temporal = fopen(ruta_temporal, "w");
+	if (!temporal) {
+		fclose(archivo);
+		return -1;
+	}
+
+	RegistroHistorico* registros = NULL;
+	int cantidad = 0, capacidad = 0;
+	int error = 0;
+	char linea[MAX_LINEA_HISTORICO];
+
+	// Separar las lineas del ano archivado de las que siguen activas
+	while (!error && fgets(linea, sizeof(linea), archivo)) {
+		RegistroHistorico registro;
+		if (!extraer_placa_fecha(linea, tabla, registro.placa, &registro.fecha) ||
+			(int)(registro.fecha / 10000) != ano) {
+			if (fputs(linea, temporal) == EOF) error = 1;
+			continue;
+		}
+
+		if (cantidad == capacidad) {
+			int nueva_capacidad = capacidad ? capacidad * 2 : 256;
+			RegistroHistorico* nuevos = realloc(registros, (size_t)nueva_capacidad * sizeof(RegistroHistorico));
+			if (!nuevos) {
+				error = 1;
+				break;
+			}
+			registros = nuevos;
+			capacidad = nueva_capacidad;
+		}
+		registro.longitud = strlen(linea);
+		registro.linea = malloc(registro.longitud + 1);
+		if (!registro.linea) {
+			error = 1;
+			break;
+		}
+		memcpy(registro.linea, linea, registro.longitud + 1);
+		registros[cantidad++] = registro;
+	}
+	if (ferror(archivo)) error = 1;
+	fclose(archivo);
+	if (fclose(temporal) == EOF) error = 1;
+
+	// Sin todas las lineas en memoria no se archiva nada
+	int resultado = error ? -1 : cantidad;
+	if (resultado > 0) {
+		qsort(registros, (size_t)cantidad, sizeof(RegistroHistorico), comparar_registros_historico);
+
+		struct stat st = {0};
+		if (stat(CARPETA_HISTORICO, &st) == -1) {
+			_mkdir(CARPETA_HISTORICO);
+		}
+
+		char ruta[64];
+		historico_ruta(ruta, tabla, ano);
+		int existe = (stat(ruta, &st) == 0);
+		FILE* destino = fopen(ruta, "ab");
+		if (!destino) {
+			resultado = -1;
+		} else {
+			long tamano_inicial = existe ? (long)st.st_size : 0;
+			if (!existe) {
+				uint32_t tabla_u = (uint32_t)tabla;
+				fwrite(MAGIA_HISTORICO, 1, 4, destino);
+				fwrite(&tabla_u, sizeof(tabla_u), 1, destino);
+			}
+
+			// Agrupar registros en bloques de hasta LZ_MAX_BLOQUE bytes
+			int inicio = 0;
+			size_t usado = 0;
+			for (int i = 0; i < cantidad && resultado >= 0; i++) {
+				if (usado + registros[i].longitud > LZ_MAX_BLOQUE) {
+					if (!escribir_bloque(destino, registros, inicio, i)) resultado = -1;
+					inicio = i;
+					usado = 0;
+				}
+				usado += registros[i].longitud;
+			}
+			if (resultado >= 0 && !escribir_bloque(destino, registros, inicio, cantidad)) resultado = -1;
+			if (fflush(destino) == EOF) resultado = -1;
+
+			// Quitar los bloques escritos a medias
+			if (resultado < 0) ftruncate(fileno(destino), tamano_inicial);
+			if (fclose(destino) == EOF) resultado = -1;
+			if (resultado < 0 && !existe) remove(ruta);
+		}
+	}
+
+	// Reemplazar el archivo activo solo si el historico quedo completo
+	if (resultado > 0) {
+		remove(origen);
+		rename(ruta_temporal, origen);
+	} else {
+		remove(ruta_temporal);
+	}
+
+	for (int i = 0; i < cantidad; i++) free(registros[i].linea);
+	free(registros);
+	return resultado;
+}
+
+/*
+ * Funcion: historico_archivar_tabla
+ * Descripcion: Archiva las particiones mensuales de un ano (y las lineas
+ *              de ese ano que queden en el archivo anterior a las
+ *              particiones). Las particiones archivadas se eliminan
+ * Parametros: tabla, ano
+ * Retorno: Registros archivados, -1 si hubo error
+ */
+static int historico_archivar_tabla(int tabla, int ano) {
+	int periodos[MAX_PARTICIONES];
+	int cantidad = particion_listar(tabla, ano * 100 + 1, ano * 100 + 12, periodos, MAX_PARTICIONES);
+	int total = 0;
+
+	for (int i = 0; i < cantidad; i++) {
+		char ruta[MAX_RUTA_PARTICION];
+		particion_ruta(ruta, tabla, periodos[i]);
+
+		int archivados = historico_archivar_archivo(ruta, tabla, ano);
+		if (archivados < 0) return -1;
+		total += archivados;
+
+		// Una particion del ano queda vacia despues de archivarla
+		struct stat st;
+		if (periodos[i] != PERIODO_LEGADO && stat(ruta, &st) == 0 && st.st_size == 0) {
+			particion_eliminar(tabla, periodos[i]);
+		}
+	}
+	return total;
+}
+
+/*
+ * Funcion: historico_archivar_ano
+ * Descripcion: Archiva pagos y comprobantes de un ano fiscal cerrado
+ * Parametros: ano - Ano a archivar (debe ser anterior al ano actual)
+ * Retorno: Total de registros archivados, -1 si hubo error
+ */
+int historico_archivar_ano(int ano) {
+	time_t t = time(NULL);
+	struct tm* fecha = localtime(&t);
+	if (ano >= fecha->tm_year + 1900) return -1;   // Solo anos cerrados
+
+	int pagos = historico_archivar_tabla(TABLA_HISTORICO_PAGOS, ano);
+	int comprobantes = historico_archivar_tabla(TABLA_HISTORICO_COMPROBANTES, ano);
+	if (pagos < 0 || comprobantes < 0) return -1;
+
+	// Lo archivado ya no esta en las particiones: el motor se vuelve a copiar
+	if (pagos + comprobantes > 0) repositorio_recargar();
+	return pagos + comprobantes;
+}
+
+// ===================================================================
+// FUNCIONES DE CONSULTA
+// ===================================================================
+
+/*
+ * Funcion: historico_consultar
+ * Descripcion: Recorre las cabeceras de los bloques de un ano y solo
+ *              descomprime los bloques cuyo rango de placa y fecha puede
+ *              contener registros de la consulta
+ * Parametros:
+ *   - tabla, ano: Archivo historico a consultar
+ *   - placa: Placa a buscar o NULL/"" para todas
+ *   - fecha_desde, fecha_hasta: Rango AAAAMMDD (0 = sin limite)
+ *   - visitante, contexto: Funcion que recibe cada registro encontrado
+ *   - estadisticas: Resumen de la consulta (puede ser NULL)
+ * Retorno: Registros encontrados, -1 si el archivo no existe o esta danado
+ */
+int historico_consultar(int tabla, int ano, const char* placa, uint32_t fecha_desde, uint32_t fecha_hasta,
+						VisitanteHistorico visitante, void* contexto, EstadisticasHistorico* estadisticas) {
+	static unsigned char comprimido[LZ_LIMITE_COMPRIMIDO(LZ_MAX_BLOQUE)];
+	static char original[LZ_MAX_BLOQUE + 1];
+	EstadisticasHistorico est = {0, 0, 0};
+	char ruta[64];
+
+	if (fecha_hasta == 0) fecha_hasta = 0xFFFFFFFFu;
+	int filtrar_placa = (placa != NULL && placa[0] != '\0');
+
+	historico_ruta(ruta, tabla, ano);
+	FILE* archivo = fopen(ruta, "rb");
+	if (!archivo) return -1;
+
+	char magia[4];
+	uint32_t tabla_archivo;
+	if (fread(magia, 1, 4, archivo) != 4 || memcmp(magia, MAGIA_HISTORICO, 4) != 0 ||
+		fread(&tabla_archivo, sizeof(tabla_archivo), 1, archivo) != 1) {
+		fclose(archivo);
+		return -1;
+	}
+
+	CabeceraBloqueHistorico cabecera;
+	int error = 0;
+	while (fread(&cabecera, sizeof(cabecera), 1, archivo) == 1) {
+		est.bloques_totales++;
+		if (cabecera.longitud_comprimida > sizeof(comprimido) || cabecera.longitud_original > LZ_MAX_BLOQUE) {
+			error = 1;
+			break;
+		}
+
+		// Descartar el bloque solo con la cabecera
+		int descartar = cabecera.fecha_max < fecha_desde || cabecera.fecha_min > fecha_hasta;
+		if (filtrar_placa && (strcmp(placa, cabecera.placa_min) < 0 || strcmp(placa, cabecera.placa_max) > 0)) {
+			descartar = 1;
+		}
+		if (descartar) {
+			if (fseek(archivo, (long)cabecera.longitud_comprimida, SEEK_CUR) != 0) break;
+			continue;
+		}
+
+		est.bloques_leidos++;
+		if (fread(comprimido, 1, cabecera.longitud_comprimida, archivo) != cabecera.longitud_comprimida ||
+			lz_descomprimir(comprimido, cabecera.longitud_comprimida, (unsigned char*)original,
+							LZ_MAX_BLOQUE) != cabecera.longitud_original ||
+			suma_fnv1a_historico((unsigned char*)original, cabecera.longitud_original) != cabecera.suma_verificacion) {
+			error = 1;
+			break;
+		}
+		original[cabecera.longitud_original] = '\0';
+
+		// Filtrar linea por linea dentro del bloque
+		char* linea = original;
+		while (*linea) {
+			char* fin = strchr(linea, '\n');
+			if (fin) *fin = '\0';
+
+			char placa_linea[10];
+			uint32_t fecha_linea;
+			if (extraer_placa_fecha(linea, (int)tabla_archivo, placa_linea, &fecha_linea) &&
+				fecha_linea >= fecha_desde && fecha_linea <= fecha_hasta &&
+				(!filtrar_placa || strcmp(placa_linea, placa) == 0)) {
+				est.registros_encontrados++;
+				if (visitante) visitante(linea, contexto);
+			}
+
+			if (!fin) break;
+			linea = fin + 1;
+		}
+	}
+	fclose(archivo);
+
+	if (estadisticas) *estadisticas = est;
+	return error ? -1 : est.registros_encontrados;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+/*
+ * Funcion: imprimir_registro_historico
+ * Descripcion: Visitante que imprime cada registro encontrado
+ */
+static void imprimir_registro_historico(const char* linea, void* contexto) {
+	(void)contexto;
+	printf("  %s\n", linea);
+}
+
+/*
+ * Funcion: menu_archivar_historico
+ * Descripcion: Solicita un ano fiscal cerrado y lo archiva comprimido
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_archivar_historico(void) {
+	char buffer[100];
+	int ano = 0;
+
+	limpiar_pantalla();
+	printf("=== ARCHIVAR ANO FISCAL CERRADO ===\n");
+	printf("Los pagos y comprobantes del ano se moveran a '%s/' comprimidos.\n\n", CARPETA_HISTORICO);
+	printf("Ingrese el ano a archivar: ");
+	if (!fgets(buffer, sizeof(buffer), stdin) || sscanf(buffer, "%d", &ano) != 1 || ano < 1990) {
+		printf("\nERROR: Ano invalido.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+
+	int archivados = historico_archivar_ano(ano);
+	if (archivados < 0) {
+		printf("\nERROR: No se pudo archivar el ano %d (solo se archivan anos cerrados).\n", ano);
+	} else {
+		printf("\nRegistros archivados del ano %d: %d\n", ano, archivados);
+	}
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
+
+/*
+ * Funcion: menu_auditoria_historico
+ * Descripcion: Consulta de auditoria sobre el historico comprimido
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_auditoria_historico(void) {
+	char buffer[100];
+	char placa[10] = "";
+	char fecha_texto[20];
+	int ano = 0;
+	uint32_t desde = 0, hasta = 0;
+
+	limpiar_pantalla();
+	printf("=== CONSULTA DE AUDITORIA EN HISTORICO ===\n\n");
+
+	printf("Ano fiscal: ");
+	if (!fgets(buffer, sizeof(buffer), stdin) || sscanf(buffer, "%d", &ano) != 1) {
+		printf("\nERROR: Ano invalido.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+
+	printf("Placa (Enter para todas): ");
+	if (fgets(buffer, sizeof(buffer), stdin)) {
+		if (sscanf(buffer, "%9s", placa) != 1) placa[0] = '\0';
+		convertir_a_mayusculas(placa);
+	}
+
+	printf("Desde (DD/MM/AAAA, Enter sin limite): ");
+	if (fgets(buffer, sizeof(buffer), stdin) && sscanf(buffer, "%19s", fecha_texto) == 1) {
+		desde = fecha_a_entero(fecha_texto);
+	}
+	printf("Hasta (DD/MM/AAAA, Enter sin limite): ");
+	if (fgets(buffer, sizeof(buffer), stdin) && sscanf(buffer, "%19s", fecha_texto) == 1) {
+		hasta = fecha_a_entero(fecha_texto);
+	}
+
+	int tablas[2] = {TABLA_HISTORICO_PAGOS, TABLA_HISTORICO_COMPROBANTES};
+	const char* nombres[2] = {"PAGOS", "COMPROBANTES"};
+	for (int i = 0; i < 2; i++) {
+		EstadisticasHistorico est;
+		printf("\n%s %d:\n", nombres[i], ano);
+		printf("-------------------------------------------------------\n");
+		int encontrados = historico_consultar(tablas[i], ano, placa, desde, hasta,
+											  imprimir_registro_historico, NULL, &est);
+		if (encontrados < 0) {
+			printf("  No hay historico disponible para este ano.\n");
+		} else {
+			printf("  Registros: %d (bloques leidos %d de %d)\n",
+				   est.registros_encontrados, est.bloques_leidos, est.bloques_totales);
+		}
+	}
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
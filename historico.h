@@ -0,0 +1,90 @@
+/*
+ * historico.h - Libreria del historico comprimido (anos fiscales cerrados)
+ *
+ * Descripcion: Este archivo contiene las constantes, estructuras y
+ *              prototipos del almacenamiento frio para pagos y
+ *              comprobantes de anos fiscales cerrados. Los registros se
+ *              ordenan por placa y fecha y se guardan en bloques
+ *              comprimidos de forma independiente; cada bloque lleva la
+ *              placa y fecha minima/maxima para que una auditoria solo
+ *              descomprima los bloques que necesita.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "particiones.h"
+
+// ===================================================================
+// CONSTANTES DEL HISTORICO
+// ===================================================================
+
+#define CARPETA_HISTORICO "historico"
+#define MAGIA_HISTORICO "HLZ1"
+
+// Tablas que se pueden archivar (las mismas que se particionan por mes)
+#define TABLA_HISTORICO_PAGOS PARTICION_PAGOS
+#define TABLA_HISTORICO_COMPROBANTES PARTICION_COMPROBANTES
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: CabeceraBloqueHistorico
+ * Descripcion: Cabecera de cada bloque comprimido. Permite decidir si el
+ *              bloque puede contener registros de una consulta sin
+ *              descomprimirlo
+ */
+typedef struct {
+	uint32_t longitud_original;      // Bytes del texto original
+	uint32_t longitud_comprimida;    // Bytes comprimidos que siguen a la cabecera
+	uint32_t registros;              // Lineas dentro del bloque
+	uint32_t fecha_min;              // Fecha minima (AAAAMMDD)
+	uint32_t fecha_max;              // Fecha maxima (AAAAMMDD)
+	char placa_min[10];              // Placa minima del bloque
+	char placa_max[10];              // Placa maxima del bloque
+	uint32_t suma_verificacion;      // FNV-1a del texto original
+} CabeceraBloqueHistorico;
+
+/*
+ * Estructura: EstadisticasHistorico
+ * Descripcion: Resumen de una consulta de auditoria
+ */
+typedef struct {
+	int bloques_totales;             // Bloques en el archivo
+	int bloques_leidos;              // Bloques descomprimidos
+	int registros_encontrados;       // Lineas que cumplen el filtro
+} EstadisticasHistorico;
+
+// Funcion que recibe cada registro encontrado en una consulta
+typedef void (*VisitanteHistorico)(const char* linea, void* contexto);
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de archivado
+int historico_archivar_archivo(const char* origen, int tabla, int ano);
+int historico_archivar_ano(int ano);
+
+// Funciones de consulta
+int historico_consultar(int tabla, int ano, const char* placa, uint32_t fecha_desde, uint32_t fecha_hasta,
+                        VisitanteHistorico visitante, void* contexto, EstadisticasHistorico* estadisticas);
+uint32_t fecha_a_entero(const char* fecha);
+void historico_ruta(char* ruta, int tabla, int ano);
+
+// Funciones de interfaz
+void menu_archivar_historico(void);
+void menu_auditoria_historico(void);
+
+#endif // HISTORICO_H
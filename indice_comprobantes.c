@@ -0,0 +1,793 @@
+/*
+ * indice_comprobantes.c - Implementacion del indice de comprobantes por numero
+ *
+ * Descripcion: Este archivo implementa el arbol B+ de comprobantes,
+ *              incluyendo:
+ *              - Paginas de 4 KiB: hojas con (numero, particion, posicion)
+ *                enlazadas en orden, y paginas internas con separadores
+ *              - Carga en bloque: todas las lineas se ordenan y las hojas
+ *                se escriben una tras otra al CARGA_INICIAL_ARBOL %, luego
+ *                cada nivel interno sobre el anterior
+ *              - Insercion con division de paginas para las lineas nuevas
+ *              - Busqueda exacta y recorrido por prefijo, comprobando que
+ *                la linea siga en su lugar
+ *              - Marca de la cabecera borrada mientras se insertan lineas:
+ *                un indice a medio actualizar se vuelve a cargar en bloque
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "indice_comprobantes.h"
+#include "particiones.h"
+#include "archivos.h"
+#include <stdint.h>
+#include <sys/stat.h>    // Para el tamano de las particiones
+
+// Posicionamiento de 64 bits para archivos mayores a 2 GB
+#ifdef _WIN32
+#define BUSCAR_64(archivo, pos) _fseeki64((archivo), (pos), SEEK_SET)
+#else
+#define BUSCAR_64(archivo, pos) fseeko((archivo), (off_t)(pos), SEEK_SET)
+#endif
+
+#define PAGINA_HOJA 1
+#define PAGINA_INTERNA 2
+
+/*
+ * Estructura: EntradaHoja
+ * Descripcion: Numero de comprobante y ubicacion de su linea
+ */
+typedef struct {
+	char clave[LARGO_CLAVE_ARBOL];
+	int32_t periodo;
+	int32_t reservado;
+	int64_t posicion;
+} EntradaHoja;
+
+/*
+ * Estructura: EntradaInterna
+ * Descripcion: Separador de una pagina interna: las claves mayores o
+ *              iguales a 'clave' (y menores que el separador siguiente)
+ *              estan bajo 'hijo'
+ */
+typedef struct {
+	char clave[LARGO_CLAVE_ARBOL];
+	uint32_t hijo;
+} EntradaInterna;
+
+/*
+ * Estructura: CabeceraPagina
+ * Descripcion: Primeros 16 bytes de cada pagina del arbol
+ */
+typedef struct {
+	uint16_t tipo;               // PAGINA_HOJA o PAGINA_INTERNA
+	uint16_t cantidad;           // Entradas usadas
+	uint32_t siguiente;          // Hoja siguiente en orden (0 = ultima)
+	uint32_t primer_hijo;        // Pagina de las claves menores al primer separador
+	uint32_t reservado;
+} CabeceraPagina;
+
+#define ENTRADAS_HOJA ((TAMANO_PAGINA_ARBOL - (int)sizeof(CabeceraPagina)) / (int)sizeof(EntradaHoja))
+#define ENTRADAS_INTERNAS ((TAMANO_PAGINA_ARBOL - (int)sizeof(CabeceraPagina)) / (int)sizeof(EntradaInterna))
+
+/*
+ * Estructura: PaginaArbol
+ * Descripcion: Pagina de 4 KiB tal como esta en el archivo
+ */
+typedef struct {
+	CabeceraPagina cabecera;
+	union {
+		EntradaHoja hojas[ENTRADAS_HOJA];
+		EntradaInterna internas[ENTRADAS_INTERNAS];
+		uint8_t bytes[TAMANO_PAGINA_ARBOL - sizeof(CabeceraPagina)];
+	};
+} PaginaArbol;
+
+/*
+ * Estructura: ParticionIndexada
+ * Descripcion: Bytes de una particion que ya estan en el indice
+ */
+typedef struct {
+	int32_t periodo;
+	int32_t reservado;
+	int64_t tamano;
+} ParticionIndexada;
+
+/*
+ * Estructura: CabeceraArbol
+ * Descripcion: Inicio del archivo (ocupa PAGINAS_CABECERA_ARBOL paginas)
+ */
+typedef struct {
+	char magia[4];               // "BPT1"
+	uint32_t raiz;
+	uint32_t paginas;            // Paginas del archivo, incluida la cabecera
+	uint32_t altura;             // 1 = la raiz es una hoja
+	uint32_t registros;
+	uint32_t particiones;
+	uint32_t reservado[2];
+	ParticionIndexada indexadas[MAX_PARTICIONES];
+} CabeceraArbol;
+
+/*
+ * Estructura: CargaArbol
+ * Descripcion: Entradas leidas de las particiones para la carga en bloque
+ */
+typedef struct {
+	EntradaHoja* entradas;
+	long cantidad;
+	long capacidad;
+} CargaArbol;
+
+/*
+ * Estructura: NodoCarga
+ * Descripcion: Primera clave y pagina de cada nodo de un nivel al cargar
+ */
+typedef struct {
+	char clave[LARGO_CLAVE_ARBOL];
+	uint32_t pagina;
+} NodoCarga;
+
+// Funcion llamada por cada linea completa de una particion
+typedef int (*FuncionLinea)(const char* numero, int periodo, long long posicion, void* contexto);
+
+static FILE* archivo_indice = NULL;
+static CabeceraArbol cabecera;
+static int reconstruir_pendiente = 0;   // 1 si una linea no estaba donde decia el indice o no se pudo leer
+
+// ===================================================================
+// PAGINAS
+// ===================================================================
+
+static int leer_pagina(uint32_t numero, PaginaArbol* pagina) {
+	if (numero < PAGINAS_CABECERA_ARBOL || numero >= cabecera.paginas) return 0;
+	return BUSCAR_64(archivo_indice, (long long)numero * TAMANO_PAGINA_ARBOL) == 0 &&
+		   fread(pagina, TAMANO_PAGINA_ARBOL, 1, archivo_indice) == 1;
+}
+
+static int escribir_pagina(uint32_t numero, const PaginaArbol* pagina) {
+	return BUSCAR_64(archivo_indice, (long long)numero * TAMANO_PAGINA_ARBOL) == 0 &&
+		   fwrite(pagina, TAMANO_PAGINA_ARBOL, 1, archivo_indice) == 1;
+}
+
+/*
+ * Funcion: escribir_cabecera
+ * Descripcion: Guarda la cabecera (con su marca) despues de que las
+ *              paginas ya estan en el disco, asi la marca nunca queda
+ *              sobre paginas a medio escribir
+ */
+static int escribir_cabecera(void) {
+	return sincronizar_archivo(archivo_indice) &&
+		   BUSCAR_64(archivo_indice, 0) == 0 &&
+		   fwrite(&cabecera, sizeof(cabecera), 1, archivo_indice) == 1 &&
+		   fflush(archivo_indice) == 0;
+}
+
+/*
+ * Funcion: marcar_en_cambio
+ * Descripcion: Borra la marca de la cabecera en el disco antes de tocar
+ *              cualquier pagina. Si el programa se corta a medio insertar,
+ *              abrir_indice no reconoce el archivo y se carga en bloque;
+ *              escribir_cabecera vuelve a poner la marca al terminar
+ */
+static int marcar_en_cambio(void) {
+	static const char sin_marca[4] = {0, 0, 0, 0};
+	return BUSCAR_64(archivo_indice, 0) == 0 &&
+		   fwrite(sin_marca, sizeof(sin_marca), 1, archivo_indice) == 1 &&
+		   sincronizar_archivo(archivo_indice);
+}
+
+/*
+ * Funcion: nueva_pagina
+ * Descripcion: Pagina vacia de un tipo, sin numero aun
+ */
+static void nueva_pagina(PaginaArbol* pagina, int tipo) {
+	memset(pagina, 0, sizeof(*pagina));
+	pagina->cabecera.tipo = (uint16_t)tipo;
+}
+
+/*
+ * Funcion: cota_hoja
+ * Descripcion: Primera entrada de una hoja con clave mayor o igual
+ */
+static int cota_hoja(const PaginaArbol* pagina, const char* clave) {
+	int bajo = 0, alto = pagina->cabecera.cantidad;
+	while (bajo < alto) {
+		int medio = (bajo + alto) / 2;
+		if (strcmp(pagina->hojas[medio].clave, clave) < 0) {
+			bajo = medio + 1;
+		} else {
+			alto = medio;
+		}
+	}
+	return bajo;
+}
+
+/*
+ * Funcion: separadores_menores
+ * Descripcion: Cantidad de separadores de una pagina interna menores o
+ *              iguales a la clave (el hijo a seguir)
+ */
+static int separadores_menores(const PaginaArbol* pagina, const char* clave) {
+	int bajo = 0, alto = pagina->cabecera.cantidad;
+	while (bajo < alto) {
+		int medio = (bajo + alto) / 2;
+		if (strcmp(pagina->internas[medio].clave, clave) <= 0) {
+			bajo = medio + 1;
+		} else {
+			alto = medio;
+		}
+	}
+	return bajo;
+}
+
+/*
+ * Funcion: descender
+ * Descripcion: Baja desde la raiz hasta la hoja donde va una clave
+ * Parametros: clave, camino (salida, puede ser NULL) - pagina de cada nivel
+ *             interno (camino[1] es el padre de la hoja)
+ * Retorno: Numero de la hoja, 0 si hubo error
+ */
+static uint32_t descender(const char* clave, uint32_t* camino) {
+	uint32_t numero = cabecera.raiz;
+	PaginaArbol pagina;
+	for (uint32_t nivel = cabecera.altura - 1; nivel > 0; nivel--) {
+		if (camino) camino[nivel] = numero;
+		if (!leer_pagina(numero, &pagina) || pagina.cabecera.tipo != PAGINA_INTERNA) return 0;
+		int i = separadores_menores(&pagina, clave);
+		numero = (i == 0) ? pagina.cabecera.primer_hijo : pagina.internas[i - 1].hijo;
+	}
+	return numero;
+}
+
+// ===================================================================
+// INSERCION
+// ===================================================================
+
+/*
+ * Funcion: insertar_en_padre
+ * Descripcion: Agrega el separador de una pagina recien dividida a su
+ *              padre. Si el padre esta lleno tambien se divide; si se
+ *              dividio la raiz, se crea una raiz nueva
+ * Parametros: camino, nivel - Nivel del padre, izquierda, clave, derecha
+ */
+static int insertar_en_padre(const uint32_t* camino, uint32_t nivel, uint32_t izquierda,
+							 const char* clave, uint32_t derecha) {
+	PaginaArbol pagina;
+	if (nivel == cabecera.altura) {
+		if (cabecera.altura >= MAX_ALTURA_ARBOL) return 0;
+		nueva_pagina(&pagina, PAGINA_INTERNA);
+		pagina.cabecera.primer_hijo = izquierda;
+		pagina.cabecera.cantidad = 1;
+		strcpy(pagina.internas[0].clave, clave);
+		pagina.internas[0].hijo = derecha;
+		cabecera.raiz = cabecera.paginas++;
+		cabecera.altura++;
+		return escribir_pagina(cabecera.raiz, &pagina);
+	}
+
+	uint32_t numero = camino[nivel];
+	if (!leer_pagina(numero, &pagina)) return 0;
+	int i = separadores_menores(&pagina, clave);
+	int cantidad = pagina.cabecera.cantidad;
+
+	EntradaInterna nueva_entrada;
+	memset(&nueva_entrada, 0, sizeof(nueva_entrada));
+	strcpy(nueva_entrada.clave, clave);
+	nueva_entrada.hijo = derecha;
+
+	if (cantidad < ENTRADAS_INTERNAS) {
+		memmove(&pagina.internas[i + 1], &pagina.internas[i], (size_t)(cantidad - i) * sizeof(EntradaInterna));
+		pagina.internas[i] = nueva_entrada;
+		pagina.cabecera.cantidad++;
+		return escribir_pagina(numero, &pagina);
+	}
+
+	// Pagina llena: la mitad derecha pasa a una pagina nueva y el separador
+	// del medio sube al padre
+	EntradaInterna todas[ENTRADAS_INTERNAS + 1];
+	memcpy(todas, pagina.internas, (size_t)i * sizeof(EntradaInterna));
+	todas[i] = nueva_entrada;
+	memcpy(&todas[i + 1], &pagina.internas[i], (size_t)(cantidad - i) * sizeof(EntradaInterna));
+	int total = cantidad + 1, mitad = total / 2;
+
+	PaginaArbol nueva;
+	nueva_pagina(&nueva, PAGINA_INTERNA);
+	nueva.cabecera.primer_hijo = todas[mitad].hijo;
+	nueva.cabecera.cantidad = (uint16_t)(total - mitad - 1);
+	memcpy(nueva.internas, &todas[mitad + 1], (size_t)(total - mitad - 1) * sizeof(EntradaInterna));
+
+	memset(pagina.internas, 0, sizeof(pagina.internas));
+	memcpy(pagina.internas, todas, (size_t)mitad * sizeof(EntradaInterna));
+	pagina.cabecera.cantidad = (uint16_t)mitad;
+
+	uint32_t numero_nueva = cabecera.paginas++;
+	char separador[LARGO_CLAVE_ARBOL];
+	strcpy(separador, todas[mitad].clave);
+	return escribir_pagina(numero, &pagina) && escribir_pagina(numero_nueva, &nueva) &&
+		   insertar_en_padre(camino, nivel + 1, numero, separador, numero_nueva);
+}
+
+/*
+ * Funcion: insertar_entrada
+ * Descripcion: Agrega un numero al arbol. Si ya estaba se reemplaza su
+ *              ubicacion: gana la linea mas reciente, como al leer las
+ *              particiones
+ */
+static int insertar_entrada(const char* clave, int periodo, long long posicion) {
+	uint32_t camino[MAX_ALTURA_ARBOL];
+	PaginaArbol hoja;
+	uint32_t numero = descender(clave, camino);
+	if (!numero || !leer_pagina(numero, &hoja) || hoja.cabecera.tipo != PAGINA_HOJA) return 0;
+
+	EntradaHoja entrada;
+	memset(&entrada, 0, sizeof(entrada));
+	strcpy(entrada.clave, clave);
+	entrada.periodo = periodo;
+	entrada.posicion = posicion;
+
+	int i = cota_hoja(&hoja, clave);
+	int cantidad = hoja.cabecera.cantidad;
+	if (i < cantidad && strcmp(hoja.hojas[i].clave, clave) == 0) {
+		hoja.hojas[i] = entrada;
+		return escribir_pagina(numero, &hoja);
+	}
+
+	cabecera.registros++;
+	if (cantidad < ENTRADAS_HOJA) {
+		memmove(&hoja.hojas[i + 1], &hoja.hojas[i], (size_t)(cantidad - i) * sizeof(EntradaHoja));
+		hoja.hojas[i] = entrada;
+		hoja.cabecera.cantidad++;
+		return escribir_pagina(numero, &hoja);
+	}
+
+	// Hoja llena: se divide en dos mitades enlazadas
+	EntradaHoja todas[ENTRADAS_HOJA + 1];
+	memcpy(todas, hoja.hojas, (size_t)i * sizeof(EntradaHoja));
+	todas[i] = entrada;
+	memcpy(&todas[i + 1], &hoja.hojas[i], (size_t)(cantidad - i) * sizeof(EntradaHoja));
+	int total = cantidad + 1, mitad = total / 2;
+
+	PaginaArbol nueva;
+	nueva_pagina(&nueva, PAGINA_HOJA);
+	nueva.cabecera.cantidad = (uint16_t)(total - mitad);
+	memcpy(nueva.hojas, &todas[mitad], (size_t)(total - mitad) * sizeof(EntradaHoja));
+
+	memset(hoja.hojas, 0, sizeof(hoja.hojas));
+	memcpy(hoja.hojas, todas, (size_t)mitad * sizeof(EntradaHoja));
+	hoja.cabecera.cantidad = (uint16_t)mitad;
+
+	uint32_t numero_nueva = cabecera.paginas++;
+	nueva.cabecera.siguiente = hoja.cabecera.siguiente;
+	hoja.cabecera.siguiente = numero_nueva;
+	return escribir_pagina(numero, &hoja) && escribir_pagina(numero_nueva, &nueva) &&
+		   insertar_en_padre(camino, 1, numero, nueva.hojas[0].clave, numero_nueva);
+}
+
+// ===================================================================
+// LINEAS DE LAS PARTICIONES
+// ===================================================================
+
+/*
+ * Funcion: numero_de_linea
+ * Descripcion: Copia el numero de comprobante (segundo campo) de una linea
+ * Retorno: 1 si la linea tiene un numero que se puede indexar, 0 si no
+ */
+static int numero_de_linea(const char* linea, char* numero) {
+	const char* inicio = strchr(linea, '|');
+	if (!inicio) return 0;
+	inicio++;
+	size_t largo = strcspn(inicio, "|\r\n");
+	if (largo == 0 || largo >= LARGO_CLAVE_ARBOL || inicio[largo] != '|') return 0;
+	memcpy(numero, inicio, largo);
+	numero[largo] = '\0';
+	return 1;
+}
+
+/*
+ * Funcion: recorrer_lineas
+ * Descripcion: Entrega el numero y la posicion de cada linea completa de
+ *              una particion desde una posicion. Una linea sin salto al
+ *              final (a medio escribir) se deja para la proxima vez
+ * Retorno: Posicion despues de la ultima linea completa, -1 si hubo error
+ */
+static long long recorrer_lineas(int periodo, long long desde, FuncionLinea funcion, void* contexto) {
+	char ruta[MAX_RUTA_PARTICION], linea[500], numero[LARGO_CLAVE_ARBOL];
+	particion_ruta(ruta, PARTICION_COMPROBANTES, periodo);
+	FILE* archivo = fopen(ruta, "rb");
+	if (!archivo) return -1;
+	if (BUSCAR_64(archivo, desde) != 0) {
+		fclose(archivo);
+		return -1;
+	}
+
+	long long posicion = desde;
+	while (fgets(linea, sizeof(linea), archivo)) {
+		size_t largo = strlen(linea);
+		if (linea[largo - 1] != '\n') break;
+		if (numero_de_linea(linea, numero) && !funcion(numero, periodo, posicion, contexto)) {
+			fclose(archivo);
+			return -1;
+		}
+		posicion += (long long)largo;
+	}
+	fclose(archivo);
+	return posicion;
+}
+
+/*
+ * Funcion: leer_linea_ubicada
+ * Descripcion: Lee la linea de una ubicacion y comprueba que sea la del
+ *              numero buscado (sin el salto de linea)
+ * Retorno: 1 si la linea sigue en su lugar, 0 si no
+ */
+static int leer_linea_ubicada(const UbicacionComprobante* ubicacion, const char* numero, char* linea, size_t tamano) {
+	char ruta[MAX_RUTA_PARTICION], leida[500], numero_leido[LARGO_CLAVE_ARBOL];
+	particion_ruta(ruta, PARTICION_COMPROBANTES, ubicacion->periodo);
+	FILE* archivo = fopen(ruta, "rb");
+	if (!archivo) return 0;
+
+	int exito = BUSCAR_64(archivo, ubicacion->posicion) == 0 && fgets(leida, sizeof(leida), archivo) &&
+				numero_de_linea(leida, numero_leido) && strcmp(numero_leido, numero) == 0;
+	fclose(archivo);
+	leida[strcspn(leida, "\r\n")] = '\0';
+	if (!exito || strlen(leida) >= tamano) return 0;
+	strcpy(linea, leida);
+	return 1;
+}
+
+static int insertar_linea(const char* numero, int periodo, long long posicion, void* contexto) {
+	(void)contexto;
+	return insertar_entrada(numero, periodo, posicion);
+}
+
+// ===================================================================
+// CARGA EN BLOQUE
+// ===================================================================
+
+static int agregar_a_carga(const char* numero, int periodo, long long posicion, void* contexto) {
+	CargaArbol* carga = contexto;
+	if (carga->cantidad == carga->capacidad) {
+		long capacidad = carga->capacidad ? carga->capacidad * 2 : 4096;
+		EntradaHoja* entradas = realloc(carga->entradas, (size_t)capacidad * sizeof(EntradaHoja));
+		if (!entradas) return 0;
+		carga->entradas = entradas;
+		carga->capacidad = capacidad;
+	}
+	EntradaHoja* entrada = &carga->entradas[carga->cantidad++];
+	memset(entrada, 0, sizeof(*entrada));
+	strcpy(entrada->clave, numero);
+	entrada->periodo = periodo;
+	entrada->posicion = posicion;
+	return 1;
+}
+
+/*
+ * Funcion: comparar_entradas
+ * Descripcion: Orden por numero y, entre numeros iguales, por el orden de
+ *              las lineas (particion y posicion)
+ */
+static int comparar_entradas(const void* a, const void* b) {
+	const EntradaHoja* x = a;
+	const EntradaHoja* y = b;
+	int comparacion = strcmp(x->clave, y->clave);
+	if (comparacion != 0) return comparacion;
+	if (x->periodo != y->periodo) return x->periodo < y->periodo ? -1 : 1;
+	if (x->posicion != y->posicion) return x->posicion < y->posicion ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Funcion: escribir_niveles
+ * Descripcion: Escribe las hojas con las entradas ordenadas y, encima,
+ *              los niveles internos hasta llegar a una sola raiz
+ */
+static int escribir_niveles(const EntradaHoja* entradas, long cantidad) {
+	int por_hoja = ENTRADAS_HOJA * CARGA_INICIAL_ARBOL / 100;
+	int por_interna = ENTRADAS_INTERNAS * CARGA_INICIAL_ARBOL / 100 + 1;
+	long nodos = cantidad ? (cantidad + por_hoja - 1) / por_hoja : 1;
+	NodoCarga* nivel = malloc((size_t)nodos * sizeof(NodoCarga));
+	if (!nivel) return 0;
+
+	PaginaArbol pagina;
+	int exito = 1;
+	for (long h = 0; exito && h < nodos; h++) {
+		long desde = h * por_hoja;
+		long usadas = (cantidad - desde < por_hoja) ? cantidad - desde : por_hoja;
+		nueva_pagina(&pagina, PAGINA_HOJA);
+		pagina.cabecera.cantidad = (uint16_t)usadas;
+		memcpy(pagina.hojas, &entradas[desde], (size_t)usadas * sizeof(EntradaHoja));
+		nivel[h].pagina = cabecera.paginas++;
+		pagina.cabecera.siguiente = (h + 1 < nodos) ? nivel[h].pagina + 1 : 0;
+		strcpy(nivel[h].clave, usadas ? entradas[desde].clave : "");
+		exito = escribir_pagina(nivel[h].pagina, &pagina);
+	}
+
+	cabecera.altura = 1;
+	while (exito && nodos > 1) {
+		long padres = (nodos + por_interna - 1) / por_interna;
+		for (long p = 0; exito && p < padres; p++) {
+			long primero = p * por_interna;
+			long hijos = (nodos - primero < por_interna) ? nodos - primero : por_interna;
+			nueva_pagina(&pagina, PAGINA_INTERNA);
+			pagina.cabecera.primer_hijo = nivel[primero].pagina;
+			pagina.cabecera.cantidad = (uint16_t)(hijos - 1);
+			for (long c = 1; c < hijos; c++) {
+				strcpy(pagina.internas[c - 1].clave, nivel[primero + c].clave);
+				pagina.internas[c - 1].hijo = nivel[primero + c].pagina;
+			}
+			// El nodo p del nivel nuevo ocupa un lugar ya leido del anterior
+			nivel[p] = nivel[primero];
+			nivel[p].pagina = cabecera.paginas++;
+			exito = escribir_pagina(nivel[p].pagina, &pagina);
+		}
+		nodos = padres;
+		cabecera.altura++;
+	}
+	cabecera.raiz = nivel[0].pagina;
+	free(nivel);
+	return exito && cabecera.altura <= MAX_ALTURA_ARBOL;
+}
+
+/*
+ * Funcion: cargar_en_bloque
+ * Descripcion: Reconstruye el indice con todas las lineas de las
+ *              particiones de comprobantes
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int cargar_en_bloque(void) {
+	int periodos[MAX_PARTICIONES];
+	int cantidad = particion_listar(PARTICION_COMPROBANTES, 0, 0, periodos, MAX_PARTICIONES);
+	CargaArbol carga = {NULL, 0, 0};
+
+	memset(&cabecera, 0, sizeof(cabecera));
+	memcpy(cabecera.magia, MAGIA_INDICE_COMPROBANTES, 4);
+	cabecera.paginas = PAGINAS_CABECERA_ARBOL;
+	for (int i = 0; i < cantidad; i++) {
+		long long fin = recorrer_lineas(periodos[i], 0, agregar_a_carga, &carga);
+		if (fin < 0) {
+			free(carga.entradas);
+			return 0;
+		}
+		cabecera.indexadas[i].periodo = periodos[i];
+		cabecera.indexadas[i].tamano = fin;
+	}
+	cabecera.particiones = (uint32_t)cantidad;
+
+	// Numeros repetidos: queda la ultima linea
+	qsort(carga.entradas, (size_t)carga.cantidad, sizeof(EntradaHoja), comparar_entradas);
+	long unicas = 0;
+	for (long i = 0; i < carga.cantidad; i++) {
+		if (unicas > 0 && strcmp(carga.entradas[unicas - 1].clave, carga.entradas[i].clave) == 0) {
+			carga.entradas[unicas - 1] = carga.entradas[i];
+		} else {
+			carga.entradas[unicas++] = carga.entradas[i];
+		}
+	}
+	cabecera.registros = (uint32_t)unicas;
+
+	if (archivo_indice) fclose(archivo_indice);
+	archivo_indice = fopen(ARCHIVO_INDICE_COMPROBANTES, "w+b");
+	int exito = archivo_indice && escribir_niveles(carga.entradas, unicas) && escribir_cabecera();
+	free(carga.entradas);
+
+	reconstruir_pendiente = 0;
+	if (!exito && archivo_indice) {
+		fclose(archivo_indice);
+		archivo_indice = NULL;
+		remove(ARCHIVO_INDICE_COMPROBANTES);
+	}
+	return exito;
+}
+
+// ===================================================================
+// FUNCIONES DEL INDICE
+// ===================================================================
+
+/*
+ * Funcion: abrir_indice
+ * Descripcion: Abre el archivo del indice y lee su cabecera
+ * Retorno: 1 si el indice existe y es valido, 0 si hay que cargarlo
+ */
+static int abrir_indice(void) {
+	if (archivo_indice) return 1;
+	archivo_indice = fopen(ARCHIVO_INDICE_COMPROBANTES, "r+b");
+	if (!archivo_indice) return 0;
+
+	if (fread(&cabecera, sizeof(cabecera), 1, archivo_indice) == 1 &&
+		memcmp(cabecera.magia, MAGIA_INDICE_COMPROBANTES, 4) == 0 &&
+		cabecera.altura >= 1 && cabecera.altura <= MAX_ALTURA_ARBOL &&
+		cabecera.raiz >= PAGINAS_CABECERA_ARBOL && cabecera.raiz < cabecera.paginas &&
+		cabecera.particiones <= MAX_PARTICIONES) {
+		return 1;
+	}
+	fclose(archivo_indice);
+	archivo_indice = NULL;
+	return 0;
+}
+
+/*
+ * Funcion: buscar_indexada
+ * Descripcion: Estado de una particion en la cabecera
+ * Retorno: Entrada de la particion, NULL si no esta indexada
+ */
+static ParticionIndexada* buscar_indexada(int periodo) {
+	for (uint32_t i = 0; i < cabecera.particiones; i++) {
+		if (cabecera.indexadas[i].periodo == periodo) return &cabecera.indexadas[i];
+	}
+	return NULL;
+}
+
+/*
+ * Funcion: indice_comprobantes_actualizar
+ * Descripcion: Pone el indice al dia con las particiones de comprobantes.
+ *              Si las particiones solo crecieron, inserta las lineas
+ *              nuevas; si alguna se acorto o desaparecio (por ejemplo al
+ *              archivar un ano), o una linea no estaba donde decia el
+ *              indice, lo vuelve a cargar en bloque
+ * Parametros: Ninguno
+ * Retorno: 1 si el indice esta al dia, 0 si no se pudo usar
+ */
+int indice_comprobantes_actualizar(void) {
+	int periodos[MAX_PARTICIONES];
+	long long tamanos[MAX_PARTICIONES];
+	int cantidad = particion_listar(PARTICION_COMPROBANTES, 0, 0, periodos, MAX_PARTICIONES);
+	for (int i = 0; i < cantidad; i++) {
+		char ruta[MAX_RUTA_PARTICION];
+		struct stat st;
+		particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[i]);
+		tamanos[i] = (stat(ruta, &st) == 0) ? (long long)st.st_size : 0;
+	}
+
+	if (reconstruir_pendiente || !abrir_indice()) return cargar_en_bloque();
+
+	for (uint32_t j = 0; j < cabecera.particiones; j++) {
+		int sigue = 0;
+		for (int i = 0; i < cantidad; i++) {
+			if (periodos[i] == cabecera.indexadas[j].periodo) {
+				sigue = tamanos[i] >= cabecera.indexadas[j].tamano;
+				break;
+			}
+		}
+		if (!sigue) return cargar_en_bloque();
+	}
+
+	int cambios = 0;
+	for (int i = 0; i < cantidad; i++) {
+		ParticionIndexada* indexada = buscar_indexada(periodos[i]);
+		if (!indexada) {
+			indexada = &cabecera.indexadas[cabecera.particiones++];
+			indexada->periodo = periodos[i];
+			indexada->tamano = 0;
+		}
+		if (tamanos[i] <= indexada->tamano) continue;
+
+		if (!cambios && !marcar_en_cambio()) return cargar_en_bloque();
+		long long fin = recorrer_lineas(periodos[i], indexada->tamano, insertar_linea, NULL);
+		if (fin < 0) return cargar_en_bloque();
+		indexada->tamano = fin;
+		cambios = 1;
+	}
+	return !cambios || escribir_cabecera();
+}
+
+/*
+ * Funcion: indice_comprobantes_obtener
+ * Descripcion: Busca la linea de un comprobante por su numero. Si la linea
+ *              ya no esta donde dice el indice (una particion se
+ *              reescribio con otras lineas) o una pagina no se puede leer,
+ *              lo reconstruye y vuelve a buscar
+ * Parametros: numero, ubicacion (salida), linea (salida, sin salto), tamano
+ * Retorno: 1 si lo encontro, 0 si no existe, -1 si no se puede usar el indice
+ */
+int indice_comprobantes_obtener(const char* numero, UbicacionComprobante* ubicacion, char* linea, size_t tamano) {
+	if (strlen(numero) >= LARGO_CLAVE_ARBOL) return -1;
+
+	for (int intento = 0; intento < 2; intento++) {
+		if (!indice_comprobantes_actualizar()) return -1;
+
+		PaginaArbol hoja;
+		uint32_t numero_hoja = descender(numero, NULL);
+		if (!numero_hoja || !leer_pagina(numero_hoja, &hoja) || hoja.cabecera.tipo != PAGINA_HOJA) {
+			reconstruir_pendiente = 1;
+			continue;
+		}
+		int i = cota_hoja(&hoja, numero);
+		if (i >= hoja.cabecera.cantidad || strcmp(hoja.hojas[i].clave, numero) != 0) return 0;
+
+		ubicacion->periodo = hoja.hojas[i].periodo;
+		ubicacion->posicion = hoja.hojas[i].posicion;
+		if (leer_linea_ubicada(ubicacion, numero, linea, tamano)) return 1;
+		reconstruir_pendiente = 1;
+	}
+	return -1;
+}
+
+/*
+ * Funcion: indice_comprobantes_recorrer_prefijo
+ * Descripcion: Entrega en orden los comprobantes cuyo numero empieza con
+ *              un prefijo (MAT-<placa>- para los de una placa), siguiendo
+ *              las hojas enlazadas desde la primera clave del prefijo
+ * Parametros: prefijo, funcion, contexto
+ * Retorno: Comprobantes entregados, -1 si no se puede usar el indice (si
+ *          una pagina no se pudo leer, se reconstruye la proxima vez)
+ */
+long indice_comprobantes_recorrer_prefijo(const char* prefijo, FuncionComprobante funcion, void* contexto) {
+	size_t largo = strlen(prefijo);
+	if (largo >= LARGO_CLAVE_ARBOL || !indice_comprobantes_actualizar()) return -1;
+
+	PaginaArbol hoja;
+	uint32_t numero_hoja = descender(prefijo, NULL);
+	if (!numero_hoja || !leer_pagina(numero_hoja, &hoja) || hoja.cabecera.tipo != PAGINA_HOJA) {
+		reconstruir_pendiente = 1;
+		return -1;
+	}
+
+	long entregados = 0;
+	int i = cota_hoja(&hoja, prefijo);
+	for (;;) {
+		for (; i < hoja.cabecera.cantidad; i++) {
+			const EntradaHoja* entrada = &hoja.hojas[i];
+			if (strncmp(entrada->clave, prefijo, largo) != 0) return entregados;
+
+			char linea[500];
+			UbicacionComprobante ubicacion = {entrada->periodo, entrada->posicion};
+			if (!leer_linea_ubicada(&ubicacion, entrada->clave, linea, sizeof(linea))) {
+				reconstruir_pendiente = 1;
+				return -1;
+			}
+			entregados++;
+			if (!funcion(entrada->clave, &ubicacion, linea, contexto)) return entregados;
+		}
+		if (hoja.cabecera.siguiente == 0) break;
+		if (!leer_pagina(hoja.cabecera.siguiente, &hoja) || hoja.cabecera.tipo != PAGINA_HOJA) {
+			reconstruir_pendiente = 1;
+			return -1;
+		}
+		i = 0;
+	}
+	return entregados;
+}
+
+/*
+ * Funcion: indice_comprobantes_cambiar_estado
+ * Descripcion: Cambia el estado de un comprobante sobre su misma linea, sin
+ *              reescribir la particion. El estado es el digito del ultimo
+ *              campo, asi que la linea no cambia de largo y el indice
+ *              sigue valido
+ * Parametros: numero, nuevo_estado
+ * Retorno: 1 si lo cambio, 0 si hay que reescribir la particion
+ */
+int indice_comprobantes_cambiar_estado(const char* numero, int nuevo_estado) {
+	UbicacionComprobante ubicacion;
+	char linea[500], ruta[MAX_RUTA_PARTICION];
+	if (nuevo_estado < 0 || nuevo_estado > 9 ||
+		indice_comprobantes_obtener(numero, &ubicacion, linea, sizeof(linea)) != 1) {
+		return 0;
+	}
+
+	char* estado = strrchr(linea, '|');
+	if (!estado || estado[1] < '0' || estado[1] > '9' || estado[2] != '\0') return 0;
+
+	particion_ruta(ruta, PARTICION_COMPROBANTES, ubicacion.periodo);
+	FILE* archivo = fopen(ruta, "r+b");
+	if (!archivo) return 0;
+	int exito = BUSCAR_64(archivo, ubicacion.posicion + (estado + 1 - linea)) == 0 &&
+				fputc('0' + nuevo_estado, archivo) != EOF;
+	return fclose(archivo) == 0 && exito;
+}
+
+/*
+ * Funcion: indice_comprobantes_cerrar
+ * Descripcion: Cierra el archivo del indice
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void indice_comprobantes_cerrar(void) {
+	if (archivo_indice) {
+		fclose(archivo_indice);
+		archivo_indice = NULL;
+	}
+}
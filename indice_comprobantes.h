@@ -0,0 +1,68 @@
+/*
+ * indice_comprobantes.h - Libreria del indice de comprobantes por numero
+ *
+ * Descripcion: Este archivo contiene las constantes y prototipos del
+ *              indice en disco de los comprobantes: un arbol B+ de paginas
+ *              de 4 KiB (comprobantes/indice_comprobantes.bpt) que lleva
+ *              cada numero de comprobante a su particion y a la posicion
+ *              de su linea. Las hojas estan enlazadas en orden, asi que
+ *              los comprobantes de una placa (MAT-<placa>-...) son un
+ *              recorrido por prefijo. El indice se carga en bloque desde
+ *              las particiones la primera vez, se pone al dia solo con las
+ *              lineas nuevas y se reconstruye si una particion se acorta,
+ *              desaparece o una linea ya no esta donde dice el indice.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef INDICE_COMPROBANTES_H
+#define INDICE_COMPROBANTES_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// ===================================================================
+// CONSTANTES DEL INDICE
+// ===================================================================
+
+#define ARCHIVO_INDICE_COMPROBANTES "comprobantes/indice_comprobantes.bpt"
+#define MAGIA_INDICE_COMPROBANTES "BPT1"
+
+#define TAMANO_PAGINA_ARBOL 4096
+#define PAGINAS_CABECERA_ARBOL 3         // Cabecera y tamano indexado de cada particion
+#define LARGO_CLAVE_ARBOL 32             // Numeros mas largos no se indexan
+#define CARGA_INICIAL_ARBOL 80           // % de llenado de las paginas al cargar en bloque
+#define MAX_ALTURA_ARBOL 8
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: UbicacionComprobante
+ * Descripcion: Donde esta la linea de un comprobante
+ */
+typedef struct {
+	int periodo;                 // Particion AAAAMM (PERIODO_LEGADO = comprobantes.txt)
+	long long posicion;          // Posicion de la linea en la particion
+} UbicacionComprobante;
+
+// Funcion llamada por cada comprobante de un recorrido (0 = detener)
+typedef int (*FuncionComprobante)(const char* numero, const UbicacionComprobante* ubicacion,
+								  const char* linea, void* contexto);
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+int indice_comprobantes_actualizar(void);
+int indice_comprobantes_obtener(const char* numero, UbicacionComprobante* ubicacion, char* linea, size_t tamano);
+long indice_comprobantes_recorrer_prefijo(const char* prefijo, FuncionComprobante funcion, void* contexto);
+int indice_comprobantes_cambiar_estado(const char* numero, int nuevo_estado);
+void indice_comprobantes_cerrar(void);
+
+#endif // INDICE_COMPROBANTES_H
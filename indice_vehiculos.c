@@ -0,0 +1,883 @@
+/*
+ * indice_vehiculos.c - Implementacion de los indices de vehiculos.txt
+ *
+ * Descripcion: Este archivo implementa los indices en memoria de
+ *              vehiculos, incluyendo:
+ *              - Codificacion de placas (32 bits) y cedulas (64 bits)
+ *              - Arreglos ordenados por clave con busqueda binaria
+ *              - Puesta al dia incremental: si vehiculos.txt crecio solo
+ *                se leen las lineas nuevas, que se insertan en orden
+ *              - Reconstruccion completa si el archivo se reescribio
+ *              - Indice invertido de trigramas de nombres con listas de
+ *                registros comprimidas (diferencias en varint)
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "indice_vehiculos.h"
+#include "vehiculos.h"
+#include <sys/stat.h>
+#include <ctype.h>
+
+// ===================================================================
+// ESTADO DE LOS INDICES
+// ===================================================================
+
+/*
+ * Estructura: EntradaPlaca
+ * Descripcion: Entrada del indice placa -> registro
+ */
+typedef struct {
+	uint32_t codigo;             // codigo_placa()
+	uint32_t registro;           // Posicion en posiciones[]
+} EntradaPlaca;
+
+/*
+ * Estructura: EntradaCedula
+ * Descripcion: Entrada del indice cedula -> placas. Guarda tambien el
+ *              codigo de la placa para listar las placas sin leer el archivo
+ */
+typedef struct {
+	uint64_t cedula;             // clave_cedula()
+	uint32_t registro;
+	uint32_t codigo;
+} EntradaCedula;
+
+/*
+ * Estructura: ListaTrigrama
+ * Descripcion: Registros cuyo nombre contiene un trigrama. Los registros se
+ *              agregan en orden creciente, asi que se guarda la diferencia
+ *              con el anterior en varint (7 bits por byte): casi siempre
+ *              uno o dos bytes por registro
+ */
+typedef struct {
+	uint8_t* datos;
+	uint32_t longitud;           // Bytes usados
+	uint32_t capacidad;          // Bytes reservados
+	uint32_t ultimo;             // Ultimo registro agregado
+	uint32_t cantidad;           // Registros en la lista
+} ListaTrigrama;
+
+static struct {
+	long* posiciones;            // Inicio de la linea de cada registro en vehiculos.txt
+	EntradaPlaca* placas;        // Ordenado por (codigo, registro)
+	EntradaCedula* cedulas;      // Ordenado por (cedula, registro)
+	ListaTrigrama* trigramas;    // NUM_TRIGRAMAS listas
+	uint8_t* trigramas_nombre;   // Trigramas distintos del nombre de cada registro
+	int registros;
+	int cantidad_placas;
+	int cantidad_cedulas;
+	int capacidad;
+	long tamano_indexado;        // Bytes de vehiculos.txt ya leidos
+	time_t modificacion;         // Fecha del archivo en la ultima lectura
+	int cargado;
+} indice;
+
+// ===================================================================
+// FUNCIONES DE CLAVES
+// ===================================================================
+
+/*
+ * Funcion: codigo_placa
+ * Descripcion: Convierte una placa ABC-1234 en un entero: las tres letras
+ *              en base 26 por 10000 mas los digitos, mas 1 (el mayor
+ *              codigo es 175760000, cabe en 32 bits)
+ * Parametros: placa - Placa del vehiculo
+ * Retorno: Codigo de la placa, o CODIGO_PLACA_INVALIDO
+ */
+uint32_t codigo_placa(const char* placa) {
+	uint32_t codigo = 0;
+
+	for (int i = 0; i < 3; i++) {
+		if (placa[i] < 'A' || placa[i] > 'Z') return CODIGO_PLACA_INVALIDO;
+		codigo = codigo * 26 + (uint32_t)(placa[i] - 'A');
+	}
+	if (placa[3] != '-') return CODIGO_PLACA_INVALIDO;
+	for (int i = 4; i < 8; i++) {
+		if (placa[i] < '0' || placa[i] > '9') return CODIGO_PLACA_INVALIDO;
+		codigo = codigo * 10 + (uint32_t)(placa[i] - '0');
+	}
+	if (placa[8] != '\0') return CODIGO_PLACA_INVALIDO;
+
+	return codigo + 1;
+}
+
+/*
+ * Funcion: placa_de_codigo
+ * Descripcion: Operacion inversa de codigo_placa
+ * Parametros: codigo, placa - Buffer de al menos 9 caracteres
+ * Retorno: void
+ */
+void placa_de_codigo(uint32_t codigo, char* placa) {
+	codigo--;
+	for (int i = 7; i >= 4; i--) {
+		placa[i] = (char)('0' + codigo % 10);
+		codigo /= 10;
+	}
+	placa[3] = '-';
+	for (int i = 2; i >= 0; i--) {
+		placa[i] = (char)('A' + codigo % 26);
+		codigo /= 26;
+	}
+	placa[8] = '\0';
+}
+
+/*
+ * Funcion: clave_cedula
+ * Descripcion: Convierte una cedula (10 digitos) o un RUC (13 digitos) en
+ *              un entero de 64 bits. Los RUC se desplazan 10^13 para que
+ *              nunca coincidan con una cedula
+ * Parametros: cedula - Cadena de digitos
+ * Retorno: Clave de la cedula, o CLAVE_CEDULA_INVALIDA
+ */
+uint64_t clave_cedula(const char* cedula) {
+	uint64_t valor = 0;
+	int longitud = 0;
+
+	for (; cedula[longitud]; longitud++) {
+		if (cedula[longitud] < '0' || cedula[longitud] > '9') return CLAVE_CEDULA_INVALIDA;
+		if (longitud == 13) return CLAVE_CEDULA_INVALIDA;
+		valor = valor * 10 + (uint64_t)(cedula[longitud] - '0');
+	}
+	if (longitud == 10) return valor + 1;
+	if (longitud == 13) return valor + 1 + 10000000000000ull;
+	return CLAVE_CEDULA_INVALIDA;
+}
+
+/*
+ * Funcion: cedula_de_clave
+ * Descripcion: Operacion inversa de clave_cedula (conserva los ceros a la
+ *              izquierda)
+ * Parametros: clave, cedula - Buffer de al menos 14 caracteres
+ * Retorno: void
+ */
+void cedula_de_clave(uint64_t clave, char* cedula) {
+	if (clave > 10000000000000ull) {
+		sprintf(cedula, "%013llu", (unsigned long long)(clave - 1 - 10000000000000ull));
+	} else {
+		sprintf(cedula, "%010llu", (unsigned long long)(clave - 1));
+	}
+}
+
+/*
+ * Funcion: letra_sin_tilde
+ * Descripcion: Letra base de un caracter Latin-1 (0xC0-0xFF): a para
+ *              a con tilde, n para enie, u para u con dieresis, etc.
+ */
+static char letra_sin_tilde(unsigned int caracter) {
+	static const char letras[] = "aaaaaaaceeeeiiiidnooooo ouuuuyts";
+	return letras[caracter & 0x1F];
+}
+
+/*
+ * Funcion: normalizar_nombre
+ * Descripcion: Deja un nombre listo para comparar: minusculas, sin tildes
+ *              (acepta UTF-8 y Latin-1), y las palabras separadas por un
+ *              solo espacio, sin espacios al inicio ni al final
+ * Parametros: nombre, destino, tamano
+ * Retorno: Longitud del nombre normalizado
+ */
+int normalizar_nombre(const char* nombre, char* destino, size_t tamano) {
+	const unsigned char* c = (const unsigned char*)nombre;
+	size_t longitud = 0;
+	int separar = 0;
+
+	while (*c && longitud + 2 < tamano) {
+		char letra = 0;
+		if (*c >= 'A' && *c <= 'Z') {
+			letra = (char)(*c - 'A' + 'a');
+		} else if ((*c >= 'a' && *c <= 'z') || (*c >= '0' && *c <= '9')) {
+			letra = (char)*c;
+		} else if (*c == 0xC3 && c[1] >= 0x80 && c[1] <= 0xBF) {
+			letra = letra_sin_tilde(0xC0u + (c[1] - 0x80u));
+			c++;
+		} else if (*c >= 0xC0) {
+			letra = letra_sin_tilde(*c);
+		}
+		c++;
+
+		if (letra == 0 || letra == ' ') {
+			separar = longitud > 0;
+			continue;
+		}
+		if (separar) {
+			destino[longitud++] = ' ';
+			separar = 0;
+		}
+		destino[longitud++] = letra;
+	}
+	destino[longitud] = '\0';
+	return (int)longitud;
+}
+
+/*
+ * Funcion: simbolo_trigrama
+ * Descripcion: Posicion de un caracter normalizado en el alfabeto de trigramas
+ */
+static int simbolo_trigrama(char c) {
+	if (c >= 'a' && c <= 'z') return 1 + (c - 'a');
+	if (c >= '0' && c <= '9') return 27 + (c - '0');
+	return 0;
+}
+
+/*
+ * Funcion: trigramas_de_nombre
+ * Descripcion: Trigramas distintos de un nombre, ordenados. El nombre se
+ *              rodea de espacios para que el inicio y el final de cada
+ *              palabra tambien cuenten
+ * Parametros: nombre, trigramas (salida, MAX_NOMBRE_NORMALIZADO)
+ * Retorno: Cantidad de trigramas
+ */
+static int trigramas_de_nombre(const char* nombre, uint16_t* trigramas) {
+	char normalizado[MAX_NOMBRE_NORMALIZADO];
+	int longitud = normalizar_nombre(nombre, normalizado + 1, sizeof(normalizado) - 1);
+	if (longitud == 0) return 0;
+
+	normalizado[0] = ' ';
+	normalizado[longitud + 1] = ' ';
+	int cantidad = 0;
+	for (int i = 0; i < longitud; i++) {
+		uint16_t trigrama = (uint16_t)((simbolo_trigrama(normalizado[i]) * ALFABETO_TRIGRAMA +
+			simbolo_trigrama(normalizado[i + 1])) * ALFABETO_TRIGRAMA + simbolo_trigrama(normalizado[i + 2]));
+
+		// Insercion en orden sin repetidos
+		int j = cantidad;
+		while (j > 0 && trigramas[j - 1] > trigrama) j--;
+		if (j > 0 && trigramas[j - 1] == trigrama) continue;
+		memmove(&trigramas[j + 1], &trigramas[j], (size_t)(cantidad - j) * sizeof(uint16_t));
+		trigramas[j] = trigrama;
+		cantidad++;
+	}
+	return cantidad;
+}
+
+// ===================================================================
+// CONSTRUCCION DE LOS INDICES
+// ===================================================================
+
+static int comparar_placas(const void* a, const void* b) {
+	const EntradaPlaca* x = a;
+	const EntradaPlaca* y = b;
+	if (x->codigo != y->codigo) return x->codigo < y->codigo ? -1 : 1;
+	return (x->registro > y->registro) - (x->registro < y->registro);
+}
+
+static int comparar_cedulas(const void* a, const void* b) {
+	const EntradaCedula* x = a;
+	const EntradaCedula* y = b;
+	if (x->cedula != y->cedula) return x->cedula < y->cedula ? -1 : 1;
+	return (x->registro > y->registro) - (x->registro < y->registro);
+}
+
+/*
+ * Funcion: vaciar_indice
+ * Descripcion: Descarta los indices para reconstruirlos desde el inicio
+ */
+static void vaciar_indice(void) {
+	indice.registros = 0;
+	indice.cantidad_placas = 0;
+	indice.cantidad_cedulas = 0;
+	indice.tamano_indexado = 0;
+	indice.cargado = 0;
+	if (indice.trigramas) {
+		for (int i = 0; i < NUM_TRIGRAMAS; i++) {
+			indice.trigramas[i].longitud = 0;
+			indice.trigramas[i].cantidad = 0;
+		}
+	}
+}
+
+/*
+ * Funcion: agregar_trigrama
+ * Descripcion: Agrega un registro al final de la lista de un trigrama
+ * Retorno: 1 si fue exitoso, 0 si no hay memoria
+ */
+static int agregar_trigrama(ListaTrigrama* lista, uint32_t registro) {
+	if (lista->longitud + 5 > lista->capacidad) {
+		uint32_t nueva = lista->capacidad ? lista->capacidad * 2 : 16;
+		uint8_t* datos = realloc(lista->datos, nueva);
+		if (!datos) return 0;
+		lista->datos = datos;
+		lista->capacidad = nueva;
+	}
+
+	uint32_t valor = lista->cantidad ? registro - lista->ultimo : registro;
+	while (valor >= 0x80) {
+		lista->datos[lista->longitud++] = (uint8_t)(valor | 0x80);
+		valor >>= 7;
+	}
+	lista->datos[lista->longitud++] = (uint8_t)valor;
+	lista->ultimo = registro;
+	lista->cantidad++;
+	return 1;
+}
+
+/*
+ * Funcion: agregar_registro
+ * Descripcion: Agrega un vehiculo al final de los indices (sin ordenar)
+ * Parametros: posicion - Inicio de la linea, vehiculo
+ * Retorno: 1 si fue exitoso, 0 si no hay memoria
+ */
+static int agregar_registro(long posicion, const DatosVehiculo* vehiculo) {
+	if (indice.registros == indice.capacidad) {
+		int nueva = indice.capacidad ? indice.capacidad * 2 : 1024;
+		long* posiciones = realloc(indice.posiciones, (size_t)nueva * sizeof(long));
+		if (!posiciones) return 0;
+		indice.posiciones = posiciones;
+		EntradaPlaca* placas = realloc(indice.placas, (size_t)nueva * sizeof(EntradaPlaca));
+		if (!placas) return 0;
+		indice.placas = placas;
+		EntradaCedula* cedulas = realloc(indice.cedulas, (size_t)nueva * sizeof(EntradaCedula));
+		if (!cedulas) return 0;
+		indice.cedulas = cedulas;
+		uint8_t* trigramas_nombre = realloc(indice.trigramas_nombre, (size_t)nueva);
+		if (!trigramas_nombre) return 0;
+		indice.trigramas_nombre = trigramas_nombre;
+		indice.capacidad = nueva;
+	}
+
+	uint32_t registro = (uint32_t)indice.registros++;
+	uint32_t codigo = codigo_placa(vehiculo->placa);
+	uint64_t cedula = clave_cedula(vehiculo->cedula);
+
+	indice.posiciones[registro] = posicion;
+	if (codigo != CODIGO_PLACA_INVALIDO) {
+		indice.placas[indice.cantidad_placas].codigo = codigo;
+		indice.placas[indice.cantidad_placas].registro = registro;
+		indice.cantidad_placas++;
+	}
+	if (cedula != CLAVE_CEDULA_INVALIDA) {
+		indice.cedulas[indice.cantidad_cedulas].cedula = cedula;
+		indice.cedulas[indice.cantidad_cedulas].registro = registro;
+		indice.cedulas[indice.cantidad_cedulas].codigo = codigo;
+		indice.cantidad_cedulas++;
+	}
+
+	if (!indice.trigramas) {
+		indice.trigramas = calloc(NUM_TRIGRAMAS, sizeof(ListaTrigrama));
+		if (!indice.trigramas) return 0;
+	}
+	uint16_t trigramas[MAX_NOMBRE_NORMALIZADO];
+	int cantidad = trigramas_de_nombre(vehiculo->propietario, trigramas);
+	for (int i = 0; i < cantidad; i++) {
+		if (!agregar_trigrama(&indice.trigramas[trigramas[i]], registro)) return 0;
+	}
+	indice.trigramas_nombre[registro] = (uint8_t)cantidad;
+	return 1;
+}
+
+/*
+ * Funcion: ordenar_nuevas
+ * Descripcion: Deja ordenadas las entradas agregadas al final. Pocas
+ *              entradas (un registro desde el menu) se insertan en su
+ *              lugar; muchas (carga inicial) se ordenan con qsort
+ * Parametros: placas_antes, cedulas_antes - Entradas que ya estaban ordenadas
+ * Retorno: void
+ */
+static void ordenar_nuevas(int placas_antes, int cedulas_antes) {
+	if (indice.cantidad_placas - placas_antes > MAX_INSERCIONES_INDICE) {
+		qsort(indice.placas, (size_t)indice.cantidad_placas, sizeof(EntradaPlaca), comparar_placas);
+	} else {
+		for (int i = placas_antes; i < indice.cantidad_placas; i++) {
+			EntradaPlaca nueva = indice.placas[i];
+			int j = i;
+			while (j > 0 && comparar_placas(&indice.placas[j - 1], &nueva) > 0) {
+				indice.placas[j] = indice.placas[j - 1];
+				j--;
+			}
+			indice.placas[j] = nueva;
+		}
+	}
+
+	if (indice.cantidad_cedulas - cedulas_antes > MAX_INSERCIONES_INDICE) {
+		qsort(indice.cedulas, (size_t)indice.cantidad_cedulas, sizeof(EntradaCedula), comparar_cedulas);
+	} else {
+		for (int i = cedulas_antes; i < indice.cantidad_cedulas; i++) {
+			EntradaCedula nueva = indice.cedulas[i];
+			int j = i;
+			while (j > 0 && comparar_cedulas(&indice.cedulas[j - 1], &nueva) > 0) {
+				indice.cedulas[j] = indice.cedulas[j - 1];
+				j--;
+			}
+			indice.cedulas[j] = nueva;
+		}
+	}
+}
+
+/*
+ * Funcion: indice_vehiculos_actualizar
+ * Descripcion: Pone los indices al dia con vehiculos.txt. Si el archivo
+ *              solo crecio (vehiculos registrados) lee unicamente las
+ *              lineas nuevas; si se acorto o se reescribio, reconstruye
+ * Parametros: Ninguno
+ * Retorno: 1 si los indices estan al dia, 0 si no se pudo leer el archivo
+ */
+int indice_vehiculos_actualizar(void) {
+	struct stat st;
+	if (stat(ARCHIVO_VEHICULOS, &st) != 0) {
+		vaciar_indice();
+		return 0;
+	}
+
+	if (indice.cargado && (long)st.st_size == indice.tamano_indexado && st.st_mtime == indice.modificacion) {
+		return 1;
+	}
+	if (!indice.cargado || (long)st.st_size <= indice.tamano_indexado) {
+		vaciar_indice();
+	}
+
+	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "rb");
+	if (!archivo) {
+		vaciar_indice();
+		return 0;
+	}
+	fseek(archivo, indice.tamano_indexado, SEEK_SET);
+
+	int placas_antes = indice.cantidad_placas;
+	int cedulas_antes = indice.cantidad_cedulas;
+	char linea[MAX_LINEA2];
+	long posicion = ftell(archivo);
+	int exito = 1;
+
+	while (fgets(linea, sizeof(linea), archivo)) {
+		DatosVehiculo vehiculo;
+		if (leer_linea_vehiculo(linea, &vehiculo) && !agregar_registro(posicion, &vehiculo)) {
+			exito = 0;
+			break;
+		}
+		posicion = ftell(archivo);
+	}
+	fclose(archivo);
+
+	ordenar_nuevas(placas_antes, cedulas_antes);
+	if (!exito) {
+		vaciar_indice();
+		return 0;
+	}
+
+	indice.tamano_indexado = posicion;
+	indice.modificacion = st.st_mtime;
+	indice.cargado = 1;
+	return 1;
+}
+
+// ===================================================================
+// CONSULTAS
+// ===================================================================
+
+/*
+ * Funcion: leer_registro_de
+ * Descripcion: Lee la linea de un registro de vehiculos.txt ya abierto
+ */
+static int leer_registro_de(FILE* archivo, uint32_t registro, DatosVehiculo* vehiculo) {
+	char linea[MAX_LINEA2];
+	return fseek(archivo, indice.posiciones[registro], SEEK_SET) == 0 &&
+		fgets(linea, sizeof(linea), archivo) && leer_linea_vehiculo(linea, vehiculo);
+}
+
+/*
+ * Funcion: leer_registro
+ * Descripcion: Lee la linea de un registro directamente de su posicion
+ */
+static int leer_registro(uint32_t registro, DatosVehiculo* vehiculo) {
+	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "rb");
+	if (!archivo) return 0;
+
+	int leido = leer_registro_de(archivo, registro, vehiculo);
+	fclose(archivo);
+	return leido;
+}
+
+/*
+ * Funcion: cota_inferior_placa
+ * Descripcion: Primera entrada del indice de placas con codigo >= al dado
+ * Retorno: Posicion en indice.placas (cantidad_placas si no hay ninguna)
+ */
+static int cota_inferior_placa(uint32_t codigo) {
+	int izquierda = 0, derecha = indice.cantidad_placas;
+	while (izquierda < derecha) {
+		int medio = izquierda + (derecha - izquierda) / 2;
+		if (indice.placas[medio].codigo < codigo) izquierda = medio + 1;
+		else derecha = medio;
+	}
+	return izquierda;
+}
+
+/*
+ * Funcion: primera_placa
+ * Descripcion: Primera entrada del indice de placas con el codigo dado
+ * Retorno: Posicion en indice.placas, o -1 si no esta
+ */
+static int primera_placa(uint32_t codigo) {
+	int posicion = cota_inferior_placa(codigo);
+	return (posicion < indice.cantidad_placas && indice.placas[posicion].codigo == codigo) ? posicion : -1;
+}
+
+/*
+ * Funcion: indice_buscar_placa
+ * Descripcion: Datos de un vehiculo por placa sin recorrer vehiculos.txt.
+ *              Si la linea indexada ya no corresponde a la placa (archivo
+ *              editado a mano), reconstruye el indice y reintenta
+ * Parametros: placa, vehiculo (salida)
+ * Retorno: 1 si lo encontro, 0 si no
+ */
+int indice_buscar_placa(const char* placa, DatosVehiculo* vehiculo) {
+	uint32_t codigo = codigo_placa(placa);
+	if (codigo == CODIGO_PLACA_INVALIDO) return 0;
+
+	for (int intento = 0; intento < 2; intento++) {
+		if (!indice_vehiculos_actualizar()) return 0;
+
+		int posicion = primera_placa(codigo);
+		if (posicion < 0) return 0;
+
+		DatosVehiculo leido;
+		if (leer_registro(indice.placas[posicion].registro, &leido) && strcmp(leido.placa, placa) == 0) {
+			*vehiculo = leido;
+			return 1;
+		}
+		vaciar_indice();
+	}
+	return 0;
+}
+
+/*
+ * Funcion: plantilla_patron_placa
+ * Descripcion: Convierte un patron de placa en una plantilla ABC-1234 donde
+ *              '?' es cualquier caracter. En el patron '?' o '_' valen por
+ *              un caracter, '*' por todos los que faltan, el guion es
+ *              opcional y un patron incompleto se toma como prefijo
+ *              ("PCO-94" = "PCO-94??", "*12" = "???-??12")
+ * Parametros: patron, plantilla (salida, 9 caracteres)
+ * Retorno: 1 si el patron es valido, 0 si no
+ */
+int plantilla_patron_placa(const char* patron, char* plantilla) {
+	char simbolos[8];
+	int cantidad = 0;
+	int asterisco = -1;
+
+	for (int i = 0; patron[i]; i++) {
+		char c = (char)toupper((unsigned char)patron[i]);
+		if (c == '-' && cantidad == 3) continue;
+		if (c == '*') {
+			if (asterisco >= 0) return 0;
+			asterisco = cantidad;
+			continue;
+		}
+		if (cantidad == 7) return 0;
+		simbolos[cantidad++] = (c == '_') ? '?' : c;
+	}
+	if (cantidad == 0 && asterisco < 0) return 0;
+
+	// El asterisco (o el final de un prefijo) se rellena con '?'
+	int relleno = 7 - cantidad;
+	int inicio = asterisco >= 0 ? asterisco : cantidad;
+	memmove(&simbolos[inicio + relleno], &simbolos[inicio], (size_t)(cantidad - inicio));
+	memset(&simbolos[inicio], '?', (size_t)relleno);
+
+	for (int i = 0, j = 0; i < 8; i++) {
+		if (i == 3) {
+			plantilla[i] = '-';
+			continue;
+		}
+		char c = simbolos[j++];
+		if (c != '?' && (i < 3 ? (c < 'A' || c > 'Z') : (c < '0' || c > '9'))) return 0;
+		plantilla[i] = c;
+	}
+	plantilla[8] = '\0';
+	return 1;
+}
+
+/*
+ * Estructura: BusquedaPatron
+ * Descripcion: Estado de una busqueda de placas con comodines
+ */
+typedef struct {
+	const char* plantilla;       // ABC-1234 con '?' donde vale cualquier caracter
+	DatosVehiculo* resultados;
+	int max;
+	int cantidad;                // Placas que cumplen el patron
+} BusquedaPatron;
+
+/*
+ * Funcion: rango_prefijo_placa
+ * Descripcion: Entradas del indice (dentro de [desde, hasta)) cuya placa
+ *              empieza con los primeros "largo" caracteres del prefijo. Como
+ *              el codigo conserva el orden alfabetico es un rango continuo
+ */
+static void rango_prefijo_placa(const char* prefijo, int largo, int* desde, int* hasta) {
+	char minima[9], maxima[9];
+	for (int i = 0; i < 8; i++) {
+		minima[i] = i < largo ? prefijo[i] : (i < 3 ? 'A' : (i == 3 ? '-' : '0'));
+		maxima[i] = i < largo ? prefijo[i] : (i < 3 ? 'Z' : (i == 3 ? '-' : '9'));
+	}
+	minima[8] = maxima[8] = '\0';
+
+	uint32_t codigo_minimo = codigo_placa(minima);
+	uint32_t codigo_maximo = codigo_placa(maxima);
+	int izquierda = *desde, derecha = *hasta;
+	while (izquierda < derecha) {
+		int medio = izquierda + (derecha - izquierda) / 2;
+		if (indice.placas[medio].codigo < codigo_minimo) izquierda = medio + 1;
+		else derecha = medio;
+	}
+	*desde = izquierda;
+	derecha = *hasta;
+	while (izquierda < derecha) {
+		int medio = izquierda + (derecha - izquierda) / 2;
+		if (indice.placas[medio].codigo <= codigo_maximo) izquierda = medio + 1;
+		else derecha = medio;
+	}
+	*hasta = izquierda;
+}
+
+/*
+ * Funcion: revisar_rango_patron
+ * Descripcion: Compara con la plantilla cada placa de un rango del indice
+ */
+static void revisar_rango_patron(BusquedaPatron* busqueda, int desde, int hasta) {
+	uint32_t anterior = CODIGO_PLACA_INVALIDO;
+	for (int i = desde; i < hasta; i++) {
+		// Una placa repetida en el archivo cuenta una vez (la primera)
+		if (indice.placas[i].codigo == anterior) continue;
+		anterior = indice.placas[i].codigo;
+
+		char placa[9];
+		placa_de_codigo(anterior, placa);
+		int cumple = 1;
+		for (int j = 0; j < 8 && cumple; j++) {
+			cumple = busqueda->plantilla[j] == '?' || busqueda->plantilla[j] == placa[j];
+		}
+		if (!cumple) continue;
+
+		if (busqueda->cantidad < busqueda->max &&
+			!leer_registro(indice.placas[i].registro, &busqueda->resultados[busqueda->cantidad])) continue;
+		busqueda->cantidad++;
+	}
+}
+
+/*
+ * Funcion: recorrer_patron
+ * Descripcion: Recorre el indice como un arbol de prefijos: los caracteres
+ *              fijos de la plantilla acotan el rango con busqueda binaria y
+ *              en cada comodin se baja por cada letra o digito posible,
+ *              descartando los prefijos sin placas. Cuando el rango ya es
+ *              pequeno se revisa directamente
+ * Parametros: busqueda, prefijo (se va completando), largo, desde, hasta
+ * Retorno: void
+ */
+static void recorrer_patron(BusquedaPatron* busqueda, char* prefijo, int largo, int desde, int hasta) {
+	while (largo < 8 && (largo == 3 || busqueda->plantilla[largo] != '?')) {
+		prefijo[largo] = busqueda->plantilla[largo];
+		largo++;
+	}
+	rango_prefijo_placa(prefijo, largo, &desde, &hasta);
+
+	if (desde >= hasta) return;
+	if (largo == 8 || hasta - desde <= MAX_RANGO_REVISION_PATRON) {
+		revisar_rango_patron(busqueda, desde, hasta);
+		return;
+	}
+
+	char primero = largo < 3 ? 'A' : '0';
+	char ultimo = largo < 3 ? 'Z' : '9';
+	for (char c = primero; c <= ultimo; c++) {
+		prefijo[largo] = c;
+		recorrer_patron(busqueda, prefijo, largo + 1, desde, hasta);
+	}
+}
+
+/*
+ * Funcion: indice_buscar_patron_placa
+ * Descripcion: Vehiculos cuya placa cumple un patron con comodines, en
+ *              orden de placa, sin leer vehiculos.txt salvo los resultados
+ * Parametros: patron - Ver plantilla_patron_placa, resultados (salida), max
+ * Retorno: Cantidad de placas que cumplen el patron (se guardan hasta max),
+ *          -1 si el patron no es valido
+ */
+int indice_buscar_patron_placa(const char* patron, DatosVehiculo* resultados, int max) {
+	char plantilla[9], prefijo[9];
+	if (!plantilla_patron_placa(patron, plantilla)) return -1;
+	if (!indice_vehiculos_actualizar()) return 0;
+
+	BusquedaPatron busqueda = { plantilla, resultados, max, 0 };
+	recorrer_patron(&busqueda, prefijo, 0, 0, indice.cantidad_placas);
+	return busqueda.cantidad;
+}
+
+/*
+ * Funcion: indice_placas_de_cedula
+ * Descripcion: Placas registradas a nombre de una cedula, en el orden en
+ *              que se registraron. Cada linea indexada se lee para
+ *              comprobar que sigue siendo de la cedula y de la placa: si el
+ *              archivo se reescribio (y crecio), reconstruye el indice y
+ *              reintenta, igual que indice_buscar_placa
+ * Parametros: cedula, placas (salida), max
+ * Retorno: Cantidad de placas (0 si no tiene vehiculos), -1 si hubo error
+ */
+int indice_placas_de_cedula(const char* cedula, char (*placas)[10], int max) {
+	uint64_t clave = clave_cedula(cedula);
+	if (clave == CLAVE_CEDULA_INVALIDA) return 0;
+
+	for (int intento = 0; intento < 2; intento++) {
+		if (!indice_vehiculos_actualizar()) return -1;
+
+		int izquierda = 0, derecha = indice.cantidad_cedulas;
+		while (izquierda < derecha) {
+			int medio = izquierda + (derecha - izquierda) / 2;
+			if (indice.cedulas[medio].cedula < clave) izquierda = medio + 1;
+			else derecha = medio;
+		}
+
+		FILE* archivo = fopen(ARCHIVO_VEHICULOS, "rb");
+		if (!archivo) return -1;
+		int cantidad = 0, vigente = 1;
+		for (int i = izquierda; vigente && i < indice.cantidad_cedulas && indice.cedulas[i].cedula == clave &&
+			 cantidad < max; i++) {
+			DatosVehiculo vehiculo;
+			vigente = leer_registro_de(archivo, indice.cedulas[i].registro, &vehiculo) &&
+					  clave_cedula(vehiculo.cedula) == clave && codigo_placa(vehiculo.placa) == indice.cedulas[i].codigo;
+			if (vigente) strcpy(placas[cantidad++], vehiculo.placa);
+		}
+		fclose(archivo);
+
+		if (vigente) return cantidad;
+		vaciar_indice();
+	}
+	return -1;
+}
+
+/*
+ * Funcion: trigramas_en_comun
+ * Descripcion: Trigramas que comparten dos listas ordenadas sin repetidos
+ */
+static int trigramas_en_comun(const uint16_t* a, int cantidad_a, const uint16_t* b, int cantidad_b) {
+	int i = 0, j = 0, comunes = 0;
+	while (i < cantidad_a && j < cantidad_b) {
+		if (a[i] < b[j]) {
+			i++;
+		} else if (a[i] > b[j]) {
+			j++;
+		} else {
+			comunes++;
+			i++;
+			j++;
+		}
+	}
+	return comunes;
+}
+
+/*
+ * Funcion: buscar_nombre_indexado
+ * Descripcion: Busqueda por trigramas de indice_buscar_nombre sobre el
+ *              indice cargado
+ * Parametros: trigramas, cantidad_busqueda, resultados (salida), max
+ * Retorno: Cantidad de resultados, -1 si hubo error, -2 si una linea ya no
+ *          es la que se indexo
+ */
+static int buscar_nombre_indexado(const uint16_t* trigramas, int cantidad_busqueda, ResultadoNombre* resultados, int max) {
+	uint8_t* comunes = calloc((size_t)indice.registros, sizeof(uint8_t));
+	if (!comunes) return -1;
+
+	for (int i = 0; i < cantidad_busqueda; i++) {
+		const ListaTrigrama* lista = &indice.trigramas[trigramas[i]];
+		uint32_t registro = 0;
+		uint32_t posicion = 0;
+		for (uint32_t n = 0; n < lista->cantidad; n++) {
+			uint32_t valor = 0;
+			int desplazamiento = 0;
+			uint8_t byte;
+			do {
+				byte = lista->datos[posicion++];
+				valor |= (uint32_t)(byte & 0x7F) << desplazamiento;
+				desplazamiento += 7;
+			} while (byte & 0x80);
+			registro = n ? registro + valor : valor;
+			comunes[registro]++;
+		}
+	}
+
+	// Los mejores max registros, de mayor a menor similitud
+	int minimo = (int)(cantidad_busqueda * COBERTURA_MINIMA_NOMBRE + 0.999);
+	uint32_t* mejores = malloc((size_t)max * sizeof(uint32_t));
+	double* similitudes = malloc((size_t)max * sizeof(double));
+	int encontrados = 0;
+	if (!mejores || !similitudes) {
+		free(comunes);
+		free(mejores);
+		free(similitudes);
+		return -1;
+	}
+
+	for (int r = 0; r < indice.registros; r++) {
+		if (comunes[r] < minimo) continue;
+		double similitud = (double)comunes[r] / (cantidad_busqueda + indice.trigramas_nombre[r] - comunes[r]);
+		if (encontrados == max && similitud <= similitudes[max - 1]) continue;
+
+		int j = encontrados < max ? encontrados++ : max - 1;
+		while (j > 0 && similitudes[j - 1] < similitud) {
+			mejores[j] = mejores[j - 1];
+			similitudes[j] = similitudes[j - 1];
+			j--;
+		}
+		mejores[j] = (uint32_t)r;
+		similitudes[j] = similitud;
+	}
+
+	// Cada resultado debe tener en su linea el mismo nombre que se indexo
+	int cantidad = 0;
+	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "rb");
+	for (int i = 0; archivo && cantidad >= 0 && i < encontrados; i++) {
+		uint16_t trigramas_leidos[MAX_NOMBRE_NORMALIZADO];
+		DatosVehiculo* vehiculo = &resultados[cantidad].vehiculo;
+		int cantidad_leidos = leer_registro_de(archivo, mejores[i], vehiculo) ?
+			trigramas_de_nombre(vehiculo->propietario, trigramas_leidos) : -1;
+		if (cantidad_leidos != indice.trigramas_nombre[mejores[i]] ||
+			trigramas_en_comun(trigramas, cantidad_busqueda, trigramas_leidos, cantidad_leidos) != comunes[mejores[i]]) {
+			cantidad = -2;
+			break;
+		}
+		resultados[cantidad].similitud = similitudes[i];
+		cantidad++;
+	}
+	if (!archivo) cantidad = -1;
+	else fclose(archivo);
+
+	free(comunes);
+	free(mejores);
+	free(similitudes);
+	return cantidad;
+}
+
+/*
+ * Funcion: indice_buscar_nombre
+ * Descripcion: Busca vehiculos por nombre del propietario tolerando errores
+ *              de escritura, tildes y espacios de mas. Cuenta cuantos
+ *              trigramas de la busqueda tiene cada nombre recorriendo solo
+ *              las listas de esos trigramas; descarta los nombres que no
+ *              tienen al menos COBERTURA_MINIMA_NOMBRE de ellos y ordena
+ *              el resto por similitud (trigramas comunes / trigramas de
+ *              ambos nombres). Si el nombre leido de un resultado ya no es
+ *              el que se indexo (archivo reescrito), reconstruye el indice
+ *              y vuelve a buscar
+ * Parametros: nombre - Texto buscado, resultados (salida), max
+ * Retorno: Cantidad de resultados, -1 si hubo error
+ */
+int indice_buscar_nombre(const char* nombre, ResultadoNombre* resultados, int max) {
+	uint16_t trigramas[MAX_NOMBRE_NORMALIZADO];
+	int cantidad_busqueda = trigramas_de_nombre(nombre, trigramas);
+	if (cantidad_busqueda == 0 || max <= 0) return 0;
+
+	for (int intento = 0; intento < 2; intento++) {
+		if (!indice_vehiculos_actualizar()) return -1;
+		if (indice.registros == 0) return 0;
+
+		int cantidad = buscar_nombre_indexado(trigramas, cantidad_busqueda, resultados, max);
+		if (cantidad != -2) return cantidad;
+		vaciar_indice();
+	}
+	return -1;
+}
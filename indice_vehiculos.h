@@ -0,0 +1,88 @@
+/*
+ * indice_vehiculos.h - Libreria de indices en memoria de vehiculos.txt
+ *
+ * Descripcion: Este archivo contiene los prototipos de los indices que
+ *              evitan recorrer vehiculos.txt completo en cada consulta:
+ *              - Placa -> registro: la placa ABC-1234 se codifica en un
+ *                entero de 32 bits que conserva el orden alfabetico, asi
+ *                que tambien sirve para buscar por prefijo o con comodines
+ *              - Cedula -> placas: la cedula (10 digitos, o RUC de 13) se
+ *                usa como clave entera de 64 bits
+ *              - Trigramas del nombre del propietario -> registros, para
+ *                buscar nombres con errores de escritura o sin tildes
+ *              Cada registro guarda la posicion de su linea en el archivo.
+ *              Los indices se ponen al dia solos cuando vehiculos.txt
+ *              crece (registro de vehiculos) y se reconstruyen si cambia
+ *              de otra forma.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef INDICE_VEHICULOS_H
+#define INDICE_VEHICULOS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "matricula.h"
+
+// ===================================================================
+// CONSTANTES DE INDICES
+// ===================================================================
+
+#define CODIGO_PLACA_INVALIDO 0u         // La placa no tiene el formato ABC-1234
+#define CLAVE_CEDULA_INVALIDA 0ull       // La cedula no es numerica
+#define MAX_VEHICULOS_PROPIETARIO 64     // Placas listadas por cedula
+#define MAX_RESULTADOS_PATRON 50         // Placas mostradas por busqueda con comodines
+#define MAX_RANGO_REVISION_PATRON 64     // Placas que se revisan una por una en vez de subdividir
+
+// Nuevas entradas que se insertan en orden; con mas se reordena todo
+#define MAX_INSERCIONES_INDICE 64
+
+// Busqueda por nombre: trigramas sobre a-z, 0-9 y espacio
+#define ALFABETO_TRIGRAMA 37
+#define NUM_TRIGRAMAS (ALFABETO_TRIGRAMA * ALFABETO_TRIGRAMA * ALFABETO_TRIGRAMA)
+#define MAX_NOMBRE_NORMALIZADO 64        // Nombre normalizado (sin tildes, minusculas)
+#define MAX_RESULTADOS_NOMBRE 20         // Resultados mostrados por busqueda
+#define COBERTURA_MINIMA_NOMBRE 0.5      // Fraccion de trigramas de la busqueda que debe tener el nombre
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: ResultadoNombre
+ * Descripcion: Vehiculo encontrado por nombre del propietario y que tan
+ *              parecido es el nombre a lo buscado (1.0 = igual)
+ */
+typedef struct {
+	DatosVehiculo vehiculo;
+	double similitud;
+} ResultadoNombre;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de claves
+uint32_t codigo_placa(const char* placa);
+void placa_de_codigo(uint32_t codigo, char* placa);
+uint64_t clave_cedula(const char* cedula);
+void cedula_de_clave(uint64_t clave, char* cedula);
+
+// Funciones de indices
+int indice_vehiculos_actualizar(void);
+int indice_buscar_placa(const char* placa, DatosVehiculo* vehiculo);
+int indice_placas_de_cedula(const char* cedula, char (*placas)[10], int max);
+int plantilla_patron_placa(const char* patron, char* plantilla);
+int indice_buscar_patron_placa(const char* patron, DatosVehiculo* resultados, int max);
+
+// Funciones de busqueda por nombre
+int normalizar_nombre(const char* nombre, char* destino, size_t tamano);
+int indice_buscar_nombre(const char* nombre, ResultadoNombre* resultados, int max);
+
+#endif // INDICE_VEHICULOS_H
@@ -23,6 +23,17 @@
 #include "vehiculos.h"
 #include "matricula.h"
 #include "pagos.h"
+#include "almacen_documentos.h"
+#include "historico.h"
+#include "tarifas.h"
+#include "renovacion.h"
+#include "simulacion.h"
+#include "eventos.h"
+#include "matriculas_pagadas.h"
+#include "repositorio.h"
+#include "indice_comprobantes.h"
+#include "conjuntos_estado.h"
+#include "resumenes.h"
 
 // Constantes y definiciones del sistema
 #define ARCHIVO_USUARIOS "usuarios.txt"
@@ -57,6 +68,7 @@ void dibujar_formulario_login(const char* usuario_actual, int fase);
 // Funciones del menu principal
 void menu_vehiculos();
 void mostrar_tarifas_vigentes();
+void menu_administracion();
 
 // ===================================================================
 // IMPLEMENTACION DE FUNCIONES DE UTILIDAD
@@ -472,6 +484,9 @@ void menu_vehiculos() {
 	char buffer[10];
 	
 	do {
+		// Publicar tarifas nuevas si tarifas.cfg cambio desde la ultima operacion
+		tarifas_verificar_recarga();
+		
 		limpiar_pantalla();
 		printf("===============================================\n");
 		printf("||                                           ||\n");
@@ -487,13 +502,14 @@ void menu_vehiculos() {
 		printf("    +----------------------------------------------------------+\n");
 		printf("    |                                                          |\n");
 		printf("    |    1. Registrar nuevo vehiculo                           |\n");
-		printf("    |    2. Buscar vehiculo por placa                          |\n");
+		printf("    |    2. Buscar vehiculo por placa o propietario            |\n");
 		printf("    |    3. Calcular valor de matricula                        |\n");
 		printf("    |    4. Procesar pago de matricula                         |\n");
 		printf("    |    5. Registrar revision tecnica                         |\n");
 		printf("    |    6. Matricular vehiculo                                |\n");
 		printf("    |    7. Ver vehiculos matriculados                         |\n");
 		printf("    |    8. Mostrar tarifas vigentes                           |\n");
+		printf("    |    9. Archivo de documentos y administracion             |\n");
 		printf("    |    0. Cerrar sesion y volver al menu                     |\n");
 		printf("    |                                                          |\n");
 		printf("    +----------------------------------------------------------+\n");
@@ -535,6 +551,9 @@ void menu_vehiculos() {
 			mostrar_tarifas_vigentes(); 
 			pausar(); 
 			break;
+		case 9: 
+			menu_administracion(); 
+			break;
 		case 0: 
 			printf("\n    Cerrando sesion...\n");
 			printf("    Sesion cerrada exitosamente.\n");
@@ -547,6 +566,95 @@ void menu_vehiculos() {
 	} while (opcion != 0);
 }
 
+/*
+ * Funcion: menu_administracion
+ * Descripcion: Menu de herramientas de archivo y administracion del sistema
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+
+void menu_administracion() {
+	int opcion;
+	char buffer[10];
+	
+	do {
+		limpiar_pantalla();
+		printf("===============================================\n");
+		printf("||                                           ||\n");
+		printf("||      ARCHIVO DE DOCUMENTOS Y ADMIN        ||\n");
+		printf("||                                           ||\n");
+		printf("===============================================\n");
+		
+		printf("\n    +----------------------------------------------------------+\n");
+		printf("    |    1. Consultar / exportar comprobante o certificado     |\n");
+		printf("    |    2. Archivar ano fiscal cerrado (historico)            |\n");
+		printf("    |    3. Consulta de auditoria en historico                 |\n");
+		printf("    |    4. Recargar tarifas (tarifas.cfg)                     |\n");
+		printf("    |    5. Deuda de varios anos fiscales                      |\n");
+		printf("    |    6. Simular recaudacion (escenarios.cfg)               |\n");
+		printf("    |    7. Historial de eventos de una placa                  |\n");
+		printf("    |    8. Reconstruir archivos desde eventos                 |\n");
+		printf("    |    9. Comparar motores de almacenamiento                 |\n");
+		printf("    |   10. Reporte de vehiculos por estado                    |\n");
+		printf("    |   11. Estadisticas de avaluos y pagos                    |\n");
+		printf("    |   12. Listado de pagos ordenado                          |\n");
+		printf("    |    0. Volver al menu principal                           |\n");
+		printf("    +----------------------------------------------------------+\n");
+		
+		printf("\n    Seleccione una opcion: ");
+		
+		if (fgets(buffer, sizeof(buffer), stdin)) {
+			if (sscanf(buffer, "%d", &opcion) != 1) opcion = -1;
+		} else {
+			opcion = 0;
+		}
+		
+		switch (opcion) {
+		case 1: 
+			menu_exportar_documento(); 
+			break;
+		case 2: 
+			menu_archivar_historico(); 
+			break;
+		case 3: 
+			menu_auditoria_historico(); 
+			break;
+		case 4: 
+			menu_recargar_tarifas(); 
+			break;
+		case 5: 
+			menu_deuda_multianual(); 
+			break;
+		case 6: 
+			menu_simulacion_recaudacion(); 
+			break;
+		case 7: 
+			menu_historial_placa(); 
+			break;
+		case 8: 
+			menu_reconstruir_proyecciones(); 
+			break;
+		case 9: 
+			menu_comparar_motores(); 
+			break;
+		case 10: 
+			mostrar_reporte_estados(); 
+			break;
+		case 11: 
+			menu_estadisticas(); 
+			break;
+		case 12: 
+			listar_pagos_ordenados(); 
+			break;
+		case 0: 
+			break;
+		default: 
+			printf("\n    ERROR: Opcion invalida. Intente de nuevo.\n");
+			pausar();
+		}
+	} while (opcion != 0);
+}
+
 /*
  * Funcion: mostrar_tarifas_vigentes
  * Descripcion: Muestra las tarifas actuales para matriculacion vehicular
@@ -555,36 +663,62 @@ void menu_vehiculos() {
  */
 
 void mostrar_tarifas_vigentes() {
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	const TablaTarifas* tarifas = lectura.tabla;
+	
 	limpiar_pantalla();
 	printf("===============================================\n");
 	printf("||                                           ||\n");
 	printf("||         TARIFAS VIGENTES PARA             ||\n");
-	printf("||           MATRICULACION 2025              ||\n");
+	printf("||           MATRICULACION %04d              ||\n", tarifas->ano_fiscal);
 	printf("||                                           ||\n");
 	printf("===============================================\n\n");
 	
 	printf("TASAS ANT (Agencia Nacional de Transito):\n");
-	printf(" Vehiculos Particulares:      $%.2f\n", TASA_ANT_PARTICULAR);
-	printf(" Vehiculos Comerciales:       $%.2f\n", TASA_ANT_COMERCIAL);
-	printf(" Motocicletas:                $%.2f\n", TASA_ANT_MOTOCICLETA);
+	printf(" Vehiculos Particulares:      $%.2f\n", tarifas->tasa_ant_particular);
+	printf(" Vehiculos Comerciales:       $%.2f\n", tarifas->tasa_ant_comercial);
+	printf(" Motocicletas:                $%.2f\n", tarifas->tasa_ant_motocicleta);
 	printf("\n");
 	
 	printf("TASAS PREFECTURA DE PICHINCHA:\n");
-	printf(" Vehiculos Particulares:      $%.2f\n", TASA_PREFECTURA_PARTICULAR);
-	printf(" Vehiculos Comerciales:       $%.2f\n", TASA_PREFECTURA_COMERCIAL);
-	printf(" Motocicletas:                $%.2f\n", TASA_PREFECTURA_MOTOCICLETA);
+	printf(" Vehiculos Particulares:      $%.2f\n", tarifas->tasa_prefectura_particular);
+	printf(" Vehiculos Comerciales:       $%.2f\n", tarifas->tasa_prefectura_comercial);
+	printf(" Motocicletas:                $%.2f\n", tarifas->tasa_prefectura_motocicleta);
 	printf("\n");
 	
+	// Provincias con tasas o recargo distintos a los de Pichincha
+	int encabezado = 0;
+	for (int p = 0; p < NUM_PROVINCIAS; p++) {
+		const TarifaProvincia* provincia = &tarifas->provincias[p];
+		if (provincia->recargo == 0.0 &&
+			provincia->tasa_prefectura[PREFECTURA_PARTICULAR] == tarifas->tasa_prefectura_particular &&
+			provincia->tasa_prefectura[PREFECTURA_COMERCIAL] == tarifas->tasa_prefectura_comercial &&
+			provincia->tasa_prefectura[PREFECTURA_MOTOCICLETA] == tarifas->tasa_prefectura_motocicleta) {
+			continue;
+		}
+		if (!encabezado) {
+			printf("TASAS PREFECTURA DE OTRAS PROVINCIAS (particular / comercial / moto + recargo):\n");
+			encabezado = 1;
+		}
+		printf(" %c %-18s $%.2f / $%.2f / $%.2f + $%.2f\n", 'A' + p, tarifas_nombre_provincia(p),
+			   provincia->tasa_prefectura[PREFECTURA_PARTICULAR], provincia->tasa_prefectura[PREFECTURA_COMERCIAL],
+			   provincia->tasa_prefectura[PREFECTURA_MOTOCICLETA], provincia->recargo);
+	}
+	if (encabezado) printf("\n");
+	
 	printf("REVISION TECNICA VEHICULAR (RTV):\n");
-	printf(" Vehiculos Livianos:          $%.2f\n", VALOR_RTV_LIVIANO);
-	printf(" Vehiculos Pesados:           $%.2f\n", VALOR_RTV_PESADO);
-	printf(" Motocicletas:                $%.2f\n", VALOR_RTV_MOTOCICLETA);
+	printf(" Vehiculos Livianos:          $%.2f\n", tarifas->valor_rtv_liviano);
+	printf(" Vehiculos Pesados:           $%.2f\n", tarifas->valor_rtv_pesado);
+	printf(" Motocicletas:                $%.2f\n", tarifas->valor_rtv_motocicleta);
 	printf("\n");
 	
 	printf("OTROS VALORES:\n");
-	printf(" Adhesivo (Sticker):          $%.2f\n", VALOR_ADHESIVO);
-	printf(" Recargo anual por mora:      %.1f%%\n", RECARGO_ANUAL_PORCENTAJE);
+	printf(" Adhesivo (Sticker):          $%.2f\n", tarifas->valor_adhesivo);
+	printf(" Recargo anual por mora:      %.1f%%\n", tarifas->recargo_anual_porcentaje);
+	printf(" Version de tarifas:          %u\n", tarifas->version);
 	printf("\n");
+	
+	tarifas_leer_fin(lectura);
 }
 
 // ===================================================================
@@ -595,13 +729,41 @@ void mostrar_tarifas_vigentes() {
  * Funcion: main
  * Descripcion: Funcion principal del programa. Controla el flujo general
  *              del sistema de matriculacion vehicular
- * Parametros: Ninguno
+ * Parametros: argc, argv - "--renew-all [--hilos N]" ejecuta la
+ *             renovacion anual en lote y "--simular [archivo]" la
+ *             simulacion de recaudacion, en lugar del menu
  * Retorno: 0 si el programa termina correctamente
  */
-int main() {
+int main(int argc, char* argv[]) {
 	// Configurar la codificacion de caracteres para caracteres especiales
 	setlocale(LC_ALL, "");
 	
+	// Cargar las tarifas de tarifas.cfg (si no existe, se usan las de fabrica)
+	tarifas_verificar_recarga();
+	
+	// Renovacion anual en lote: MiProyecto.exe --renew-all [--hilos N]
+	if (argc > 1 && strcmp(argv[1], ARGUMENTO_RENOVACION) == 0) {
+		int hilos = 0;
+		if (argc > 3 && strcmp(argv[2], "--hilos") == 0) {
+			hilos = atoi(argv[3]);
+		}
+		repositorio_iniciar();
+		int resultado = renovar_flota(hilos) ? 0 : 1;
+		repositorio_cerrar();
+		return resultado;
+	}
+	
+	// Simulacion de recaudacion: MiProyecto.exe --simular [escenarios.cfg]
+	if (argc > 1 && strcmp(argv[1], ARGUMENTO_SIMULACION) == 0) {
+		return ejecutar_simulacion(argc > 2 ? argv[2] : ARCHIVO_ESCENARIOS) ? 0 : 1;
+	}
+	
+	// matriculas_pagadas.txt con el formato anterior se migra mientras se inicia sesion
+	matriculas_pagadas_iniciar();
+	
+	// Motor de almacenamiento de almacen.cfg (texto, binario o sqlite)
+	repositorio_iniciar();
+	
 	// Bucle principal del programa
 	while (1) {
 		// Intentar iniciar sesion
@@ -614,5 +776,9 @@ int main() {
 		}
 	}
 	
+	repositorio_cerrar();
+	indice_comprobantes_cerrar();
+	conjuntos_estado_liberar();
+	matriculas_pagadas_finalizar();
 	return 0; // Terminar programa exitosamente
 }
@@ -0,0 +1,563 @@
+/*
+ * mapa_bits.c - Implementacion de los mapas de bits comprimidos
+ *
+ * Descripcion: Este archivo implementa los mapas de bits al estilo
+ *              "roaring", incluyendo:
+ *              - Contenedores de arreglo ordenado que pasan a 65536 bits
+ *                al superar MAX_ARREGLO_MAPA valores
+ *              - Interseccion, union y diferencia contenedor por
+ *                contenedor: dos arreglos se mezclan, un arreglo contra
+ *                bits se filtra y dos contenedores de bits se operan de a
+ *                una palabra de 64 bits
+ *              - Conteo de valores con popcount, sin armar el resultado
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "mapa_bits.h"
+
+#define OPERACION_Y 0
+#define OPERACION_O 1
+#define OPERACION_Y_NO 2
+
+// ===================================================================
+// BITS
+// ===================================================================
+
+/*
+ * Funcion: contar_bits
+ * Descripcion: Bits en 1 de una palabra (popcount)
+ */
+static int contar_bits(uint64_t palabra) {
+#ifdef __GNUC__
+	return __builtin_popcountll(palabra);
+#else
+	palabra = palabra - ((palabra >> 1) & 0x5555555555555555ull);
+	palabra = (palabra & 0x3333333333333333ull) + ((palabra >> 2) & 0x3333333333333333ull);
+	palabra = (palabra + (palabra >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return (int)((palabra * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/*
+ * Funcion: bit_mas_bajo
+ * Descripcion: Posicion del bit en 1 mas bajo de una palabra distinta de 0
+ */
+static int bit_mas_bajo(uint64_t palabra) {
+#ifdef __GNUC__
+	return __builtin_ctzll(palabra);
+#else
+	return contar_bits((palabra & (~palabra + 1)) - 1);
+#endif
+}
+
+// ===================================================================
+// CONTENEDORES
+// ===================================================================
+
+static void liberar_contenedor(ContenedorMapa* contenedor) {
+	free(contenedor->valores);
+	free(contenedor->bits);
+}
+
+/*
+ * Funcion: cota_valor
+ * Descripcion: Primera posicion de un arreglo con valor mayor o igual
+ */
+static int cota_valor(const uint16_t* valores, int cantidad, uint16_t valor) {
+	int bajo = 0, alto = cantidad;
+	while (bajo < alto) {
+		int medio = (bajo + alto) / 2;
+		if (valores[medio] < valor) {
+			bajo = medio + 1;
+		} else {
+			alto = medio;
+		}
+	}
+	return bajo;
+}
+
+static int contenedor_contiene(const ContenedorMapa* contenedor, uint16_t bajo) {
+	if (contenedor->tipo == CONTENEDOR_BITS) {
+		return (contenedor->bits[bajo >> 6] >> (bajo & 63)) & 1;
+	}
+	int posicion = cota_valor(contenedor->valores, contenedor->cardinalidad, bajo);
+	return posicion < contenedor->cardinalidad && contenedor->valores[posicion] == bajo;
+}
+
+/*
+ * Funcion: cargar_palabras
+ * Descripcion: Copia un contenedor (de cualquier tipo) como 65536 bits
+ */
+static void cargar_palabras(const ContenedorMapa* contenedor, uint64_t* palabras) {
+	if (contenedor->tipo == CONTENEDOR_BITS) {
+		memcpy(palabras, contenedor->bits, PALABRAS_CONTENEDOR * sizeof(uint64_t));
+		return;
+	}
+	memset(palabras, 0, PALABRAS_CONTENEDOR * sizeof(uint64_t));
+	for (int i = 0; i < contenedor->cardinalidad; i++) {
+		uint16_t valor = contenedor->valores[i];
+		palabras[valor >> 6] |= 1ull << (valor & 63);
+	}
+}
+
+/*
+ * Funcion: contenedor_de_valores
+ * Descripcion: Arma un contenedor de arreglo con valores ya ordenados
+ */
+static int contenedor_de_valores(ContenedorMapa* contenedor, uint16_t alto, const uint16_t* valores, int cantidad) {
+	memset(contenedor, 0, sizeof(*contenedor));
+	contenedor->alto = alto;
+	contenedor->tipo = CONTENEDOR_ARREGLO;
+	contenedor->cardinalidad = cantidad;
+	contenedor->capacidad = cantidad;
+	if (cantidad == 0) return 1;
+
+	contenedor->valores = malloc((size_t)cantidad * sizeof(uint16_t));
+	if (!contenedor->valores) return 0;
+	memcpy(contenedor->valores, valores, (size_t)cantidad * sizeof(uint16_t));
+	return 1;
+}
+
+/*
+ * Funcion: contenedor_de_palabras
+ * Descripcion: Arma un contenedor con 65536 bits. Si quedan pocos valores
+ *              se guarda como arreglo
+ */
+static int contenedor_de_palabras(ContenedorMapa* contenedor, uint16_t alto, const uint64_t* palabras) {
+	int cardinalidad = 0;
+	for (int i = 0; i < PALABRAS_CONTENEDOR; i++) {
+		cardinalidad += contar_bits(palabras[i]);
+	}
+
+	if (cardinalidad <= MAX_ARREGLO_MAPA) {
+		uint16_t valores[MAX_ARREGLO_MAPA];
+		int cantidad = 0;
+		for (int i = 0; i < PALABRAS_CONTENEDOR; i++) {
+			for (uint64_t palabra = palabras[i]; palabra; palabra &= palabra - 1) {
+				valores[cantidad++] = (uint16_t)(i * 64 + bit_mas_bajo(palabra));
+			}
+		}
+		return contenedor_de_valores(contenedor, alto, valores, cantidad);
+	}
+
+	memset(contenedor, 0, sizeof(*contenedor));
+	contenedor->alto = alto;
+	contenedor->tipo = CONTENEDOR_BITS;
+	contenedor->cardinalidad = cardinalidad;
+	contenedor->bits = malloc(PALABRAS_CONTENEDOR * sizeof(uint64_t));
+	if (!contenedor->bits) return 0;
+	memcpy(contenedor->bits, palabras, PALABRAS_CONTENEDOR * sizeof(uint64_t));
+	return 1;
+}
+
+/*
+ * Funcion: copiar_contenedor
+ * Descripcion: Copia un contenedor de un mapa a otro
+ */
+static int copiar_contenedor(ContenedorMapa* destino, const ContenedorMapa* origen) {
+	if (origen->tipo == CONTENEDOR_BITS) {
+		return contenedor_de_palabras(destino, origen->alto, origen->bits);
+	}
+	return contenedor_de_valores(destino, origen->alto, origen->valores, origen->cardinalidad);
+}
+
+/*
+ * Funcion: pasar_a_bits
+ * Descripcion: Convierte un contenedor de arreglo lleno en uno de bits
+ */
+static int pasar_a_bits(ContenedorMapa* contenedor) {
+	uint64_t* bits = malloc(PALABRAS_CONTENEDOR * sizeof(uint64_t));
+	if (!bits) return 0;
+	cargar_palabras(contenedor, bits);
+	free(contenedor->valores);
+	contenedor->valores = NULL;
+	contenedor->capacidad = 0;
+	contenedor->bits = bits;
+	contenedor->tipo = CONTENEDOR_BITS;
+	return 1;
+}
+
+/*
+ * Funcion: operar_arreglos
+ * Descripcion: Mezcla dos arreglos ordenados segun la operacion
+ * Retorno: Cantidad de valores escritos en destino
+ */
+static int operar_arreglos(const ContenedorMapa* a, const ContenedorMapa* b, int operacion, uint16_t* destino) {
+	int i = 0, j = 0, cantidad = 0;
+	while (i < a->cardinalidad && j < b->cardinalidad) {
+		if (a->valores[i] < b->valores[j]) {
+			if (operacion != OPERACION_Y) destino[cantidad++] = a->valores[i];
+			i++;
+		} else if (a->valores[i] > b->valores[j]) {
+			if (operacion == OPERACION_O) destino[cantidad++] = b->valores[j];
+			j++;
+		} else {
+			if (operacion != OPERACION_Y_NO) destino[cantidad++] = a->valores[i];
+			i++;
+			j++;
+		}
+	}
+	if (operacion != OPERACION_Y) {
+		while (i < a->cardinalidad) destino[cantidad++] = a->valores[i++];
+	}
+	if (operacion == OPERACION_O) {
+		while (j < b->cardinalidad) destino[cantidad++] = b->valores[j++];
+	}
+	return cantidad;
+}
+
+/*
+ * Funcion: filtrar_arreglo
+ * Descripcion: Valores de un arreglo que estan (o no estan) en otro
+ *              contenedor
+ */
+static int filtrar_arreglo(const ContenedorMapa* arreglo, const ContenedorMapa* otro, int presentes, uint16_t* destino) {
+	int cantidad = 0;
+	for (int i = 0; i < arreglo->cardinalidad; i++) {
+		if (contenedor_contiene(otro, arreglo->valores[i]) == presentes) {
+			destino[cantidad++] = arreglo->valores[i];
+		}
+	}
+	return cantidad;
+}
+
+/*
+ * Funcion: operar_contenedores
+ * Descripcion: Aplica una operacion a dos contenedores con los mismos 16
+ *              bits altos. Los casos con un arreglo se resuelven sobre el
+ *              arreglo; el resto palabra por palabra
+ */
+static int operar_contenedores(const ContenedorMapa* a, const ContenedorMapa* b, int operacion,
+							   ContenedorMapa* resultado) {
+	uint16_t valores[2 * MAX_ARREGLO_MAPA];
+
+	if (a->tipo == CONTENEDOR_ARREGLO && b->tipo == CONTENEDOR_ARREGLO) {
+		int cantidad = operar_arreglos(a, b, operacion, valores);
+		if (cantidad <= MAX_ARREGLO_MAPA) {
+			return contenedor_de_valores(resultado, a->alto, valores, cantidad);
+		}
+	} else if (a->tipo == CONTENEDOR_ARREGLO && operacion != OPERACION_O) {
+		int cantidad = filtrar_arreglo(a, b, operacion == OPERACION_Y, valores);
+		return contenedor_de_valores(resultado, a->alto, valores, cantidad);
+	} else if (b->tipo == CONTENEDOR_ARREGLO && operacion == OPERACION_Y) {
+		int cantidad = filtrar_arreglo(b, a, 1, valores);
+		return contenedor_de_valores(resultado, a->alto, valores, cantidad);
+	}
+
+	uint64_t palabras[PALABRAS_CONTENEDOR];
+	cargar_palabras(a, palabras);
+	if (b->tipo == CONTENEDOR_BITS) {
+		for (int i = 0; i < PALABRAS_CONTENEDOR; i++) {
+			if (operacion == OPERACION_Y) {
+				palabras[i] &= b->bits[i];
+			} else if (operacion == OPERACION_O) {
+				palabras[i] |= b->bits[i];
+			} else {
+				palabras[i] &= ~b->bits[i];
+			}
+		}
+	} else {
+		for (int i = 0; i < b->cardinalidad; i++) {
+			uint16_t valor = b->valores[i];
+			if (operacion == OPERACION_O) {
+				palabras[valor >> 6] |= 1ull << (valor & 63);
+			} else {
+				palabras[valor >> 6] &= ~(1ull << (valor & 63));
+			}
+		}
+	}
+	return contenedor_de_palabras(resultado, a->alto, palabras);
+}
+
+// ===================================================================
+// FUNCIONES DEL MAPA
+// ===================================================================
+
+/*
+ * Funcion: reservar_contenedores
+ * Descripcion: Asegura lugar para un contenedor mas
+ */
+static int reservar_contenedores(MapaBits* mapa) {
+	if (mapa->cantidad < mapa->capacidad) return 1;
+	int capacidad = mapa->capacidad ? mapa->capacidad * 2 : 4;
+	ContenedorMapa* contenedores = realloc(mapa->contenedores, (size_t)capacidad * sizeof(ContenedorMapa));
+	if (!contenedores) return 0;
+	mapa->contenedores = contenedores;
+	mapa->capacidad = capacidad;
+	return 1;
+}
+
+/*
+ * Funcion: buscar_contenedor
+ * Descripcion: Busca el contenedor de unos 16 bits altos
+ * Retorno: Posicion del contenedor, o -(posicion donde iria + 1)
+ */
+static int buscar_contenedor(const MapaBits* mapa, uint16_t alto) {
+	int bajo = 0, tope = mapa->cantidad;
+	while (bajo < tope) {
+		int medio = (bajo + tope) / 2;
+		if (mapa->contenedores[medio].alto < alto) {
+			bajo = medio + 1;
+		} else {
+			tope = medio;
+		}
+	}
+	if (bajo < mapa->cantidad && mapa->contenedores[bajo].alto == alto) return bajo;
+	return -(bajo + 1);
+}
+
+/*
+ * Funcion: agregar_resultado
+ * Descripcion: Agrega al final de un mapa un contenedor armado por una
+ *              operacion (los vacios se descartan)
+ */
+static int agregar_resultado(MapaBits* mapa, ContenedorMapa* contenedor) {
+	if (contenedor->cardinalidad == 0) {
+		liberar_contenedor(contenedor);
+		return 1;
+	}
+	if (!reservar_contenedores(mapa)) {
+		liberar_contenedor(contenedor);
+		return 0;
+	}
+	mapa->contenedores[mapa->cantidad++] = *contenedor;
+	return 1;
+}
+
+/*
+ * Funcion: mapa_iniciar
+ * Descripcion: Deja un mapa vacio
+ * Parametros: mapa
+ * Retorno: void
+ */
+void mapa_iniciar(MapaBits* mapa) {
+	mapa->contenedores = NULL;
+	mapa->cantidad = 0;
+	mapa->capacidad = 0;
+}
+
+/*
+ * Funcion: mapa_liberar
+ * Descripcion: Libera la memoria de un mapa y lo deja vacio
+ * Parametros: mapa
+ * Retorno: void
+ */
+void mapa_liberar(MapaBits* mapa) {
+	for (int i = 0; i < mapa->cantidad; i++) {
+		liberar_contenedor(&mapa->contenedores[i]);
+	}
+	free(mapa->contenedores);
+	mapa_iniciar(mapa);
+}
+
+/*
+ * Funcion: mapa_agregar
+ * Descripcion: Agrega un valor al conjunto. Agregar en orden creciente es
+ *              lo mas rapido: cada valor va al final de su contenedor
+ * Parametros: mapa, valor
+ * Retorno: 1 si fue exitoso, 0 si falto memoria
+ */
+int mapa_agregar(MapaBits* mapa, uint32_t valor) {
+	uint16_t alto = (uint16_t)(valor >> 16), bajo = (uint16_t)(valor & 0xffff);
+	int i = buscar_contenedor(mapa, alto);
+	if (i < 0) {
+		i = -i - 1;
+		if (!reservar_contenedores(mapa)) return 0;
+		memmove(&mapa->contenedores[i + 1], &mapa->contenedores[i],
+				(size_t)(mapa->cantidad - i) * sizeof(ContenedorMapa));
+		contenedor_de_valores(&mapa->contenedores[i], alto, NULL, 0);
+		mapa->cantidad++;
+	}
+
+	ContenedorMapa* contenedor = &mapa->contenedores[i];
+	if (contenedor->tipo == CONTENEDOR_BITS) {
+		uint64_t mascara = 1ull << (bajo & 63);
+		if (!(contenedor->bits[bajo >> 6] & mascara)) {
+			contenedor->bits[bajo >> 6] |= mascara;
+			contenedor->cardinalidad++;
+		}
+		return 1;
+	}
+
+	int posicion = cota_valor(contenedor->valores, contenedor->cardinalidad, bajo);
+	if (posicion < contenedor->cardinalidad && contenedor->valores[posicion] == bajo) return 1;
+	if (contenedor->cardinalidad == MAX_ARREGLO_MAPA) {
+		return pasar_a_bits(contenedor) && mapa_agregar(mapa, valor);
+	}
+	if (contenedor->cardinalidad == contenedor->capacidad) {
+		int capacidad = contenedor->capacidad ? contenedor->capacidad * 2 : 4;
+		if (capacidad > MAX_ARREGLO_MAPA) capacidad = MAX_ARREGLO_MAPA;
+		uint16_t* valores = realloc(contenedor->valores, (size_t)capacidad * sizeof(uint16_t));
+		if (!valores) return 0;
+		contenedor->valores = valores;
+		contenedor->capacidad = capacidad;
+	}
+	memmove(&contenedor->valores[posicion + 1], &contenedor->valores[posicion],
+			(size_t)(contenedor->cardinalidad - posicion) * sizeof(uint16_t));
+	contenedor->valores[posicion] = bajo;
+	contenedor->cardinalidad++;
+	return 1;
+}
+
+/*
+ * Funcion: mapa_contiene
+ * Descripcion: Indica si un valor esta en el conjunto
+ * Parametros: mapa, valor
+ * Retorno: 1 si esta, 0 si no
+ */
+int mapa_contiene(const MapaBits* mapa, uint32_t valor) {
+	int i = buscar_contenedor(mapa, (uint16_t)(valor >> 16));
+	return i >= 0 && contenedor_contiene(&mapa->contenedores[i], (uint16_t)(valor & 0xffff));
+}
+
+/*
+ * Funcion: mapa_cardinalidad
+ * Descripcion: Cantidad de valores del conjunto
+ * Parametros: mapa
+ * Retorno: Cantidad de valores
+ */
+long mapa_cardinalidad(const MapaBits* mapa) {
+	long total = 0;
+	for (int i = 0; i < mapa->cantidad; i++) {
+		total += mapa->contenedores[i].cardinalidad;
+	}
+	return total;
+}
+
+/*
+ * Funcion: mapa_recorrer
+ * Descripcion: Entrega los valores del conjunto en orden creciente
+ * Parametros: mapa, funcion, contexto
+ * Retorno: Valores entregados
+ */
+long mapa_recorrer(const MapaBits* mapa, FuncionValorMapa funcion, void* contexto) {
+	long entregados = 0;
+	for (int i = 0; i < mapa->cantidad; i++) {
+		const ContenedorMapa* contenedor = &mapa->contenedores[i];
+		uint32_t base = (uint32_t)contenedor->alto << 16;
+		if (contenedor->tipo == CONTENEDOR_ARREGLO) {
+			for (int j = 0; j < contenedor->cardinalidad; j++) {
+				entregados++;
+				if (!funcion(base | contenedor->valores[j], contexto)) return entregados;
+			}
+			continue;
+		}
+		for (int p = 0; p < PALABRAS_CONTENEDOR; p++) {
+			for (uint64_t palabra = contenedor->bits[p]; palabra; palabra &= palabra - 1) {
+				entregados++;
+				if (!funcion(base | (uint32_t)(p * 64 + bit_mas_bajo(palabra)), contexto)) return entregados;
+			}
+		}
+	}
+	return entregados;
+}
+
+/*
+ * Funcion: operar_mapas
+ * Descripcion: Recorre los contenedores de los dos mapas en orden y arma
+ *              el resultado de la operacion
+ */
+static int operar_mapas(const MapaBits* a, const MapaBits* b, int operacion, MapaBits* resultado) {
+	int i = 0, j = 0;
+	mapa_iniciar(resultado);
+	while (i < a->cantidad || j < b->cantidad) {
+		const ContenedorMapa* de_a = (i < a->cantidad) ? &a->contenedores[i] : NULL;
+		const ContenedorMapa* de_b = (j < b->cantidad) ? &b->contenedores[j] : NULL;
+		ContenedorMapa contenedor;
+		int exito = 1;
+
+		if (!de_b || (de_a && de_a->alto < de_b->alto)) {
+			// Solo en a: queda salvo en la interseccion
+			if (operacion != OPERACION_Y) exito = copiar_contenedor(&contenedor, de_a) && agregar_resultado(resultado, &contenedor);
+			i++;
+		} else if (!de_a || de_b->alto < de_a->alto) {
+			// Solo en b: queda solo en la union
+			if (operacion == OPERACION_O) exito = copiar_contenedor(&contenedor, de_b) && agregar_resultado(resultado, &contenedor);
+			j++;
+		} else {
+			exito = operar_contenedores(de_a, de_b, operacion, &contenedor) && agregar_resultado(resultado, &contenedor);
+			i++;
+			j++;
+		}
+
+		if (!exito) {
+			mapa_liberar(resultado);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Funcion: mapa_y
+ * Descripcion: Interseccion de dos conjuntos (a AND b)
+ * Parametros: a, b, resultado - Mapa nuevo (se inicia aqui)
+ * Retorno: 1 si fue exitoso, 0 si falto memoria
+ */
+int mapa_y(const MapaBits* a, const MapaBits* b, MapaBits* resultado) {
+	return operar_mapas(a, b, OPERACION_Y, resultado);
+}
+
+/*
+ * Funcion: mapa_o
+ * Descripcion: Union de dos conjuntos (a OR b)
+ * Parametros: a, b, resultado - Mapa nuevo (se inicia aqui)
+ * Retorno: 1 si fue exitoso, 0 si falto memoria
+ */
+int mapa_o(const MapaBits* a, const MapaBits* b, MapaBits* resultado) {
+	return operar_mapas(a, b, OPERACION_O, resultado);
+}
+
+/*
+ * Funcion: mapa_y_no
+ * Descripcion: Valores de a que no estan en b (a ANDNOT b)
+ * Parametros: a, b, resultado - Mapa nuevo (se inicia aqui)
+ * Retorno: 1 si fue exitoso, 0 si falto memoria
+ */
+int mapa_y_no(const MapaBits* a, const MapaBits* b, MapaBits* resultado) {
+	return operar_mapas(a, b, OPERACION_Y_NO, resultado);
+}
+
+/*
+ * Funcion: mapa_cardinalidad_y
+ * Descripcion: Cantidad de valores de la interseccion sin armarla: dos
+ *              contenedores de bits se cuentan con popcount y un arreglo
+ *              se busca en el otro contenedor
+ * Parametros: a, b
+ * Retorno: Cantidad de valores en a AND b
+ */
+long mapa_cardinalidad_y(const MapaBits* a, const MapaBits* b) {
+	long total = 0;
+	int i = 0, j = 0;
+	while (i < a->cantidad && j < b->cantidad) {
+		const ContenedorMapa* de_a = &a->contenedores[i];
+		const ContenedorMapa* de_b = &b->contenedores[j];
+		if (de_a->alto < de_b->alto) {
+			i++;
+			continue;
+		}
+		if (de_b->alto < de_a->alto) {
+			j++;
+			continue;
+		}
+
+		if (de_a->tipo == CONTENEDOR_BITS && de_b->tipo == CONTENEDOR_BITS) {
+			for (int p = 0; p < PALABRAS_CONTENEDOR; p++) {
+				total += contar_bits(de_a->bits[p] & de_b->bits[p]);
+			}
+		} else {
+			const ContenedorMapa* arreglo = (de_a->tipo == CONTENEDOR_ARREGLO) ? de_a : de_b;
+			const ContenedorMapa* otro = (arreglo == de_a) ? de_b : de_a;
+			for (int k = 0; k < arreglo->cardinalidad; k++) {
+				total += contenedor_contiene(otro, arreglo->valores[k]);
+			}
+		}
+		i++;
+		j++;
+	}
+	return total;
+}
@@ -0,0 +1,84 @@
+/*
+ * mapa_bits.h - Libreria de mapas de bits comprimidos
+ *
+ * Descripcion: Este archivo contiene las estructuras y prototipos de un
+ *              mapa de bits comprimido al estilo "roaring" para conjuntos
+ *              de enteros de 32 bits. Los valores se agrupan por sus 16
+ *              bits altos; cada grupo es un contenedor que guarda los 16
+ *              bits bajos como un arreglo ordenado (pocos valores) o como
+ *              65536 bits (muchos valores). Asi un conjunto disperso ocupa
+ *              poco y uno denso se opera de a 64 valores por palabra.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef MAPA_BITS_H
+#define MAPA_BITS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// ===================================================================
+// CONSTANTES DEL MAPA
+// ===================================================================
+
+#define CONTENEDOR_ARREGLO 0
+#define CONTENEDOR_BITS 1
+
+#define MAX_ARREGLO_MAPA 4096            // Con mas valores el arreglo ocupa mas que los bits
+#define PALABRAS_CONTENEDOR 1024         // 65536 bits en palabras de 64
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: ContenedorMapa
+ * Descripcion: Valores de un mapa que comparten los 16 bits altos
+ */
+typedef struct {
+	uint16_t alto;               // 16 bits altos comunes
+	uint16_t tipo;               // CONTENEDOR_ARREGLO o CONTENEDOR_BITS
+	int cardinalidad;
+	int capacidad;               // Valores reservados en el arreglo
+	uint16_t* valores;           // 16 bits bajos en orden (CONTENEDOR_ARREGLO)
+	uint64_t* bits;              // PALABRAS_CONTENEDOR palabras (CONTENEDOR_BITS)
+} ContenedorMapa;
+
+/*
+ * Estructura: MapaBits
+ * Descripcion: Conjunto de enteros de 32 bits
+ */
+typedef struct {
+	ContenedorMapa* contenedores;    // En orden por 'alto'
+	int cantidad;
+	int capacidad;
+} MapaBits;
+
+// Funcion llamada por cada valor al recorrer un mapa (0 = detener)
+typedef int (*FuncionValorMapa)(uint32_t valor, void* contexto);
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones basicas
+void mapa_iniciar(MapaBits* mapa);
+void mapa_liberar(MapaBits* mapa);
+int mapa_agregar(MapaBits* mapa, uint32_t valor);
+int mapa_contiene(const MapaBits* mapa, uint32_t valor);
+long mapa_cardinalidad(const MapaBits* mapa);
+long mapa_recorrer(const MapaBits* mapa, FuncionValorMapa funcion, void* contexto);
+
+// Operaciones de conjuntos (el resultado es un mapa nuevo, distinto de a y b)
+int mapa_y(const MapaBits* a, const MapaBits* b, MapaBits* resultado);
+int mapa_o(const MapaBits* a, const MapaBits* b, MapaBits* resultado);
+int mapa_y_no(const MapaBits* a, const MapaBits* b, MapaBits* resultado);
+long mapa_cardinalidad_y(const MapaBits* a, const MapaBits* b);
+
+#endif // MAPA_BITS_H
@@ -17,6 +17,8 @@
 #include "matricula.h" 
 #include "vehiculos.h"    // Necesario para obtener datos del vehiculo
 #include "pagos.h"        // Necesario para guardar comprobantes en sistema de pagos
+#include "plantillas.h"   // Plantillas precompiladas para comprobantes en archivo
+#include "almacen_documentos.h" // Archivo empaquetado de comprobantes
 #include <stdio.h>   
 #include <string.h>   
 #include <stdlib.h>
@@ -33,145 +35,159 @@
  * Funcion: calcular_impuesto_propiedad
  * Descripcion: Calcula el impuesto a la propiedad vehicular segun SRI
  *              Solo se aplica si el avaluo supera el limite establecido
- * Parametros: avaluo - Valor comercial del vehiculo
- * Retorno: Monto del impuesto a pagar (0 si no aplica)
+ * Parametros: tarifas - Tabla de tarifas, avaluo - Valor comercial del vehiculo
+ * Retorno: Monto del impuesto a pagar en centavos (0 si no aplica)
  */
-double calcular_impuesto_propiedad(double avaluo) {
-	if (avaluo > LIMITE_PROPIEDAD) {
-		return (avaluo - LIMITE_PROPIEDAD) * (PORCENTAJE_PROPIEDAD / 100.0);
+Dinero calcular_impuesto_propiedad(const TablaTarifas* tarifas, Dinero avaluo) {
+	Dinero limite = dinero_desde_decimal(tarifas->limite_propiedad);
+	if (avaluo > limite) {
+		return dinero_porcentaje(avaluo - limite, tasa_desde_porcentaje(tarifas->porcentaje_propiedad));
 	}
-	return 0.0;
+	return 0;
 }
 
 /*
  * Funcion: calcular_impuesto_rodaje
  * Descripcion: Calcula el impuesto de rodaje vehicular segun AMT
  *              Solo se aplica si el avaluo supera el limite establecido
- * Parametros: avaluo - Valor comercial del vehiculo
- * Retorno: Monto del impuesto a pagar (0 si no aplica)
+ * Parametros: tarifas - Tabla de tarifas, avaluo - Valor comercial del vehiculo
+ * Retorno: Monto del impuesto a pagar en centavos (0 si no aplica)
  */
-double calcular_impuesto_rodaje(double avaluo) {
-	if (avaluo > LIMITE_RODAJE) {
-		return (avaluo - LIMITE_RODAJE) * (PORCENTAJE_RODAJE / 100.0);
+Dinero calcular_impuesto_rodaje(const TablaTarifas* tarifas, Dinero avaluo) {
+	Dinero limite = dinero_desde_decimal(tarifas->limite_rodaje);
+	if (avaluo > limite) {
+		return dinero_porcentaje(avaluo - limite, tasa_desde_porcentaje(tarifas->porcentaje_rodaje));
 	}
-	return 0.0;
+	return 0;
 }
 
 /*
  * Funcion: calcular_tasa_sppat
  * Descripcion: Calcula la tasa SPPAT segun el tipo de vehiculo y cilindraje
  * Parametros: 
+ *   - tarifas: Tabla de tarifas en uso
  *   - tipo: Tipo de vehiculo (PARTICULAR/COMERCIAL)
  *   - subtipo: Subtipo (LIVIANO/PESADO/MOTOCICLETA)
  *   - cilindraje: Cilindraje del motor en cc
- * Retorno: Monto de la tasa SPPAT
+ * Retorno: Monto de la tasa SPPAT en centavos
  */
 
-double calcular_tasa_sppat(char* tipo, char* subtipo, int cilindraje) {
+Dinero calcular_tasa_sppat(const TablaTarifas* tarifas, const char* tipo, const char* subtipo, int cilindraje) {
 	// Verificar si es motocicleta
 	if (strcmp(subtipo, "MOTOCICLETA") == 0) {
-		return (cilindraje <= 200) ? SPPAT_MOTO_HASTA_200 : SPPAT_MOTO_MAS_200;
+		return dinero_desde_decimal((cilindraje <= 200) ? tarifas->sppat_moto_hasta_200 : tarifas->sppat_moto_mas_200);
 	}
 	
 	// Verificar si es vehiculo comercial
-	if (strcmp(tipo, "COMERCIAL") == 0) return SPPAT_COMERCIAL;
+	if (strcmp(tipo, "COMERCIAL") == 0) return dinero_desde_decimal(tarifas->sppat_comercial);
 	
 	// Verificar si es vehiculo pesado
-	if (strcmp(subtipo, "PESADO") == 0) return SPPAT_PESADO;
+	if (strcmp(subtipo, "PESADO") == 0) return dinero_desde_decimal(tarifas->sppat_pesado);
 	
 	// Para vehiculos livianos, aplicar segun cilindraje
-	if (cilindraje <= 1500) return SPPAT_LIVIANO_HASTA_1500;
-	if (cilindraje <= 2500) return SPPAT_LIVIANO_1501_2500;
-	return SPPAT_LIVIANO_MAS_2500;
+	if (cilindraje <= 1500) return dinero_desde_decimal(tarifas->sppat_liviano_hasta_1500);
+	if (cilindraje <= 2500) return dinero_desde_decimal(tarifas->sppat_liviano_1501_2500);
+	return dinero_desde_decimal(tarifas->sppat_liviano_mas_2500);
 }
 
 /*
  * Funcion: calcular_tasa_ant
  * Descripcion: Calcula la tasa ANT segun el tipo de vehiculo
  * Parametros:
+ *   - tarifas: Tabla de tarifas en uso
  *   - tipo: Tipo de vehiculo (PARTICULAR/COMERCIAL)
  *   - subtipo: Subtipo (LIVIANO/PESADO/MOTOCICLETA)
- * Retorno: Monto de la tasa ANT
+ * Retorno: Monto de la tasa ANT en centavos
  */
-double calcular_tasa_ant(char* tipo, char* subtipo) {
-	if (strcmp(subtipo, "MOTOCICLETA") == 0) return TASA_ANT_MOTOCICLETA;
-	if (strcmp(tipo, "COMERCIAL") == 0) return TASA_ANT_COMERCIAL;
-	return TASA_ANT_PARTICULAR;
+Dinero calcular_tasa_ant(const TablaTarifas* tarifas, const char* tipo, const char* subtipo) {
+	if (strcmp(subtipo, "MOTOCICLETA") == 0) return dinero_desde_decimal(tarifas->tasa_ant_motocicleta);
+	if (strcmp(tipo, "COMERCIAL") == 0) return dinero_desde_decimal(tarifas->tasa_ant_comercial);
+	return dinero_desde_decimal(tarifas->tasa_ant_particular);
 }
 
 /*
  * Funcion: calcular_tasa_prefectura
- * Descripcion: Calcula la tasa de prefectura segun el tipo de vehiculo
+ * Descripcion: Calcula la tasa de prefectura segun el tipo de vehiculo y
+ *              la provincia de la placa (primera letra), incluyendo el
+ *              recargo provincial
  * Parametros:
+ *   - tarifas: Tabla de tarifas en uso
  *   - tipo: Tipo de vehiculo (PARTICULAR/COMERCIAL)
  *   - subtipo: Subtipo (LIVIANO/PESADO/MOTOCICLETA)
- * Retorno: Monto de la tasa de prefectura
+ *   - placa: Placa del vehiculo
+ * Retorno: Monto de la tasa de prefectura en centavos
  */
-double calcular_tasa_prefectura(char* tipo, char* subtipo) {
-	if (strcmp(subtipo, "MOTOCICLETA") == 0) return TASA_PREFECTURA_MOTOCICLETA;
-	if (strcmp(tipo, "COMERCIAL") == 0) return TASA_PREFECTURA_COMERCIAL;
-	return TASA_PREFECTURA_PARTICULAR;
+Dinero calcular_tasa_prefectura(const TablaTarifas* tarifas, const char* tipo, const char* subtipo, const char* placa) {
+	const TarifaProvincia* provincia = &tarifas->provincias[tarifas_indice_provincia(placa)];
+	int categoria = PREFECTURA_PARTICULAR;
+	if (strcmp(subtipo, "MOTOCICLETA") == 0) categoria = PREFECTURA_MOTOCICLETA;
+	else if (strcmp(tipo, "COMERCIAL") == 0) categoria = PREFECTURA_COMERCIAL;
+	return dinero_desde_decimal(provincia->tasa_prefectura[categoria]) + dinero_desde_decimal(provincia->recargo);
 }
 
 /*
  * Funcion: calcular_valor_rtv
  * Descripcion: Calcula el valor de revision tecnica vehicular segun subtipo
- * Parametros: subtipo - Subtipo del vehiculo (LIVIANO/PESADO/MOTOCICLETA)
- * Retorno: Monto del valor RTV
+ * Parametros: tarifas - Tabla de tarifas, subtipo - Subtipo del vehiculo (LIVIANO/PESADO/MOTOCICLETA)
+ * Retorno: Monto del valor RTV en centavos
  */
-double calcular_valor_rtv(char* subtipo) {
-	if (strcmp(subtipo, "MOTOCICLETA") == 0) return VALOR_RTV_MOTOCICLETA;
-	if (strcmp(subtipo, "PESADO") == 0) return VALOR_RTV_PESADO;
-	return VALOR_RTV_LIVIANO;
+Dinero calcular_valor_rtv(const TablaTarifas* tarifas, const char* subtipo) {
+	if (strcmp(subtipo, "MOTOCICLETA") == 0) return dinero_desde_decimal(tarifas->valor_rtv_motocicleta);
+	if (strcmp(subtipo, "PESADO") == 0) return dinero_desde_decimal(tarifas->valor_rtv_pesado);
+	return dinero_desde_decimal(tarifas->valor_rtv_liviano);
 }
 
 /*
  * Funcion: calcular_recargos_mora
  * Descripcion: Calcula los recargos por mora en pagos de impuestos
  * Parametros:
+ *   - tarifas: Tabla de tarifas en uso
  *   - impuesto_propiedad: Monto del impuesto a la propiedad
  *   - impuesto_rodaje: Monto del impuesto de rodaje
  *   - meses_retraso: Numero de meses de retraso en el pago
- * Retorno: Monto total de recargos por mora
+ * Retorno: Monto total de recargos por mora en centavos
  */
 
-double calcular_recargos_mora(double impuesto_propiedad, double impuesto_rodaje, int meses_retraso) {
-	if (meses_retraso <= 0) return 0.0;
+Dinero calcular_recargos_mora(const TablaTarifas* tarifas, Dinero impuesto_propiedad, Dinero impuesto_rodaje, int meses_retraso) {
+	if (meses_retraso <= 0) return 0;
 	
 	// Calcular base sobre la cual se aplican recargos
-	double base_calculo = impuesto_propiedad + impuesto_rodaje;
+	Dinero base_calculo = impuesto_propiedad + impuesto_rodaje;
 	
-	// Calcular recargo anual y convertir a mensual
-	double recargo_anual = base_calculo * (RECARGO_ANUAL_PORCENTAJE / 100.0);
-	return (recargo_anual / 12.0) * meses_retraso;
+	// Recargo anual prorrateado por meses, redondeado una sola vez
+	TasaDinero tasa_anual = tasa_desde_porcentaje(tarifas->recargo_anual_porcentaje);
+	return dinero_escalar(base_calculo, tasa_anual * meses_retraso, (int64_t)ESCALA_TASA * 12);
 }
 
 /*
- * Funcion: calcular_matricula_completa
+ * Funcion: calcular_matricula_con_tarifas
  * Descripcion: Realiza el calculo completo de matricula vehicular
- *              incluyendo todos los impuestos, tasas y recargos
- * Parametros: vehiculo - Estructura con datos del vehiculo
+ *              incluyendo todos los impuestos, tasas y recargos, usando
+ *              una sola tabla de tarifas para todo el calculo
+ * Parametros:
+ *   - vehiculo: Estructura con datos del vehiculo
+ *   - tarifas: Tabla de tarifas (obtenida con tarifas_leer_inicio)
  * Retorno: Estructura con todos los valores calculados
  */
-ResultadoMatricula calcular_matricula_completa(DatosVehiculo vehiculo) {
+ResultadoMatricula calcular_matricula_con_tarifas(const DatosVehiculo* vehiculo, const TablaTarifas* tarifas) {
 	ResultadoMatricula res = {0};
 	
 	// Calcular impuestos
-	res.impuesto_propiedad = calcular_impuesto_propiedad(vehiculo.avaluo);
-	res.impuesto_rodaje = calcular_impuesto_rodaje(vehiculo.avaluo);
+	res.impuesto_propiedad = calcular_impuesto_propiedad(tarifas, vehiculo->avaluo);
+	res.impuesto_rodaje = calcular_impuesto_rodaje(tarifas, vehiculo->avaluo);
 	
 	// Calcular tasas
-	res.tasa_sppat = calcular_tasa_sppat(vehiculo.tipo, vehiculo.subtipo, vehiculo.cilindraje);
-	res.tasa_ant = calcular_tasa_ant(vehiculo.tipo, vehiculo.subtipo);
-	res.tasa_prefectura = calcular_tasa_prefectura(vehiculo.tipo, vehiculo.subtipo);
+	res.tasa_sppat = calcular_tasa_sppat(tarifas, vehiculo->tipo, vehiculo->subtipo, vehiculo->cilindraje);
+	res.tasa_ant = calcular_tasa_ant(tarifas, vehiculo->tipo, vehiculo->subtipo);
+	res.tasa_prefectura = calcular_tasa_prefectura(tarifas, vehiculo->tipo, vehiculo->subtipo, vehiculo->placa);
 	
 	// Calcular servicios
-	res.valor_rtv = calcular_valor_rtv(vehiculo.subtipo);
-	res.valor_adhesivo = VALOR_ADHESIVO;
+	res.valor_rtv = calcular_valor_rtv(tarifas, vehiculo->subtipo);
+	res.valor_adhesivo = dinero_desde_decimal(tarifas->valor_adhesivo);
 	
 	// Calcular adicionales
-	res.multas_pendientes = vehiculo.tiene_multas ? vehiculo.valor_multas : 0.0;
-	res.recargos_mora = calcular_recargos_mora(res.impuesto_propiedad, res.impuesto_rodaje, vehiculo.meses_retraso);
+	res.multas_pendientes = vehiculo->tiene_multas ? vehiculo->valor_multas : 0;
+	res.recargos_mora = calcular_recargos_mora(tarifas, res.impuesto_propiedad, res.impuesto_rodaje, vehiculo->meses_retraso);
 	
 	// Calcular total final
 	res.total_matricula = res.impuesto_propiedad + res.impuesto_rodaje + res.tasa_sppat + 
@@ -181,6 +197,341 @@ ResultadoMatricula calcular_matricula_completa(DatosVehiculo vehiculo) {
 	return res;
 }
 
+/*
+ * Funcion: calcular_matricula_completa
+ * Descripcion: Calcula la matricula con la tabla de tarifas vigente
+ * Parametros: vehiculo - Estructura con datos del vehiculo
+ * Retorno: Estructura con todos los valores calculados
+ */
+ResultadoMatricula calcular_matricula_completa(const DatosVehiculo* vehiculo) {
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	ResultadoMatricula res = calcular_matricula_con_tarifas(vehiculo, lectura.tabla);
+	tarifas_leer_fin(lectura);
+	return res;
+}
+
+// ===================================================================
+// DEUDA DE VARIOS ANOS FISCALES
+// ===================================================================
+
+/*
+ * Funcion: clase_tarifa_vehiculo
+ * Descripcion: Clasifica un vehiculo con las mismas reglas que
+ *              calcular_tasa_sppat, calcular_tasa_ant y calcular_valor_rtv
+ * Parametros: tipo, subtipo, cilindraje
+ * Retorno: Clase tarifaria (CLASE_*)
+ */
+int clase_tarifa_vehiculo(const char* tipo, const char* subtipo, int cilindraje) {
+	if (strcmp(subtipo, "MOTOCICLETA") == 0) {
+		return (cilindraje <= 200) ? CLASE_MOTO_HASTA_200 : CLASE_MOTO_MAS_200;
+	}
+	if (strcmp(tipo, "COMERCIAL") == 0) {
+		return (strcmp(subtipo, "PESADO") == 0) ? CLASE_COMERCIAL_PESADO : CLASE_COMERCIAL_LIVIANO;
+	}
+	if (strcmp(subtipo, "PESADO") == 0) return CLASE_PARTICULAR_PESADO;
+	if (cilindraje <= 1500) return CLASE_LIVIANO_HASTA_1500;
+	if (cilindraje <= 2500) return CLASE_LIVIANO_1501_2500;
+	return CLASE_LIVIANO_MAS_2500;
+}
+
+// Categoria de prefectura de cada clase tarifaria
+static const unsigned char categoria_prefectura_clase[NUM_CLASES_TARIFA] = {
+	PREFECTURA_MOTOCICLETA, PREFECTURA_MOTOCICLETA,
+	PREFECTURA_COMERCIAL, PREFECTURA_COMERCIAL,
+	PREFECTURA_PARTICULAR, PREFECTURA_PARTICULAR, PREFECTURA_PARTICULAR, PREFECTURA_PARTICULAR
+};
+
+/*
+ * Funcion: ajuste_provincia
+ * Descripcion: Diferencia entre la tasa de prefectura de una provincia
+ *              (con su recargo) y la tasa nacional del ano vigente. El
+ *              calendario por ano solo tiene tasas nacionales, asi que en
+ *              los anos anteriores cada provincia conserva esta diferencia
+ * Parametros: tarifas, provincia, clase
+ * Retorno: Valor a sumar a las tasas fijas de la clase
+ */
+static Dinero ajuste_provincia(const TablaTarifas* tarifas, int provincia, int clase) {
+	int categoria = categoria_prefectura_clase[clase];
+	int vigente = tarifas_indice_ano(tarifas, tarifas->ano_fiscal);
+	return dinero_desde_decimal(tarifas->provincias[provincia].tasa_prefectura[categoria]) +
+		dinero_desde_decimal(tarifas->provincias[provincia].recargo) -
+		dinero_desde_decimal(tarifas->calendario.valores[CONCEPTO_TASA_PREFECTURA_PARTICULAR + categoria][vigente]);
+}
+
+/*
+ * Funcion: valor_calendario
+ * Descripcion: Valor de un concepto del calendario en centavos
+ */
+static Dinero valor_calendario(const CalendarioTarifas* cal, int concepto, int indice_ano) {
+	return dinero_desde_decimal(cal->valores[concepto][indice_ano]);
+}
+
+/*
+ * Funcion: tasas_fijas_por_clase
+ * Descripcion: Suma de SPPAT, ANT, prefectura, RTV y adhesivo de cada
+ *              clase tarifaria para un ano del calendario
+ * Parametros: tarifas, indice_ano, fijos (arreglo de NUM_CLASES_TARIFA)
+ * Retorno: void
+ */
+static void tasas_fijas_por_clase(const TablaTarifas* tarifas, int indice_ano, Dinero* fijos) {
+	const CalendarioTarifas* cal = &tarifas->calendario;
+	int k = indice_ano;
+	Dinero adhesivo = valor_calendario(cal, CONCEPTO_VALOR_ADHESIVO, k);
+	Dinero moto = valor_calendario(cal, CONCEPTO_TASA_ANT_MOTOCICLETA, k) +
+		valor_calendario(cal, CONCEPTO_TASA_PREFECTURA_MOTOCICLETA, k) +
+		valor_calendario(cal, CONCEPTO_VALOR_RTV_MOTOCICLETA, k) + adhesivo;
+	Dinero comercial = valor_calendario(cal, CONCEPTO_TASA_ANT_COMERCIAL, k) +
+		valor_calendario(cal, CONCEPTO_TASA_PREFECTURA_COMERCIAL, k) +
+		valor_calendario(cal, CONCEPTO_SPPAT_COMERCIAL, k) + adhesivo;
+	Dinero particular = valor_calendario(cal, CONCEPTO_TASA_ANT_PARTICULAR, k) +
+		valor_calendario(cal, CONCEPTO_TASA_PREFECTURA_PARTICULAR, k) + adhesivo;
+	Dinero rtv_liviano = valor_calendario(cal, CONCEPTO_VALOR_RTV_LIVIANO, k);
+	Dinero rtv_pesado = valor_calendario(cal, CONCEPTO_VALOR_RTV_PESADO, k);
+	
+	fijos[CLASE_MOTO_HASTA_200] = moto + valor_calendario(cal, CONCEPTO_SPPAT_MOTO_HASTA_200, k);
+	fijos[CLASE_MOTO_MAS_200] = moto + valor_calendario(cal, CONCEPTO_SPPAT_MOTO_MAS_200, k);
+	fijos[CLASE_COMERCIAL_LIVIANO] = comercial + rtv_liviano;
+	fijos[CLASE_COMERCIAL_PESADO] = comercial + rtv_pesado;
+	fijos[CLASE_PARTICULAR_PESADO] = particular + valor_calendario(cal, CONCEPTO_SPPAT_PESADO, k) + rtv_pesado;
+	fijos[CLASE_LIVIANO_HASTA_1500] = particular + valor_calendario(cal, CONCEPTO_SPPAT_LIVIANO_HASTA_1500, k) + rtv_liviano;
+	fijos[CLASE_LIVIANO_1501_2500] = particular + valor_calendario(cal, CONCEPTO_SPPAT_LIVIANO_1501_2500, k) + rtv_liviano;
+	fijos[CLASE_LIVIANO_MAS_2500] = particular + valor_calendario(cal, CONCEPTO_SPPAT_LIVIANO_MAS_2500, k) + rtv_liviano;
+}
+
+/*
+ * Funcion: impuestos_ano
+ * Descripcion: Impuesto a la propiedad + rodaje de un avaluo con las
+ *              tarifas de un ano del calendario
+ */
+static Dinero impuestos_ano(const CalendarioTarifas* cal, int indice_ano, Dinero avaluo) {
+	Dinero exceso_propiedad = avaluo - valor_calendario(cal, CONCEPTO_LIMITE_PROPIEDAD, indice_ano);
+	Dinero exceso_rodaje = avaluo - valor_calendario(cal, CONCEPTO_LIMITE_RODAJE, indice_ano);
+	Dinero impuestos = 0;
+	
+	if (exceso_propiedad > 0) {
+		impuestos += dinero_porcentaje(exceso_propiedad,
+			tasa_desde_porcentaje(cal->valores[CONCEPTO_PORCENTAJE_PROPIEDAD][indice_ano]));
+	}
+	if (exceso_rodaje > 0) {
+		impuestos += dinero_porcentaje(exceso_rodaje,
+			tasa_desde_porcentaje(cal->valores[CONCEPTO_PORCENTAJE_RODAJE][indice_ano]));
+	}
+	return impuestos;
+}
+
+/*
+ * Funcion: calcular_deuda_multianual
+ * Descripcion: Calcula lo adeudado por un vehiculo en varios anos fiscales,
+ *              cada ano con sus propias tarifas. La mora de cada ano se
+ *              cuenta hasta ano_hasta (12 meses por ano de atraso) mas los
+ *              meses_retraso del vehiculo. Las multas no se incluyen porque
+ *              se cobran una sola vez
+ * Parametros:
+ *   - vehiculo: Datos del vehiculo
+ *   - ano_desde, ano_hasta: Anos fiscales adeudados (inclusive)
+ *   - detalle: Arreglo de (ano_hasta - ano_desde + 1) elementos o NULL
+ * Retorno: Total adeudado en todos los anos (centavos)
+ */
+Dinero calcular_deuda_multianual(const DatosVehiculo* vehiculo, int ano_desde, int ano_hasta, DeudaAnual* detalle) {
+	int clase = clase_tarifa_vehiculo(vehiculo->tipo, vehiculo->subtipo, vehiculo->cilindraje);
+	Dinero total = 0;
+	
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	const CalendarioTarifas* cal = &lectura.tabla->calendario;
+	Dinero ajuste = ajuste_provincia(lectura.tabla, tarifas_indice_provincia(vehiculo->placa), clase);
+	
+	for (int ano = ano_desde; ano <= ano_hasta; ano++) {
+		int k = tarifas_indice_ano(lectura.tabla, ano);
+		Dinero fijos[NUM_CLASES_TARIFA];
+		tasas_fijas_por_clase(lectura.tabla, k, fijos);
+		
+		DeudaAnual deuda;
+		int meses = (ano_hasta - ano) * 12 + vehiculo->meses_retraso;
+		TasaDinero tasa_mora = tasa_desde_porcentaje(cal->valores[CONCEPTO_RECARGO_ANUAL_PORCENTAJE][k]);
+		
+		deuda.ano = ano;
+		deuda.impuestos = impuestos_ano(cal, k, vehiculo->avaluo);
+		deuda.tasas = fijos[clase] + ajuste;
+		deuda.recargos = (meses > 0) ?
+			dinero_escalar(deuda.impuestos, tasa_mora * meses, (int64_t)ESCALA_TASA * 12) : 0;
+		deuda.total = deuda.impuestos + deuda.tasas + deuda.recargos;
+		
+		if (detalle) detalle[ano - ano_desde] = deuda;
+		total += deuda.total;
+	}
+	
+	tarifas_leer_fin(lectura);
+	return total;
+}
+
+/*
+ * Funcion: menu_deuda_multianual
+ * Descripcion: Muestra la deuda de un vehiculo por cada ano fiscal impago
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_deuda_multianual(void) {
+	char buffer[100];
+	char placa[10];
+	int ano_desde;
+	DatosVehiculo vehiculo;
+	DeudaAnual detalle[MAX_ANOS_TARIFA];
+	int ano_hasta = tarifas_ano_fiscal();
+	
+	limpiar_pantalla();
+	printf("=== DEUDA DE VARIOS ANOS FISCALES ===\n\n");
+	
+	printf("Ingrese la placa del vehiculo: ");
+	if (!fgets(buffer, sizeof(buffer), stdin) || sscanf(buffer, "%9s", placa) != 1) {
+		return;
+	}
+	convertir_a_mayusculas(placa);
+	
+	if (!obtener_datos_vehiculo_para_calculo_desde_archivo(placa, &vehiculo)) {
+		printf("\nERROR: Vehiculo con placa '%s' no encontrado.\n", placa);
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+	
+	printf("Primer ano fiscal impago (%d-%d): ", ano_hasta - MAX_ANOS_TARIFA + 1, ano_hasta);
+	if (!fgets(buffer, sizeof(buffer), stdin) || sscanf(buffer, "%d", &ano_desde) != 1 ||
+		ano_desde > ano_hasta || ano_desde < ano_hasta - MAX_ANOS_TARIFA + 1) {
+		printf("\nERROR: Ano fuera del rango permitido.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+	
+	Dinero total = calcular_deuda_multianual(&vehiculo, ano_desde, ano_hasta, detalle);
+	
+	printf("\nVehiculo: %s (%s %s)\n\n", vehiculo.placa, vehiculo.tipo, vehiculo.subtipo);
+	printf("%-6s %12s %12s %12s %12s\n", "ANO", "IMPUESTOS", "TASAS", "RECARGOS", "TOTAL");
+	printf("-------------------------------------------------------------\n");
+	for (int i = 0; i <= ano_hasta - ano_desde; i++) {
+		printf("%-6d %12.2f %12.2f %12.2f %12.2f\n", detalle[i].ano, dinero_a_decimal(detalle[i].impuestos),
+			   dinero_a_decimal(detalle[i].tasas), dinero_a_decimal(detalle[i].recargos),
+			   dinero_a_decimal(detalle[i].total));
+	}
+	printf("-------------------------------------------------------------\n");
+	printf("%-6s %51.2f\n", "TOTAL", dinero_a_decimal(total));
+	
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
+
+// ===================================================================
+// CACHE DE RESULTADOS DE MATRICULA
+// ===================================================================
+
+/*
+ * Estructura: EntradaCacheMatricula
+ * Descripcion: Resultado de matricula junto con todos los datos que
+ *              influyen en el calculo. Si alguno cambia, la entrada no sirve
+ */
+typedef struct {
+	int ocupada;
+	char placa[10];
+	Dinero avaluo;
+	int cilindraje;
+	char tipo[20];
+	char subtipo[20];
+	Dinero multas;
+	int meses_retraso;
+	unsigned int version_tarifas;
+	ResultadoMatricula resultado;
+} EntradaCacheMatricula;
+
+// Cache de mapeo directo: cada placa tiene una sola posicion posible,
+// asi que invalidar una placa solo revisa esa posicion
+static EntradaCacheMatricula cache_matricula[MAX_CACHE_MATRICULA];
+
+/*
+ * Funcion: posicion_cache_matricula
+ * Descripcion: Posicion de una placa en la cache (hash FNV-1a)
+ * Parametros: placa - Placa del vehiculo
+ * Retorno: Indice dentro de cache_matricula
+ */
+static unsigned int posicion_cache_matricula(const char* placa) {
+	unsigned int hash = 2166136261u;
+	for (int i = 0; placa[i]; i++) {
+		hash ^= (unsigned char)placa[i];
+		hash *= 16777619u;
+	}
+	return hash & (MAX_CACHE_MATRICULA - 1);
+}
+
+/*
+ * Funcion: calcular_matricula_cacheada
+ * Descripcion: Igual que calcular_matricula_completa, pero reutiliza el
+ *              resultado si la misma placa ya se calculo con los mismos
+ *              datos y la misma version de tarifas. La usan todos los
+ *              flujos interactivos (calculo, matriculacion y pago)
+ * Parametros: vehiculo - Estructura con datos del vehiculo
+ * Retorno: Estructura con todos los valores calculados
+ */
+ResultadoMatricula calcular_matricula_cacheada(const DatosVehiculo* vehiculo) {
+	EntradaCacheMatricula* entrada = &cache_matricula[posicion_cache_matricula(vehiculo->placa)];
+	Dinero multas = vehiculo->tiene_multas ? vehiculo->valor_multas : 0;
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	unsigned int version = lectura.tabla->version;
+	
+	if (entrada->ocupada &&
+		entrada->version_tarifas == version &&
+		entrada->avaluo == vehiculo->avaluo &&
+		entrada->cilindraje == vehiculo->cilindraje &&
+		entrada->multas == multas &&
+		entrada->meses_retraso == vehiculo->meses_retraso &&
+		strcmp(entrada->placa, vehiculo->placa) == 0 &&
+		strcmp(entrada->tipo, vehiculo->tipo) == 0 &&
+		strcmp(entrada->subtipo, vehiculo->subtipo) == 0) {
+		tarifas_leer_fin(lectura);
+		return entrada->resultado;
+	}
+	
+	// No estaba en cache: calcular y reemplazar la entrada de esa posicion
+	ResultadoMatricula resultado = calcular_matricula_con_tarifas(vehiculo, lectura.tabla);
+	tarifas_leer_fin(lectura);
+	
+	entrada->ocupada = 1;
+	strcpy(entrada->placa, vehiculo->placa);
+	entrada->avaluo = vehiculo->avaluo;
+	entrada->cilindraje = vehiculo->cilindraje;
+	strcpy(entrada->tipo, vehiculo->tipo);
+	strcpy(entrada->subtipo, vehiculo->subtipo);
+	entrada->multas = multas;
+	entrada->meses_retraso = vehiculo->meses_retraso;
+	entrada->version_tarifas = version;
+	entrada->resultado = resultado;
+	
+	return resultado;
+}
+
+/*
+ * Funcion: invalidar_cache_matricula
+ * Descripcion: Descarta el resultado guardado de una placa (por ejemplo,
+ *              cuando se registran o modifican los datos del vehiculo)
+ * Parametros: placa - Placa del vehiculo
+ * Retorno: void
+ */
+void invalidar_cache_matricula(const char* placa) {
+	EntradaCacheMatricula* entrada = &cache_matricula[posicion_cache_matricula(placa)];
+	if (entrada->ocupada && strcmp(entrada->placa, placa) == 0) {
+		entrada->ocupada = 0;
+	}
+}
+
+/*
+ * Funcion: invalidar_cache_matricula_completa
+ * Descripcion: Descarta todos los resultados guardados. Se usa cuando
+ *              se publica una nueva tabla de tarifas
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void invalidar_cache_matricula_completa(void) {
+	memset(cache_matricula, 0, sizeof(cache_matricula));
+}
+
 // ===================================================================
 // FUNCIONES DE INTERFAZ DE USUARIO
 // ===================================================================
@@ -191,26 +542,26 @@ ResultadoMatricula calcular_matricula_completa(DatosVehiculo vehiculo) {
  * Retorno: void
  */
 void mostrar_desglose_matricula(ResultadoMatricula res) {
-	printf("\n=== DESGLOSE DE MATRICULA %d ===\n", ANO_FISCAL);
+	printf("\n=== DESGLOSE DE MATRICULA %d ===\n", tarifas_ano_fiscal());
 	printf("+-----------------------------------------+\n");
 	printf("| IMPUESTOS:\n");
-	printf("|   Impuesto a la Propiedad (SRI): $%-8.2f |\n", res.impuesto_propiedad);
-	printf("|   Impuesto al Rodaje (AMT):      $%-8.2f |\n", res.impuesto_rodaje);
+	printf("|   Impuesto a la Propiedad (SRI): $%-8.2f |\n", dinero_a_decimal(res.impuesto_propiedad));
+	printf("|   Impuesto al Rodaje (AMT):      $%-8.2f |\n", dinero_a_decimal(res.impuesto_rodaje));
 	printf("+-----------------------------------------+\n");
 	printf("| TASAS:\n");
-	printf("|   Tasa SPPAT:                    $%-8.2f |\n", res.tasa_sppat);
-	printf("|   Tasa ANT:                      $%-8.2f |\n", res.tasa_ant);
-	printf("|   Tasa Prefectura:               $%-8.2f |\n", res.tasa_prefectura);
+	printf("|   Tasa SPPAT:                    $%-8.2f |\n", dinero_a_decimal(res.tasa_sppat));
+	printf("|   Tasa ANT:                      $%-8.2f |\n", dinero_a_decimal(res.tasa_ant));
+	printf("|   Tasa Prefectura:               $%-8.2f |\n", dinero_a_decimal(res.tasa_prefectura));
 	printf("+-----------------------------------------+\n");
 	printf("| SERVICIOS Y OTROS:\n");
-	printf("|   Revision Tecnica (RTV):        $%-8.2f |\n", res.valor_rtv);
-	printf("|   Adhesivo (Sticker):            $%-8.2f |\n", res.valor_adhesivo);
+	printf("|   Revision Tecnica (RTV):        $%-8.2f |\n", dinero_a_decimal(res.valor_rtv));
+	printf("|   Adhesivo (Sticker):            $%-8.2f |\n", dinero_a_decimal(res.valor_adhesivo));
 	printf("+-----------------------------------------+\n");
 	printf("| ADICIONALES (si aplica):\n");
-	printf("|   Multas Pendientes:             $%-8.2f |\n", res.multas_pendientes);
-	printf("|   Recargos por Mora:             $%-8.2f |\n", res.recargos_mora);
+	printf("|   Multas Pendientes:             $%-8.2f |\n", dinero_a_decimal(res.multas_pendientes));
+	printf("|   Recargos por Mora:             $%-8.2f |\n", dinero_a_decimal(res.recargos_mora));
 	printf("+-----------------------------------------+\n");
-	printf("| TOTAL A PAGAR:                   $%-8.2f |\n", res.total_matricula);
+	printf("| TOTAL A PAGAR:                   $%-8.2f |\n", dinero_a_decimal(res.total_matricula));
 	printf("+-----------------------------------------+\n");
 }
 
@@ -255,7 +606,7 @@ void menu_calculo_matricula() {
 	// Paso 2: Obtener datos adicionales (multas, retrasos)
 	limpiar_pantalla();
 	printf("=== VEHICULO ENCONTRADO ===\n");
-	printf("Placa: %s, Tipo: %s, Avaluo: $%.2f\n\n", vehiculo.placa, vehiculo.tipo, vehiculo.avaluo);
+	printf("Placa: %s, Tipo: %s, Avaluo: $%.2f\n\n", vehiculo.placa, vehiculo.tipo, dinero_a_decimal(vehiculo.avaluo));
 	
 	// Solicitar informacion sobre multas
 	while (1) {
@@ -273,7 +624,7 @@ void menu_calculo_matricula() {
 		while (1) {
 			printf("Ingrese el valor total de multas: $");
 			if (fgets(buffer, sizeof(buffer), stdin)) {
-				if (sscanf(buffer, "%lf", &vehiculo.valor_multas) == 1) {
+				if (dinero_leer(buffer, &vehiculo.valor_multas)) {
 					if (vehiculo.valor_multas > 0) break;
 				}
 			}
@@ -293,7 +644,7 @@ void menu_calculo_matricula() {
 	}
 	
 	// Paso 3: Calcular y mostrar resultados
-	ResultadoMatricula resultado = calcular_matricula_completa(vehiculo);
+	ResultadoMatricula resultado = calcular_matricula_cacheada(&vehiculo);
 	limpiar_pantalla();
 	printf("=== CALCULO FINALIZADO PARA PLACA: %s ===\n", vehiculo.placa);
 	mostrar_desglose_matricula(resultado);
@@ -309,10 +660,10 @@ void menu_calculo_matricula() {
 			generar_numero_comprobante(numero_comprobante, vehiculo.placa);
 			
 			// Mostrar comprobante con el numero generado
-			generar_comprobante_matricula(vehiculo.placa, resultado, vehiculo, numero_comprobante);
+			generar_comprobante_matricula(resultado, &vehiculo, numero_comprobante);
 			
 			// Tambien guardar en el sistema de pagos con el mismo numero
-			if (guardar_comprobante_sistema(vehiculo.placa, resultado, vehiculo, numero_comprobante)) {
+			if (guardar_comprobante_sistema(vehiculo.placa, resultado, &vehiculo, numero_comprobante)) {
 				printf("\nComprobante guardado en el sistema de pagos.\n");
 				printf("Puede usar la placa %s para realizar el pago posteriormente.\n", vehiculo.placa);
 			}
@@ -383,13 +734,12 @@ void imprimir_pie_comprobante(void) {
  * Funcion: generar_comprobante_matricula
  * Descripcion: Genera y muestra el comprobante completo de matricula
  * Parametros:
- *   - placa: Placa del vehiculo
  *   - resultado: Estructura con los resultados del calculo
  *   - vehiculo: Datos del vehiculo
  *   - numero_comprobante: Numero del comprobante a mostrar
  * Retorno: void
  */
-void generar_comprobante_matricula(const char* placa, ResultadoMatricula resultado, DatosVehiculo vehiculo, const char* numero_comprobante) {
+void generar_comprobante_matricula(ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const char* numero_comprobante) {
 	// Limpiar pantalla
 	limpiar_pantalla();
 	
@@ -399,40 +749,40 @@ void generar_comprobante_matricula(const char* placa, ResultadoMatricula resulta
 	// Mostrar placa prominentemente
 	printf("Comprobante No: %s\n", numero_comprobante);
 	imprimir_linea_decorativa('=', 55);
-	printf("                    PLACA: %s\n", vehiculo.placa);
+	printf("                    PLACA: %s\n", vehiculo->placa);
 	imprimir_linea_decorativa('=', 55);
 	
 	// Datos del vehiculo
 	printf("\nDATOS DEL VEHICULO:\n");
 	imprimir_linea_decorativa('-', 55);
-	printf("Placa:                      %s\n", vehiculo.placa);
-	printf("Tipo:                       %s\n", vehiculo.tipo);
-	printf("Subtipo:                    %s\n", vehiculo.subtipo);
-	printf("Avaluo:                     $%.2f\n", vehiculo.avaluo);
-	printf("Cilindraje:                 %d cc\n", vehiculo.cilindraje);
+	printf("Placa:                      %s\n", vehiculo->placa);
+	printf("Tipo:                       %s\n", vehiculo->tipo);
+	printf("Subtipo:                    %s\n", vehiculo->subtipo);
+	printf("Avaluo:                     $%.2f\n", dinero_a_decimal(vehiculo->avaluo));
+	printf("Cilindraje:                 %d cc\n", vehiculo->cilindraje);
 	printf("\n");
 	
 	// Desglose detallado
 	printf("DESGLOSE DE COSTOS:\n");
 	imprimir_linea_decorativa('-', 55);
-	printf("Impuesto a la Propiedad:    $%12.2f\n", resultado.impuesto_propiedad);
-	printf("Impuesto de Rodaje:         $%12.2f\n", resultado.impuesto_rodaje);
-	printf("Tasa SPPAT:                 $%12.2f\n", resultado.tasa_sppat);
-	printf("Tasa ANT:                   $%12.2f\n", resultado.tasa_ant);
-	printf("Tasa Prefectura:            $%12.2f\n", resultado.tasa_prefectura);
-	printf("Valor RTV:                  $%12.2f\n", resultado.valor_rtv);
-	printf("Valor Adhesivo:             $%12.2f\n", resultado.valor_adhesivo);
+	printf("Impuesto a la Propiedad:    $%12.2f\n", dinero_a_decimal(resultado.impuesto_propiedad));
+	printf("Impuesto de Rodaje:         $%12.2f\n", dinero_a_decimal(resultado.impuesto_rodaje));
+	printf("Tasa SPPAT:                 $%12.2f\n", dinero_a_decimal(resultado.tasa_sppat));
+	printf("Tasa ANT:                   $%12.2f\n", dinero_a_decimal(resultado.tasa_ant));
+	printf("Tasa Prefectura:            $%12.2f\n", dinero_a_decimal(resultado.tasa_prefectura));
+	printf("Valor RTV:                  $%12.2f\n", dinero_a_decimal(resultado.valor_rtv));
+	printf("Valor Adhesivo:             $%12.2f\n", dinero_a_decimal(resultado.valor_adhesivo));
 	
 	if (resultado.multas_pendientes > 0) {
-		printf("Multas Pendientes:          $%12.2f\n", resultado.multas_pendientes);
+		printf("Multas Pendientes:          $%12.2f\n", dinero_a_decimal(resultado.multas_pendientes));
 	}
 	
 	if (resultado.recargos_mora > 0) {
-		printf("Recargos por Mora:          $%12.2f\n", resultado.recargos_mora);
+		printf("Recargos por Mora:          $%12.2f\n", dinero_a_decimal(resultado.recargos_mora));
 	}
 	
 	imprimir_linea_decorativa('-', 55);
-	printf("TOTAL A PAGAR:              $%12.2f\n", resultado.total_matricula);
+	printf("TOTAL A PAGAR:              $%12.2f\n", dinero_a_decimal(resultado.total_matricula));
 	imprimir_linea_decorativa('=', 55);
 	
 	// Imprimir pie
@@ -445,8 +795,8 @@ void generar_comprobante_matricula(const char* placa, ResultadoMatricula resulta
 	if (fgets(buffer, sizeof(buffer), stdin)) {
 		sscanf(buffer, "%c", &respuesta);
 		if (respuesta == 'S' || respuesta == 's') {
-			guardar_comprobante_archivo(placa, resultado, vehiculo, numero_comprobante);
-			printf("Comprobante guardado exitosamente en 'comprobantes/comprobante_%s.txt'.\n", placa);
+			guardar_comprobante_archivo(resultado, vehiculo, numero_comprobante);
+			printf("Comprobante %s guardado en el almacen de documentos.\n", numero_comprobante);
 		}
 	}
 	
@@ -454,25 +804,133 @@ void generar_comprobante_matricula(const char* placa, ResultadoMatricula resulta
 	getchar();
 }
 
-// Funcion para guardar comprobante en archivo
-void guardar_comprobante_archivo(const char* placa, ResultadoMatricula resultado, DatosVehiculo vehiculo, const char* numero_comprobante) {
-	// Crear carpeta de comprobantes si no existe
-	struct stat st = {0};
-	if (stat("comprobantes", &st) == -1) {
-		_mkdir("comprobantes");
-	}
-	
-	// Crear nombre de archivo con la placa en la carpeta de comprobantes
-	char nombre_archivo[100];
-	sprintf(nombre_archivo, "comprobantes/comprobante_%s.txt", placa);
-	
-	FILE *archivo = fopen(nombre_archivo, "a");
-	if (archivo == NULL) {
-		printf("Error: No se pudo crear el archivo de comprobantes.\n");
-		printf("Verifique que tenga permisos de escritura en esta carpeta.\n");
-		return;
-	}
-	
+// ===================================================================
+// PLANTILLA DEL COMPROBANTE EN ARCHIVO
+// ===================================================================
+
+// Nombres de los espacios de la plantilla; el orden define el indice del valor
+enum {
+	CP_PLACA, CP_DIA, CP_MES, CP_ANO, CP_HORA, CP_MINUTO, CP_SEGUNDO,
+	CP_TIPO, CP_SUBTIPO, CP_AVALUO, CP_CILINDRAJE,
+	CP_PROPIEDAD, CP_RODAJE, CP_SPPAT, CP_ANT, CP_PREFECTURA, CP_RTV, CP_ADHESIVO,
+	CP_MULTAS, CP_RECARGOS, CP_TOTAL, CP_NUM_ESPACIOS
+};
+
+static const char* const nombres_comprobante[CP_NUM_ESPACIOS] = {
+	"placa", "dia", "mes", "ano", "hora", "minuto", "segundo",
+	"tipo", "subtipo", "avaluo", "cilindraje",
+	"propiedad", "rodaje", "sppat", "ant", "prefectura", "rtv", "adhesivo",
+	"multas", "recargos", "total"
+};
+
+// Cuerpo del comprobante (hasta el valor del adhesivo)
+static const char* const fuente_comprobante_cuerpo =
+	"=======================================================\n"
+	"          COMPROBANTE DE MATRICULA VEHICULAR\n"
+	"           AGENCIA NACIONAL DE TRANSITO\n"
+	"                    PLACA: {placa}\n"
+	"=======================================================\n"
+	"Fecha: {dia:02}/{mes:02}/{ano:d} {hora:02}:{minuto:02}:{segundo:02}\n\n"
+	"DATOS DEL VEHICULO:\n"
+	"-------------------------------------------------------\n"
+	"Placa: {placa}\n"
+	"Tipo: {tipo}\n"
+	"Subtipo: {subtipo}\n"
+	"Avaluo: ${avaluo:$}\n"
+	"Cilindraje: {cilindraje:d} cc\n\n"
+	"DESGLOSE DE COSTOS:\n"
+	"-------------------------------------------------------\n"
+	"Impuesto a la Propiedad: ${propiedad:$}\n"
+	"Impuesto de Rodaje: ${rodaje:$}\n"
+	"Tasa SPPAT: ${sppat:$}\n"
+	"Tasa ANT: ${ant:$}\n"
+	"Tasa Prefectura: ${prefectura:$}\n"
+	"Valor RTV: ${rtv:$}\n"
+	"Valor Adhesivo: ${adhesivo:$}\n";
+
+// Lineas opcionales (solo si el valor es mayor a cero)
+static const char* const fuente_comprobante_multas = "Multas Pendientes: ${multas:$}\n";
+static const char* const fuente_comprobante_recargos = "Recargos por Mora: ${recargos:$}\n";
+
+// Pie con el total
+static const char* const fuente_comprobante_pie =
+	"-------------------------------------------------------\n"
+	"TOTAL A PAGAR: ${total:$}\n"
+	"=======================================================\n\n";
+
+static Plantilla plantilla_comprobante_cuerpo;
+static Plantilla plantilla_comprobante_multas;
+static Plantilla plantilla_comprobante_recargos;
+static Plantilla plantilla_comprobante_pie;
+
+/*
+ * Funcion: compilar_plantillas_comprobante
+ * Descripcion: Compila las plantillas del comprobante la primera vez
+ * Parametros: Ninguno
+ * Retorno: 1 si estan listas, 0 si alguna plantilla es invalida
+ */
+static int compilar_plantillas_comprobante(void) {
+	if (plantilla_comprobante_pie.compilada) return 1;
+	return plantilla_compilar(&plantilla_comprobante_cuerpo, fuente_comprobante_cuerpo, nombres_comprobante, CP_NUM_ESPACIOS) &&
+		plantilla_compilar(&plantilla_comprobante_multas, fuente_comprobante_multas, nombres_comprobante, CP_NUM_ESPACIOS) &&
+		plantilla_compilar(&plantilla_comprobante_recargos, fuente_comprobante_recargos, nombres_comprobante, CP_NUM_ESPACIOS) &&
+		plantilla_compilar(&plantilla_comprobante_pie, fuente_comprobante_pie, nombres_comprobante, CP_NUM_ESPACIOS);
+}
+
+/*
+ * Funcion: renderizar_comprobante_archivo
+ * Descripcion: Renderiza el comprobante completo al final del buffer.
+ *              Se puede llamar varias veces sobre el mismo buffer para
+ *              emitir muchos comprobantes con una sola escritura
+ * Parametros:
+ *   - salida: Buffer donde se agrega el comprobante
+ *   - resultado: Resultado del calculo de matricula
+ *   - vehiculo: Datos del vehiculo
+ *   - fecha: Fecha y hora de emision
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int renderizar_comprobante_archivo(BufferTexto* salida, ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const struct tm* fecha) {
+	if (!compilar_plantillas_comprobante()) return 0;
+
+	ValorPlantilla valores[CP_NUM_ESPACIOS] = {{0}};
+	valores[CP_PLACA].texto = vehiculo->placa;
+	valores[CP_DIA].entero = fecha->tm_mday;
+	valores[CP_MES].entero = fecha->tm_mon + 1;
+	valores[CP_ANO].entero = fecha->tm_year + 1900;
+	valores[CP_HORA].entero = fecha->tm_hour;
+	valores[CP_MINUTO].entero = fecha->tm_min;
+	valores[CP_SEGUNDO].entero = fecha->tm_sec;
+	valores[CP_TIPO].texto = vehiculo->tipo;
+	valores[CP_SUBTIPO].texto = vehiculo->subtipo;
+	valores[CP_AVALUO].dinero = vehiculo->avaluo;
+	valores[CP_CILINDRAJE].entero = vehiculo->cilindraje;
+	valores[CP_PROPIEDAD].dinero = resultado.impuesto_propiedad;
+	valores[CP_RODAJE].dinero = resultado.impuesto_rodaje;
+	valores[CP_SPPAT].dinero = resultado.tasa_sppat;
+	valores[CP_ANT].dinero = resultado.tasa_ant;
+	valores[CP_PREFECTURA].dinero = resultado.tasa_prefectura;
+	valores[CP_RTV].dinero = resultado.valor_rtv;
+	valores[CP_ADHESIVO].dinero = resultado.valor_adhesivo;
+	valores[CP_MULTAS].dinero = resultado.multas_pendientes;
+	valores[CP_RECARGOS].dinero = resultado.recargos_mora;
+	valores[CP_TOTAL].dinero = resultado.total_matricula;
+
+	if (!plantilla_renderizar(&plantilla_comprobante_cuerpo, valores, salida)) return 0;
+	if (resultado.multas_pendientes > 0 &&
+		!plantilla_renderizar(&plantilla_comprobante_multas, valores, salida)) return 0;
+	if (resultado.recargos_mora > 0 &&
+		!plantilla_renderizar(&plantilla_comprobante_recargos, valores, salida)) return 0;
+	return plantilla_renderizar(&plantilla_comprobante_pie, valores, salida);
+}
+
+/*
+ * Funcion: guardar_comprobante_archivo
+ * Descripcion: Renderiza el comprobante y lo agrega al almacen de
+ *              documentos, indexado por su numero de comprobante
+ * Parametros: resultado, vehiculo, numero_comprobante
+ * Retorno: void
+ */
+void guardar_comprobante_archivo(ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const char* numero_comprobante) {
 	// Obtener fecha actual
 	time_t t = time(NULL);
 	struct tm *fecha_actual = localtime(&t);
@@ -480,57 +938,24 @@ void guardar_comprobante_archivo(const char* placa, ResultadoMatricula resultado
 	// Validar que localtime funciono correctamente
 	if (fecha_actual == NULL) {
 		printf("Error: No se pudo obtener la fecha actual.\n");
-		fclose(archivo);
 		return;
 	}
 	
-	// Escribir comprobante en archivo
-	fprintf(archivo, "=======================================================\n");
-	fprintf(archivo, "          COMPROBANTE DE MATRICULA VEHICULAR\n");
-	fprintf(archivo, "           AGENCIA NACIONAL DE TRANSITO\n");
-	fprintf(archivo, "                    PLACA: %s\n", vehiculo.placa);
-	fprintf(archivo, "=======================================================\n");
-	fprintf(archivo, "Fecha: %02d/%02d/%d %02d:%02d:%02d\n\n", 
-			fecha_actual->tm_mday, fecha_actual->tm_mon + 1, 
-			fecha_actual->tm_year + 1900, fecha_actual->tm_hour,
-			fecha_actual->tm_min, fecha_actual->tm_sec);
-	
-	// Datos del vehiculo
-	fprintf(archivo, "DATOS DEL VEHICULO:\n");
-	fprintf(archivo, "-------------------------------------------------------\n");
-	fprintf(archivo, "Placa: %s\n", vehiculo.placa);
-	fprintf(archivo, "Tipo: %s\n", vehiculo.tipo);
-	fprintf(archivo, "Subtipo: %s\n", vehiculo.subtipo);
-	fprintf(archivo, "Avaluo: $%.2f\n", vehiculo.avaluo);
-	fprintf(archivo, "Cilindraje: %d cc\n\n", vehiculo.cilindraje);
-	
-	// Desglose de costos
-	fprintf(archivo, "DESGLOSE DE COSTOS:\n");
-	fprintf(archivo, "-------------------------------------------------------\n");
-	fprintf(archivo, "Impuesto a la Propiedad: $%.2f\n", resultado.impuesto_propiedad);
-	fprintf(archivo, "Impuesto de Rodaje: $%.2f\n", resultado.impuesto_rodaje);
-	fprintf(archivo, "Tasa SPPAT: $%.2f\n", resultado.tasa_sppat);
-	fprintf(archivo, "Tasa ANT: $%.2f\n", resultado.tasa_ant);
-	fprintf(archivo, "Tasa Prefectura: $%.2f\n", resultado.tasa_prefectura);
-	fprintf(archivo, "Valor RTV: $%.2f\n", resultado.valor_rtv);
-	fprintf(archivo, "Valor Adhesivo: $%.2f\n", resultado.valor_adhesivo);
-	
-	if (resultado.multas_pendientes > 0) {
-		fprintf(archivo, "Multas Pendientes: $%.2f\n", resultado.multas_pendientes);
-	}
-	
-	if (resultado.recargos_mora > 0) {
-		fprintf(archivo, "Recargos por Mora: $%.2f\n", resultado.recargos_mora);
+	// Renderizar el comprobante completo en memoria
+	BufferTexto buffer;
+	buffer_iniciar(&buffer);
+	if (!renderizar_comprobante_archivo(&buffer, resultado, vehiculo, fecha_actual)) {
+		printf("Error: No se pudo generar el comprobante.\n");
+		buffer_liberar(&buffer);
+		return;
 	}
 	
-	fprintf(archivo, "-------------------------------------------------------\n");
-	fprintf(archivo, "TOTAL A PAGAR: $%.2f\n", resultado.total_matricula);
-	fprintf(archivo, "=======================================================\n\n");
-	
-	// Cerrar archivo de forma segura
-	if (fclose(archivo) == EOF) {
-		printf("Advertencia: Error al cerrar el archivo de comprobantes.\n");
+	// Agregar al almacen de documentos con una sola escritura
+	if (!almacen_agregar_documento(numero_comprobante, DOCUMENTO_COMPROBANTE, &buffer)) {
+		printf("Error: No se pudo guardar el comprobante en '%s'.\n", ARCHIVO_ALMACEN_DOCUMENTOS);
+		printf("Verifique que tenga permisos de escritura en esta carpeta.\n");
 	}
+	buffer_liberar(&buffer);
 }
 
 /*
@@ -583,35 +1008,35 @@ void calcular_matricula_mostrar() {
 	}
 	
 	// Calcular matricula
-	resultado = calcular_matricula_completa(vehiculo);
+	resultado = calcular_matricula_cacheada(&vehiculo);
 	
 	// Mostrar resultado del calculo
 	printf("\n");
 	printf("CALCULO DE MATRICULA COMPLETADO:\n");
 	printf("=======================================================\n");
 	printf("Vehiculo: %s (%s %s)\n", vehiculo.placa, vehiculo.tipo, vehiculo.subtipo);
-	printf("Avaluo comercial: $%.2f\n", vehiculo.avaluo);
+	printf("Avaluo comercial: $%.2f\n", dinero_a_decimal(vehiculo.avaluo));
 	printf("\n");
 	printf("DESGLOSE DE COSTOS:\n");
 	printf("-------------------------------------------------------\n");
-	printf("Impuesto a la Propiedad:    $%8.2f\n", resultado.impuesto_propiedad);
-	printf("Impuesto de Rodaje:         $%8.2f\n", resultado.impuesto_rodaje);
-	printf("Tasa SPPAT:                 $%8.2f\n", resultado.tasa_sppat);
-	printf("Tasa ANT:                   $%8.2f\n", resultado.tasa_ant);
-	printf("Tasa Prefectura:            $%8.2f\n", resultado.tasa_prefectura);
-	printf("Valor RTV:                  $%8.2f\n", resultado.valor_rtv);
-	printf("Valor Adhesivo:             $%8.2f\n", resultado.valor_adhesivo);
+	printf("Impuesto a la Propiedad:    $%8.2f\n", dinero_a_decimal(resultado.impuesto_propiedad));
+	printf("Impuesto de Rodaje:         $%8.2f\n", dinero_a_decimal(resultado.impuesto_rodaje));
+	printf("Tasa SPPAT:                 $%8.2f\n", dinero_a_decimal(resultado.tasa_sppat));
+	printf("Tasa ANT:                   $%8.2f\n", dinero_a_decimal(resultado.tasa_ant));
+	printf("Tasa Prefectura:            $%8.2f\n", dinero_a_decimal(resultado.tasa_prefectura));
+	printf("Valor RTV:                  $%8.2f\n", dinero_a_decimal(resultado.valor_rtv));
+	printf("Valor Adhesivo:             $%8.2f\n", dinero_a_decimal(resultado.valor_adhesivo));
 	
 	if (resultado.multas_pendientes > 0) {
-		printf("Multas Pendientes:          $%8.2f\n", resultado.multas_pendientes);
+		printf("Multas Pendientes:          $%8.2f\n", dinero_a_decimal(resultado.multas_pendientes));
 	}
 	
 	if (resultado.recargos_mora > 0) {
-		printf("Recargos por Mora:          $%8.2f\n", resultado.recargos_mora);
+		printf("Recargos por Mora:          $%8.2f\n", dinero_a_decimal(resultado.recargos_mora));
 	}
 	
 	printf("-------------------------------------------------------\n");
-	printf("TOTAL A PAGAR:              $%8.2f\n", resultado.total_matricula);
+	printf("TOTAL A PAGAR:              $%8.2f\n", dinero_a_decimal(resultado.total_matricula));
 	printf("=======================================================\n");
 	printf("\n");
 	
@@ -637,10 +1062,10 @@ void calcular_matricula_mostrar() {
 				rand() % 1000);
 		
 		// Generar comprobante completo
-		generar_comprobante_matricula(placa, resultado, vehiculo, numero_comprobante);
+		generar_comprobante_matricula(resultado, &vehiculo, numero_comprobante);
 		
 		// Guardar en el sistema de pagos
-		if (guardar_comprobante_sistema(placa, resultado, vehiculo, numero_comprobante)) {
+		if (guardar_comprobante_sistema(placa, resultado, &vehiculo, numero_comprobante)) {
 			printf("\nComprobante generado exitosamente!\n");
 			printf("Ahora puede proceder al pago usando la placa: %s\n", placa);
 		} else {
@@ -18,10 +18,15 @@
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include "plantillas.h"
+#include "tarifas.h"
+#include "dinero.h"
 
 // ===================================================================
 // CONSTANTES DEL SISTEMA
 // ===================================================================
+// Las tarifas de este archivo son los valores de fabrica. Los valores
+// vigentes se leen de tarifas.cfg (ver tarifas.h)
 
 // Constante del ano fiscal actual
 #define ANO_FISCAL 2025
@@ -49,7 +54,8 @@
 // TASAS FIJAS PREFECTURA DE PICHINCHA
 // ===================================================================
 
-// Tasas cobradas por la Prefectura de Pichincha
+// Tasas cobradas por la Prefectura de Pichincha. Son tambien las tasas de
+// las demas provincias mientras tarifas.cfg no tenga su seccion [provincia X]
 #define TASA_PREFECTURA_PARTICULAR 18.00    // Tasa para vehiculos particulares
 #define TASA_PREFECTURA_COMERCIAL 20.50     // Tasa para vehiculos comerciales
 #define TASA_PREFECTURA_MOTOCICLETA 9.30    // Tasa para motocicletas
@@ -89,25 +95,51 @@
 // Porcentaje de recargo anual por mora en pagos
 #define RECARGO_ANUAL_PORCENTAJE 3.0  // 3% anual sobre impuestos
 
+// ===================================================================
+// CONFIGURACION DE LA CACHE DE CALCULOS
+// ===================================================================
+
+// Resultados de matricula recordados por placa (potencia de 2)
+#define MAX_CACHE_MATRICULA 64
+
+// ===================================================================
+// CLASES TARIFARIAS
+// ===================================================================
+
+// Combinaciones de tipo, subtipo y cilindraje que tienen las mismas tasas
+// fijas. Permiten calcular flotas completas sin comparar cadenas
+enum {
+	CLASE_MOTO_HASTA_200,
+	CLASE_MOTO_MAS_200,
+	CLASE_COMERCIAL_LIVIANO,
+	CLASE_COMERCIAL_PESADO,
+	CLASE_PARTICULAR_PESADO,
+	CLASE_LIVIANO_HASTA_1500,
+	CLASE_LIVIANO_1501_2500,
+	CLASE_LIVIANO_MAS_2500,
+	NUM_CLASES_TARIFA
+};
+
 // ===================================================================
 // ESTRUCTURAS DE DATOS
 // ===================================================================
 /*
  * Estructura: ResultadoMatricula
  * Descripcion: Almacena todos los valores calculados para la matricula
- *              de un vehiculo, incluyendo impuestos, tasas y total
+ *              de un vehiculo, incluyendo impuestos, tasas y total. Todos
+ *              los valores son centavos y el total es su suma exacta
  */
 typedef struct {
-	double impuesto_propiedad;    // Impuesto a la propiedad (SRI)
-	double impuesto_rodaje;       // Impuesto de rodaje (AMT)
-	double tasa_sppat;           // Tasa SPPAT segun tipo vehiculo
-	double tasa_ant;             // Tasa ANT segun tipo vehiculo
-	double tasa_prefectura;      // Tasa Prefectura segun tipo vehiculo
-	double valor_rtv;            // Valor revision tecnica vehicular
-	double valor_adhesivo;       // Valor del adhesivo (sticker)
-	double multas_pendientes;    // Multas pendientes de pago
-	double recargos_mora;        // Recargos por mora en pagos
-	double total_matricula;      // Total final a pagar
+	Dinero impuesto_propiedad;    // Impuesto a la propiedad (SRI)
+	Dinero impuesto_rodaje;       // Impuesto de rodaje (AMT)
+	Dinero tasa_sppat;           // Tasa SPPAT segun tipo vehiculo
+	Dinero tasa_ant;             // Tasa ANT segun tipo vehiculo
+	Dinero tasa_prefectura;      // Tasa Prefectura segun tipo vehiculo
+	Dinero valor_rtv;            // Valor revision tecnica vehicular
+	Dinero valor_adhesivo;       // Valor del adhesivo (sticker)
+	Dinero multas_pendientes;    // Multas pendientes de pago
+	Dinero recargos_mora;        // Recargos por mora en pagos
+	Dinero total_matricula;      // Total final a pagar
 } ResultadoMatricula;
 
 /*
@@ -122,13 +154,26 @@ typedef struct {
 	char tipo[20];               // Tipo: PARTICULAR o COMERCIAL
 	char subtipo[20];            // Subtipo: LIVIANO, PESADO, MOTOCICLETA
 	int ano;                     // Ano del vehiculo
-	float avaluo;                // Avaluo comercial del vehiculo
+	Dinero avaluo;               // Avaluo comercial del vehiculo (centavos)
 	int cilindraje;              // Cilindraje del motor en cc
 	int tiene_multas;            // Indica si tiene multas (0=No, 1=Si)
-	double valor_multas;         // Valor total de multas pendientes
+	Dinero valor_multas;         // Valor total de multas pendientes (centavos)
 	int meses_retraso;           // Meses de retraso en pagos
 } DatosVehiculo;
 
+/*
+ * Estructura: DeudaAnual
+ * Descripcion: Valor adeudado de un ano fiscal, calculado con las tarifas
+ *              de ese ano (en centavos)
+ */
+typedef struct {
+	int ano;                     // Ano fiscal
+	Dinero impuestos;            // Impuesto a la propiedad + rodaje
+	Dinero tasas;                // SPPAT, ANT, prefectura, RTV y adhesivo
+	Dinero recargos;             // Recargos por mora hasta el ano de pago
+	Dinero total;                // Total del ano
+} DeudaAnual;
+
 // ===================================================================
 // PROTOTIPOS DE FUNCIONES
 // ===================================================================
@@ -138,12 +183,24 @@ void menu_calculo_matricula();
 void calcular_matricula_mostrar();
 
 // Funciones de calculo de matricula
-ResultadoMatricula calcular_matricula_completa(DatosVehiculo vehiculo);
+ResultadoMatricula calcular_matricula_completa(const DatosVehiculo* vehiculo);
+ResultadoMatricula calcular_matricula_con_tarifas(const DatosVehiculo* vehiculo, const TablaTarifas* tarifas);
+ResultadoMatricula calcular_matricula_cacheada(const DatosVehiculo* vehiculo);
 void mostrar_desglose_matricula(ResultadoMatricula resultado);
 
+// Funciones de deuda de varios anos fiscales
+int clase_tarifa_vehiculo(const char* tipo, const char* subtipo, int cilindraje);
+Dinero calcular_deuda_multianual(const DatosVehiculo* vehiculo, int ano_desde, int ano_hasta, DeudaAnual* detalle);
+void menu_deuda_multianual(void);
+
+// Funciones de la cache de calculos
+void invalidar_cache_matricula(const char* placa);
+void invalidar_cache_matricula_completa(void);
+
 // Funciones de generacion de comprobantes
-void generar_comprobante_matricula(const char* placa, ResultadoMatricula resultado, DatosVehiculo vehiculo, const char* numero_comprobante);
-void guardar_comprobante_archivo(const char* placa, ResultadoMatricula resultado, DatosVehiculo vehiculo, const char* numero_comprobante);
+void generar_comprobante_matricula(ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const char* numero_comprobante);
+void guardar_comprobante_archivo(ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const char* numero_comprobante);
+int renderizar_comprobante_archivo(BufferTexto* salida, ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const struct tm* fecha);
 
 // Funciones auxiliares para comprobantes
 void imprimir_linea_decorativa(char caracter, int longitud);
@@ -0,0 +1,293 @@
+/*
+ * matriculas_pagadas.c - Implementacion del archivo de matriculas pagadas
+ *
+ * Descripcion: Este archivo implementa matriculas_pagadas.txt con formato
+ *              versionado, incluyendo:
+ *              - Una sola forma de escribir y de leer cada linea
+ *              - Conversion de las lineas anteriores ('|' o ',') al formato
+ *                vigente, solo al migrar. Las lineas que no se pueden leer
+ *                se conservan sin cambios
+ *              - Migracion en linea: un hilo reescribe el archivo al iniciar
+ *                el programa; las escrituras esperan con un cerrojo mientras
+ *                se reemplaza el archivo
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "matriculas_pagadas.h"
+#include "plantillas.h"
+#include "hilos.h"
+
+// ===================================================================
+// ESTADO DE LA MIGRACION
+// ===================================================================
+
+static Cerrojo cerrojo_archivo;          // Escrituras y migracion del archivo
+static int cerrojo_listo = 0;
+static Hilo hilo_migracion;
+static int migracion_en_curso = 0;
+
+/*
+ * Funcion: preparar_cerrojo
+ * Descripcion: Inicia el cerrojo del archivo la primera vez (siempre desde
+ *              el hilo principal, antes de lanzar la migracion)
+ */
+static void preparar_cerrojo(void) {
+	if (!cerrojo_listo) {
+		cerrojo_iniciar(&cerrojo_archivo);
+		cerrojo_listo = 1;
+	}
+}
+
+// ===================================================================
+// FUNCIONES DE LINEAS
+// ===================================================================
+
+/*
+ * Funcion: formatear_matricula_pagada
+ * Descripcion: Arma la linea de una matricula pagada en el formato vigente
+ * Parametros: destino, tamano, registro
+ * Retorno: Longitud de la linea (sin salto de linea)
+ */
+int formatear_matricula_pagada(char* destino, size_t tamano, const MatriculaPagada* registro) {
+	char monto[MAX_TEXTO_DINERO];
+	// Formato: numero_comprobante|placa|fecha_pago|monto|PAGADO
+	return snprintf(destino, tamano, "%s|%s|%s|%s|PAGADO", registro->numero_comprobante, registro->placa,
+					registro->fecha_pago, dinero_formatear(registro->monto, monto));
+}
+
+/*
+ * Funcion: leer_matricula_pagada
+ * Descripcion: Lee una linea del formato vigente. Es la unica forma de
+ *              leer el archivo cuando ya tiene la cabecera de la version
+ * Parametros: linea, registro (salida)
+ * Retorno: 1 si la linea es valida, 0 si no
+ */
+int leer_matricula_pagada(const char* linea, MatriculaPagada* registro) {
+	char monto[MAX_TEXTO_DINERO];
+	return sscanf(linea, "%49[^|]|%9[^|]|%19[^|]|%23[^|]|", registro->numero_comprobante,
+				  registro->placa, registro->fecha_pago, monto) == 4 && dinero_leer(monto, &registro->monto);
+}
+
+/*
+ * Funcion: leer_matricula_pagada_anterior
+ * Descripcion: Lee una linea de la version 1, separada por '|' o por ','
+ */
+static int leer_matricula_pagada_anterior(const char* linea, MatriculaPagada* registro) {
+	char monto[MAX_TEXTO_DINERO];
+	if (leer_matricula_pagada(linea, registro)) return 1;
+	return sscanf(linea, "%49[^,],%9[^,],%19[^,],%23[^,],", registro->numero_comprobante,
+				  registro->placa, registro->fecha_pago, monto) == 4 && dinero_leer(monto, &registro->monto);
+}
+
+/*
+ * Funcion: normalizar_linea_matricula_pagada
+ * Descripcion: Convierte una linea de cualquier version al formato vigente.
+ *              Una linea que no se puede leer se copia sin cambios, como
+ *              registro anterior: el archivo es un libro de pagos y no se
+ *              descarta nada al migrarlo
+ * Parametros: linea, destino, tamano
+ * Retorno: 1 si se convirtio, 2 si se copio sin cambios, 0 si no cabe en destino
+ */
+int normalizar_linea_matricula_pagada(const char* linea, char* destino, size_t tamano) {
+	MatriculaPagada registro;
+	if (!leer_matricula_pagada_anterior(linea, &registro)) {
+		size_t largo = strlen(linea);
+		if (largo >= tamano) return 0;
+		memcpy(destino, linea, largo + 1);
+		return 2;
+	}
+	int longitud = formatear_matricula_pagada(destino, tamano, &registro);
+	return longitud > 0 && (size_t)longitud < tamano;
+}
+
+// ===================================================================
+// FUNCIONES DEL ARCHIVO
+// ===================================================================
+
+/*
+ * Funcion: version_de_archivo
+ * Descripcion: Lee la version de la cabecera de un archivo abierto
+ * Retorno: Version, 1 si no tiene cabecera, 0 si esta vacio
+ */
+static int version_de_archivo(FILE* archivo) {
+	char linea[200];
+	int version;
+	if (!fgets(linea, sizeof(linea), archivo)) return 0;
+	if (sscanf(linea, "#version|%d|", &version) == 1) return version;
+	return 1;
+}
+
+/*
+ * Funcion: matriculas_pagadas_version
+ * Descripcion: Version del formato de matriculas_pagadas.txt
+ * Parametros: Ninguno
+ * Retorno: Version, 1 si no tiene cabecera, 0 si no existe o esta vacio
+ */
+int matriculas_pagadas_version(void) {
+	FILE* archivo = fopen(ARCHIVO_MATRICULAS_PAGADAS, "r");
+	if (!archivo) return 0;
+	int version = version_de_archivo(archivo);
+	fclose(archivo);
+	return version;
+}
+
+/*
+ * Funcion: matriculas_pagadas_anexar
+ * Descripcion: Agrega lineas (ya en el formato vigente, cada una con su
+ *              salto de linea) con una sola escritura. Si el archivo esta
+ *              vacio, escribe primero la cabecera
+ * Parametros: datos, longitud
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int matriculas_pagadas_anexar(const char* datos, size_t longitud) {
+	if (longitud == 0) return 1;
+	preparar_cerrojo();
+	cerrojo_tomar(&cerrojo_archivo);
+
+	int exito = 0;
+	FILE* archivo = fopen(ARCHIVO_MATRICULAS_PAGADAS, "a");
+	if (archivo) {
+		fseek(archivo, 0, SEEK_END);
+		exito = 1;
+		if (ftell(archivo) == 0) {
+			exito = fprintf(archivo, CABECERA_MATRICULAS_PAGADAS, VERSION_MATRICULAS_PAGADAS) > 0;
+		}
+		exito = exito && fwrite(datos, 1, longitud, archivo) == longitud;
+		if (fclose(archivo) != 0) exito = 0;
+	}
+
+	cerrojo_soltar(&cerrojo_archivo);
+	return exito;
+}
+
+/*
+ * Funcion: matriculas_pagadas_vaciar
+ * Descripcion: Deja el archivo solo con la cabecera
+ * Parametros: Ninguno
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int matriculas_pagadas_vaciar(void) {
+	preparar_cerrojo();
+	cerrojo_tomar(&cerrojo_archivo);
+
+	int exito = 0;
+	FILE* archivo = fopen(ARCHIVO_MATRICULAS_PAGADAS, "w");
+	if (archivo) {
+		exito = fprintf(archivo, CABECERA_MATRICULAS_PAGADAS, VERSION_MATRICULAS_PAGADAS) > 0;
+		if (fclose(archivo) != 0) exito = 0;
+	}
+
+	cerrojo_soltar(&cerrojo_archivo);
+	return exito;
+}
+
+/*
+ * Funcion: migrar_matriculas_pagadas
+ * Descripcion: Reescribe matriculas_pagadas.txt en el formato vigente si
+ *              todavia tiene el formato anterior. Se escribe un temporal y
+ *              se reemplaza el archivo, con el cerrojo tomado para que no
+ *              se pierdan lineas agregadas mientras tanto. Las lineas que
+ *              no se pueden leer se conservan sin cambios. Si algo falla
+ *              el archivo original queda como estaba
+ * Parametros: Ninguno
+ * Retorno: Lineas migradas, 0 si ya estaba al dia, -1 si hubo error
+ */
+int migrar_matriculas_pagadas(void) {
+	preparar_cerrojo();
+	cerrojo_tomar(&cerrojo_archivo);
+
+	FILE* archivo = fopen(ARCHIVO_MATRICULAS_PAGADAS, "r");
+	if (!archivo) {
+		cerrojo_soltar(&cerrojo_archivo);
+		return 0;
+	}
+	int version = version_de_archivo(archivo);
+	if (version == 0 || version >= VERSION_MATRICULAS_PAGADAS) {
+		fclose(archivo);
+		cerrojo_soltar(&cerrojo_archivo);
+		return 0;
+	}
+	rewind(archivo);
+
+	BufferTexto salida;
+	char linea[MAX_LINEA_MATRICULA_PAGADA], convertida[MAX_LINEA_MATRICULA_PAGADA];
+	int migradas = 0;
+	int longitud = snprintf(convertida, sizeof(convertida), CABECERA_MATRICULAS_PAGADAS, VERSION_MATRICULAS_PAGADAS);
+	int exito;
+
+	buffer_iniciar(&salida);
+	exito = buffer_agregar(&salida, convertida, (size_t)longitud);
+	while (exito && fgets(linea, sizeof(linea), archivo)) {
+		// Una linea que no cabe no se puede copiar entera: no se migra nada
+		if (!strchr(linea, '\n') && !feof(archivo)) {
+			exito = 0;
+			break;
+		}
+		linea[strcspn(linea, "\r\n")] = '\0';
+		if (linea[0] == '\0') continue;
+		exito = normalizar_linea_matricula_pagada(linea, convertida, sizeof(convertida)) &&
+				buffer_agregar(&salida, convertida, strlen(convertida)) && buffer_agregar(&salida, "\n", 1);
+		migradas++;
+	}
+	if (ferror(archivo)) exito = 0;
+	fclose(archivo);
+
+	exito = exito && escribir_buffer_archivo(ARCHIVO_TEMPORAL_MATRICULAS_PAGADAS, &salida, 0);
+	if (exito) {
+		remove(ARCHIVO_MATRICULAS_PAGADAS);
+		exito = rename(ARCHIVO_TEMPORAL_MATRICULAS_PAGADAS, ARCHIVO_MATRICULAS_PAGADAS) == 0;
+	}
+	buffer_liberar(&salida);
+	cerrojo_soltar(&cerrojo_archivo);
+
+	return exito ? migradas : -1;
+}
+
+// ===================================================================
+// MIGRACION EN SEGUNDO PLANO
+// ===================================================================
+
+/*
+ * Funcion: hilo_migrar
+ * Descripcion: Hilo de la migracion en segundo plano
+ */
+static void hilo_migrar(void* argumento) {
+	(void)argumento;
+	migrar_matriculas_pagadas();
+}
+
+/*
+ * Funcion: matriculas_pagadas_iniciar
+ * Descripcion: Si matriculas_pagadas.txt tiene el formato anterior, lo
+ *              migra en segundo plano mientras el programa sigue. Si no se
+ *              puede crear el hilo, migra en este momento
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void matriculas_pagadas_iniciar(void) {
+	preparar_cerrojo();
+	int version = matriculas_pagadas_version();
+	if (version == 0 || version >= VERSION_MATRICULAS_PAGADAS || migracion_en_curso) return;
+
+	migracion_en_curso = hilo_crear(&hilo_migracion, hilo_migrar, NULL);
+	if (!migracion_en_curso) {
+		migrar_matriculas_pagadas();
+	}
+}
+
+/*
+ * Funcion: matriculas_pagadas_finalizar
+ * Descripcion: Espera a que termine la migracion en segundo plano
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void matriculas_pagadas_finalizar(void) {
+	if (migracion_en_curso) {
+		hilo_esperar(hilo_migracion);
+		migracion_en_curso = 0;
+	}
+}
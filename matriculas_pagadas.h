@@ -0,0 +1,75 @@
+/*
+ * matriculas_pagadas.h - Libreria del archivo de matriculas pagadas
+ *
+ * Descripcion: Este archivo contiene las constantes, estructuras y
+ *              prototipos de matriculas_pagadas.txt. El archivo empieza
+ *              con una cabecera que indica la version del formato y todas
+ *              sus lineas usan un solo formato:
+ *                  numero_comprobante|placa|fecha_pago|monto|PAGADO
+ *              Los archivos anteriores (sin cabecera, con lineas separadas
+ *              por '|' o por ',') se convierten en segundo plano al iniciar
+ *              el programa, asi quien lee el archivo usa una sola forma de
+ *              leer cada linea.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef MATRICULAS_PAGADAS_H
+#define MATRICULAS_PAGADAS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pagos.h"
+
+// ===================================================================
+// CONSTANTES DE MATRICULAS PAGADAS
+// ===================================================================
+
+#define ARCHIVO_MATRICULAS_PAGADAS "matriculas_pagadas.txt"
+#define ARCHIVO_TEMPORAL_MATRICULAS_PAGADAS "matriculas_pagadas.tmp"
+
+// Version 1: sin cabecera, lineas con '|' o con ','. Version 2: cabecera y solo '|'
+#define VERSION_MATRICULAS_PAGADAS 2
+#define CABECERA_MATRICULAS_PAGADAS "#version|%d|numero_comprobante|placa|fecha_pago|monto|estado\n"
+#define PREFIJO_CABECERA_VERSION "#version|"
+#define MAX_LINEA_MATRICULA_PAGADA 512
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: MatriculaPagada
+ * Descripcion: Una linea de matriculas_pagadas.txt
+ */
+typedef struct {
+	char numero_comprobante[MAX_COMPROBANTE];
+	char placa[10];
+	char fecha_pago[20];
+	Dinero monto;                // Centavos
+} MatriculaPagada;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de lineas
+int formatear_matricula_pagada(char* destino, size_t tamano, const MatriculaPagada* registro);
+int leer_matricula_pagada(const char* linea, MatriculaPagada* registro);
+int normalizar_linea_matricula_pagada(const char* linea, char* destino, size_t tamano);
+
+// Funciones del archivo
+int matriculas_pagadas_version(void);
+int matriculas_pagadas_anexar(const char* datos, size_t longitud);
+int matriculas_pagadas_vaciar(void);
+int migrar_matriculas_pagadas(void);
+
+// Migracion en segundo plano
+void matriculas_pagadas_iniciar(void);
+void matriculas_pagadas_finalizar(void);
+
+#endif // MATRICULAS_PAGADAS_H
@@ -0,0 +1,427 @@
+/*
+ * motor_binario.c - Implementacion del motor de almacenamiento binario
+ *
+ * Descripcion: Este archivo implementa el motor binario, incluyendo:
+ *              - Indice hash en memoria (clave -> posicion del registro),
+ *                armado al abrir la tabla con un recorrido del archivo
+ *              - Lectura de un registro con un solo acceso directo
+ *              - Cambios en el mismo lugar si el valor nuevo cabe; si no,
+ *                el registro anterior se marca como reemplazado y se agrega
+ *                uno nuevo al final
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "motor_binario.h"
+#include <stdint.h>
+#include <direct.h>      // Para _mkdir en Windows
+#include <sys/stat.h>    // Para verificar si existe la carpeta
+
+// Posicionamiento de 64 bits para archivos mayores a 2 GB
+#ifdef _WIN32
+#define BUSCAR_64(archivo, pos) _fseeki64((archivo), (pos), SEEK_SET)
+#define POSICION_64(archivo) _ftelli64(archivo)
+#else
+#define BUSCAR_64(archivo, pos) fseeko((archivo), (off_t)(pos), SEEK_SET)
+#define POSICION_64(archivo) ((long long)ftello(archivo))
+#endif
+
+#define TAMANO_CABECERA_BINARIA 16
+
+/*
+ * Estructura: CabeceraRegistroBinario
+ * Descripcion: Cabecera de cada registro. Le siguen la clave (sin '\0') y
+ *              'capacidad' bytes para el valor
+ */
+typedef struct {
+	char magia[4];                 // "REG1"
+	uint8_t vigente;               // 0 si el registro fue reemplazado
+	uint8_t longitud_clave;        // Bytes de la clave
+	uint16_t capacidad;            // Bytes reservados para el valor
+	uint16_t longitud_valor;       // Bytes usados del valor
+	uint16_t reservado;            // Sin uso (cero)
+	uint32_t suma_verificacion;    // FNV-1a del valor
+} CabeceraRegistroBinario;
+
+/*
+ * Estructura: EntradaHashBinaria
+ * Descripcion: Ranura del indice: hash de la clave y posicion + 1 del
+ *              registro (0 = ranura vacia)
+ */
+typedef struct {
+	uint64_t hash;
+	long long posicion;
+} EntradaHashBinaria;
+
+/*
+ * Estructura: TablaBinaria
+ * Descripcion: Archivo abierto e indice de una tabla
+ */
+typedef struct {
+	const TablaRepositorio* tabla;
+	FILE* archivo;
+	long long fin;                 // Fin del ultimo registro valido
+	int escribiendo;               // Ultima operacion: 1 escritura, 0 lectura, -1 ninguna
+	EntradaHashBinaria* indice;    // Sondeo lineal, capacidad potencia de 2
+	int capacidad;
+	int cantidad;
+	int pendiente;                 // 1 si hay escrituras sin confirmar
+} TablaBinaria;
+
+static TablaBinaria tablas_binarias[MAX_TABLAS_BINARIAS];
+static char area_valor[UINT16_MAX + 1];    // Espacio del valor al recorrer un archivo
+
+// ===================================================================
+// INDICE EN MEMORIA
+// ===================================================================
+
+/*
+ * Funcion: hash_clave
+ * Descripcion: Hash FNV-1a de 64 bits de una clave
+ */
+static uint64_t hash_clave(const char* clave) {
+	uint64_t hash = 1469598103934665603ull;
+	for (const char* c = clave; *c; c++) {
+		hash ^= (unsigned char)*c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static uint32_t suma_valor(const char* valor, size_t longitud) {
+	uint32_t suma = 2166136261u;
+	for (size_t i = 0; i < longitud; i++) {
+		suma ^= (unsigned char)valor[i];
+		suma *= 16777619u;
+	}
+	return suma;
+}
+
+/*
+ * Funcion: insertar_posicion
+ * Descripcion: Agrega una entrada al indice, duplicando la tabla cuando
+ *              supera el 70% de ocupacion
+ * Retorno: 1 si fue exitoso, 0 si no hubo memoria
+ */
+static int insertar_posicion(TablaBinaria* t, uint64_t hash, long long posicion) {
+	if ((t->cantidad + 1) * 10 > t->capacidad * 7) {
+		int nueva_capacidad = t->capacidad ? t->capacidad * 2 : 1024;
+		EntradaHashBinaria* nuevo = calloc((size_t)nueva_capacidad, sizeof(EntradaHashBinaria));
+		if (!nuevo) return 0;
+		for (int i = 0; i < t->capacidad; i++) {
+			if (t->indice[i].posicion == 0) continue;
+			int j = (int)(t->indice[i].hash & (uint64_t)(nueva_capacidad - 1));
+			while (nuevo[j].posicion != 0) j = (j + 1) & (nueva_capacidad - 1);
+			nuevo[j] = t->indice[i];
+		}
+		free(t->indice);
+		t->indice = nuevo;
+		t->capacidad = nueva_capacidad;
+	}
+
+	int i = (int)(hash & (uint64_t)(t->capacidad - 1));
+	while (t->indice[i].posicion != 0) i = (i + 1) & (t->capacidad - 1);
+	t->indice[i].hash = hash;
+	t->indice[i].posicion = posicion + 1;
+	t->cantidad++;
+	return 1;
+}
+
+/*
+ * Funcion: ir_a
+ * Descripcion: Posiciona el archivo solo si hace falta. Mover el archivo
+ *              descarta el buffer de stdio; en recorridos y cargas
+ *              seguidas los registros se leen o escriben uno tras otro sin
+ *              moverlo. Al pasar de leer a escribir siempre se posiciona
+ */
+static int ir_a(TablaBinaria* t, long long posicion, int escritura) {
+	if (t->escribiendo == escritura && POSICION_64(t->archivo) == posicion) return 1;
+	t->escribiendo = escritura;
+	return BUSCAR_64(t->archivo, posicion) == 0;
+}
+
+/*
+ * Funcion: leer_cabecera_binaria
+ * Descripcion: Lee y valida la cabecera y la clave de un registro
+ * Parametros: t, posicion, cabecera (salida), clave (salida, MAX_CLAVE_REGISTRO)
+ * Retorno: 1 si hay un registro valido completo en la posicion, 0 si no
+ */
+static int leer_cabecera_binaria(TablaBinaria* t, long long posicion, CabeceraRegistroBinario* cabecera, char* clave) {
+	if (!ir_a(t, posicion, 0)) return 0;
+	if (fread(cabecera, 1, TAMANO_CABECERA_BINARIA, t->archivo) != TAMANO_CABECERA_BINARIA) return 0;
+	if (memcmp(cabecera->magia, MAGIA_REGISTRO_BINARIO, 4) != 0) return 0;
+	if (cabecera->longitud_clave == 0 || cabecera->longitud_clave >= MAX_CLAVE_REGISTRO) return 0;
+	if (cabecera->longitud_valor > cabecera->capacidad) return 0;
+	if (fread(clave, 1, cabecera->longitud_clave, t->archivo) != cabecera->longitud_clave) return 0;
+	clave[cabecera->longitud_clave] = '\0';
+	return 1;
+}
+
+/*
+ * Funcion: buscar_ranura
+ * Descripcion: Busca la ranura del indice de una clave. Entre las ranuras
+ *              con el mismo hash se comprueba la clave en el archivo
+ * Parametros: t, clave, cabecera (salida, del registro encontrado)
+ * Retorno: Indice de la ranura, -1 si la clave no esta
+ */
+static int buscar_ranura(TablaBinaria* t, const char* clave, CabeceraRegistroBinario* cabecera) {
+	if (t->capacidad == 0) return -1;
+	uint64_t hash = hash_clave(clave);
+	int i = (int)(hash & (uint64_t)(t->capacidad - 1));
+	char leida[MAX_CLAVE_REGISTRO];
+
+	while (t->indice[i].posicion != 0) {
+		if (t->indice[i].hash == hash &&
+			leer_cabecera_binaria(t, t->indice[i].posicion - 1, cabecera, leida) &&
+			strcmp(leida, clave) == 0) {
+			return i;
+		}
+		i = (i + 1) & (t->capacidad - 1);
+	}
+	return -1;
+}
+
+// ===================================================================
+// ARCHIVOS DE LAS TABLAS
+// ===================================================================
+
+/*
+ * Funcion: cargar_tabla_binaria
+ * Descripcion: Recorre el archivo de una tabla y arma su indice. Un
+ *              registro incompleto al final (el programa se cerro a mitad
+ *              de una escritura) se ignora y se sobreescribe despues
+ */
+static int cargar_tabla_binaria(TablaBinaria* t) {
+	CabeceraRegistroBinario cabecera;
+	char clave[MAX_CLAVE_REGISTRO];
+	long long posicion = 0;
+
+	t->escribiendo = -1;
+	while (leer_cabecera_binaria(t, posicion, &cabecera, clave)) {
+		// Se lee el espacio del valor para seguir sin mover el archivo
+		if (fread(area_valor, 1, cabecera.capacidad, t->archivo) != cabecera.capacidad) break;
+		if (cabecera.vigente && !insertar_posicion(t, hash_clave(clave), posicion)) return 0;
+		posicion += TAMANO_CABECERA_BINARIA + cabecera.longitud_clave + cabecera.capacidad;
+	}
+	t->fin = posicion;
+	return 1;
+}
+
+/*
+ * Funcion: tabla_binaria
+ * Descripcion: Devuelve la tabla abierta; la primera vez abre (o crea) su
+ *              archivo y arma el indice
+ * Parametros: tabla, creada (salida, puede ser NULL) - 1 si el archivo no existia
+ * Retorno: Tabla abierta, NULL si hubo error
+ */
+static TablaBinaria* tabla_binaria(const TablaRepositorio* tabla, int* creada) {
+	TablaBinaria* libre = NULL;
+	if (creada) *creada = 0;
+
+	for (int i = 0; i < MAX_TABLAS_BINARIAS; i++) {
+		if (tablas_binarias[i].tabla == tabla) return &tablas_binarias[i];
+		if (!libre && !tablas_binarias[i].tabla) libre = &tablas_binarias[i];
+	}
+	if (!libre) return NULL;
+
+	struct stat st = {0};
+	if (stat(CARPETA_DATOS, &st) == -1) {
+		_mkdir(CARPETA_DATOS);
+	}
+
+	char ruta[80];
+	snprintf(ruta, sizeof(ruta), "%s/%s.dat", CARPETA_DATOS, tabla->nombre);
+	memset(libre, 0, sizeof(*libre));
+	libre->archivo = fopen(ruta, "r+b");
+	if (!libre->archivo) {
+		libre->archivo = fopen(ruta, "w+b");
+		if (!libre->archivo) return NULL;
+		if (creada) *creada = 1;
+	}
+
+	libre->tabla = tabla;
+	if (!cargar_tabla_binaria(libre)) {
+		fclose(libre->archivo);
+		free(libre->indice);
+		memset(libre, 0, sizeof(*libre));
+		return NULL;
+	}
+	return libre;
+}
+
+/*
+ * Funcion: escribir_registro_binario
+ * Descripcion: Escribe un registro completo (cabecera, clave y valor con
+ *              su espacio de sobra) en una posicion
+ */
+static int escribir_registro_binario(TablaBinaria* t, long long posicion, const char* clave,
+									 const char* valor, int capacidad) {
+	CabeceraRegistroBinario cabecera;
+	size_t longitud_clave = strlen(clave);
+	size_t longitud_valor = strlen(valor);
+	char relleno[HOLGURA_REGISTRO_BINARIO] = {0};
+
+	memset(&cabecera, 0, sizeof(cabecera));
+	memcpy(cabecera.magia, MAGIA_REGISTRO_BINARIO, 4);
+	cabecera.vigente = 1;
+	cabecera.longitud_clave = (uint8_t)longitud_clave;
+	cabecera.capacidad = (uint16_t)capacidad;
+	cabecera.longitud_valor = (uint16_t)longitud_valor;
+	cabecera.suma_verificacion = suma_valor(valor, longitud_valor);
+
+	t->pendiente = 1;
+	return ir_a(t, posicion, 1) &&
+		   fwrite(&cabecera, 1, TAMANO_CABECERA_BINARIA, t->archivo) == TAMANO_CABECERA_BINARIA &&
+		   fwrite(clave, 1, longitud_clave, t->archivo) == longitud_clave &&
+		   fwrite(valor, 1, longitud_valor, t->archivo) == longitud_valor &&
+		   fwrite(relleno, 1, (size_t)capacidad - longitud_valor, t->archivo) == (size_t)capacidad - longitud_valor;
+}
+
+/*
+ * Funcion: escribir_valor
+ * Descripcion: Guarda el valor de una clave. Si la clave existe y el valor
+ *              cabe en su espacio, se cambia en el mismo lugar; si no, se
+ *              agrega un registro al final
+ * Parametros: t, clave, valor, solo_existente - 1 para no agregar claves nuevas
+ * Retorno: 1 si fue exitoso, 0 si hubo error o la clave no existe
+ */
+static int escribir_valor(TablaBinaria* t, const char* clave, const char* valor, int solo_existente) {
+	size_t longitud_clave = strlen(clave);
+	size_t longitud_valor = strlen(valor);
+	if (longitud_clave == 0 || longitud_clave >= MAX_CLAVE_REGISTRO || longitud_valor >= MAX_VALOR_REGISTRO) return 0;
+
+	CabeceraRegistroBinario cabecera;
+	int ranura = buscar_ranura(t, clave, &cabecera);
+	if (ranura < 0 && solo_existente) return 0;
+
+	if (ranura >= 0) {
+		long long posicion = t->indice[ranura].posicion - 1;
+		if (longitud_valor <= cabecera.capacidad) {
+			return escribir_registro_binario(t, posicion, clave, valor, cabecera.capacidad);
+		}
+		// No cabe: el registro anterior queda como reemplazado
+		uint8_t reemplazado = 0;
+		if (!ir_a(t, posicion + 4, 1) || fwrite(&reemplazado, 1, 1, t->archivo) != 1) return 0;
+	}
+
+	int capacidad = (int)((longitud_valor + HOLGURA_REGISTRO_BINARIO) / HOLGURA_REGISTRO_BINARIO * HOLGURA_REGISTRO_BINARIO);
+	long long posicion = t->fin;
+	if (!escribir_registro_binario(t, posicion, clave, valor, capacidad)) return 0;
+	t->fin = posicion + TAMANO_CABECERA_BINARIA + (long long)longitud_clave + capacidad;
+
+	if (ranura >= 0) {
+		t->indice[ranura].posicion = posicion + 1;
+		return 1;
+	}
+	return insertar_posicion(t, hash_clave(clave), posicion);
+}
+
+// ===================================================================
+// OPERACIONES DEL MOTOR
+// ===================================================================
+
+static int abrir_binario(const TablaRepositorio* tabla) {
+	int creada;
+	if (!tabla_binaria(tabla, &creada)) return 0;
+	return creada ? 2 : 1;
+}
+
+static int obtener_binario(const TablaRepositorio* tabla, const char* clave, char* valor, size_t tamano) {
+	TablaBinaria* t = tabla_binaria(tabla, NULL);
+	CabeceraRegistroBinario cabecera;
+	if (!t || buscar_ranura(t, clave, &cabecera) < 0 || cabecera.longitud_valor >= tamano) return 0;
+
+	// buscar_ranura deja el archivo justo despues de la clave
+	if (fread(valor, 1, cabecera.longitud_valor, t->archivo) != cabecera.longitud_valor) return 0;
+	valor[cabecera.longitud_valor] = '\0';
+	return suma_valor(valor, cabecera.longitud_valor) == cabecera.suma_verificacion;
+}
+
+static int guardar_binario(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	TablaBinaria* t = tabla_binaria(tabla, NULL);
+	return t && escribir_valor(t, clave, valor, 0);
+}
+
+static int actualizar_binario(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	TablaBinaria* t = tabla_binaria(tabla, NULL);
+	return t && escribir_valor(t, clave, valor, 1);
+}
+
+/*
+ * Funcion: recorrer_binario
+ * Descripcion: Entrega los registros vigentes en el orden del archivo
+ */
+static long recorrer_binario(const TablaRepositorio* tabla, FuncionRegistro funcion, void* contexto) {
+	TablaBinaria* t = tabla_binaria(tabla, NULL);
+	if (!t) return -1;
+
+	CabeceraRegistroBinario cabecera;
+	char clave[MAX_CLAVE_REGISTRO], valor[MAX_VALOR_REGISTRO];
+	long long posicion = 0;
+	long registros = 0;
+
+	while (posicion < t->fin && leer_cabecera_binaria(t, posicion, &cabecera, clave)) {
+		posicion += TAMANO_CABECERA_BINARIA + cabecera.longitud_clave + cabecera.capacidad;
+		if (fread(area_valor, 1, cabecera.capacidad, t->archivo) != cabecera.capacidad) break;
+		if (!cabecera.vigente || cabecera.longitud_valor >= sizeof(valor)) continue;
+		memcpy(valor, area_valor, cabecera.longitud_valor);
+		valor[cabecera.longitud_valor] = '\0';
+		registros++;
+		if (!funcion(clave, valor, contexto)) break;
+	}
+	return registros;
+}
+
+static int vaciar_binario(const TablaRepositorio* tabla) {
+	TablaBinaria* t = tabla_binaria(tabla, NULL);
+	if (!t) return 0;
+
+	char ruta[80];
+	snprintf(ruta, sizeof(ruta), "%s/%s.dat", CARPETA_DATOS, tabla->nombre);
+	fclose(t->archivo);
+	t->archivo = fopen(ruta, "w+b");
+	t->escribiendo = -1;
+	free(t->indice);
+	t->indice = NULL;
+	t->capacidad = t->cantidad = 0;
+	t->fin = 0;
+	t->pendiente = 0;
+	if (!t->archivo) {
+		t->tabla = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+static int confirmar_binario(void) {
+	int exito = 1;
+	for (int i = 0; i < MAX_TABLAS_BINARIAS; i++) {
+		TablaBinaria* t = &tablas_binarias[i];
+		if (t->tabla && t->pendiente) {
+			if (fflush(t->archivo) != 0) exito = 0;
+			t->pendiente = 0;
+		}
+	}
+	return exito;
+}
+
+static int cerrar_binario(void) {
+	int exito = 1;
+	for (int i = 0; i < MAX_TABLAS_BINARIAS; i++) {
+		TablaBinaria* t = &tablas_binarias[i];
+		if (!t->tabla) continue;
+		if (fclose(t->archivo) != 0) exito = 0;
+		free(t->indice);
+		memset(t, 0, sizeof(*t));
+	}
+	return exito;
+}
+
+const MotorAlmacen motor_binario = {
+	"binario", 0,
+	abrir_binario, obtener_binario, guardar_binario, actualizar_binario,
+	recorrer_binario, NULL, vaciar_binario, confirmar_binario, cerrar_binario
+};
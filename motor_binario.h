@@ -0,0 +1,32 @@
+/*
+ * motor_binario.h - Libreria del motor de almacenamiento binario
+ *
+ * Descripcion: Este archivo contiene las constantes y el motor binario del
+ *              repositorio. Cada tabla es un archivo de registros
+ *              (datos/<tabla>.dat): cabecera de 16 bytes, la clave y el
+ *              valor con espacio de sobra para cambiarlo en su lugar. Un
+ *              indice hash en memoria lleva cada clave a la posicion de su
+ *              registro, asi una consulta es una sola lectura.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef MOTOR_BINARIO_H
+#define MOTOR_BINARIO_H
+
+#include "repositorio.h"
+
+// ===================================================================
+// CONSTANTES DEL MOTOR BINARIO
+// ===================================================================
+
+#define MAGIA_REGISTRO_BINARIO "REG1"
+#define HOLGURA_REGISTRO_BINARIO 16      // El espacio del valor se redondea a multiplos de 16
+#define MAX_TABLAS_BINARIAS 8            // Tablas abiertas a la vez (incluye la de prueba)
+
+extern const MotorAlmacen motor_binario;
+
+#endif // MOTOR_BINARIO_H
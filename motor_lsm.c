@@ -0,0 +1,1252 @@
+/*
+ * motor_lsm.c - Implementacion del motor de almacenamiento LSM
+ *
+ * Descripcion: Este archivo implementa el motor LSM, incluyendo:
+ *              - Tabla en memoria: una lista por saltos ordenada por clave
+ *              - Archivos ordenados e inmutables con indice disperso (una
+ *                clave cada INTERVALO_INDICE_LSM registros) y filtro de
+ *                Bloom, cargados en memoria al abrir la tabla
+ *              - Manifiesto por tabla (datos/<tabla>.lsm) con los archivos
+ *                vigentes y su nivel; se reemplaza entero en cada cambio
+ *              - Compactacion por niveles en un hilo en segundo plano: los
+ *                archivos del nivel 0 se mezclan con el nivel 1, y un nivel
+ *                que pasa su limite se mezcla con el siguiente
+ *              La tabla en memoria no tiene registro propio: como en los
+ *              otros motores, si el programa no termina bien la tabla se
+ *              vuelve a cargar desde los archivos de texto.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "motor_lsm.h"
+#include "hilos.h"
+#include <stdint.h>
+#include <direct.h>      // Para _mkdir en Windows
+#include <sys/stat.h>    // Para verificar si existe la carpeta
+
+// Posicionamiento de 64 bits para archivos mayores a 2 GB
+#ifdef _WIN32
+#define BUSCAR_64(archivo, pos) _fseeki64((archivo), (pos), SEEK_SET)
+#define FINAL_64(archivo, desplazamiento) _fseeki64((archivo), (desplazamiento), SEEK_END)
+#define POSICION_64(archivo) _ftelli64(archivo)
+#else
+#define BUSCAR_64(archivo, pos) fseeko((archivo), (off_t)(pos), SEEK_SET)
+#define FINAL_64(archivo, desplazamiento) fseeko((archivo), (off_t)(desplazamiento), SEEK_END)
+#define POSICION_64(archivo) ((long long)ftello(archivo))
+#endif
+
+#define TAMANO_CABECERA_LSM 4
+#define TAMANO_PIE_SSTABLE 96
+
+/*
+ * Estructura: NodoMemtabla
+ * Descripcion: Registro de la tabla en memoria con sus enlaces de la
+ *              lista por saltos ('altura' enlaces)
+ */
+typedef struct NodoMemtabla {
+	char clave[MAX_CLAVE_REGISTRO];
+	char* valor;
+	int altura;
+	struct NodoMemtabla* siguiente[];
+} NodoMemtabla;
+
+/*
+ * Estructura: Memtabla
+ * Descripcion: Lista por saltos con las escrituras aun no volcadas
+ */
+typedef struct {
+	NodoMemtabla* cabeza;          // Nodo sin clave con ALTURA_MAXIMA_LSM enlaces
+	int altura;
+	int cantidad;
+} Memtabla;
+
+/*
+ * Estructura: CabeceraRegistroLsm
+ * Descripcion: Cabecera de cada registro de un archivo ordenado. Le siguen
+ *              la clave y el valor (sin '\0')
+ */
+typedef struct {
+	uint8_t longitud_clave;
+	uint8_t reservado;
+	uint16_t longitud_valor;
+} CabeceraRegistroLsm;
+
+/*
+ * Estructura: PieSSTable
+ * Descripcion: Ultimos 96 bytes de un archivo ordenado. Antes del pie van
+ *              los registros, las claves y posiciones del indice disperso y
+ *              el filtro de Bloom
+ */
+typedef struct {
+	char magia[4];                 // "SST1"
+	uint32_t registros;
+	uint32_t entradas_indice;
+	uint32_t bits_bloom;
+	uint64_t posicion_indice;      // Fin de los registros
+	uint64_t posicion_bloom;
+	char ultima_clave[64];
+} PieSSTable;
+
+/*
+ * Estructura: SSTable
+ * Descripcion: Archivo ordenado abierto, con su indice y filtro en memoria.
+ *              Se libera cuando nadie lo usa (referencias = 0); si ya salio
+ *              del manifiesto, ademas se borra el archivo
+ */
+typedef struct {
+	char ruta[80];
+	unsigned int secuencia;
+	int nivel;
+	long registros;
+	FILE* archivo;                 // Consultas por clave (solo el hilo principal)
+	long long fin_registros;
+	char (*claves_indice)[MAX_CLAVE_REGISTRO];
+	long long* posiciones_indice;
+	int entradas_indice;
+	uint8_t* bloom;
+	uint32_t bits_bloom;
+	char ultima_clave[MAX_CLAVE_REGISTRO];
+	int referencias;
+	int retirada;                  // 1 si ya no esta en el manifiesto
+} SSTable;
+
+/*
+ * Estructura: TablaLsm
+ * Descripcion: Tabla en memoria y archivos vigentes de una tabla. Los
+ *              archivos estan en orden de lectura: el nivel 0 del mas
+ *              nuevo al mas viejo y luego un archivo por nivel, del 1 en
+ *              adelante. Los datos de un archivo son mas nuevos que los de
+ *              los que le siguen
+ */
+typedef struct {
+	const TablaRepositorio* tabla;
+	Memtabla memtabla;
+	SSTable* archivos[MAX_SSTABLES_LSM];
+	int cantidad;
+	unsigned int siguiente_secuencia;
+} TablaLsm;
+
+/*
+ * Estructura: CursorLsm
+ * Descripcion: Recorrido en orden de la tabla en memoria o de un archivo
+ */
+typedef struct {
+	FILE* archivo;                 // NULL = cursor de la tabla en memoria
+	long long fin;
+	NodoMemtabla* nodo;
+	char clave[MAX_CLAVE_REGISTRO];
+	char area[MAX_VALOR_REGISTRO];
+	const char* valor;
+	int valido;
+} CursorLsm;
+
+/*
+ * Estructura: EscritorSSTable
+ * Descripcion: Archivo ordenado en construccion
+ */
+typedef struct {
+	FILE* archivo;
+	long long posicion;
+	long registros;
+	char (*claves_indice)[MAX_CLAVE_REGISTRO];
+	long long* posiciones_indice;
+	int entradas_indice;
+	int capacidad_indice;
+	uint8_t* bloom;
+	uint32_t bits_bloom;
+	char ultima_clave[MAX_CLAVE_REGISTRO];
+} EscritorSSTable;
+
+static TablaLsm tablas_lsm[MAX_TABLAS_LSM];
+
+// El cerrojo protege la lista de archivos de cada tabla, las referencias
+// y el manifiesto. La tabla en memoria solo la usa el hilo principal
+static Cerrojo cerrojo_lsm;
+static int cerrojo_listo = 0;
+static Hilo hilo_compactacion;
+static int compactacion_en_curso = 0;
+static int compactacion_terminada = 0;
+
+static unsigned int estado_altura = 2463534242u;
+
+// ===================================================================
+// TABLA EN MEMORIA
+// ===================================================================
+
+/*
+ * Funcion: nuevo_nodo
+ * Descripcion: Reserva un nodo con 'altura' enlaces
+ */
+static NodoMemtabla* nuevo_nodo(int altura) {
+	NodoMemtabla* nodo = calloc(1, sizeof(NodoMemtabla) + (size_t)altura * sizeof(NodoMemtabla*));
+	if (nodo) nodo->altura = altura;
+	return nodo;
+}
+
+/*
+ * Funcion: altura_aleatoria
+ * Descripcion: Altura de un nodo nuevo: cada nivel con probabilidad 1/4
+ *              (xorshift: la misma secuencia en cada ejecucion)
+ */
+static int altura_aleatoria(void) {
+	int altura = 1;
+	estado_altura ^= estado_altura << 13;
+	estado_altura ^= estado_altura >> 17;
+	estado_altura ^= estado_altura << 5;
+	unsigned int bits = estado_altura;
+	while (altura < ALTURA_MAXIMA_LSM && (bits & 3u) == 0) {
+		altura++;
+		bits >>= 2;
+	}
+	return altura;
+}
+
+static int memtabla_iniciar(Memtabla* m) {
+	m->cabeza = nuevo_nodo(ALTURA_MAXIMA_LSM);
+	m->altura = 1;
+	m->cantidad = 0;
+	return m->cabeza != NULL;
+}
+
+/*
+ * Funcion: memtabla_desde
+ * Descripcion: Primer nodo con clave mayor o igual a la buscada. Si se pasa
+ *              'previos', deja en cada nivel el ultimo nodo anterior
+ */
+static NodoMemtabla* memtabla_desde(Memtabla* m, const char* clave, NodoMemtabla** previos) {
+	NodoMemtabla* nodo = m->cabeza;
+	for (int nivel = ALTURA_MAXIMA_LSM - 1; nivel >= 0; nivel--) {
+		while (nivel < m->altura && nodo->siguiente[nivel] && strcmp(nodo->siguiente[nivel]->clave, clave) < 0) {
+			nodo = nodo->siguiente[nivel];
+		}
+		if (previos) previos[nivel] = nodo;
+	}
+	return nodo->siguiente[0];
+}
+
+static NodoMemtabla* memtabla_buscar(Memtabla* m, const char* clave) {
+	NodoMemtabla* nodo = memtabla_desde(m, clave, NULL);
+	return (nodo && strcmp(nodo->clave, clave) == 0) ? nodo : NULL;
+}
+
+/*
+ * Funcion: memtabla_poner
+ * Descripcion: Agrega una clave o reemplaza su valor
+ * Retorno: 1 si fue exitoso, 0 si no hubo memoria
+ */
+static int memtabla_poner(Memtabla* m, const char* clave, const char* valor) {
+	NodoMemtabla* previos[ALTURA_MAXIMA_LSM];
+	NodoMemtabla* nodo = memtabla_desde(m, clave, previos);
+	size_t longitud = strlen(valor);
+
+	char* copia = malloc(longitud + 1);
+	if (!copia) return 0;
+	memcpy(copia, valor, longitud + 1);
+
+	if (nodo && strcmp(nodo->clave, clave) == 0) {
+		free(nodo->valor);
+		nodo->valor = copia;
+		return 1;
+	}
+
+	int altura = altura_aleatoria();
+	nodo = nuevo_nodo(altura);
+	if (!nodo) {
+		free(copia);
+		return 0;
+	}
+	strcpy(nodo->clave, clave);
+	nodo->valor = copia;
+	if (altura > m->altura) m->altura = altura;
+	for (int nivel = 0; nivel < altura; nivel++) {
+		nodo->siguiente[nivel] = previos[nivel]->siguiente[nivel];
+		previos[nivel]->siguiente[nivel] = nodo;
+	}
+	m->cantidad++;
+	return 1;
+}
+
+/*
+ * Funcion: memtabla_vaciar
+ * Descripcion: Libera todos los nodos (la cabeza queda para seguir usandola)
+ */
+static void memtabla_vaciar(Memtabla* m) {
+	if (!m->cabeza) return;
+	NodoMemtabla* nodo = m->cabeza->siguiente[0];
+	while (nodo) {
+		NodoMemtabla* siguiente = nodo->siguiente[0];
+		free(nodo->valor);
+		free(nodo);
+		nodo = siguiente;
+	}
+	memset(m->cabeza->siguiente, 0, ALTURA_MAXIMA_LSM * sizeof(NodoMemtabla*));
+	m->altura = 1;
+	m->cantidad = 0;
+}
+
+// ===================================================================
+// FILTRO DE BLOOM
+// ===================================================================
+
+/*
+ * Funcion: hash_clave
+ * Descripcion: Hash FNV-1a de 64 bits de una clave
+ */
+static uint64_t hash_clave(const char* clave) {
+	uint64_t hash = 1469598103934665603ull;
+	for (const char* c = clave; *c; c++) {
+		hash ^= (unsigned char)*c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/*
+ * Funcion: bloom_revisar
+ * Descripcion: Marca (marcar = 1) o revisa los bits de una clave. Los
+ *              HASHES_BLOOM_LSM bits salen de las dos mitades del hash
+ * Retorno: 1 si todos los bits estaban marcados (la clave puede estar)
+ */
+static int bloom_revisar(uint8_t* bloom, uint32_t bits, const char* clave, int marcar) {
+	uint64_t hash = hash_clave(clave);
+	uint32_t h1 = (uint32_t)hash;
+	uint32_t h2 = (uint32_t)(hash >> 32) | 1u;
+	int presentes = 1;
+
+	for (uint32_t i = 0; i < HASHES_BLOOM_LSM; i++) {
+		uint32_t bit = (h1 + i * h2) % bits;
+		if (marcar) {
+			bloom[bit / 8] |= (uint8_t)(1u << (bit % 8));
+		} else if (!(bloom[bit / 8] & (1u << (bit % 8)))) {
+			presentes = 0;
+			break;
+		}
+	}
+	return presentes;
+}
+
+// ===================================================================
+// ARCHIVOS ORDENADOS
+// ===================================================================
+
+static void ruta_sstable(const TablaRepositorio* tabla, unsigned int secuencia, char* ruta) {
+	snprintf(ruta, 80, "%s/%s_%06u.sst", CARPETA_DATOS, tabla->nombre, secuencia);
+}
+
+/*
+ * Funcion: leer_registro_lsm
+ * Descripcion: Lee el registro en la posicion actual del archivo
+ * Parametros: archivo, clave (salida, MAX_CLAVE_REGISTRO), valor (salida,
+ *             MAX_VALOR_REGISTRO)
+ * Retorno: Bytes del registro, 0 si no hay un registro valido
+ */
+static long leer_registro_lsm(FILE* archivo, char* clave, char* valor) {
+	CabeceraRegistroLsm cabecera;
+	if (fread(&cabecera, 1, TAMANO_CABECERA_LSM, archivo) != TAMANO_CABECERA_LSM) return 0;
+	if (cabecera.longitud_clave == 0 || cabecera.longitud_clave >= MAX_CLAVE_REGISTRO ||
+		cabecera.longitud_valor >= MAX_VALOR_REGISTRO) {
+		return 0;
+	}
+	if (fread(clave, 1, cabecera.longitud_clave, archivo) != cabecera.longitud_clave ||
+		fread(valor, 1, cabecera.longitud_valor, archivo) != cabecera.longitud_valor) {
+		return 0;
+	}
+	clave[cabecera.longitud_clave] = '\0';
+	valor[cabecera.longitud_valor] = '\0';
+	return TAMANO_CABECERA_LSM + cabecera.longitud_clave + cabecera.longitud_valor;
+}
+
+/*
+ * Funcion: escritor_abrir
+ * Descripcion: Crea un archivo ordenado. El filtro se dimensiona con los
+ *              registros esperados (si llegan mas, solo sube la tasa de
+ *              falsos positivos)
+ */
+static int escritor_abrir(EscritorSSTable* e, const char* ruta, long esperados) {
+	memset(e, 0, sizeof(*e));
+	if (esperados < 1) esperados = 1;
+	e->bits_bloom = (uint32_t)((esperados * BITS_BLOOM_LSM + 63) / 64 * 64);
+	e->bloom = calloc(e->bits_bloom / 8, 1);
+	e->archivo = e->bloom ? fopen(ruta, "wb") : NULL;
+	if (!e->archivo) {
+		free(e->bloom);
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Funcion: escritor_agregar
+ * Descripcion: Agrega un registro; las claves llegan en orden creciente
+ */
+static int escritor_agregar(EscritorSSTable* e, const char* clave, const char* valor) {
+	if (e->registros % INTERVALO_INDICE_LSM == 0) {
+		if (e->entradas_indice == e->capacidad_indice) {
+			int capacidad = e->capacidad_indice ? e->capacidad_indice * 2 : 256;
+			char (*claves)[MAX_CLAVE_REGISTRO] = realloc(e->claves_indice, (size_t)capacidad * MAX_CLAVE_REGISTRO);
+			if (!claves) return 0;
+			e->claves_indice = claves;
+			long long* posiciones = realloc(e->posiciones_indice, (size_t)capacidad * sizeof(long long));
+			if (!posiciones) return 0;
+			e->posiciones_indice = posiciones;
+			e->capacidad_indice = capacidad;
+		}
+		memset(e->claves_indice[e->entradas_indice], 0, MAX_CLAVE_REGISTRO);
+		strcpy(e->claves_indice[e->entradas_indice], clave);
+		e->posiciones_indice[e->entradas_indice] = e->posicion;
+		e->entradas_indice++;
+	}
+
+	CabeceraRegistroLsm cabecera = {(uint8_t)strlen(clave), 0, (uint16_t)strlen(valor)};
+	if (fwrite(&cabecera, 1, TAMANO_CABECERA_LSM, e->archivo) != TAMANO_CABECERA_LSM ||
+		fwrite(clave, 1, cabecera.longitud_clave, e->archivo) != cabecera.longitud_clave ||
+		fwrite(valor, 1, cabecera.longitud_valor, e->archivo) != cabecera.longitud_valor) {
+		return 0;
+	}
+	bloom_revisar(e->bloom, e->bits_bloom, clave, 1);
+	strcpy(e->ultima_clave, clave);
+	e->posicion += TAMANO_CABECERA_LSM + cabecera.longitud_clave + cabecera.longitud_valor;
+	e->registros++;
+	return 1;
+}
+
+/*
+ * Funcion: escritor_terminar
+ * Descripcion: Escribe el indice, el filtro y el pie, y cierra el archivo
+ * Parametros: e, exito - 0 para solo liberar (el archivo queda incompleto)
+ * Retorno: 1 si el archivo quedo completo, 0 si no
+ */
+static int escritor_terminar(EscritorSSTable* e, int exito) {
+	PieSSTable pie;
+	memset(&pie, 0, sizeof(pie));
+	memcpy(pie.magia, MAGIA_SSTABLE, 4);
+	pie.registros = (uint32_t)e->registros;
+	pie.entradas_indice = (uint32_t)e->entradas_indice;
+	pie.bits_bloom = e->bits_bloom;
+	pie.posicion_indice = (uint64_t)e->posicion;
+	pie.posicion_bloom = (uint64_t)(e->posicion + (long long)e->entradas_indice * (MAX_CLAVE_REGISTRO + (long long)sizeof(long long)));
+	strcpy(pie.ultima_clave, e->ultima_clave);
+
+	size_t entradas = (size_t)e->entradas_indice;
+	if (exito) {
+		exito = fwrite(e->claves_indice, MAX_CLAVE_REGISTRO, entradas, e->archivo) == entradas &&
+				fwrite(e->posiciones_indice, sizeof(long long), entradas, e->archivo) == entradas &&
+				fwrite(e->bloom, 1, e->bits_bloom / 8, e->archivo) == e->bits_bloom / 8 &&
+				fwrite(&pie, 1, TAMANO_PIE_SSTABLE, e->archivo) == TAMANO_PIE_SSTABLE;
+	}
+	if (fclose(e->archivo) != 0) exito = 0;
+	free(e->claves_indice);
+	free(e->posiciones_indice);
+	free(e->bloom);
+	return exito;
+}
+
+/*
+ * Funcion: sstable_abrir
+ * Descripcion: Abre un archivo ordenado y carga su indice y su filtro
+ * Retorno: Archivo abierto con una referencia (la del manifiesto), NULL si
+ *          no existe o esta incompleto
+ */
+static SSTable* sstable_abrir(const TablaRepositorio* tabla, unsigned int secuencia, int nivel) {
+	SSTable* sst = calloc(1, sizeof(SSTable));
+	if (!sst) return NULL;
+	ruta_sstable(tabla, secuencia, sst->ruta);
+	sst->secuencia = secuencia;
+	sst->nivel = nivel;
+	sst->referencias = 1;
+
+	PieSSTable pie;
+	sst->archivo = fopen(sst->ruta, "rb");
+	int exito = sst->archivo && FINAL_64(sst->archivo, -TAMANO_PIE_SSTABLE) == 0 &&
+				fread(&pie, 1, TAMANO_PIE_SSTABLE, sst->archivo) == TAMANO_PIE_SSTABLE &&
+				memcmp(pie.magia, MAGIA_SSTABLE, 4) == 0 && pie.bits_bloom > 0 &&
+				memchr(pie.ultima_clave, '\0', MAX_CLAVE_REGISTRO) != NULL;
+	if (exito) {
+		size_t entradas = pie.entradas_indice;
+		sst->registros = (long)pie.registros;
+		sst->fin_registros = (long long)pie.posicion_indice;
+		sst->entradas_indice = (int)entradas;
+		sst->bits_bloom = pie.bits_bloom;
+		memcpy(sst->ultima_clave, pie.ultima_clave, MAX_CLAVE_REGISTRO);
+		sst->claves_indice = malloc(entradas * MAX_CLAVE_REGISTRO + 1);
+		sst->posiciones_indice = malloc(entradas * sizeof(long long) + 1);
+		sst->bloom = malloc(pie.bits_bloom / 8);
+		exito = sst->claves_indice && sst->posiciones_indice && sst->bloom &&
+				BUSCAR_64(sst->archivo, sst->fin_registros) == 0 &&
+				fread(sst->claves_indice, MAX_CLAVE_REGISTRO, entradas, sst->archivo) == entradas &&
+				fread(sst->posiciones_indice, sizeof(long long), entradas, sst->archivo) == entradas &&
+				fread(sst->bloom, 1, pie.bits_bloom / 8, sst->archivo) == pie.bits_bloom / 8;
+	}
+
+	if (!exito) {
+		if (sst->archivo) fclose(sst->archivo);
+		free(sst->claves_indice);
+		free(sst->posiciones_indice);
+		free(sst->bloom);
+		free(sst);
+		return NULL;
+	}
+	return sst;
+}
+
+/*
+ * Funcion: sstable_soltar
+ * Descripcion: Quita una referencia; con la ultima se cierra y, si ya
+ *              salio del manifiesto, se borra el archivo. Se llama con el
+ *              cerrojo tomado
+ */
+static void sstable_soltar(SSTable* sst) {
+	if (--sst->referencias > 0) return;
+	fclose(sst->archivo);
+	if (sst->retirada) remove(sst->ruta);
+	free(sst->claves_indice);
+	free(sst->posiciones_indice);
+	free(sst->bloom);
+	free(sst);
+}
+
+/*
+ * Funcion: sstable_bloque
+ * Descripcion: Entrada del indice disperso donde empezar a buscar una
+ *              clave: la ultima con clave menor o igual (busqueda binaria)
+ * Retorno: Indice de la entrada, -1 si la clave es menor que la primera
+ */
+static int sstable_bloque(const SSTable* sst, const char* clave) {
+	int bajo = 0, alto = sst->entradas_indice - 1, encontrado = -1;
+	while (bajo <= alto) {
+		int medio = (bajo + alto) / 2;
+		if (strcmp(sst->claves_indice[medio], clave) <= 0) {
+			encontrado = medio;
+			bajo = medio + 1;
+		} else {
+			alto = medio - 1;
+		}
+	}
+	return encontrado;
+}
+
+/*
+ * Funcion: sstable_obtener
+ * Descripcion: Busca una clave en un archivo: descarta por rango y por el
+ *              filtro sin leer el disco; si no, lee un solo bloque de
+ *              INTERVALO_INDICE_LSM registros
+ */
+static int sstable_obtener(SSTable* sst, const char* clave, char* valor, size_t tamano) {
+	if (strcmp(clave, sst->ultima_clave) > 0) return 0;
+	if (!bloom_revisar(sst->bloom, sst->bits_bloom, clave, 0)) return 0;
+	int bloque = sstable_bloque(sst, clave);
+	if (bloque < 0 || BUSCAR_64(sst->archivo, sst->posiciones_indice[bloque]) != 0) return 0;
+
+	char leida[MAX_CLAVE_REGISTRO], leido[MAX_VALOR_REGISTRO];
+	long long posicion = sst->posiciones_indice[bloque];
+	for (int i = 0; i < INTERVALO_INDICE_LSM && posicion < sst->fin_registros; i++) {
+		long bytes = leer_registro_lsm(sst->archivo, leida, leido);
+		if (bytes == 0) return 0;
+		posicion += bytes;
+
+		int comparacion = strcmp(leida, clave);
+		if (comparacion > 0) return 0;
+		if (comparacion == 0) {
+			if (strlen(leido) >= tamano) return 0;
+			strcpy(valor, leido);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// ===================================================================
+// MANIFIESTO
+// ===================================================================
+
+static void ruta_manifiesto(const TablaRepositorio* tabla, char* ruta) {
+	snprintf(ruta, 80, "%s/%s.lsm", CARPETA_DATOS, tabla->nombre);
+}
+
+/*
+ * Funcion: escribir_manifiesto
+ * Descripcion: Reemplaza el manifiesto con los archivos vigentes (por un
+ *              temporal, asi el manifiesto anterior sigue valido si el
+ *              programa se cierra a mitad). Se llama con el cerrojo tomado
+ */
+static int escribir_manifiesto(TablaLsm* t) {
+	char ruta[80], ruta_temporal[84];
+	ruta_manifiesto(t->tabla, ruta);
+	snprintf(ruta_temporal, sizeof(ruta_temporal), "%s.tmp", ruta);
+
+	FILE* archivo = fopen(ruta_temporal, "w");
+	if (!archivo) return 0;
+	int exito = fprintf(archivo, "%s %u\n", MAGIA_MANIFIESTO_LSM, t->siguiente_secuencia) > 0;
+	for (int i = 0; exito && i < t->cantidad; i++) {
+		exito = fprintf(archivo, "%d %u\n", t->archivos[i]->nivel, t->archivos[i]->secuencia) > 0;
+	}
+	if (fclose(archivo) != 0) exito = 0;
+	if (!exito) {
+		remove(ruta_temporal);
+		return 0;
+	}
+	remove(ruta);
+	return rename(ruta_temporal, ruta) == 0;
+}
+
+/*
+ * Funcion: cargar_manifiesto
+ * Descripcion: Abre los archivos del manifiesto de una tabla. Si no hay
+ *              manifiesto, o falta o esta danado alguno de sus archivos, la
+ *              tabla queda vacia y se informa como recien creada para que
+ *              el repositorio la vuelva a cargar. Un archivo que quedo a
+ *              medio escribir no esta en el manifiesto y se sobreescribe
+ *              cuando se vuelve a usar su numero
+ * Retorno: 1 cargada, 2 vacia (recien creada), 0 error
+ */
+static int cargar_manifiesto(TablaLsm* t) {
+	char ruta[80], magia[8];
+	ruta_manifiesto(t->tabla, ruta);
+	t->siguiente_secuencia = 1;
+	t->cantidad = 0;
+
+	FILE* archivo = fopen(ruta, "r");
+	int completo = archivo && fscanf(archivo, "%7s %u", magia, &t->siguiente_secuencia) == 2 &&
+				   strcmp(magia, MAGIA_MANIFIESTO_LSM) == 0;
+	int nivel;
+	unsigned int secuencia;
+	while (completo && fscanf(archivo, "%d %u", &nivel, &secuencia) == 2) {
+		SSTable* sst = (t->cantidad < MAX_SSTABLES_LSM) ? sstable_abrir(t->tabla, secuencia, nivel) : NULL;
+		if (!sst) {
+			printf("Advertencia: falta un archivo de la tabla LSM '%s'; se vuelve a cargar.\n", t->tabla->nombre);
+			completo = 0;
+			break;
+		}
+		t->archivos[t->cantidad++] = sst;
+	}
+	if (archivo) fclose(archivo);
+	if (completo) return 1;
+
+	for (int i = 0; i < t->cantidad; i++) {
+		t->archivos[i]->retirada = 1;
+		sstable_soltar(t->archivos[i]);
+	}
+	t->cantidad = 0;
+	return escribir_manifiesto(t) ? 2 : 0;
+}
+
+// ===================================================================
+// RECORRIDOS EN ORDEN
+// ===================================================================
+
+/*
+ * Funcion: cursor_memtabla
+ * Descripcion: Cursor de la tabla en memoria desde la primera clave mayor
+ *              o igual a 'desde'
+ */
+static void cursor_memtabla(CursorLsm* c, Memtabla* m, const char* desde) {
+	memset(c, 0, sizeof(*c));
+	c->nodo = memtabla_desde(m, desde, NULL);
+	c->valido = c->nodo != NULL;
+	if (c->valido) {
+		strcpy(c->clave, c->nodo->clave);
+		c->valor = c->nodo->valor;
+	}
+}
+
+/*
+ * Funcion: cursor_avanzar
+ * Descripcion: Pasa al registro siguiente del cursor
+ */
+static void cursor_avanzar(CursorLsm* c) {
+	if (!c->archivo) {
+		c->nodo = c->nodo ? c->nodo->siguiente[0] : NULL;
+		c->valido = c->nodo != NULL;
+		if (c->valido) {
+			strcpy(c->clave, c->nodo->clave);
+			c->valor = c->nodo->valor;
+		}
+		return;
+	}
+	c->valido = POSICION_64(c->archivo) < c->fin && leer_registro_lsm(c->archivo, c->clave, c->area) > 0;
+	c->valor = c->area;
+}
+
+static void cursor_cerrar(CursorLsm* c) {
+	if (c->archivo) fclose(c->archivo);
+	c->archivo = NULL;
+}
+
+/*
+ * Funcion: cursor_sstable
+ * Descripcion: Cursor de un archivo ordenado desde la primera clave mayor
+ *              o igual a 'desde'. Abre su propio FILE, asi puede usarse
+ *              desde el hilo de compactacion
+ * Retorno: 1 si fue exitoso, 0 si no se pudo abrir el archivo
+ */
+static int cursor_sstable(CursorLsm* c, const SSTable* sst, const char* desde) {
+	memset(c, 0, sizeof(*c));
+	c->archivo = fopen(sst->ruta, "rb");
+	if (!c->archivo) return 0;
+	c->fin = sst->fin_registros;
+
+	int bloque = sstable_bloque(sst, desde);
+	if (bloque > 0 && BUSCAR_64(c->archivo, sst->posiciones_indice[bloque]) != 0) {
+		cursor_cerrar(c);
+		return 0;
+	}
+	do {
+		cursor_avanzar(c);
+	} while (c->valido && strcmp(c->clave, desde) < 0);
+	return 1;
+}
+
+/*
+ * Funcion: mezclar_cursores
+ * Descripcion: Entrega en orden las claves de todos los cursores. Si una
+ *              clave esta en varios, gana el primero (el mas nuevo). Se
+ *              detiene con la primera clave que no empieza con el prefijo
+ * Parametros: cursores (del mas nuevo al mas viejo), cantidad, prefijo,
+ *             funcion, contexto
+ * Retorno: Registros entregados
+ */
+static long mezclar_cursores(CursorLsm* cursores, int cantidad, const char* prefijo,
+							 FuncionRegistro funcion, void* contexto) {
+	size_t largo_prefijo = strlen(prefijo);
+	long registros = 0;
+
+	for (;;) {
+		CursorLsm* menor = NULL;
+		for (int i = 0; i < cantidad; i++) {
+			if (cursores[i].valido && (!menor || strcmp(cursores[i].clave, menor->clave) < 0)) {
+				menor = &cursores[i];
+			}
+		}
+		if (!menor || strncmp(menor->clave, prefijo, largo_prefijo) != 0) break;
+
+		char clave[MAX_CLAVE_REGISTRO];
+		strcpy(clave, menor->clave);
+		registros++;
+		if (!funcion(clave, menor->valor, contexto)) break;
+
+		// Las versiones viejas de la misma clave se saltan
+		for (int i = 0; i < cantidad; i++) {
+			if (cursores[i].valido && strcmp(cursores[i].clave, clave) == 0) cursor_avanzar(&cursores[i]);
+		}
+	}
+	return registros;
+}
+
+// ===================================================================
+// ARCHIVOS VIGENTES
+// ===================================================================
+
+static void preparar_cerrojo(void) {
+	if (!cerrojo_listo) {
+		cerrojo_iniciar(&cerrojo_lsm);
+		cerrojo_listo = 1;
+	}
+}
+
+/*
+ * Funcion: tomar_archivos
+ * Descripcion: Copia la lista de archivos vigentes y toma una referencia
+ *              de cada uno: la compactacion puede cambiar la lista
+ *              mientras se leen, pero no los borra
+ */
+static int tomar_archivos(TablaLsm* t, SSTable** copia) {
+	cerrojo_tomar(&cerrojo_lsm);
+	int cantidad = t->cantidad;
+	for (int i = 0; i < cantidad; i++) {
+		copia[i] = t->archivos[i];
+		copia[i]->referencias++;
+	}
+	cerrojo_soltar(&cerrojo_lsm);
+	return cantidad;
+}
+
+static void soltar_archivos(SSTable** copia, int cantidad) {
+	cerrojo_tomar(&cerrojo_lsm);
+	for (int i = 0; i < cantidad; i++) {
+		sstable_soltar(copia[i]);
+	}
+	cerrojo_soltar(&cerrojo_lsm);
+}
+
+/*
+ * Funcion: archivos_de_nivel
+ * Descripcion: Cuenta los archivos de un nivel. Se llama con el cerrojo tomado
+ */
+static int archivos_de_nivel(const TablaLsm* t, int nivel) {
+	int cantidad = 0;
+	for (int i = 0; i < t->cantidad; i++) {
+		if (t->archivos[i]->nivel == nivel) cantidad++;
+	}
+	return cantidad;
+}
+
+/*
+ * Funcion: archivo_de_nivel
+ * Descripcion: Archivo de un nivel 1 en adelante (hay uno por nivel). Se
+ *              llama con el cerrojo tomado
+ */
+static SSTable* archivo_de_nivel(const TablaLsm* t, int nivel) {
+	for (int i = 0; i < t->cantidad; i++) {
+		if (t->archivos[i]->nivel == nivel) return t->archivos[i];
+	}
+	return NULL;
+}
+
+/*
+ * Funcion: insertar_archivo
+ * Descripcion: Agrega un archivo a la lista en su lugar de lectura (por
+ *              nivel y, dentro del nivel 0, del mas nuevo al mas viejo).
+ *              Se llama con el cerrojo tomado
+ */
+static void insertar_archivo(TablaLsm* t, SSTable* sst) {
+	int i = 0;
+	while (i < t->cantidad && (t->archivos[i]->nivel < sst->nivel ||
+		   (t->archivos[i]->nivel == sst->nivel && t->archivos[i]->secuencia > sst->secuencia))) {
+		i++;
+	}
+	memmove(&t->archivos[i + 1], &t->archivos[i], (size_t)(t->cantidad - i) * sizeof(SSTable*));
+	t->archivos[i] = sst;
+	t->cantidad++;
+}
+
+/*
+ * Funcion: retirar_archivo
+ * Descripcion: Quita un archivo de la lista; se borra cuando nadie lo use.
+ *              Se llama con el cerrojo tomado
+ */
+static void retirar_archivo(TablaLsm* t, SSTable* sst) {
+	for (int i = 0; i < t->cantidad; i++) {
+		if (t->archivos[i] != sst) continue;
+		memmove(&t->archivos[i], &t->archivos[i + 1], (size_t)(t->cantidad - i - 1) * sizeof(SSTable*));
+		t->cantidad--;
+		sst->retirada = 1;
+		sstable_soltar(sst);
+		return;
+	}
+}
+
+// ===================================================================
+// COMPACTACION
+// ===================================================================
+
+/*
+ * Funcion: limite_nivel
+ * Descripcion: Registros que admite un nivel antes de mezclarse con el
+ *              siguiente
+ */
+static long limite_nivel(int nivel) {
+	long limite = (long)REGISTROS_MEMTABLA_LSM * ARCHIVOS_NIVEL0_LSM;
+	for (int i = 1; i < nivel; i++) limite *= FACTOR_NIVEL_LSM;
+	return limite;
+}
+
+/*
+ * Funcion: buscar_compactacion
+ * Descripcion: Busca una tabla con trabajo: demasiados archivos en el
+ *              nivel 0 o un nivel que paso su limite (el ultimo nivel no
+ *              tiene limite). Se llama con el cerrojo tomado
+ * Retorno: 1 si hay trabajo (tabla y nivel de origen en la salida), 0 si no
+ */
+static int buscar_compactacion(TablaLsm** tabla, int* nivel) {
+	for (int i = 0; i < MAX_TABLAS_LSM; i++) {
+		TablaLsm* t = &tablas_lsm[i];
+		if (!t->tabla) continue;
+		if (archivos_de_nivel(t, 0) >= ARCHIVOS_NIVEL0_LSM) {
+			*tabla = t;
+			*nivel = 0;
+			return 1;
+		}
+		for (int n = 1; n < MAX_NIVELES_LSM - 1; n++) {
+			SSTable* sst = archivo_de_nivel(t, n);
+			if (sst && sst->registros > limite_nivel(n)) {
+				*tabla = t;
+				*nivel = n;
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * Funcion: escribir_en_archivo
+ * Descripcion: Agrega al archivo en construccion un registro de la mezcla
+ */
+static int escribir_en_archivo(const char* clave, const char* valor, void* contexto) {
+	return escritor_agregar(contexto, clave, valor);
+}
+
+/*
+ * Funcion: compactar
+ * Descripcion: Mezcla los archivos de un nivel con el archivo del nivel
+ *              siguiente en un solo archivo nuevo de ese nivel. Los
+ *              archivos de origen no cambian mientras se leen; la lista de
+ *              la tabla solo se toca al principio y al final
+ * Parametros: t, nivel - Nivel de origen (0 = todos sus archivos)
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int compactar(TablaLsm* t, int nivel) {
+	SSTable* origen[MAX_SSTABLES_LSM];
+	CursorLsm cursores[MAX_SSTABLES_LSM];
+	int cantidad = 0;
+	long esperados = 0;
+
+	cerrojo_tomar(&cerrojo_lsm);
+	for (int i = 0; i < t->cantidad; i++) {
+		SSTable* sst = t->archivos[i];
+		if (sst->nivel != nivel && sst->nivel != nivel + 1) continue;
+		sst->referencias++;
+		origen[cantidad++] = sst;
+		esperados += sst->registros;
+	}
+	unsigned int secuencia = t->siguiente_secuencia++;
+	cerrojo_soltar(&cerrojo_lsm);
+
+	char ruta[80];
+	EscritorSSTable escritor;
+	ruta_sstable(t->tabla, secuencia, ruta);
+	int escritor_abierto = escritor_abrir(&escritor, ruta, esperados);
+	int exito = escritor_abierto;
+	int abiertos = 0;
+	while (exito && abiertos < cantidad && cursor_sstable(&cursores[abiertos], origen[abiertos], "")) {
+		abiertos++;
+	}
+	if (escritor_abierto) {
+		long mezclados = (abiertos == cantidad) ? mezclar_cursores(cursores, abiertos, "", escribir_en_archivo, &escritor) : -1;
+		exito = escritor_terminar(&escritor, mezclados == escritor.registros);
+	}
+	for (int i = 0; i < abiertos; i++) {
+		cursor_cerrar(&cursores[i]);
+	}
+
+	SSTable* nuevo = exito ? sstable_abrir(t->tabla, secuencia, nivel + 1) : NULL;
+
+	cerrojo_tomar(&cerrojo_lsm);
+	if (nuevo) {
+		for (int i = 0; i < cantidad; i++) {
+			retirar_archivo(t, origen[i]);
+		}
+		insertar_archivo(t, nuevo);
+		if (!escribir_manifiesto(t)) exito = 0;
+	}
+	for (int i = 0; i < cantidad; i++) {
+		sstable_soltar(origen[i]);
+	}
+	cerrojo_soltar(&cerrojo_lsm);
+
+	if (!nuevo) {
+		remove(ruta);
+		return 0;
+	}
+	return exito;
+}
+
+/*
+ * Funcion: hilo_compactar
+ * Descripcion: Hilo de la compactacion: trabaja mientras haya tablas con
+ *              trabajo. Revisa y se marca como terminado con el cerrojo
+ *              tomado, asi un volcado no queda sin compactar
+ */
+static void hilo_compactar(void* argumento) {
+	(void)argumento;
+	TablaLsm* t;
+	int nivel;
+	for (;;) {
+		cerrojo_tomar(&cerrojo_lsm);
+		int pendiente = buscar_compactacion(&t, &nivel);
+		if (!pendiente) compactacion_terminada = 1;
+		cerrojo_soltar(&cerrojo_lsm);
+		if (!pendiente) return;
+
+		if (!compactar(t, nivel)) {
+			printf("Advertencia: no se pudo compactar la tabla LSM '%s'.\n", t->tabla->nombre);
+			cerrojo_tomar(&cerrojo_lsm);
+			compactacion_terminada = 1;
+			cerrojo_soltar(&cerrojo_lsm);
+			return;
+		}
+	}
+}
+
+/*
+ * Funcion: esperar_compactacion
+ * Descripcion: Espera a que termine la compactacion en segundo plano
+ */
+static void esperar_compactacion(void) {
+	if (compactacion_en_curso) {
+		hilo_esperar(hilo_compactacion);
+		compactacion_en_curso = 0;
+	}
+}
+
+/*
+ * Funcion: iniciar_compactacion
+ * Descripcion: Si hay trabajo y no hay una compactacion en curso, la
+ *              inicia en segundo plano. Si no se puede crear el hilo,
+ *              compacta en este momento
+ */
+static void iniciar_compactacion(void) {
+	TablaLsm* t;
+	int nivel;
+	cerrojo_tomar(&cerrojo_lsm);
+	int pendiente = buscar_compactacion(&t, &nivel);
+	int terminada = compactacion_terminada;
+	cerrojo_soltar(&cerrojo_lsm);
+
+	if (!pendiente || (compactacion_en_curso && !terminada)) return;
+	esperar_compactacion();
+
+	compactacion_terminada = 0;
+	compactacion_en_curso = hilo_crear(&hilo_compactacion, hilo_compactar, NULL);
+	if (!compactacion_en_curso) {
+		hilo_compactar(NULL);
+	}
+}
+
+// ===================================================================
+// TABLAS
+// ===================================================================
+
+/*
+ * Funcion: volcar_memtabla
+ * Descripcion: Escribe la tabla en memoria como un archivo nuevo del
+ *              nivel 0 y la vacia. Si el nivel 0 llego a su tope, primero
+ *              espera a la compactacion (asi las consultas nunca revisan
+ *              mas de TOPE_NIVEL0_LSM archivos del nivel 0)
+ */
+static int volcar_memtabla(TablaLsm* t) {
+	if (t->memtabla.cantidad == 0) return 1;
+
+	cerrojo_tomar(&cerrojo_lsm);
+	int lleno = archivos_de_nivel(t, 0) >= TOPE_NIVEL0_LSM;
+	cerrojo_soltar(&cerrojo_lsm);
+	if (lleno) {
+		esperar_compactacion();
+		iniciar_compactacion();
+		esperar_compactacion();
+	}
+
+	cerrojo_tomar(&cerrojo_lsm);
+	unsigned int secuencia = t->siguiente_secuencia++;
+	cerrojo_soltar(&cerrojo_lsm);
+
+	char ruta[80];
+	EscritorSSTable escritor;
+	ruta_sstable(t->tabla, secuencia, ruta);
+	if (!escritor_abrir(&escritor, ruta, t->memtabla.cantidad)) return 0;
+	int exito = 1;
+	for (NodoMemtabla* nodo = t->memtabla.cabeza->siguiente[0]; exito && nodo; nodo = nodo->siguiente[0]) {
+		exito = escritor_agregar(&escritor, nodo->clave, nodo->valor);
+	}
+	SSTable* sst = (escritor_terminar(&escritor, exito)) ? sstable_abrir(t->tabla, secuencia, 0) : NULL;
+	if (!sst) {
+		remove(ruta);
+		return 0;
+	}
+
+	cerrojo_tomar(&cerrojo_lsm);
+	insertar_archivo(t, sst);
+	exito = escribir_manifiesto(t);
+	cerrojo_soltar(&cerrojo_lsm);
+
+	memtabla_vaciar(&t->memtabla);
+	iniciar_compactacion();
+	return exito;
+}
+
+/*
+ * Funcion: tabla_lsm
+ * Descripcion: Devuelve la tabla abierta; la primera vez carga su manifiesto
+ * Parametros: tabla, creada (salida, puede ser NULL) - 1 si la tabla esta vacia
+ *             por no tener manifiesto
+ * Retorno: Tabla abierta, NULL si hubo error
+ */
+static TablaLsm* tabla_lsm(const TablaRepositorio* tabla, int* creada) {
+	TablaLsm* libre = NULL;
+	if (creada) *creada = 0;
+
+	for (int i = 0; i < MAX_TABLAS_LSM; i++) {
+		if (tablas_lsm[i].tabla == tabla) return &tablas_lsm[i];
+		if (!libre && !tablas_lsm[i].tabla) libre = &tablas_lsm[i];
+	}
+	if (!libre) return NULL;
+
+	struct stat st = {0};
+	if (stat(CARPETA_DATOS, &st) == -1) {
+		_mkdir(CARPETA_DATOS);
+	}
+	preparar_cerrojo();
+
+	memset(libre, 0, sizeof(*libre));
+	libre->tabla = tabla;
+	if (!memtabla_iniciar(&libre->memtabla)) {
+		libre->tabla = NULL;
+		return NULL;
+	}
+
+	cerrojo_tomar(&cerrojo_lsm);
+	int resultado = cargar_manifiesto(libre);
+	cerrojo_soltar(&cerrojo_lsm);
+	if (resultado == 0) {
+		free(libre->memtabla.cabeza);
+		memset(libre, 0, sizeof(*libre));
+		return NULL;
+	}
+	if (creada) *creada = resultado == 2;
+	return libre;
+}
+
+/*
+ * Funcion: recorrer_desde
+ * Descripcion: Entrega en orden de clave los registros que empiezan con un
+ *              prefijo: la tabla en memoria y cada archivo se posicionan
+ *              en la primera clave del prefijo y se mezclan. La funcion no
+ *              debe escribir en la misma tabla
+ */
+static long recorrer_desde(TablaLsm* t, const char* prefijo, FuncionRegistro funcion, void* contexto) {
+	SSTable* archivos[MAX_SSTABLES_LSM];
+	CursorLsm cursores[MAX_SSTABLES_LSM + 1];
+	int cantidad = tomar_archivos(t, archivos);
+	int abiertos = 1;
+	long registros = -1;
+
+	cursor_memtabla(&cursores[0], &t->memtabla, prefijo);
+	while (abiertos <= cantidad && cursor_sstable(&cursores[abiertos], archivos[abiertos - 1], prefijo)) {
+		abiertos++;
+	}
+	if (abiertos == cantidad + 1) {
+		registros = mezclar_cursores(cursores, abiertos, prefijo, funcion, contexto);
+	}
+
+	for (int i = 0; i < abiertos; i++) {
+		cursor_cerrar(&cursores[i]);
+	}
+	soltar_archivos(archivos, cantidad);
+	return registros;
+}
+
+// ===================================================================
+// OPERACIONES DEL MOTOR
+// ===================================================================
+
+static int abrir_lsm(const TablaRepositorio* tabla) {
+	int creada;
+	if (!tabla_lsm(tabla, &creada)) return 0;
+	return creada ? 2 : 1;
+}
+
+static int obtener_lsm(const TablaRepositorio* tabla, const char* clave, char* valor, size_t tamano) {
+	TablaLsm* t = tabla_lsm(tabla, NULL);
+	if (!t) return 0;
+
+	NodoMemtabla* nodo = memtabla_buscar(&t->memtabla, clave);
+	if (nodo) {
+		if (strlen(nodo->valor) >= tamano) return 0;
+		strcpy(valor, nodo->valor);
+		return 1;
+	}
+
+	// Del archivo mas nuevo al mas viejo: la primera version es la vigente
+	SSTable* archivos[MAX_SSTABLES_LSM];
+	int cantidad = tomar_archivos(t, archivos);
+	int encontrado = 0;
+	for (int i = 0; !encontrado && i < cantidad; i++) {
+		encontrado = sstable_obtener(archivos[i], clave, valor, tamano);
+	}
+	soltar_archivos(archivos, cantidad);
+	return encontrado;
+}
+
+static int guardar_lsm(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	TablaLsm* t = tabla_lsm(tabla, NULL);
+	size_t longitud_clave = strlen(clave);
+	if (!t || longitud_clave == 0 || longitud_clave >= MAX_CLAVE_REGISTRO || strlen(valor) >= MAX_VALOR_REGISTRO) return 0;
+
+	if (!memtabla_poner(&t->memtabla, clave, valor)) return 0;
+	if (t->memtabla.cantidad >= REGISTROS_MEMTABLA_LSM) return volcar_memtabla(t);
+	return 1;
+}
+
+static int actualizar_lsm(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	char actual[MAX_VALOR_REGISTRO];
+	if (!obtener_lsm(tabla, clave, actual, sizeof(actual))) return 0;
+	return guardar_lsm(tabla, clave, valor);
+}
+
+static long recorrer_lsm(const TablaRepositorio* tabla, FuncionRegistro funcion, void* contexto) {
+	TablaLsm* t = tabla_lsm(tabla, NULL);
+	return t ? recorrer_desde(t, "", funcion, contexto) : -1;
+}
+
+static long recorrer_prefijo_lsm(const TablaRepositorio* tabla, const char* prefijo, FuncionRegistro funcion, void* contexto) {
+	TablaLsm* t = tabla_lsm(tabla, NULL);
+	return t ? recorrer_desde(t, prefijo, funcion, contexto) : -1;
+}
+
+static int vaciar_lsm(const TablaRepositorio* tabla) {
+	TablaLsm* t = tabla_lsm(tabla, NULL);
+	if (!t) return 0;
+	esperar_compactacion();
+
+	cerrojo_tomar(&cerrojo_lsm);
+	while (t->cantidad > 0) {
+		retirar_archivo(t, t->archivos[0]);
+	}
+	int exito = escribir_manifiesto(t);
+	cerrojo_soltar(&cerrojo_lsm);
+
+	memtabla_vaciar(&t->memtabla);
+	return exito;
+}
+
+/*
+ * Funcion: confirmar_lsm
+ * Descripcion: No escribe nada: la tabla en memoria se vuelca cuando se
+ *              llena o al cerrar. Si el programa no termina bien, el
+ *              repositorio vuelve a cargar la tabla desde los archivos de
+ *              texto (no queda la marca de sincronizado)
+ */
+static int confirmar_lsm(void) {
+	return 1;
+}
+
+/*
+ * Funcion: cerrar_lsm
+ * Descripcion: Vuelca las tablas en memoria y libera todo
+ * Retorno: 1 si todas las tablas quedaron en el disco, 0 si alguna no
+ *          (el repositorio no la marca como sincronizada)
+ */
+static int cerrar_lsm(void) {
+	int exito = 1;
+	for (int i = 0; i < MAX_TABLAS_LSM; i++) {
+		TablaLsm* t = &tablas_lsm[i];
+		if (t->tabla && !volcar_memtabla(t)) {
+			printf("Advertencia: no se pudo guardar la tabla LSM '%s'.\n", t->tabla->nombre);
+			exito = 0;
+		}
+	}
+	esperar_compactacion();
+
+	for (int i = 0; i < MAX_TABLAS_LSM; i++) {
+		TablaLsm* t = &tablas_lsm[i];
+		if (!t->tabla) continue;
+		cerrojo_tomar(&cerrojo_lsm);
+		for (int j = 0; j < t->cantidad; j++) {
+			sstable_soltar(t->archivos[j]);
+		}
+		cerrojo_soltar(&cerrojo_lsm);
+		memtabla_vaciar(&t->memtabla);
+		free(t->memtabla.cabeza);
+		memset(t, 0, sizeof(*t));
+	}
+	return exito;
+}
+
+const MotorAlmacen motor_lsm = {
+	"lsm", 0,
+	abrir_lsm, obtener_lsm, guardar_lsm, actualizar_lsm,
+	recorrer_lsm, recorrer_prefijo_lsm, vaciar_lsm, confirmar_lsm, cerrar_lsm
+};
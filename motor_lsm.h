@@ -0,0 +1,51 @@
+/*
+ * motor_lsm.h - Libreria del motor de almacenamiento LSM
+ *
+ * Descripcion: Este archivo contiene las constantes y el motor LSM del
+ *              repositorio, pensado para tablas con muchas escrituras y
+ *              casi ningun cambio (los pagos). Las escrituras van a una
+ *              tabla en memoria ordenada; cuando se llena se escribe de
+ *              una vez como un archivo ordenado e inmutable
+ *              (datos/<tabla>_NNNNNN.sst) con un indice disperso y un
+ *              filtro de Bloom. Un hilo en segundo plano mezcla esos
+ *              archivos por niveles, asi una consulta revisa pocos
+ *              archivos aunque la tabla crezca.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef MOTOR_LSM_H
+#define MOTOR_LSM_H
+
+#include "repositorio.h"
+
+// ===================================================================
+// CONSTANTES DEL MOTOR LSM
+// ===================================================================
+
+#define MAGIA_SSTABLE "SST1"
+#define MAGIA_MANIFIESTO_LSM "LSM1"
+#define MAX_TABLAS_LSM 8                 // Tablas abiertas a la vez (incluye la de prueba)
+
+// Tabla en memoria
+#define REGISTROS_MEMTABLA_LSM 4096      // Registros antes de escribirla como archivo
+#define ALTURA_MAXIMA_LSM 16             // Niveles de la lista por saltos
+
+// Archivos ordenados
+#define INTERVALO_INDICE_LSM 16          // Una entrada del indice disperso cada 16 registros
+#define BITS_BLOOM_LSM 10                // Bits del filtro por registro (~1% de falsos positivos)
+#define HASHES_BLOOM_LSM 7               // Bits marcados por clave
+
+// Niveles y compactacion
+#define MAX_NIVELES_LSM 6                // Nivel 0 (archivos recien escritos) y niveles 1..5
+#define ARCHIVOS_NIVEL0_LSM 4            // Archivos del nivel 0 que inician una compactacion
+#define TOPE_NIVEL0_LSM 12               // Con tantos archivos se espera a la compactacion
+#define FACTOR_NIVEL_LSM 10              // Cada nivel admite 10 veces mas registros que el anterior
+#define MAX_SSTABLES_LSM (TOPE_NIVEL0_LSM + MAX_NIVELES_LSM)
+
+extern const MotorAlmacen motor_lsm;
+
+#endif // MOTOR_LSM_H
@@ -0,0 +1,265 @@
+/*
+ * motor_sqlite.c - Implementacion del motor de almacenamiento SQLite
+ *
+ * Descripcion: Este archivo implementa el motor SQLite, incluyendo:
+ *              - Una tabla (clave TEXT PRIMARY KEY, valor TEXT) por cada
+ *                tabla del repositorio, con sus consultas preparadas una vez
+ *              - Una transaccion abierta con la primera escritura y
+ *                confirmada en motor->confirmar, asi un lote de eventos es
+ *                una sola transaccion
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "motor_sqlite.h"
+
+#ifdef USAR_SQLITE
+
+#include <sqlite3.h>
+#include <direct.h>      // Para _mkdir en Windows
+#include <sys/stat.h>    // Para verificar si existe la carpeta
+
+/*
+ * Estructura: TablaSqlite
+ * Descripcion: Consultas preparadas de una tabla
+ */
+typedef struct {
+	const TablaRepositorio* tabla;
+	sqlite3_stmt* obtener;
+	sqlite3_stmt* guardar;
+	sqlite3_stmt* actualizar;
+} TablaSqlite;
+
+static sqlite3* base = NULL;
+static int transaccion_abierta = 0;
+static TablaSqlite tablas_sqlite[MAX_TABLAS_SQLITE];
+
+// ===================================================================
+// BASE Y TABLAS
+// ===================================================================
+
+/*
+ * Funcion: abrir_base
+ * Descripcion: Abre la base la primera vez que se usa
+ */
+static int abrir_base(void) {
+	if (base) return 1;
+
+	struct stat st = {0};
+	if (stat(CARPETA_DATOS, &st) == -1) {
+		_mkdir(CARPETA_DATOS);
+	}
+
+	if (sqlite3_open(ARCHIVO_BASE_SQLITE, &base) != SQLITE_OK) {
+		printf("ERROR: No se pudo abrir '%s': %s\n", ARCHIVO_BASE_SQLITE, sqlite3_errmsg(base));
+		sqlite3_close(base);
+		base = NULL;
+		return 0;
+	}
+	sqlite3_exec(base, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", NULL, NULL, NULL);
+	return 1;
+}
+
+/*
+ * Funcion: iniciar_transaccion
+ * Descripcion: Abre la transaccion antes de la primera escritura
+ */
+static int iniciar_transaccion(void) {
+	if (transaccion_abierta) return 1;
+	transaccion_abierta = sqlite3_exec(base, "BEGIN", NULL, NULL, NULL) == SQLITE_OK;
+	return transaccion_abierta;
+}
+
+/*
+ * Funcion: preparar
+ * Descripcion: Prepara una consulta con el nombre de la tabla
+ */
+static sqlite3_stmt* preparar(const char* formato, const char* nombre) {
+	char sql[200];
+	sqlite3_stmt* consulta = NULL;
+	snprintf(sql, sizeof(sql), formato, nombre);
+	if (sqlite3_prepare_v2(base, sql, -1, &consulta, NULL) != SQLITE_OK) return NULL;
+	return consulta;
+}
+
+/*
+ * Funcion: tabla_sqlite
+ * Descripcion: Devuelve la tabla con sus consultas preparadas; la primera
+ *              vez la crea si no existe
+ * Parametros: tabla, creada (salida, puede ser NULL) - 1 si la tabla no existia
+ * Retorno: Tabla preparada, NULL si hubo error
+ */
+static TablaSqlite* tabla_sqlite(const TablaRepositorio* tabla, int* creada) {
+	TablaSqlite* libre = NULL;
+	if (creada) *creada = 0;
+	if (!abrir_base()) return NULL;
+
+	for (int i = 0; i < MAX_TABLAS_SQLITE; i++) {
+		if (tablas_sqlite[i].tabla == tabla) return &tablas_sqlite[i];
+		if (!libre && !tablas_sqlite[i].tabla) libre = &tablas_sqlite[i];
+	}
+	if (!libre) return NULL;
+
+	sqlite3_stmt* existe = preparar("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = '%s'", tabla->nombre);
+	if (!existe) return NULL;
+	if (creada) *creada = sqlite3_step(existe) != SQLITE_ROW;
+	sqlite3_finalize(existe);
+
+	char sql[200];
+	snprintf(sql, sizeof(sql), "CREATE TABLE IF NOT EXISTS %s (clave TEXT PRIMARY KEY, valor TEXT NOT NULL) WITHOUT ROWID",
+			 tabla->nombre);
+	if (sqlite3_exec(base, sql, NULL, NULL, NULL) != SQLITE_OK) return NULL;
+
+	libre->obtener = preparar("SELECT valor FROM %s WHERE clave = ?1", tabla->nombre);
+	libre->guardar = preparar("INSERT OR REPLACE INTO %s (clave, valor) VALUES (?1, ?2)", tabla->nombre);
+	libre->actualizar = preparar("UPDATE %s SET valor = ?2 WHERE clave = ?1", tabla->nombre);
+	if (!libre->obtener || !libre->guardar || !libre->actualizar) {
+		sqlite3_finalize(libre->obtener);
+		sqlite3_finalize(libre->guardar);
+		sqlite3_finalize(libre->actualizar);
+		memset(libre, 0, sizeof(*libre));
+		return NULL;
+	}
+	libre->tabla = tabla;
+	return libre;
+}
+
+/*
+ * Funcion: ejecutar_escritura
+ * Descripcion: Ejecuta una consulta de escritura con clave y valor
+ * Retorno: Filas cambiadas, -1 si hubo error
+ */
+static int ejecutar_escritura(sqlite3_stmt* consulta, const char* clave, const char* valor) {
+	if (!iniciar_transaccion()) return -1;
+	sqlite3_bind_text(consulta, 1, clave, -1, SQLITE_STATIC);
+	sqlite3_bind_text(consulta, 2, valor, -1, SQLITE_STATIC);
+	int resultado = sqlite3_step(consulta);
+	sqlite3_reset(consulta);
+	if (resultado != SQLITE_DONE) return -1;
+	return sqlite3_changes(base);
+}
+
+// ===================================================================
+// OPERACIONES DEL MOTOR
+// ===================================================================
+
+static int abrir_sqlite(const TablaRepositorio* tabla) {
+	int creada;
+	if (!tabla_sqlite(tabla, &creada)) return 0;
+	return creada ? 2 : 1;
+}
+
+static int obtener_sqlite(const TablaRepositorio* tabla, const char* clave, char* valor, size_t tamano) {
+	TablaSqlite* t = tabla_sqlite(tabla, NULL);
+	if (!t) return 0;
+
+	int encontrado = 0;
+	sqlite3_bind_text(t->obtener, 1, clave, -1, SQLITE_STATIC);
+	if (sqlite3_step(t->obtener) == SQLITE_ROW) {
+		const char* texto = (const char*)sqlite3_column_text(t->obtener, 0);
+		if (texto && strlen(texto) < tamano) {
+			strcpy(valor, texto);
+			encontrado = 1;
+		}
+	}
+	sqlite3_reset(t->obtener);
+	return encontrado;
+}
+
+static int guardar_sqlite(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	TablaSqlite* t = tabla_sqlite(tabla, NULL);
+	return t && ejecutar_escritura(t->guardar, clave, valor) > 0;
+}
+
+static int actualizar_sqlite(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	TablaSqlite* t = tabla_sqlite(tabla, NULL);
+	return t && ejecutar_escritura(t->actualizar, clave, valor) > 0;
+}
+
+/*
+ * Funcion: entregar_filas
+ * Descripcion: Entrega cada fila (clave, valor) de una consulta y la libera
+ * Retorno: Filas entregadas
+ */
+static long entregar_filas(sqlite3_stmt* consulta, FuncionRegistro funcion, void* contexto) {
+	long registros = 0;
+	while (sqlite3_step(consulta) == SQLITE_ROW) {
+		registros++;
+		if (!funcion((const char*)sqlite3_column_text(consulta, 0),
+					 (const char*)sqlite3_column_text(consulta, 1), contexto)) {
+			break;
+		}
+	}
+	sqlite3_finalize(consulta);
+	return registros;
+}
+
+static long recorrer_sqlite(const TablaRepositorio* tabla, FuncionRegistro funcion, void* contexto) {
+	if (!tabla_sqlite(tabla, NULL)) return -1;
+	sqlite3_stmt* consulta = preparar("SELECT clave, valor FROM %s ORDER BY clave", tabla->nombre);
+	if (!consulta) return -1;
+	return entregar_filas(consulta, funcion, contexto);
+}
+
+/*
+ * Funcion: recorrer_prefijo_sqlite
+ * Descripcion: Recorre las claves que empiezan con un prefijo como un rango
+ *              de la clave primaria: [prefijo, prefijo con el ultimo
+ *              caracter siguiente)
+ */
+static long recorrer_prefijo_sqlite(const TablaRepositorio* tabla, const char* prefijo,
+									FuncionRegistro funcion, void* contexto) {
+	char limite[MAX_CLAVE_REGISTRO];
+	size_t largo = strlen(prefijo);
+	if (largo == 0 || largo >= sizeof(limite)) return recorrer_sqlite(tabla, funcion, contexto);
+	strcpy(limite, prefijo);
+	limite[largo - 1]++;
+
+	if (!tabla_sqlite(tabla, NULL)) return -1;
+	sqlite3_stmt* consulta = preparar("SELECT clave, valor FROM %s WHERE clave >= ?1 AND clave < ?2 ORDER BY clave",
+									  tabla->nombre);
+	if (!consulta) return -1;
+	sqlite3_bind_text(consulta, 1, prefijo, -1, SQLITE_STATIC);
+	sqlite3_bind_text(consulta, 2, limite, -1, SQLITE_STATIC);
+	return entregar_filas(consulta, funcion, contexto);
+}
+
+static int vaciar_sqlite(const TablaRepositorio* tabla) {
+	char sql[100];
+	if (!tabla_sqlite(tabla, NULL) || !iniciar_transaccion()) return 0;
+	snprintf(sql, sizeof(sql), "DELETE FROM %s", tabla->nombre);
+	return sqlite3_exec(base, sql, NULL, NULL, NULL) == SQLITE_OK;
+}
+
+static int confirmar_sqlite(void) {
+	if (!transaccion_abierta) return 1;
+	transaccion_abierta = 0;
+	return sqlite3_exec(base, "COMMIT", NULL, NULL, NULL) == SQLITE_OK;
+}
+
+static int cerrar_sqlite(void) {
+	if (!base) return 1;
+	int exito = confirmar_sqlite();
+	for (int i = 0; i < MAX_TABLAS_SQLITE; i++) {
+		TablaSqlite* t = &tablas_sqlite[i];
+		if (!t->tabla) continue;
+		sqlite3_finalize(t->obtener);
+		sqlite3_finalize(t->guardar);
+		sqlite3_finalize(t->actualizar);
+		memset(t, 0, sizeof(*t));
+	}
+	if (sqlite3_close(base) != SQLITE_OK) exito = 0;
+	base = NULL;
+	return exito;
+}
+
+const MotorAlmacen motor_sqlite = {
+	"sqlite", 0,
+	abrir_sqlite, obtener_sqlite, guardar_sqlite, actualizar_sqlite,
+	recorrer_sqlite, recorrer_prefijo_sqlite, vaciar_sqlite, confirmar_sqlite, cerrar_sqlite
+};
+
+#endif // USAR_SQLITE
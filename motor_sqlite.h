@@ -0,0 +1,35 @@
+/*
+ * motor_sqlite.h - Libreria del motor de almacenamiento SQLite
+ *
+ * Descripcion: Este archivo contiene las constantes y el motor SQLite del
+ *              repositorio: una base (datos/almacen.db) con una tabla
+ *              clave/valor por cada tabla del repositorio. Solo se compila
+ *              con -DUSAR_SQLITE (y enlazando con -lsqlite3); sin esa
+ *              opcion el motor no aparece en almacen.cfg ni en la
+ *              comparacion de motores.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef MOTOR_SQLITE_H
+#define MOTOR_SQLITE_H
+
+#include "repositorio.h"
+
+#ifdef USAR_SQLITE
+
+// ===================================================================
+// CONSTANTES DEL MOTOR SQLITE
+// ===================================================================
+
+#define ARCHIVO_BASE_SQLITE "datos/almacen.db"
+#define MAX_TABLAS_SQLITE 8              // Tablas abiertas a la vez (incluye la de prueba)
+
+extern const MotorAlmacen motor_sqlite;
+
+#endif // USAR_SQLITE
+
+#endif // MOTOR_SQLITE_H
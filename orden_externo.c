@@ -0,0 +1,583 @@
+/*
+ * orden_externo.c - Implementacion del ordenamiento externo de lineas
+ *
+ * Descripcion: Este archivo implementa el ordenamiento de listados mas
+ *              grandes que la memoria, incluyendo:
+ *              - Claves de ancho fijo que se comparan byte a byte
+ *              - Tandas ordenadas en paralelo: radix LSD para claves
+ *                cortas (placas y montos), comparacion para las demas
+ *              - Rutas temporales con la clave delante de cada linea
+ *              - Mezcla de hasta MAX_RUTAS_MEZCLA rutas con un arbol de
+ *                perdedores, en varias pasadas si hay mas rutas
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "orden_externo.h"
+#include "dinero.h"
+
+#define TAMANO_BUFFER_RUTA 65536         // Buffer de lectura y escritura de cada ruta
+
+// ===================================================================
+// ESTRUCTURAS INTERNAS
+// ===================================================================
+
+/*
+ * Estructura: LectorRuta
+ * Descripcion: Ruta abierta durante la mezcla y su linea actual
+ */
+typedef struct {
+	FILE* archivo;
+	unsigned char clave[MAX_ANCHO_CLAVE];
+	char linea[MAX_LINEA_ORDEN];
+	uint32_t largo;
+	int agotada;
+} LectorRuta;
+
+/*
+ * Estructura: MezclaRutas
+ * Descripcion: Arbol de perdedores sobre las rutas que se mezclan. Cada
+ *              nodo interno guarda la ruta que perdio en ese nodo y
+ *              perdedores[0] la ganadora, asi que despues de sacar una
+ *              linea basta volver a jugar el camino de su ruta a la raiz
+ */
+typedef struct {
+	LectorRuta* lectores;
+	int* perdedores;
+	int cantidad;
+	int ancho;
+} MezclaRutas;
+
+// ===================================================================
+// CLAVES
+// ===================================================================
+
+/*
+ * Funcion: orden_ancho_clave
+ * Descripcion: Ancho de la clave de un criterio de orden
+ * Parametros: criterio - ORDEN_POR_*
+ * Retorno: Bytes de la clave, 0 si el criterio no ordena
+ */
+int orden_ancho_clave(int criterio) {
+	switch (criterio) {
+	case ORDEN_POR_PLACA: return ANCHO_CLAVE_PLACA;
+	case ORDEN_POR_MONTO: return ANCHO_CLAVE_MONTO;
+	case ORDEN_POR_FECHA: return ANCHO_CLAVE_FECHA;
+	default: return 0;
+	}
+}
+
+/*
+ * Funcion: orden_armar_clave
+ * Descripcion: Arma la clave de un campo, de modo que comparar las claves
+ *              byte a byte de el orden del criterio: la placa se completa
+ *              con '\0', el monto pasa a centavos en big-endian con el bit
+ *              de signo invertido y la fecha DD/MM/AAAA [HH:MM] pasa a
+ *              AAAAMMDDHHMM. Un campo ilegible queda con la clave minima
+ * Parametros: clave (salida, orden_ancho_clave bytes), criterio, texto
+ * Retorno: void
+ */
+void orden_armar_clave(unsigned char* clave, int criterio, const char* texto) {
+	int ancho = orden_ancho_clave(criterio);
+	memset(clave, 0, (size_t)ancho);
+
+	if (criterio == ORDEN_POR_PLACA) {
+		size_t largo = strlen(texto);
+		memcpy(clave, texto, largo < (size_t)ancho ? largo : (size_t)ancho);
+	} else if (criterio == ORDEN_POR_MONTO) {
+		Dinero monto;
+		if (!dinero_leer(texto, &monto)) return;
+		uint64_t valor = (uint64_t)monto ^ 0x8000000000000000ull;
+		for (int i = ANCHO_CLAVE_MONTO - 1; i >= 0; i--) {
+			clave[i] = (unsigned char)(valor & 0xff);
+			valor >>= 8;
+		}
+	} else if (criterio == ORDEN_POR_FECHA) {
+		int dia, mes, ano, hora = 0, minuto = 0;
+		char fecha[24];
+		if (sscanf(texto, "%d/%d/%d %d:%d", &dia, &mes, &ano, &hora, &minuto) < 3) return;
+		snprintf(fecha, sizeof(fecha), "%04d%02d%02d%02d%02d", ano % 10000, mes % 100, dia % 100, hora % 100, minuto % 100);
+		memcpy(clave, fecha, ANCHO_CLAVE_FECHA);
+	}
+}
+
+/*
+ * Funcion: orden_clave_de_campo
+ * Descripcion: Arma la clave con el campo numero 'campo' de una linea
+ * Parametros: clave (salida), criterio, linea, separador, campo
+ * Retorno: void
+ */
+void orden_clave_de_campo(unsigned char* clave, int criterio, const char* linea, char separador, int campo) {
+	char texto[40];
+	char fin_campo[4] = {separador, '\r', '\n', '\0'};
+
+	for (int i = 0; i < campo && linea; i++) {
+		linea = strchr(linea, separador);
+		if (linea) linea++;
+	}
+	size_t largo = linea ? strcspn(linea, fin_campo) : 0;
+	if (largo >= sizeof(texto)) largo = sizeof(texto) - 1;
+	if (largo > 0) memcpy(texto, linea, largo);
+	texto[largo] = '\0';
+	orden_armar_clave(clave, criterio, texto);
+}
+
+// ===================================================================
+// TANDAS
+// ===================================================================
+
+/*
+ * Funcion: ruta_temporal
+ * Descripcion: Nombre del archivo temporal de una ruta
+ */
+static void ruta_temporal(char* ruta, size_t tamano, int numero) {
+	snprintf(ruta, tamano, ARCHIVO_TEMPORAL_ORDEN, numero);
+}
+
+/*
+ * Funcion: ordenar_radix
+ * Descripcion: Radix LSD: una pasada de conteo por byte, del ultimo al
+ *              primero. Cada pasada es estable, asi que al terminar las
+ *              entradas quedan ordenadas por la clave completa. Se saltan
+ *              los bytes iguales en toda la tanda (el guion de las placas,
+ *              los bytes altos de los montos)
+ */
+static void ordenar_radix(TandaOrden* tanda) {
+	EntradaOrden* origen = tanda->entradas;
+	EntradaOrden* destino = tanda->auxiliar;
+	uint32_t cantidad = tanda->cantidad;
+
+	for (int byte = tanda->ancho - 1; byte >= 0; byte--) {
+		uint32_t conteo[256] = {0};
+		for (uint32_t i = 0; i < cantidad; i++) conteo[origen[i].clave[byte]]++;
+		if (conteo[origen[0].clave[byte]] == cantidad) continue;
+
+		uint32_t posicion = 0;
+		for (int valor = 0; valor < 256; valor++) {
+			uint32_t en_valor = conteo[valor];
+			conteo[valor] = posicion;
+			posicion += en_valor;
+		}
+		for (uint32_t i = 0; i < cantidad; i++) {
+			destino[conteo[origen[i].clave[byte]]++] = origen[i];
+		}
+		EntradaOrden* intercambio = origen;
+		origen = destino;
+		destino = intercambio;
+	}
+	tanda->entradas = origen;
+	tanda->auxiliar = destino;
+}
+
+// Compara las claves completas: los bytes despues de 'ancho' son 0 en todas las entradas
+static int comparar_entradas(const void* a, const void* b) {
+	const EntradaOrden* x = a;
+	const EntradaOrden* y = b;
+	int diferencia = memcmp(x->clave, y->clave, MAX_ANCHO_CLAVE);
+	if (diferencia != 0) return diferencia;
+	return (x->posicion > y->posicion) - (x->posicion < y->posicion);
+}
+
+/*
+ * Funcion: ordenar_tanda
+ * Descripcion: Ordena las entradas de una tanda. Las claves cortas van
+ *              por radix; las demas por comparacion, desempatando por la
+ *              posicion para que el orden sea estable
+ */
+static void ordenar_tanda(TandaOrden* tanda) {
+	if (tanda->cantidad < 2) return;
+	if (tanda->ancho <= MAX_ANCHO_RADIX) {
+		ordenar_radix(tanda);
+	} else {
+		qsort(tanda->entradas, tanda->cantidad, sizeof(EntradaOrden), comparar_entradas);
+	}
+}
+
+/*
+ * Funcion: escribir_tanda
+ * Descripcion: Escribe una tanda ordenada como ruta temporal: por cada
+ *              linea, la clave, el largo y la linea sin el '\0'
+ */
+static int escribir_tanda(TandaOrden* tanda) {
+	char ruta[40];
+	ruta_temporal(ruta, sizeof(ruta), tanda->ruta);
+	FILE* archivo = fopen(ruta, "wb");
+	if (!archivo) return 0;
+	setvbuf(archivo, NULL, _IOFBF, TAMANO_BUFFER_RUTA);
+
+	int exito = 1;
+	for (uint32_t i = 0; exito && i < tanda->cantidad; i++) {
+		const EntradaOrden* entrada = &tanda->entradas[i];
+		exito = fwrite(entrada->clave, 1, (size_t)tanda->ancho, archivo) == (size_t)tanda->ancho &&
+				fwrite(&entrada->largo, sizeof(entrada->largo), 1, archivo) == 1 &&
+				fwrite(tanda->datos + entrada->posicion, 1, entrada->largo, archivo) == entrada->largo;
+	}
+	if (fclose(archivo) != 0) exito = 0;
+	return exito;
+}
+
+/*
+ * Funcion: procesar_tanda
+ * Descripcion: Trabajo de cada hilo: ordenar la tanda y escribirla
+ */
+static void procesar_tanda(void* argumento) {
+	TandaOrden* tanda = argumento;
+	ordenar_tanda(tanda);
+	tanda->exito = escribir_tanda(tanda);
+}
+
+/*
+ * Funcion: esperar_tanda
+ * Descripcion: Espera al hilo de una tanda y la deja vacia para volver
+ *              a llenarla
+ */
+static void esperar_tanda(OrdenExterno* orden, TandaOrden* tanda) {
+	if (tanda->ocupada) {
+		hilo_esperar(tanda->hilo);
+		tanda->ocupada = 0;
+		if (!tanda->exito) orden->exito = 0;
+	}
+	tanda->usado = 0;
+	tanda->cantidad = 0;
+}
+
+/*
+ * Funcion: despachar_tanda
+ * Descripcion: Entrega la tanda llena a un hilo (o la procesa aqui si no
+ *              se puede crear el hilo) y pasa a la siguiente tanda,
+ *              esperando a que su hilo anterior termine
+ */
+static void despachar_tanda(OrdenExterno* orden) {
+	TandaOrden* tanda = &orden->tandas[orden->actual];
+
+	tanda->ruta = orden->rutas++;
+	if (orden->hilos > 1 && hilo_crear(&tanda->hilo, procesar_tanda, tanda)) {
+		tanda->ocupada = 1;
+	} else {
+		procesar_tanda(tanda);
+		if (!tanda->exito) orden->exito = 0;
+	}
+
+	orden->actual = (orden->actual + 1) % orden->hilos;
+	esperar_tanda(orden, &orden->tandas[orden->actual]);
+}
+
+// ===================================================================
+// MEZCLA
+// ===================================================================
+
+/*
+ * Funcion: leer_linea_ruta
+ * Descripcion: Avanza un lector a la siguiente linea de su ruta
+ * Retorno: 1 si fue exitoso o la ruta termino, 0 si la ruta esta danada
+ */
+static int leer_linea_ruta(LectorRuta* lector, int ancho) {
+	if (fread(lector->clave, 1, (size_t)ancho, lector->archivo) != (size_t)ancho) {
+		lector->agotada = 1;
+		return feof(lector->archivo) != 0;
+	}
+	if (fread(&lector->largo, sizeof(lector->largo), 1, lector->archivo) != 1 ||
+		lector->largo >= MAX_LINEA_ORDEN ||
+		fread(lector->linea, 1, lector->largo, lector->archivo) != lector->largo) {
+		lector->agotada = 1;
+		return 0;
+	}
+	lector->linea[lector->largo] = '\0';
+	return 1;
+}
+
+/*
+ * Funcion: gana
+ * Descripcion: Indica si la ruta a va antes que la ruta b. La ruta -1 es
+ *              el centinela con que se arma el arbol y gana siempre; una
+ *              ruta agotada pierde siempre. Con claves iguales gana la
+ *              ruta anterior, que tiene las lineas agregadas antes
+ */
+static int gana(const MezclaRutas* mezcla, int a, int b) {
+	if (a < 0) return b >= 0;
+	if (b < 0) return 0;
+	if (mezcla->lectores[a].agotada) return 0;
+	if (mezcla->lectores[b].agotada) return 1;
+	int diferencia = memcmp(mezcla->lectores[a].clave, mezcla->lectores[b].clave, (size_t)mezcla->ancho);
+	return diferencia < 0 || (diferencia == 0 && a < b);
+}
+
+/*
+ * Funcion: jugar_camino
+ * Descripcion: Vuelve a jugar los partidos del camino de una ruta hasta
+ *              la raiz. Las hojas estan en las posiciones cantidad a
+ *              2*cantidad-1 de un arbol binario implicito
+ */
+static void jugar_camino(MezclaRutas* mezcla, int ruta) {
+	int ganador = ruta;
+	for (int nodo = (ruta + mezcla->cantidad) / 2; nodo > 0; nodo /= 2) {
+		if (gana(mezcla, mezcla->perdedores[nodo], ganador)) {
+			int perdedor = ganador;
+			ganador = mezcla->perdedores[nodo];
+			mezcla->perdedores[nodo] = perdedor;
+		}
+	}
+	mezcla->perdedores[0] = ganador;
+}
+
+/*
+ * Funcion: mezclar_rutas
+ * Descripcion: Mezcla rutas ordenadas. Cada linea se escribe en otra ruta
+ *              (destino) o se entrega a la funcion. Las rutas mezcladas
+ *              se borran
+ * Parametros: orden, numeros - Rutas en orden de creacion, cantidad,
+ *             destino - Ruta de salida (NULL = entregar a la funcion),
+ *             funcion, contexto
+ * Retorno: Lineas entregadas o escritas, -1 si hubo error
+ */
+static long mezclar_rutas(OrdenExterno* orden, const int* numeros, int cantidad, FILE* destino,
+						  FuncionLineaOrden funcion, void* contexto) {
+	MezclaRutas mezcla;
+	char ruta[40];
+	long entregadas = 0;
+	int exito = 1;
+
+	mezcla.cantidad = cantidad;
+	mezcla.ancho = orden->ancho;
+	mezcla.lectores = calloc((size_t)cantidad, sizeof(LectorRuta));
+	mezcla.perdedores = malloc((size_t)cantidad * sizeof(int));
+	if (!mezcla.lectores || !mezcla.perdedores) {
+		free(mezcla.lectores);
+		free(mezcla.perdedores);
+		return -1;
+	}
+
+	for (int i = 0; i < cantidad; i++) {
+		ruta_temporal(ruta, sizeof(ruta), numeros[i]);
+		mezcla.lectores[i].archivo = fopen(ruta, "rb");
+		if (!mezcla.lectores[i].archivo) {
+			mezcla.lectores[i].agotada = 1;
+			exito = 0;
+			continue;
+		}
+		setvbuf(mezcla.lectores[i].archivo, NULL, _IOFBF, TAMANO_BUFFER_RUTA);
+		if (!leer_linea_ruta(&mezcla.lectores[i], orden->ancho)) exito = 0;
+	}
+
+	// Se arma el arbol con el centinela en todos los nodos
+	for (int i = 0; i < cantidad; i++) mezcla.perdedores[i] = -1;
+	for (int i = cantidad - 1; i >= 0; i--) jugar_camino(&mezcla, i);
+
+	while (exito) {
+		int ganadora = mezcla.perdedores[0];
+		if (ganadora < 0 || mezcla.lectores[ganadora].agotada) break;
+
+		LectorRuta* lector = &mezcla.lectores[ganadora];
+		entregadas++;
+		if (destino) {
+			exito = fwrite(lector->clave, 1, (size_t)orden->ancho, destino) == (size_t)orden->ancho &&
+					fwrite(&lector->largo, sizeof(lector->largo), 1, destino) == 1 &&
+					fwrite(lector->linea, 1, lector->largo, destino) == lector->largo;
+		} else if (!funcion(lector->linea, contexto)) {
+			break;
+		}
+
+		if (exito && !leer_linea_ruta(lector, orden->ancho)) exito = 0;
+		jugar_camino(&mezcla, ganadora);
+	}
+
+	for (int i = 0; i < cantidad; i++) {
+		if (mezcla.lectores[i].archivo) fclose(mezcla.lectores[i].archivo);
+		ruta_temporal(ruta, sizeof(ruta), numeros[i]);
+		remove(ruta);
+	}
+	free(mezcla.lectores);
+	free(mezcla.perdedores);
+	return exito ? entregadas : -1;
+}
+
+// ===================================================================
+// ORDENAMIENTO
+// ===================================================================
+
+/*
+ * Funcion: orden_iniciar
+ * Descripcion: Prepara un ordenamiento. La memoria se reparte entre una
+ *              tanda por hilo y se reserva toda al iniciar
+ * Parametros:
+ *   - orden: Estado (salida)
+ *   - ancho: Bytes de la clave (hasta MAX_ANCHO_CLAVE)
+ *   - memoria: Bytes para las tandas (0 = MEMORIA_ORDEN)
+ *   - hilos: Tandas que se ordenan a la vez (0 = uno por procesador)
+ * Retorno: 1 si fue exitoso, 0 si no hay memoria
+ */
+int orden_iniciar(OrdenExterno* orden, int ancho, size_t memoria, int hilos) {
+	memset(orden, 0, sizeof(OrdenExterno));
+	if (ancho < 1 || ancho > MAX_ANCHO_CLAVE) return 0;
+	if (memoria == 0) memoria = MEMORIA_ORDEN;
+	if (hilos <= 0) hilos = hilos_disponibles();
+	if (hilos > MAX_HILOS_ORDEN) hilos = MAX_HILOS_ORDEN;
+
+	orden->ancho = ancho;
+	orden->hilos = hilos;
+	orden->exito = 1;
+
+	size_t por_tanda = memoria / (size_t)hilos;
+	size_t capacidad = por_tanda / 2;
+	size_t capacidad_entradas = por_tanda / 2 / (2 * sizeof(EntradaOrden));
+	if (capacidad < MAX_LINEA_ORDEN) capacidad = MAX_LINEA_ORDEN;
+	if (capacidad_entradas < 16) capacidad_entradas = 16;
+	if (capacidad > UINT32_MAX) capacidad = UINT32_MAX;
+
+	for (int i = 0; i < hilos; i++) {
+		TandaOrden* tanda = &orden->tandas[i];
+		tanda->ancho = ancho;
+		tanda->capacidad = capacidad;
+		tanda->capacidad_entradas = (uint32_t)capacidad_entradas;
+		tanda->datos = malloc(capacidad);
+		tanda->entradas = malloc(capacidad_entradas * sizeof(EntradaOrden));
+		tanda->auxiliar = malloc(capacidad_entradas * sizeof(EntradaOrden));
+		if (!tanda->datos || !tanda->entradas || !tanda->auxiliar) {
+			orden_liberar(orden);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Funcion: orden_agregar
+ * Descripcion: Agrega una linea con su clave. Cuando la tanda actual se
+ *              llena, un hilo la ordena y la escribe mientras se llena
+ *              la siguiente
+ * Parametros: orden, clave - 'ancho' bytes, linea - Sin el salto de linea
+ * Retorno: 1 si fue exitoso, 0 si hubo error o la linea es muy larga
+ */
+int orden_agregar(OrdenExterno* orden, const unsigned char* clave, const char* linea) {
+	size_t largo = strcspn(linea, "\r\n");
+	if (!orden->exito || largo >= MAX_LINEA_ORDEN) return 0;
+
+	TandaOrden* tanda = &orden->tandas[orden->actual];
+	if (tanda->usado + largo + 1 > tanda->capacidad || tanda->cantidad == tanda->capacidad_entradas) {
+		despachar_tanda(orden);
+		if (!orden->exito) return 0;
+		tanda = &orden->tandas[orden->actual];
+	}
+
+	EntradaOrden* entrada = &tanda->entradas[tanda->cantidad++];
+	memset(entrada->clave, 0, sizeof(entrada->clave));
+	memcpy(entrada->clave, clave, (size_t)orden->ancho);
+	entrada->posicion = (uint32_t)tanda->usado;
+	entrada->largo = (uint32_t)largo;
+	memcpy(tanda->datos + tanda->usado, linea, largo);
+	tanda->datos[tanda->usado + largo] = '\0';
+	tanda->usado += largo + 1;
+	orden->lineas++;
+	return 1;
+}
+
+/*
+ * Funcion: orden_terminar
+ * Descripcion: Entrega todas las lineas en orden. Si todo cupo en la
+ *              primera tanda se ordena en memoria; si no, se escribe la
+ *              ultima tanda y se mezclan las rutas, de a MAX_RUTAS_MEZCLA
+ *              en pasadas intermedias si hay mas
+ * Parametros: orden, funcion - Recibe cada linea, contexto
+ * Retorno: Lineas entregadas, -1 si hubo error
+ */
+long orden_terminar(OrdenExterno* orden, FuncionLineaOrden funcion, void* contexto) {
+	if (!orden->exito) return -1;
+
+	if (orden->rutas == 0) {
+		TandaOrden* tanda = &orden->tandas[orden->actual];
+		long entregadas = 0;
+		ordenar_tanda(tanda);
+		for (uint32_t i = 0; i < tanda->cantidad; i++) {
+			entregadas++;
+			if (!funcion(tanda->datos + tanda->entradas[i].posicion, contexto)) break;
+		}
+		return entregadas;
+	}
+
+	if (orden->tandas[orden->actual].cantidad > 0) despachar_tanda(orden);
+	for (int i = 0; i < orden->hilos; i++) esperar_tanda(orden, &orden->tandas[i]);
+	if (!orden->exito) return -1;
+
+	int cantidad = orden->rutas;
+	int* numeros = malloc((size_t)cantidad * sizeof(int));
+	if (!numeros) return -1;
+	for (int i = 0; i < cantidad; i++) numeros[i] = i;
+
+	// Pasadas intermedias: cada grupo de rutas seguidas pasa a ser una ruta
+	while (cantidad > MAX_RUTAS_MEZCLA) {
+		int nuevas = 0;
+		for (int inicio = 0; inicio < cantidad; inicio += MAX_RUTAS_MEZCLA) {
+			int grupo = cantidad - inicio < MAX_RUTAS_MEZCLA ? cantidad - inicio : MAX_RUTAS_MEZCLA;
+			char ruta[40];
+			int numero = orden->rutas++;
+			ruta_temporal(ruta, sizeof(ruta), numero);
+			FILE* destino = fopen(ruta, "wb");
+			if (!destino) {
+				free(numeros);
+				return -1;
+			}
+			setvbuf(destino, NULL, _IOFBF, TAMANO_BUFFER_RUTA);
+			long escritas = mezclar_rutas(orden, numeros + inicio, grupo, destino, NULL, NULL);
+			if (fclose(destino) != 0 || escritas < 0) {
+				free(numeros);
+				return -1;
+			}
+			numeros[nuevas++] = numero;
+		}
+		cantidad = nuevas;
+	}
+
+	long entregadas = mezclar_rutas(orden, numeros, cantidad, NULL, funcion, contexto);
+	free(numeros);
+	return entregadas;
+}
+
+/*
+ * Funcion: orden_liberar
+ * Descripcion: Espera a los hilos, libera las tandas y borra las rutas
+ *              temporales que hayan quedado
+ * Parametros: orden
+ * Retorno: void
+ */
+void orden_liberar(OrdenExterno* orden) {
+	char ruta[40];
+
+	for (int i = 0; i < MAX_HILOS_ORDEN; i++) {
+		TandaOrden* tanda = &orden->tandas[i];
+		if (tanda->ocupada) hilo_esperar(tanda->hilo);
+		free(tanda->datos);
+		free(tanda->entradas);
+		free(tanda->auxiliar);
+		memset(tanda, 0, sizeof(TandaOrden));
+	}
+	for (int i = 0; i < orden->rutas; i++) {
+		ruta_temporal(ruta, sizeof(ruta), i);
+		remove(ruta);
+	}
+	orden->rutas = 0;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+/*
+ * Funcion: orden_pedir_criterio
+ * Descripcion: Pregunta por que campo ordenar un listado
+ * Parametros: nombre_monto - Como se llama el monto en el listado
+ * Retorno: ORDEN_POR_* u ORDEN_ARCHIVO si se presiona Enter
+ */
+int orden_pedir_criterio(const char* nombre_monto) {
+	char buffer[10];
+	int criterio = ORDEN_ARCHIVO;
+
+	printf("Ordenar por: 1. Placa  2. %s  3. Fecha  (Enter = orden de registro): ", nombre_monto);
+	if (fgets(buffer, sizeof(buffer), stdin) && sscanf(buffer, "%d", &criterio) == 1 &&
+		orden_ancho_clave(criterio) == 0) {
+		criterio = ORDEN_ARCHIVO;
+	}
+	return criterio;
+}
@@ -0,0 +1,122 @@
+/*
+ * orden_externo.h - Libreria de ordenamiento externo de lineas
+ *
+ * Descripcion: Este archivo contiene las constantes, estructuras y
+ *              prototipos del ordenamiento externo. Las lineas de un
+ *              listado se ordenan por una clave de ancho fijo (placa,
+ *              monto o fecha) sin cargar todo el listado en memoria: se
+ *              juntan tandas de MEMORIA_ORDEN bytes como maximo, cada
+ *              tanda se ordena en su propio hilo y se escribe como una
+ *              ruta temporal, y al final todas las rutas se mezclan con un
+ *              arbol de perdedores. Si el listado cabe en una tanda no se
+ *              escribe ningun archivo. El orden es estable: las lineas con
+ *              la misma clave salen en el orden en que se agregaron.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef ORDEN_EXTERNO_H
+#define ORDEN_EXTERNO_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "hilos.h"
+
+// ===================================================================
+// CONSTANTES DEL ORDENAMIENTO
+// ===================================================================
+
+// Criterios de orden de los listados
+#define ORDEN_ARCHIVO 0                  // Sin ordenar (orden de los archivos)
+#define ORDEN_POR_PLACA 1
+#define ORDEN_POR_MONTO 2
+#define ORDEN_POR_FECHA 3
+
+#define MAX_ANCHO_CLAVE 16
+#define ANCHO_CLAVE_PLACA 9              // Placa completada con '\0'
+#define ANCHO_CLAVE_MONTO 8              // Centavos en big-endian con el signo invertido
+#define ANCHO_CLAVE_FECHA 12             // AAAAMMDDHHMM
+#define MAX_ANCHO_RADIX 10               // Claves mas anchas se ordenan por comparacion
+
+#define MEMORIA_ORDEN (32 * 1024 * 1024) // Memoria total de las tandas
+#define MAX_HILOS_ORDEN 4
+#define MAX_RUTAS_MEZCLA 64              // Rutas abiertas a la vez al mezclar
+#define MAX_LINEA_ORDEN 1024
+#define ARCHIVO_TEMPORAL_ORDEN "orden_%04d.tmp"
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+// Funcion que recibe cada linea en orden. Devuelve 0 para detenerse
+typedef int (*FuncionLineaOrden)(const char* linea, void* contexto);
+
+/*
+ * Estructura: EntradaOrden
+ * Descripcion: Clave de una linea y su posicion dentro de la tanda
+ */
+typedef struct {
+	unsigned char clave[MAX_ANCHO_CLAVE];
+	uint32_t posicion;
+	uint32_t largo;
+} EntradaOrden;
+
+/*
+ * Estructura: TandaOrden
+ * Descripcion: Lineas juntadas en memoria hasta llenar el espacio de la
+ *              tanda. La mitad del espacio es para las lineas y la otra
+ *              mitad para las entradas y su arreglo auxiliar
+ */
+typedef struct {
+	char* datos;                 // Lineas seguidas, cada una con su '\0'
+	size_t usado;
+	size_t capacidad;
+	EntradaOrden* entradas;
+	EntradaOrden* auxiliar;      // Destino de cada pasada del radix
+	uint32_t cantidad;
+	uint32_t capacidad_entradas;
+	int ancho;
+	int ruta;                    // Numero del archivo temporal de la tanda
+	int exito;
+	int ocupada;                 // Un hilo la esta ordenando y escribiendo
+	Hilo hilo;
+} TandaOrden;
+
+/*
+ * Estructura: OrdenExterno
+ * Descripcion: Estado de un ordenamiento
+ */
+typedef struct {
+	int ancho;
+	int hilos;
+	TandaOrden tandas[MAX_HILOS_ORDEN];
+	int actual;                  // Tanda que se esta llenando
+	int rutas;                   // Archivos temporales creados
+	int exito;
+	long lineas;
+} OrdenExterno;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Claves
+int orden_ancho_clave(int criterio);
+void orden_armar_clave(unsigned char* clave, int criterio, const char* texto);
+void orden_clave_de_campo(unsigned char* clave, int criterio, const char* linea, char separador, int campo);
+
+// Ordenamiento
+int orden_iniciar(OrdenExterno* orden, int ancho, size_t memoria, int hilos);
+int orden_agregar(OrdenExterno* orden, const unsigned char* clave, const char* linea);
+long orden_terminar(OrdenExterno* orden, FuncionLineaOrden funcion, void* contexto);
+void orden_liberar(OrdenExterno* orden);
+
+// Funciones de interfaz
+int orden_pedir_criterio(const char* nombre_monto);
+
+#endif // ORDEN_EXTERNO_H
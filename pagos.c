@@ -14,6 +14,14 @@
 
 #include "pagos.h"
 #include "vehiculos.h"
+#include "particiones.h"
+#include "indice_vehiculos.h"
+#include "indice_comprobantes.h"
+#include "almacen_documentos.h"
+#include "eventos.h"
+#include "matriculas_pagadas.h"
+#include "repositorio.h"
+#include <stdarg.h>
 #include <ctype.h>
 #include <direct.h>  // Para _mkdir en Windows
 #include <sys/stat.h>  // Para verificar si existe la carpeta
@@ -47,7 +55,9 @@ void menu_pagos() {
         printf("\n");
         printf("1. Pagar matricula por placa\n");
         printf("2. Consultar estado de pago por placa\n");
-        printf("3. Volver al menu principal\n");
+        printf("3. Consultar vehiculos de un propietario (cedula)\n");
+        printf("4. Pagar en lote (cedula/RUC o lista de placas)\n");
+        printf("5. Volver al menu principal\n");
         printf("\n");
         printf("Ingrese su opcion: ");
         
@@ -65,13 +75,19 @@ void menu_pagos() {
                 consultar_estado_por_placa();
                 break;
             case 3:
+                consultar_vehiculos_por_cedula();
+                break;
+            case 4:
+                procesar_pago_lote();
+                break;
+            case 5:
                 printf("Volviendo al menu principal...\n");
                 break;
             default:
                 printf("Opcion invalida. Intente nuevamente.\n");
                 pausar_sistema();
         }
-    } while (opcion != 3);
+    } while (opcion != 5);
 }
 
 // ===================================================================
@@ -120,12 +136,7 @@ int comprobante_vigente(const char* fecha_vencimiento) {
  * Retorno: 1 si fue exitoso, 0 si hubo error
  */
 int guardar_comprobante_sistema(const char* placa, ResultadoMatricula resultado, 
-                               DatosVehiculo vehiculo, const char* numero_comprobante) {
-    FILE* archivo = fopen(ARCHIVO_COMPROBANTES, "a");
-    if (!archivo) {
-        return 0;
-    }
-    
+                               const DatosVehiculo* vehiculo, const char* numero_comprobante) {
     // El numero de comprobante ya se paso como parametro, no generar uno nuevo
     
     // Obtener fechas
@@ -133,62 +144,131 @@ int guardar_comprobante_sistema(const char* placa, ResultadoMatricula resultado,
     obtener_fecha_actual(fecha_emision);
     calcular_fecha_vencimiento(fecha_vencimiento, DIAS_VALIDEZ_COMPROBANTE);
     
-    // Guardar en formato: placa|numero_comprobante|propietario|tipo|subtipo|fecha_emision|fecha_vencimiento|total|estado
     char cedula_propietario[15], nombre_propietario[100];
-    if (obtener_datos_propietario(placa, cedula_propietario, nombre_propietario)) {
-        fprintf(archivo, "%s|%s|%s|%s|%s|%s|%s|%.2f|%d\n", 
-                placa, numero_comprobante, nombre_propietario, vehiculo.tipo, vehiculo.subtipo,
-                fecha_emision, fecha_vencimiento, resultado.total_matricula, ESTADO_PENDIENTE);
-    } else {
+    char linea[400];
+    if (!obtener_datos_propietario(placa, cedula_propietario, nombre_propietario)) {
         // Si no se encuentran los datos del propietario, usar valores por defecto
-        fprintf(archivo, "%s|%s|%s|%s|%s|%s|%s|%.2f|%d\n", 
-                placa, numero_comprobante, "N/A", vehiculo.tipo, vehiculo.subtipo,
-                fecha_emision, fecha_vencimiento, resultado.total_matricula, ESTADO_PENDIENTE);
+        strcpy(nombre_propietario, "N/A");
     }
+    formatear_linea_comprobante(linea, sizeof(linea), placa, numero_comprobante, nombre_propietario,
+                                vehiculo, fecha_emision, fecha_vencimiento, resultado.total_matricula);
     
-    fclose(archivo);
-    return 1;
+    // El evento agrega la linea a la particion del mes del numero (o de la emision)
+    return evento_registrar(EVENTO_COMPROBANTE, placa, linea);
+}
+
+/*
+ * Funcion: formatear_linea_comprobante
+ * Descripcion: Arma la linea de un comprobante pendiente tal como se guarda
+ *              en las particiones de comprobantes
+ * Parametros: destino, tamano, placa, numero_comprobante, propietario,
+ *             vehiculo, fecha_emision, fecha_vencimiento, total
+ * Retorno: Longitud de la linea (incluye el salto de linea)
+ */
+int formatear_linea_comprobante(char* destino, size_t tamano, const char* placa, const char* numero_comprobante,
+                                const char* propietario, const DatosVehiculo* vehiculo, const char* fecha_emision,
+                                const char* fecha_vencimiento, Dinero total) {
+    char total_texto[MAX_TEXTO_DINERO];
+    // Formato: placa|numero_comprobante|propietario|tipo|subtipo|fecha_emision|fecha_vencimiento|total|estado
+    return snprintf(destino, tamano, "%s|%s|%s|%s|%s|%s|%s|%s|%d\n",
+                    placa, numero_comprobante, propietario, vehiculo->tipo, vehiculo->subtipo,
+                    fecha_emision, fecha_vencimiento, dinero_formatear(total, total_texto), ESTADO_PENDIENTE);
+}
+
+/*
+ * Funcion: formatear_linea_pago
+ * Descripcion: Arma la linea de un pago tal como se guarda en las
+ *              particiones de pagos
+ * Parametros: destino, tamano, pago
+ * Retorno: Longitud de la linea (incluye el salto de linea)
+ */
+static int formatear_linea_pago(char* destino, size_t tamano, const RegistroPago* pago) {
+    char monto[MAX_TEXTO_DINERO];
+    // Formato: numero_comprobante|placa|fecha_pago|monto|tipo|referencia|cedula|nombre
+    return snprintf(destino, tamano, "%s|%s|%s|%s|%d|%s|%s|%s\n",
+                    pago->numero_comprobante, pago->placa, pago->fecha_pago,
+                    dinero_formatear(pago->monto_pagado, monto), pago->tipo_pago, pago->referencia_pago,
+                    pago->cedula_pagador, pago->nombre_pagador);
 }
 
 /*
  * Funcion: guardar_registro_pago
- * Descripcion: Guarda un registro de pago en el archivo
+ * Descripcion: Guarda un pago como evento. Al confirmarse se agrega a la
+ *              particion de pagos y el comprobante queda como pagado
  * Parametros: pago - Estructura con datos del pago
  * Retorno: 1 si fue exitoso, 0 si hubo error
  */
 int guardar_registro_pago(RegistroPago pago) {
-    FILE* archivo = fopen(ARCHIVO_PAGOS, "a");
-    if (!archivo) {
-        return 0;
+    char linea[400];
+    formatear_linea_pago(linea, sizeof(linea), &pago);
+    return evento_registrar(EVENTO_PAGO, pago.placa, linea);
+}
+
+/*
+ * Funcion: guardar_registros_pago_lote
+ * Descripcion: Guarda todos los pagos de un lote como una sola transaccion:
+ *              los eventos de pago y de matricula pagada se arman en
+ *              memoria, se agregan al registro de eventos con una sola
+ *              escritura y se sincronizan con el disco una sola vez. O
+ *              quedan todos los pagos o ninguno. Despues se actualizan la
+ *              particion de pagos, el estado de los comprobantes y
+ *              matriculas_pagadas.txt
+ * Parametros: pagos - Pagos del lote (misma fecha), cantidad
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int guardar_registros_pago_lote(const RegistroPago* pagos, int cantidad) {
+    if (cantidad <= 0) {
+        return 1;
     }
     
-    // Formato: numero_comprobante|placa|fecha_pago|monto|tipo|referencia|cedula|nombre
-    fprintf(archivo, "%s|%s|%s|%.2f|%d|%s|%s|%s\n",
-            pago.numero_comprobante, pago.placa, pago.fecha_pago, 
-            pago.monto_pagado, pago.tipo_pago, pago.referencia_pago,
-            pago.cedula_pagador, pago.nombre_pagador);
+    BufferTexto lote;
+    buffer_iniciar(&lote);
+    for (int i = 0; i < cantidad; i++) {
+        char linea[400], pagado[200];
+        MatriculaPagada registro;
+        int longitud = formatear_linea_pago(linea, sizeof(linea), &pagos[i]);
+        strcpy(registro.numero_comprobante, pagos[i].numero_comprobante);
+        strcpy(registro.placa, pagos[i].placa);
+        strcpy(registro.fecha_pago, pagos[i].fecha_pago);
+        registro.monto = pagos[i].monto_pagado;
+        formatear_matricula_pagada(pagado, sizeof(pagado), &registro);
+        if (longitud <= 0 || longitud >= (int)sizeof(linea) ||
+            !eventos_agregar(&lote, EVENTO_PAGO, pagos[i].placa, NULL, linea) ||
+            !eventos_agregar(&lote, EVENTO_MATRICULA_PAGADA, pagos[i].placa, NULL, pagado)) {
+            buffer_liberar(&lote);
+            return 0;
+        }
+    }
     
-    fclose(archivo);
-    return 1;
+    int exito = eventos_confirmar(&lote, 1);
+    buffer_liberar(&lote);
+    return exito;
 }
 
 /*
- * Funcion: actualizar_estado_comprobante
- * Descripcion: Actualiza el estado de un comprobante
- * Parametros: numero_comprobante, nuevo_estado
- * Retorno: 1 si fue exitoso, 0 si hubo error
+ * Funcion: actualizar_estados_en_archivo
+ * Descripcion: Reescribe un archivo de comprobantes cambiando el estado
+ *              de los comprobantes indicados (una sola pasada para todos)
+ * Parametros:
+ *   - ruta: Archivo de comprobantes
+ *   - numeros, cantidad: Comprobantes a actualizar
+ *   - nuevo_estado: Estado a guardar
+ *   - actualizados: Se marca con 1 cada comprobante encontrado
+ * Retorno: Cantidad de comprobantes encontrados, -1 si hubo error
  */
-int actualizar_estado_comprobante(const char* numero_comprobante, int nuevo_estado) {
-    FILE* archivo = fopen(ARCHIVO_COMPROBANTES, "r");
+static int actualizar_estados_en_archivo(const char* ruta, char (*numeros)[MAX_COMPROBANTE], int cantidad,
+                                         int nuevo_estado, int* actualizados) {
+    FILE* archivo = fopen(ruta, "r");
     FILE* temp = fopen("temp_comprobantes.txt", "w");
     
     if (!archivo || !temp) {
         if (archivo) fclose(archivo);
         if (temp) fclose(temp);
-        return 0;
+        return -1;
     }
     
     char linea[500];
+    int encontrados = 0;
     while (fgets(linea, sizeof(linea), archivo)) {
         char linea_copia[500];
         strcpy(linea_copia, linea);
@@ -196,20 +276,29 @@ int actualizar_estado_comprobante(const char* numero_comprobante, int nuevo_esta
         // Formato: placa|numero_comprobante|propietario|tipo|subtipo|fecha_emision|fecha_vencimiento|total|estado
         char placa_temp[20], numero_temp[50], propietario_temp[100], tipo_temp[50], subtipo_temp[50];
         char fecha_emision_temp[20], fecha_vencimiento_temp[20];
-        float total_temp;
+        char total_temp[MAX_TEXTO_DINERO];
         int estado_temp;
+        int indice = -1;
         
-        if (sscanf(linea_copia, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%f|%d",
+        if (sscanf(linea_copia, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%23[^|]|%d",
                    placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
-                   fecha_emision_temp, fecha_vencimiento_temp, &total_temp, &estado_temp) == 9) {
-            
-            if (strcmp(numero_temp, numero_comprobante) == 0) {
-                // Actualizar estado - mantener el mismo formato
-                fprintf(temp, "%s|%s|%s|%s|%s|%s|%s|%.2f|%d\n", 
-                        placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
-                        fecha_emision_temp, fecha_vencimiento_temp, total_temp, nuevo_estado);
-            } else {
-                fprintf(temp, "%s", linea);
+                   fecha_emision_temp, fecha_vencimiento_temp, total_temp, &estado_temp) == 9) {
+            for (int i = 0; i < cantidad; i++) {
+                if (strcmp(numero_temp, numeros[i]) == 0) {
+                    indice = i;
+                    break;
+                }
+            }
+        }
+        
+        if (indice >= 0) {
+            // Actualizar estado - mantener el mismo formato
+            fprintf(temp, "%s|%s|%s|%s|%s|%s|%s|%s|%d\n", 
+                    placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
+                    fecha_emision_temp, fecha_vencimiento_temp, total_temp, nuevo_estado);
+            if (!actualizados[indice]) {
+                actualizados[indice] = 1;
+                encontrados++;
             }
         } else {
             fprintf(temp, "%s", linea);
@@ -219,11 +308,130 @@ int actualizar_estado_comprobante(const char* numero_comprobante, int nuevo_esta
     fclose(archivo);
     fclose(temp);
     
-    // Reemplazar archivo original
-    remove(ARCHIVO_COMPROBANTES);
-    rename("temp_comprobantes.txt", ARCHIVO_COMPROBANTES);
+    // Reemplazar archivo original solo si hubo cambios
+    if (encontrados > 0) {
+        remove(ruta);
+        rename("temp_comprobantes.txt", ruta);
+    } else {
+        remove("temp_comprobantes.txt");
+    }
     
-    return 1;
+    return encontrados;
+}
+
+/*
+ * Funcion: actualizar_estados_en_repositorio
+ * Descripcion: Cambia el estado de los comprobantes en el motor del
+ *              repositorio. Con el motor de texto no hace nada: sus datos
+ *              son las mismas particiones que ya se reescribieron
+ * Parametros: numeros, cantidad, nuevo_estado
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int actualizar_estados_en_repositorio(char (*numeros)[MAX_COMPROBANTE], int cantidad, int nuevo_estado) {
+    if (repositorio_usa_proyecciones(TABLA_COMPROBANTES)) {
+        return 1;
+    }
+    
+    int exito = 1;
+    for (int i = 0; i < cantidad; i++) {
+        char linea[MAX_VALOR_REGISTRO];
+        if (!repositorio_obtener(TABLA_COMPROBANTES, numeros[i], linea, sizeof(linea))) {
+            continue;
+        }
+        
+        // El estado es el ultimo campo de la linea
+        char* estado = strrchr(linea, '|');
+        if (!estado) {
+            continue;
+        }
+        snprintf(estado + 1, sizeof(linea) - (size_t)(estado + 1 - linea), "%d", nuevo_estado);
+        if (!repositorio_actualizar(TABLA_COMPROBANTES, numeros[i], linea)) {
+            exito = 0;
+        }
+    }
+    return repositorio_confirmar() && exito;
+}
+
+/*
+ * Funcion: actualizar_estado_comprobantes
+ * Descripcion: Actualiza el estado de varios comprobantes. Los que estan en
+ *              el indice de comprobantes se cambian en su linea; para el
+ *              resto cada particion se reescribe una sola vez, con todos
+ *              los comprobantes de su mes (el mes sale del numero)
+ * Parametros: numeros, cantidad, nuevo_estado
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int actualizar_estado_comprobantes(char (*numeros)[MAX_COMPROBANTE], int cantidad, int nuevo_estado) {
+    if (cantidad <= 0) {
+        return 1;
+    }
+    
+    int* procesados = calloc((size_t)cantidad, sizeof(int));
+    if (!procesados) {
+        return 0;
+    }
+    
+    // Con el indice cada estado se cambia sobre su propia linea; solo los
+    // comprobantes que no esten en el indice obligan a reescribir su particion
+    for (int i = 0; i < cantidad; i++) {
+        procesados[i] = indice_comprobantes_cambiar_estado(numeros[i], nuevo_estado);
+    }
+    
+    int exito = 1;
+    for (int i = 0; exito && i < cantidad; i++) {
+        if (procesados[i]) {
+            continue;
+        }
+        
+        // Los comprobantes del mismo mes que este se actualizan juntos
+        char del_mes[MAX_VEHICULOS_PROPIETARIO][MAX_COMPROBANTE];
+        int actualizados[MAX_VEHICULOS_PROPIETARIO] = {0};
+        int periodo = periodo_de_numero_comprobante(numeros[i]);
+        int cantidad_mes = 0;
+        for (int j = i; j < cantidad && cantidad_mes < MAX_VEHICULOS_PROPIETARIO; j++) {
+            if (!procesados[j] && periodo_de_numero_comprobante(numeros[j]) == periodo) {
+                strcpy(del_mes[cantidad_mes++], numeros[j]);
+                procesados[j] = 1;
+            }
+        }
+        
+        int periodos[MAX_PARTICIONES];
+        int cantidad_periodos = particion_listar(PARTICION_COMPROBANTES, periodo, periodo, periodos, MAX_PARTICIONES);
+        if (cantidad_periodos == 0) {
+            exito = 0;
+            break;
+        }
+        
+        // Primero la particion del mes, al final el archivo anterior a las particiones
+        int pendientes = cantidad_mes;
+        for (int k = cantidad_periodos - 1; k >= 0 && pendientes > 0; k--) {
+            char ruta[MAX_RUTA_PARTICION];
+            particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[k]);
+            
+            int resultado = actualizar_estados_en_archivo(ruta, del_mes, cantidad_mes, nuevo_estado, actualizados);
+            if (resultado < 0) {
+                exito = 0;
+                break;
+            }
+            pendientes -= resultado;
+        }
+    }
+    
+    free(procesados);
+    return exito && actualizar_estados_en_repositorio(numeros, cantidad, nuevo_estado);
+}
+
+/*
+ * Funcion: actualizar_estado_comprobante
+ * Descripcion: Actualiza el estado de un comprobante. Solo se reescribe la
+ *              particion del mes que indica el numero de comprobante
+ * Parametros: numero_comprobante, nuevo_estado
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int actualizar_estado_comprobante(const char* numero_comprobante, int nuevo_estado) {
+    char numero[1][MAX_COMPROBANTE];
+    snprintf(numero[0], MAX_COMPROBANTE, "%s", numero_comprobante);
+    return actualizar_estado_comprobantes(numero, 1, nuevo_estado);
 }
 
 /*
@@ -233,39 +441,269 @@ int actualizar_estado_comprobante(const char* numero_comprobante, int nuevo_esta
  * Retorno: 1 si encontro los datos, 0 si no los encontro
  */
 int obtener_datos_propietario(const char* placa, char* cedula, char* nombre) {
-    FILE* archivo = fopen("vehiculos.txt", "r");
-    if (!archivo) {
+    DatosVehiculo vehiculo;
+    if (!repositorio_buscar_vehiculo(placa, &vehiculo)) {
         return 0;
     }
     
-    char linea[500];
-    while (fgets(linea, sizeof(linea), archivo)) {
-        // Formato: placa,cedula,nombre,tipo,subtipo,anio,valor,cilindraje
-        char placa_temp[10], cedula_temp[15], nombre_temp[100];
-        char tipo_temp[20], subtipo_temp[20];
-        int anio_temp, cilindraje_temp;
-        float valor_temp;
+    strcpy(cedula, vehiculo.cedula);
+    strcpy(nombre, vehiculo.propietario);
+    return 1;
+}
+
+// ===================================================================
+// FUNCIONES DE CONSULTA
+// ===================================================================
+
+/*
+ * Estructura: BusquedaPorPlaca
+ * Descripcion: Contexto de la busqueda del comprobante de una placa en el
+ *              indice de comprobantes
+ */
+typedef struct {
+    const char* placa;
+    int solo_pendientes;
+    int periodo_desde;
+    ComprobanteMatricula* comprobante;
+    UbicacionComprobante mejor;      // Linea del comprobante elegido hasta ahora
+    int encontrado;
+} BusquedaPorPlaca;
+
+/*
+ * Funcion: elegir_comprobante_de_placa
+ * Descripcion: Revisa un comprobante del recorrido por prefijo y se queda
+ *              con el de la linea mas reciente (ultimo mes, ultima linea),
+ *              igual que el recorrido de las particiones
+ */
+static int elegir_comprobante_de_placa(const char* numero, const UbicacionComprobante* ubicacion,
+                                       const char* linea, void* contexto) {
+    BusquedaPorPlaca* busqueda = contexto;
+    char placa_temp[20], numero_temp[50], propietario_temp[100], tipo_temp[50], subtipo_temp[50];
+    char fecha_emision_temp[20], fecha_vencimiento_temp[20];
+    char total_temp[MAX_TEXTO_DINERO];
+    Dinero monto_temp;
+    int estado_temp;
+    
+    if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%23[^|]|%d",
+               placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
+               fecha_emision_temp, fecha_vencimiento_temp, total_temp, &estado_temp) != 9 ||
+        !dinero_leer(total_temp, &monto_temp) ||
+        strcmp(placa_temp, busqueda->placa) != 0 ||
+        (busqueda->solo_pendientes && estado_temp != ESTADO_PENDIENTE)) {
+        return 1;
+    }
+    if (ubicacion->periodo != PERIODO_LEGADO && ubicacion->periodo < busqueda->periodo_desde) {
+        return 1;
+    }
+    if (busqueda->encontrado &&
+        (ubicacion->periodo < busqueda->mejor.periodo ||
+         (ubicacion->periodo == busqueda->mejor.periodo && ubicacion->posicion < busqueda->mejor.posicion))) {
+        return 1;
+    }
+    
+    ComprobanteMatricula* comprobante = busqueda->comprobante;
+    strcpy(comprobante->numero_comprobante, numero);
+    strcpy(comprobante->placa, placa_temp);
+    strcpy(comprobante->fecha_emision, fecha_emision_temp);
+    strcpy(comprobante->fecha_vencimiento, fecha_vencimiento_temp);
+    comprobante->monto_total = monto_temp;
+    comprobante->estado = estado_temp;
+    busqueda->mejor = *ubicacion;
+    busqueda->encontrado = 1;
+    return 1;
+}
+
+/*
+ * Funcion: buscar_comprobante_por_placa
+ * Descripcion: Busca el comprobante mas reciente de una placa. Con el
+ *              indice de comprobantes solo se leen las lineas de la placa
+ *              (numeros MAT-<placa>-...); si no se puede usar, recorre
+ *              las particiones desde el mes actual hacia atras
+ * Parametros:
+ *   - placa: Placa del vehiculo
+ *   - solo_pendientes: 1 para ignorar comprobantes pagados o vencidos
+ *   - periodo_desde: Mes mas antiguo a revisar (0 = todo el historial)
+ *   - comprobante: Estructura donde se guarda el comprobante encontrado
+ * Retorno: 1 si lo encontro, 0 si no, -1 si no hay comprobantes en el sistema
+ */
+static int buscar_comprobante_por_placa(const char* placa, int solo_pendientes, int periodo_desde,
+                                        ComprobanteMatricula* comprobante) {
+    int periodos[MAX_PARTICIONES];
+    int cantidad = particion_listar(PARTICION_COMPROBANTES, periodo_desde, 0, periodos, MAX_PARTICIONES);
+    if (cantidad == 0) {
+        return -1;
+    }
+    
+    char prefijo[MAX_COMPROBANTE];
+    BusquedaPorPlaca busqueda = {placa, solo_pendientes, periodo_desde, comprobante, {0, 0}, 0};
+    snprintf(prefijo, sizeof(prefijo), "MAT-%s-", placa);
+    
+    // El indice no tiene los numeros de LARGO_CLAVE_ARBOL caracteres o mas:
+    // con una placa larga, no encontrar nada en el indice no es una respuesta
+    int numeros_indexados = strlen(prefijo) + strlen("AAAAMMDD-NNN") < LARGO_CLAVE_ARBOL;
+    if (indice_comprobantes_recorrer_prefijo(prefijo, elegir_comprobante_de_placa, &busqueda) >= 0 &&
+        (busqueda.encontrado || numeros_indexados)) {
+        return busqueda.encontrado;
+    }
+    
+    for (int i = cantidad - 1; i >= 0; i--) {
+        char ruta[MAX_RUTA_PARTICION];
+        particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[i]);
+        FILE* archivo = fopen(ruta, "r");
+        if (!archivo) {
+            continue;
+        }
         
-        if (sscanf(linea, "%[^,],%[^,],%[^,],%[^,],%[^,],%d,%f,%d", 
-                   placa_temp, cedula_temp, nombre_temp, tipo_temp, 
-                   subtipo_temp, &anio_temp, &valor_temp, &cilindraje_temp) == 8) {
+        // Dentro del mes gana la ultima linea de la placa (la mas reciente)
+        char linea[500];
+        int comprobante_encontrado = 0;
+        while (fgets(linea, sizeof(linea), archivo)) {
+            char placa_temp[20], numero_temp[50], propietario_temp[100], tipo_temp[50], subtipo_temp[50];
+            char fecha_emision_temp[20], fecha_vencimiento_temp[20];
+            char total_temp[MAX_TEXTO_DINERO];
+            Dinero monto_temp;
+            int estado_temp;
             
-            if (strcmp(placa_temp, placa) == 0) {
-                strcpy(cedula, cedula_temp);
-                strcpy(nombre, nombre_temp);
-                fclose(archivo);
-                return 1;
+            if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%23[^|]|%d",
+                       placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
+                       fecha_emision_temp, fecha_vencimiento_temp, total_temp, &estado_temp) == 9 &&
+                dinero_leer(total_temp, &monto_temp)) {
+                
+                if (strcmp(placa_temp, placa) == 0 && (!solo_pendientes || estado_temp == ESTADO_PENDIENTE)) {
+                    strcpy(comprobante->numero_comprobante, numero_temp);
+                    strcpy(comprobante->placa, placa_temp);
+                    strcpy(comprobante->fecha_emision, fecha_emision_temp);
+                    strcpy(comprobante->fecha_vencimiento, fecha_vencimiento_temp);
+                    comprobante->monto_total = monto_temp;
+                    comprobante->estado = estado_temp;
+                    comprobante_encontrado = 1;
+                }
             }
         }
+        fclose(archivo);
+        
+        if (comprobante_encontrado) {
+            return 1;
+        }
     }
     
-    fclose(archivo);
     return 0;
 }
 
-// ===================================================================
-// FUNCIONES DE CONSULTA
-// ===================================================================
+/*
+ * Funcion: mostrar_pago
+ * Descripcion: Muestra un pago del historial de una placa
+ */
+static int mostrar_pago(const char* clave, const char* valor, void* contexto) {
+    char fecha[20], monto_texto[MAX_TEXTO_DINERO];
+    Dinero monto;
+    
+    // Formato: numero_comprobante|placa|fecha_pago|monto|...
+    if (sscanf(valor, "%*[^|]|%*[^|]|%19[^|]|%23[^|]", fecha, monto_texto) == 2 && dinero_leer(monto_texto, &monto)) {
+        printf("%-30s %-20s $%.2f\n", clave, fecha, dinero_a_decimal(monto));
+        (*(int*)contexto)++;
+    }
+    return 1;
+}
+
+/*
+ * Funcion: mostrar_pagos_de_placa
+ * Descripcion: Muestra los pagos registrados de una placa. Los numeros de
+ *              comprobante empiezan con MAT-<placa>-, asi que los pagos de
+ *              una placa son un rango de claves de la tabla de pagos
+ * Parametros: placa
+ * Retorno: void
+ */
+static void mostrar_pagos_de_placa(const char* placa) {
+    char prefijo[MAX_CLAVE_REGISTRO];
+    int pagos = 0;
+    snprintf(prefijo, sizeof(prefijo), "MAT-%s-", placa);
+    
+    printf("\nPAGOS REGISTRADOS:\n");
+    if (repositorio_recorrer_prefijo(TABLA_PAGOS, prefijo, mostrar_pago, &pagos) < 0) {
+        printf("- No se pudieron consultar los pagos\n");
+    } else if (pagos == 0) {
+        printf("- No hay pagos registrados para esta placa\n");
+    }
+}
+
+/*
+ * Estructura: ListadoPagos
+ * Descripcion: Totales del listado de pagos
+ */
+typedef struct {
+    int cantidad;
+    Dinero total;
+} ListadoPagos;
+
+/*
+ * Funcion: mostrar_linea_listado_pago
+ * Descripcion: Muestra un pago del listado general
+ * Parametros: clave, valor, contexto - Totales del listado
+ * Retorno: 1 para seguir recorriendo
+ */
+static int mostrar_linea_listado_pago(const char* clave, const char* valor, void* contexto) {
+    (void)clave;
+    ListadoPagos* listado = contexto;
+    char numero[MAX_COMPROBANTE], placa[10], fecha[20], monto_texto[MAX_TEXTO_DINERO];
+    Dinero monto;
+    
+    // Formato: numero_comprobante|placa|fecha_pago|monto|tipo|referencia|cedula|nombre
+    if (sscanf(valor, "%49[^|]|%9[^|]|%19[^|]|%23[^|]", numero, placa, fecha, monto_texto) == 4 &&
+        dinero_leer(monto_texto, &monto)) {
+        const char* nombre = strrchr(valor, '|');
+        listado->cantidad++;
+        listado->total += monto;
+        printf("%-17s %-10s %-28.28s %12.2f  %-.*s\n", fecha, placa, numero, dinero_a_decimal(monto),
+               nombre ? (int)strcspn(nombre + 1, "\r\n") : 0, nombre ? nombre + 1 : "");
+    }
+    return 1;
+}
+
+/*
+ * Funcion: listar_pagos_ordenados
+ * Descripcion: Listado de todos los pagos para auditoria, en el orden de
+ *              registro o por placa, monto o fecha de pago. El orden usa
+ *              el ordenamiento externo, asi que funciona aunque los pagos
+ *              no quepan en memoria
+ * Parametros: ninguno
+ * Retorno: void
+ */
+void listar_pagos_ordenados() {
+    // Campo de la linea para cada criterio: placa, monto y fecha_pago
+    static const int campos_orden[] = {0, 1, 3, 2};
+    ListadoPagos listado = {0, 0};
+    char total[MAX_TEXTO_DINERO];
+    
+    system("cls");
+    printf("\n");
+    printf("===========================================================================\n");
+    printf("                         LISTADO DE PAGOS\n");
+    printf("                       AGENCIA NACIONAL DE TRANSITO\n");
+    printf("===========================================================================\n");
+    printf("\n");
+    
+    int criterio = orden_pedir_criterio("Monto");
+    printf("\n");
+    
+    printf("%-17s %-10s %-28s %12s  %s\n", "FECHA", "PLACA", "COMPROBANTE", "MONTO", "PAGADOR");
+    printf("---------------------------------------------------------------------------\n");
+    
+    if (repositorio_recorrer_ordenado(TABLA_PAGOS, criterio, campos_orden[criterio],
+                                      mostrar_linea_listado_pago, &listado) < 0) {
+        printf("No se pudo ordenar el listado (memoria o archivos temporales).\n");
+    }
+    
+    if (listado.cantidad == 0) {
+        printf("No hay pagos registrados.\n");
+    } else {
+        printf("---------------------------------------------------------------------------\n");
+        printf("Pagos: %d    Total recaudado: $%s\n", listado.cantidad, dinero_formatear(listado.total, total));
+    }
+    
+    printf("\nPresione Enter para continuar...");
+    getchar();
+}
 
 /*
  * Funcion: consultar_estado_por_placa
@@ -301,40 +739,13 @@ int consultar_estado_por_placa() {
     }
     
     // Buscar comprobante para esta placa
-    FILE* archivo = fopen(ARCHIVO_COMPROBANTES, "r");
-    if (!archivo) {
+    int comprobante_encontrado = buscar_comprobante_por_placa(placa, 0, 0, &comprobante);
+    if (comprobante_encontrado < 0) {
         printf("No se encontraron comprobantes en el sistema.\n");
         pausar_sistema();
         return 0;
     }
     
-    char linea[500];
-    int comprobante_encontrado = 0;
-    while (fgets(linea, sizeof(linea), archivo)) {
-        char placa_temp[20], numero_temp[50], propietario_temp[100], tipo_temp[50], subtipo_temp[50];
-        char fecha_emision_temp[20], fecha_vencimiento_temp[20];
-        float total_temp;
-        int estado_temp;
-        
-        if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%f|%d",
-                   placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
-                   fecha_emision_temp, fecha_vencimiento_temp, &total_temp, &estado_temp) == 9) {
-            
-            if (strcmp(placa_temp, placa) == 0) {
-                // Encontramos el comprobante
-                strcpy(comprobante.numero_comprobante, numero_temp);
-                strcpy(comprobante.placa, placa_temp);
-                strcpy(comprobante.fecha_emision, fecha_emision_temp);
-                strcpy(comprobante.fecha_vencimiento, fecha_vencimiento_temp);
-                comprobante.monto_total = total_temp;
-                comprobante.estado = estado_temp;
-                comprobante_encontrado = 1;
-                break;
-            }
-        }
-    }
-    fclose(archivo);
-    
     if (!comprobante_encontrado) {
         printf("No se encontro comprobante para la placa '%s'.\n", placa);
         printf("\nOpciones:\n");
@@ -351,7 +762,7 @@ int consultar_estado_por_placa() {
     printf("Numero de comprobante: %s\n", comprobante.numero_comprobante);
     printf("Fecha de emision: %s\n", comprobante.fecha_emision);
     printf("Fecha de vencimiento: %s\n", comprobante.fecha_vencimiento);
-    printf("Monto total: $%.2f\n", comprobante.monto_total);
+    printf("Monto total: $%.2f\n", dinero_a_decimal(comprobante.monto_total));
     printf("Estado: ");
     mostrar_estado_comprobante(comprobante.estado);
     printf("\n");
@@ -372,6 +783,173 @@ int consultar_estado_por_placa() {
         printf("- Luego puede completar la matriculacion final\n");
     }
     
+    mostrar_pagos_de_placa(comprobante.placa);
+    
+    pausar_sistema();
+    return 1;
+}
+
+/*
+ * Funcion: buscar_comprobantes_de_placas
+ * Descripcion: Busca el comprobante mas reciente de varias placas en una
+ *              sola pasada por las particiones, desde el mes actual hacia
+ *              atras, y se detiene cuando ya encontro todas
+ * Parametros:
+ *   - placas: Placas a buscar
+ *   - cantidad: Numero de placas
+ *   - solo_pendientes: 1 para ignorar comprobantes pagados o vencidos
+ *   - periodo_desde: Mes mas antiguo a revisar (0 = todo el historial)
+ *   - comprobantes: Comprobante encontrado de cada placa
+ *   - encontrados: 1 si la placa tiene comprobante, 0 si no
+ * Retorno: Numero de placas con comprobante
+ */
+static int buscar_comprobantes_de_placas(char (*placas)[10], int cantidad, int solo_pendientes, int periodo_desde,
+                                         ComprobanteMatricula* comprobantes, int* encontrados) {
+    int periodos[MAX_PARTICIONES];
+    int cantidad_periodos = particion_listar(PARTICION_COMPROBANTES, periodo_desde, 0, periodos, MAX_PARTICIONES);
+    int total_encontrados = 0;
+    
+    for (int j = 0; j < cantidad; j++) {
+        encontrados[j] = 0;
+    }
+    
+    for (int i = cantidad_periodos - 1; i >= 0 && total_encontrados < cantidad; i--) {
+        char ruta[MAX_RUTA_PARTICION];
+        particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[i]);
+        FILE* archivo = fopen(ruta, "r");
+        if (!archivo) {
+            continue;
+        }
+        
+        // Dentro del mes gana la ultima linea de cada placa; las placas ya
+        // encontradas en un mes mas reciente no se tocan
+        int en_este_mes[MAX_VEHICULOS_PROPIETARIO] = {0};
+        char linea[500];
+        while (fgets(linea, sizeof(linea), archivo)) {
+            char placa_temp[20], numero_temp[50], propietario_temp[100], tipo_temp[50], subtipo_temp[50];
+            char fecha_emision_temp[20], fecha_vencimiento_temp[20];
+            char total_temp[MAX_TEXTO_DINERO];
+            Dinero monto_temp;
+            int estado_temp;
+            
+            if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%23[^|]|%d",
+                       placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
+                       fecha_emision_temp, fecha_vencimiento_temp, total_temp, &estado_temp) != 9 ||
+                !dinero_leer(total_temp, &monto_temp) ||
+                (solo_pendientes && estado_temp != ESTADO_PENDIENTE)) {
+                continue;
+            }
+            
+            for (int j = 0; j < cantidad; j++) {
+                if ((!encontrados[j] || en_este_mes[j]) && strcmp(placa_temp, placas[j]) == 0) {
+                    strcpy(comprobantes[j].numero_comprobante, numero_temp);
+                    strcpy(comprobantes[j].placa, placa_temp);
+                    strcpy(comprobantes[j].fecha_emision, fecha_emision_temp);
+                    strcpy(comprobantes[j].fecha_vencimiento, fecha_vencimiento_temp);
+                    comprobantes[j].monto_total = monto_temp;
+                    comprobantes[j].estado = estado_temp;
+                    if (!encontrados[j]) {
+                        encontrados[j] = 1;
+                        en_este_mes[j] = 1;
+                        total_encontrados++;
+                    }
+                    break;
+                }
+            }
+        }
+        fclose(archivo);
+    }
+    
+    return total_encontrados;
+}
+
+/*
+ * Funcion: consultar_vehiculos_por_cedula
+ * Descripcion: Muestra todos los vehiculos de un propietario con el estado
+ *              del ultimo comprobante de cada uno y el total pendiente.
+ *              Las placas salen del indice por cedula, sin recorrer
+ *              vehiculos.txt
+ * Parametros: ninguno
+ * Retorno: 1 si el propietario tiene vehiculos, 0 si no
+ */
+int consultar_vehiculos_por_cedula() {
+    char cedula[20];
+    char buffer[100];
+    char placas[MAX_VEHICULOS_PROPIETARIO][10];
+    ComprobanteMatricula comprobantes[MAX_VEHICULOS_PROPIETARIO];
+    int encontrados[MAX_VEHICULOS_PROPIETARIO];
+    
+    system("cls");
+    printf("\n");
+    printf("=======================================================\n");
+    printf("           VEHICULOS DE UN PROPIETARIO\n");
+    printf("           AGENCIA NACIONAL DE TRANSITO\n");
+    printf("=======================================================\n");
+    printf("\n");
+    
+    printf("Ingrese la cedula del propietario: ");
+    if (!fgets(buffer, sizeof(buffer), stdin)) {
+        printf("Error al leer la cedula del propietario.\n");
+        pausar_sistema();
+        return 0;
+    }
+    buffer[strcspn(buffer, "\n")] = 0;
+    sscanf(buffer, "%19s", cedula);
+    
+    if (validar_cedula(cedula) != 1) {
+        printf("Cedula invalida.\n");
+        pausar_sistema();
+        return 0;
+    }
+    
+    int cantidad = indice_placas_de_cedula(cedula, placas, MAX_VEHICULOS_PROPIETARIO);
+    if (cantidad < 0) {
+        printf("No hay vehiculos registrados en el sistema.\n");
+        pausar_sistema();
+        return 0;
+    }
+    if (cantidad == 0) {
+        printf("No hay vehiculos registrados con la cedula '%s'.\n", cedula);
+        pausar_sistema();
+        return 0;
+    }
+    
+    buscar_comprobantes_de_placas(placas, cantidad, 0, 0, comprobantes, encontrados);
+    
+    DatosVehiculo vehiculo;
+    if (repositorio_buscar_vehiculo(placas[0], &vehiculo)) {
+        printf("Propietario: %s\n\n", vehiculo.propietario);
+    }
+    
+    int pendientes = 0;
+    Dinero total_pendiente = 0;
+    printf("%-10s %-12s %-12s %12s  %s\n", "PLACA", "TIPO", "SUBTIPO", "AVALUO", "ULTIMO COMPROBANTE");
+    printf("-----------------------------------------------------------------------\n");
+    for (int i = 0; i < cantidad; i++) {
+        if (!repositorio_buscar_vehiculo(placas[i], &vehiculo)) {
+            continue;
+        }
+        
+        printf("%-10s %-12s %-12s %12.2f  ", vehiculo.placa, vehiculo.tipo, vehiculo.subtipo, dinero_a_decimal(vehiculo.avaluo));
+        if (!encontrados[i]) {
+            printf("Sin comprobante\n");
+            continue;
+        }
+        printf("$%.2f ", dinero_a_decimal(comprobantes[i].monto_total));
+        mostrar_estado_comprobante(comprobantes[i].estado);
+        if (comprobantes[i].estado == ESTADO_PENDIENTE) {
+            if (!comprobante_vigente(comprobantes[i].fecha_vencimiento)) {
+                printf(" (vencido el %s)", comprobantes[i].fecha_vencimiento);
+            }
+            pendientes++;
+            total_pendiente += comprobantes[i].monto_total;
+        }
+        printf("\n");
+    }
+    printf("-----------------------------------------------------------------------\n");
+    printf("Vehiculos: %d    Comprobantes pendientes: %d    Total pendiente: $%.2f\n",
+           cantidad, pendientes, dinero_a_decimal(total_pendiente));
+    
     pausar_sistema();
     return 1;
 }
@@ -425,12 +1003,23 @@ void generar_numero_comprobante(char* numero, const char* placa) {
     time_t t = time(NULL);
     struct tm* fecha = localtime(&t);
     
-    sprintf(numero, "MAT-%s-%04d%02d%02d-%03d", 
+    formatear_numero_comprobante(numero, placa, fecha, (unsigned int)rand());
+}
+
+/*
+ * Funcion: formatear_numero_comprobante
+ * Descripcion: Arma un numero de comprobante con la fecha y la secuencia
+ *              dadas (se usan las tres ultimas cifras de la secuencia)
+ * Parametros: numero - Buffer donde guardar el numero, placa, fecha, secuencia
+ * Retorno: void
+ */
+void formatear_numero_comprobante(char* numero, const char* placa, const struct tm* fecha, unsigned int secuencia) {
+    sprintf(numero, "MAT-%s-%04d%02d%02d-%03u", 
             placa, 
             fecha->tm_year + 1900,
             fecha->tm_mon + 1,
             fecha->tm_mday,
-            rand() % 1000);
+            secuencia % 1000);
 }
 
 // ===================================================================
@@ -533,42 +1122,16 @@ int procesar_pago_por_placa() {
         placa[i] = toupper(placa[i]);
     }
     
-    // Buscar comprobante pendiente para esta placa
-    FILE* archivo = fopen(ARCHIVO_COMPROBANTES, "r");
-    if (!archivo) {
+    // Buscar comprobante pendiente para esta placa en todo el historial:
+    // un comprobante pendiente de meses anteriores se informa como vencido
+    int comprobante_encontrado = buscar_comprobante_por_placa(placa, 1, 0, &comprobante);
+    if (comprobante_encontrado < 0) {
         printf("Error: No se encontraron comprobantes en el sistema.\n");
         printf("Debe calcular la matricula primero.\n");
         pausar_sistema();
         return 0;
     }
     
-    char linea[500];
-    int comprobante_encontrado = 0;
-    while (fgets(linea, sizeof(linea), archivo)) {
-        char placa_temp[20], numero_temp[50], propietario_temp[100], tipo_temp[50], subtipo_temp[50];
-        char fecha_emision_temp[20], fecha_vencimiento_temp[20];
-        float total_temp;
-        int estado_temp;
-        
-        if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%f|%d",
-                   placa_temp, numero_temp, propietario_temp, tipo_temp, subtipo_temp,
-                   fecha_emision_temp, fecha_vencimiento_temp, &total_temp, &estado_temp) == 9) {
-            
-            if (strcmp(placa_temp, placa) == 0 && estado_temp == ESTADO_PENDIENTE) {
-                // Encontramos el comprobante pendiente
-                strcpy(comprobante.numero_comprobante, numero_temp);
-                strcpy(comprobante.placa, placa_temp);
-                strcpy(comprobante.fecha_emision, fecha_emision_temp);
-                strcpy(comprobante.fecha_vencimiento, fecha_vencimiento_temp);
-                comprobante.monto_total = total_temp;
-                comprobante.estado = estado_temp;
-                comprobante_encontrado = 1;
-                break;
-            }
-        }
-    }
-    fclose(archivo);
-    
     if (!comprobante_encontrado) {
         printf("No se encontro comprobante pendiente para la placa '%s'.\n", placa);
         printf("Opciones:\n");
@@ -595,7 +1158,7 @@ int procesar_pago_por_placa() {
     printf("Numero de comprobante: %s\n", comprobante.numero_comprobante);
     printf("Fecha de emision: %s\n", comprobante.fecha_emision);
     printf("Fecha de vencimiento: %s\n", comprobante.fecha_vencimiento);
-    printf("Monto a pagar: $%.2f\n", comprobante.monto_total);
+    printf("Monto a pagar: $%.2f\n", dinero_a_decimal(comprobante.monto_total));
     printf("=======================================================\n");
     printf("\n");
     
@@ -636,7 +1199,7 @@ int procesar_pago_por_placa() {
     printf("CONFIRMACION DE PAGO:\n");
     printf("=======================================================\n");
     printf("Esta seguro de que desea pagar $%.2f para el vehiculo %s?\n", 
-           comprobante.monto_total, placa);
+           dinero_a_decimal(comprobante.monto_total), placa);
     printf("=======================================================\n");
     printf("Confirmar pago? (S/N): ");
     
@@ -660,28 +1223,14 @@ int procesar_pago_por_placa() {
     strcpy(pago.referencia_pago, "EFECTIVO");
     obtener_fecha_actual(pago.fecha_pago);
     
-    // Guardar registro de pago
-    if (!guardar_registro_pago(pago)) {
+    // Guardar el pago y la matricula pagada en una sola escritura del
+    // registro de eventos (el evento de pago deja el comprobante como pagado)
+    if (!guardar_registros_pago_lote(&pago, 1)) {
         printf("Error: No se pudo guardar el registro de pago.\n");
         pausar_sistema();
         return 0;
     }
     
-    // Actualizar estado del comprobante
-    if (!actualizar_estado_comprobante(comprobante.numero_comprobante, ESTADO_PAGADO)) {
-        printf("Error: No se pudo actualizar el estado del comprobante.\n");
-        pausar_sistema();
-        return 0;
-    }
-    
-    // Guardar en archivo simple de pagos realizados
-    FILE* archivo_pagados = fopen("matriculas_pagadas.txt", "a");
-    if (archivo_pagados) {
-        fprintf(archivo_pagados, "%s|%s|%s|%.2f|PAGADO\n",
-                comprobante.numero_comprobante, placa, pago.fecha_pago, pago.monto_pagado);
-        fclose(archivo_pagados);
-    }
-    
     // Mostrar comprobante de pago exitoso
     printf("\n");
     printf("=======================================================\n");
@@ -694,7 +1243,7 @@ int procesar_pago_por_placa() {
     printf("Numero de comprobante: %s\n", pago.numero_comprobante);
     printf("Placa: %s\n", pago.placa);
     printf("Fecha de pago: %s\n", pago.fecha_pago);
-    printf("Monto pagado: $%.2f\n", pago.monto_pagado);
+    printf("Monto pagado: $%.2f\n", dinero_a_decimal(pago.monto_pagado));
     printf("Pagador: %s (%s)\n", pago.nombre_pagador, pago.cedula_pagador);
     printf("-------------------------------------------------------\n");
     printf("\n");
@@ -707,6 +1256,295 @@ int procesar_pago_por_placa() {
     printf("      GRACIAS POR UTILIZAR NUESTROS SERVICIOS\n");
     printf("=======================================================\n");
     
+    pausar_sistema();
+    return 1;
+}
+
+/*
+ * Funcion: leer_placas_lote
+ * Descripcion: Interpreta la entrada del pago en lote: una cedula o RUC
+ *              (se toman todos los vehiculos del propietario) o una lista
+ *              de placas separadas por espacios o comas
+ * Parametros: entrada - Texto ingresado (se modifica), placas (salida), max
+ * Retorno: Cantidad de placas, -1 si el lote tiene mas de max placas
+ */
+static int leer_placas_lote(char* entrada, char (*placas)[10], int max) {
+    int solo_digitos = entrada[0] != '\0';
+    for (int i = 0; entrada[i]; i++) {
+        if (!isdigit((unsigned char)entrada[i])) {
+            solo_digitos = 0;
+            break;
+        }
+    }
+    if (solo_digitos) {
+        // Se pide una placa mas para saber si el propietario tiene mas de max
+        char (*encontradas)[10] = malloc((size_t)(max + 1) * sizeof(*encontradas));
+        if (!encontradas) {
+            return 0;
+        }
+        int cantidad = indice_placas_de_cedula(entrada, encontradas, max + 1);
+        if (cantidad > max) {
+            cantidad = -1;
+        } else if (cantidad > 0) {
+            memcpy(placas, encontradas, (size_t)cantidad * sizeof(*placas));
+        } else {
+            cantidad = 0;
+        }
+        free(encontradas);
+        return cantidad;
+    }
+    
+    int cantidad = 0;
+    for (char* placa = strtok(entrada, " ,;\t"); placa; placa = strtok(NULL, " ,;\t")) {
+        for (int i = 0; placa[i]; i++) {
+            placa[i] = toupper((unsigned char)placa[i]);
+        }
+        if (!validar_placa(placa)) {
+            printf("Placa '%s' ignorada: formato incorrecto.\n", placa);
+            continue;
+        }
+        
+        int repetida = 0;
+        for (int i = 0; i < cantidad; i++) {
+            if (strcmp(placas[i], placa) == 0) {
+                repetida = 1;
+                break;
+            }
+        }
+        if (!repetida) {
+            if (cantidad == max) {
+                return -1;
+            }
+            strcpy(placas[cantidad++], placa);
+        }
+    }
+    return cantidad;
+}
+
+/*
+ * Funcion: agregar_linea_recibo
+ * Descripcion: Agrega una linea con formato al recibo en memoria
+ * Parametros: recibo, formato, ... - Igual que printf
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int agregar_linea_recibo(BufferTexto* recibo, const char* formato, ...) {
+    char linea[200];
+    va_list argumentos;
+    va_start(argumentos, formato);
+    int longitud = vsnprintf(linea, sizeof(linea), formato, argumentos);
+    va_end(argumentos);
+    
+    if (longitud < 0) {
+        return 0;
+    }
+    if (longitud >= (int)sizeof(linea)) {
+        longitud = (int)sizeof(linea) - 1;
+    }
+    return buffer_agregar(recibo, linea, (size_t)longitud);
+}
+
+/*
+ * Funcion: procesar_pago_lote
+ * Descripcion: Paga en una sola transaccion todos los comprobantes
+ *              pendientes de un propietario (cedula o RUC) o de una lista
+ *              de placas. Los pagos se agregan al registro con una sola
+ *              escritura y una sola sincronizacion; cada particion de
+ *              comprobantes se reescribe una vez. Emite un recibo unico
+ *              para todo el lote y lo guarda en el almacen de documentos
+ * Parametros: ninguno
+ * Retorno: 1 si el pago fue exitoso, 0 si hubo error
+ */
+int procesar_pago_lote() {
+    char buffer[1024];
+    char placas[MAX_VEHICULOS_PROPIETARIO][10];
+    ComprobanteMatricula comprobantes[MAX_VEHICULOS_PROPIETARIO];
+    int encontrados[MAX_VEHICULOS_PROPIETARIO];
+    RegistroPago pagos[MAX_VEHICULOS_PROPIETARIO];
+    
+    system("cls");
+    printf("\n");
+    printf("=======================================================\n");
+    printf("              PAGO DE MATRICULAS EN LOTE\n");
+    printf("           AGENCIA NACIONAL DE TRANSITO\n");
+    printf("=======================================================\n");
+    printf("\n");
+    
+    printf("Ingrese la cedula/RUC del propietario o las placas separadas por comas:\n> ");
+    if (!fgets(buffer, sizeof(buffer), stdin)) {
+        printf("Error al leer los datos del lote.\n");
+        pausar_sistema();
+        return 0;
+    }
+    buffer[strcspn(buffer, "\n")] = 0;
+    
+    int cantidad = leer_placas_lote(buffer, placas, MAX_VEHICULOS_PROPIETARIO);
+    if (cantidad < 0) {
+        printf("El lote tiene mas de %d vehiculos y no se puede pagar completo.\n", MAX_VEHICULOS_PROPIETARIO);
+        printf("Ingrese las placas en varios lotes de hasta %d placas.\n", MAX_VEHICULOS_PROPIETARIO);
+        pausar_sistema();
+        return 0;
+    }
+    if (cantidad == 0) {
+        printf("No se encontraron vehiculos para el lote.\n");
+        pausar_sistema();
+        return 0;
+    }
+    
+    // Comprobantes pendientes de todas las placas en una sola pasada
+    int periodo_desde = periodo_desde_hoy(DIAS_VALIDEZ_COMPROBANTE);
+    buscar_comprobantes_de_placas(placas, cantidad, 1, periodo_desde, comprobantes, encontrados);
+    
+    int cantidad_pagos = 0;
+    Dinero total_lote = 0;
+    char cedula_pagador[15] = "", nombre_pagador[100] = "";
+    int mismo_propietario = 1;
+    
+    printf("\n%-10s %-32s %-12s %10s\n", "PLACA", "COMPROBANTE", "VENCE", "MONTO");
+    printf("-----------------------------------------------------------------------\n");
+    for (int i = 0; i < cantidad; i++) {
+        if (!encontrados[i]) {
+            printf("%-10s Sin comprobante pendiente\n", placas[i]);
+            continue;
+        }
+        if (!comprobante_vigente(comprobantes[i].fecha_vencimiento)) {
+            printf("%-10s %-32s vencido el %s (no se incluye)\n", placas[i],
+                   comprobantes[i].numero_comprobante, comprobantes[i].fecha_vencimiento);
+            continue;
+        }
+        
+        printf("%-10s %-32s %-12s %10.2f\n", placas[i], comprobantes[i].numero_comprobante,
+               comprobantes[i].fecha_vencimiento, dinero_a_decimal(comprobantes[i].monto_total));
+        
+        RegistroPago* pago = &pagos[cantidad_pagos];
+        strcpy(pago->numero_comprobante, comprobantes[i].numero_comprobante);
+        strcpy(pago->placa, comprobantes[i].placa);
+        pago->monto_pagado = comprobantes[i].monto_total;
+        cantidad_pagos++;
+        total_lote += comprobantes[i].monto_total;
+        
+        // El propietario paga el lote si todos los vehiculos son suyos
+        char cedula[15], nombre[100];
+        if (!obtener_datos_propietario(placas[i], cedula, nombre)) {
+            mismo_propietario = 0;
+        } else if (cedula_pagador[0] == '\0') {
+            strcpy(cedula_pagador, cedula);
+            strcpy(nombre_pagador, nombre);
+        } else if (strcmp(cedula_pagador, cedula) != 0) {
+            mismo_propietario = 0;
+        }
+    }
+    printf("-----------------------------------------------------------------------\n");
+    
+    if (cantidad_pagos == 0) {
+        printf("Ningun vehiculo del lote tiene un comprobante pendiente vigente.\n");
+        printf("Debe calcular la matricula de cada vehiculo primero.\n");
+        pausar_sistema();
+        return 0;
+    }
+    printf("Comprobantes a pagar: %d    TOTAL: $%.2f\n\n", cantidad_pagos, dinero_a_decimal(total_lote));
+    
+    if (mismo_propietario) {
+        printf("Pagador: %s (%s)\n", nombre_pagador, cedula_pagador);
+    } else {
+        printf("Los vehiculos son de varios propietarios. Ingrese los datos del pagador:\n");
+        printf("Cedula/RUC: ");
+        if (!fgets(buffer, sizeof(buffer), stdin)) {
+            printf("Error al leer la cedula.\n");
+            pausar_sistema();
+            return 0;
+        }
+        buffer[strcspn(buffer, "\n")] = 0;
+        if (strlen(buffer) >= sizeof(cedula_pagador)) {
+            printf("Error: La cedula/RUC no puede tener mas de %d caracteres.\n", (int)sizeof(cedula_pagador) - 1);
+            pausar_sistema();
+            return 0;
+        }
+        strcpy(cedula_pagador, buffer);
+        
+        printf("Nombre completo: ");
+        if (!fgets(buffer, sizeof(buffer), stdin)) {
+            printf("Error al leer el nombre.\n");
+            pausar_sistema();
+            return 0;
+        }
+        buffer[strcspn(buffer, "\n")] = 0;
+        if (strlen(buffer) >= sizeof(nombre_pagador)) {
+            printf("Error: El nombre no puede tener mas de %d caracteres.\n", (int)sizeof(nombre_pagador) - 1);
+            pausar_sistema();
+            return 0;
+        }
+        strcpy(nombre_pagador, buffer);
+    }
+    
+    printf("Confirmar pago de %d comprobantes por $%.2f? (S/N): ", cantidad_pagos, dinero_a_decimal(total_lote));
+    if (!fgets(buffer, sizeof(buffer), stdin)) {
+        printf("Error al leer la confirmacion.\n");
+        pausar_sistema();
+        return 0;
+    }
+    if (buffer[0] != 'S' && buffer[0] != 's') {
+        printf("Pago cancelado.\n");
+        pausar_sistema();
+        return 0;
+    }
+    
+    // Numero del lote: identifica la transaccion en el registro de pagos
+    char numero_lote[MAX_COMPROBANTE];
+    char fecha_pago[20];
+    time_t t = time(NULL);
+    struct tm* fecha = localtime(&t);
+    snprintf(numero_lote, sizeof(numero_lote), "LOT-%s-%04d%02d%02d-%02d%02d%02d", cedula_pagador,
+             fecha->tm_year + 1900, fecha->tm_mon + 1, fecha->tm_mday,
+             fecha->tm_hour, fecha->tm_min, fecha->tm_sec);
+    obtener_fecha_actual(fecha_pago);
+    
+    for (int i = 0; i < cantidad_pagos; i++) {
+        strcpy(pagos[i].fecha_pago, fecha_pago);
+        pagos[i].tipo_pago = TIPO_EFECTIVO;
+        strcpy(pagos[i].referencia_pago, numero_lote);
+        strcpy(pagos[i].cedula_pagador, cedula_pagador);
+        strcpy(pagos[i].nombre_pagador, nombre_pagador);
+    }
+    
+    // El registro de eventos es el punto de confirmacion de la transaccion; al
+    // confirmarse tambien se marcan los comprobantes y matriculas_pagadas.txt
+    if (!guardar_registros_pago_lote(pagos, cantidad_pagos)) {
+        printf("Error: No se pudo guardar el registro de pagos. No se pago ningun comprobante.\n");
+        pausar_sistema();
+        return 0;
+    }
+    
+    // Recibo unico del lote
+    BufferTexto recibo;
+    buffer_iniciar(&recibo);
+    agregar_linea_recibo(&recibo, "=======================================================\n");
+    agregar_linea_recibo(&recibo, "           RECIBO DE PAGO DE MATRICULAS EN LOTE\n");
+    agregar_linea_recibo(&recibo, "           AGENCIA NACIONAL DE TRANSITO\n");
+    agregar_linea_recibo(&recibo, "=======================================================\n");
+    agregar_linea_recibo(&recibo, "Numero de lote: %s\n", numero_lote);
+    agregar_linea_recibo(&recibo, "Fecha de pago: %s\n", fecha_pago);
+    agregar_linea_recibo(&recibo, "Pagador: %s (%s)\n", nombre_pagador, cedula_pagador);
+    agregar_linea_recibo(&recibo, "Forma de pago: EFECTIVO\n");
+    agregar_linea_recibo(&recibo, "-------------------------------------------------------\n");
+    agregar_linea_recibo(&recibo, "%-10s %-32s %10s\n", "PLACA", "COMPROBANTE", "MONTO");
+    for (int i = 0; i < cantidad_pagos; i++) {
+        agregar_linea_recibo(&recibo, "%-10s %-32s %10.2f\n",
+                             pagos[i].placa, pagos[i].numero_comprobante, dinero_a_decimal(pagos[i].monto_pagado));
+    }
+    agregar_linea_recibo(&recibo, "-------------------------------------------------------\n");
+    agregar_linea_recibo(&recibo, "Comprobantes pagados: %d\n", cantidad_pagos);
+    agregar_linea_recibo(&recibo, "TOTAL PAGADO:               $%12.2f\n", dinero_a_decimal(total_lote));
+    agregar_linea_recibo(&recibo, "=======================================================\n");
+    
+    printf("\n");
+    fwrite(recibo.datos, 1, recibo.longitud, stdout);
+    if (!almacen_agregar_documento(numero_lote, DOCUMENTO_RECIBO_LOTE, &recibo)) {
+        printf("Error: No se pudo guardar el recibo en '%s'.\n", ARCHIVO_ALMACEN_DOCUMENTOS);
+    } else {
+        printf("Recibo guardado en el archivo de documentos con el numero %s\n", numero_lote);
+    }
+    buffer_liberar(&recibo);
+    
     pausar_sistema();
     return 1;
 }
\ No newline at end of file
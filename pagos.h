@@ -61,7 +61,7 @@ typedef struct {
     char placa[10];                   // Placa del vehiculo
     char fecha_emision[20];           // Fecha de emision del comprobante
     char fecha_vencimiento[20];       // Fecha de vencimiento para pago
-    double monto_total;               // Monto total a pagar
+    Dinero monto_total;               // Monto total a pagar (centavos)
     int estado;                       // Estado del comprobante (0=pendiente, 1=pagado, 2=vencido)
     DatosVehiculo vehiculo;           // Datos del vehiculo
     ResultadoMatricula resultado;     // Resultado del calculo de matricula
@@ -75,7 +75,7 @@ typedef struct {
     char numero_comprobante[50];      // Numero del comprobante pagado
     char placa[10];                   // Placa del vehiculo
     char fecha_pago[20];              // Fecha y hora del pago
-    double monto_pagado;              // Monto pagado
+    Dinero monto_pagado;              // Monto pagado (centavos)
     int tipo_pago;                    // Tipo de pago (1=efectivo, 2=tarjeta, 3=transferencia)
     char referencia_pago[50];         // Referencia del pago (numero de tarjeta, transaccion, etc.)
     char cedula_pagador[15];          // Cedula de quien realiza el pago
@@ -89,26 +89,35 @@ typedef struct {
 // Funciones principales del modulo de pagos
 void menu_pagos();
 int procesar_pago_por_placa();
+int procesar_pago_lote();
 
 // Funciones de validacion
 int comprobante_vigente(const char* fecha_vencimiento);
 
 // Funciones de archivos
-int guardar_comprobante_sistema(const char* placa, ResultadoMatricula resultado, DatosVehiculo vehiculo, const char* numero_comprobante);
+int guardar_comprobante_sistema(const char* placa, ResultadoMatricula resultado, const DatosVehiculo* vehiculo, const char* numero_comprobante);
 int guardar_registro_pago(RegistroPago pago);
+int guardar_registros_pago_lote(const RegistroPago* pagos, int cantidad);
 int actualizar_estado_comprobante(const char* numero_comprobante, int nuevo_estado);
+int actualizar_estado_comprobantes(char (*numeros)[MAX_COMPROBANTE], int cantidad, int nuevo_estado);
 int obtener_datos_propietario(const char* placa, char* cedula, char* nombre);
+int formatear_linea_comprobante(char* destino, size_t tamano, const char* placa, const char* numero_comprobante,
+                                const char* propietario, const DatosVehiculo* vehiculo, const char* fecha_emision,
+                                const char* fecha_vencimiento, Dinero total);
 
 // Funciones de generacion de comprobantes de pago
 // (Funciones removidas para simplificar el sistema)
 
 // Funciones de consulta
 int consultar_estado_por_placa();
+int consultar_vehiculos_por_cedula();
+void listar_pagos_ordenados();
 
 // Funciones auxiliares
 void obtener_fecha_actual(char* fecha);
 void calcular_fecha_vencimiento(char* fecha_vencimiento, int dias);
 void generar_numero_comprobante(char* numero, const char* placa);
+void formatear_numero_comprobante(char* numero, const char* placa, const struct tm* fecha, unsigned int secuencia);
 void crear_carpetas_sistema();
 
 // Funciones de interfaz
@@ -0,0 +1,394 @@
+/*
+ * particiones.c - Implementacion de las particiones mensuales
+ *
+ * Descripcion: Este archivo implementa el enrutamiento de comprobantes y
+ *              pagos a archivos mensuales, incluyendo:
+ *              - Manifiesto de meses existentes por tabla
+ *              - Listado de particiones que cubren un rango de fechas
+ *              - Migracion unica de los archivos anteriores a particiones
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "particiones.h"
+#include "pagos.h"       // Para ARCHIVO_PAGOS y ARCHIVO_COMPROBANTES
+#include "resumenes.h"   // Para resumen_ruta
+#include <time.h>
+#include <sys/stat.h>    // Para el tamano de las particiones
+#include <unistd.h>      // Para ftruncate
+
+/*
+ * Estructura: ManifiestoParticiones
+ * Descripcion: Meses con particion de una tabla, ordenados de menor a mayor
+ */
+typedef struct {
+	int cargado;
+	int cantidad;
+	int periodos[MAX_PARTICIONES];
+} ManifiestoParticiones;
+
+// Un manifiesto por tabla (indice PARTICION_PAGOS / PARTICION_COMPROBANTES)
+static ManifiestoParticiones manifiestos[3];
+
+// ===================================================================
+// FUNCIONES DE PERIODOS
+// ===================================================================
+
+/*
+ * Funcion: periodo_de_fecha
+ * Descripcion: Obtiene el periodo AAAAMM de una fecha DD/MM/AAAA (con o sin hora)
+ * Parametros: fecha - Texto de la fecha
+ * Retorno: Periodo AAAAMM, 0 si la fecha no es valida
+ */
+int periodo_de_fecha(const char* fecha) {
+	int dia, mes, ano;
+	if (sscanf(fecha, "%d/%d/%d", &dia, &mes, &ano) != 3) return 0;
+	if (mes < 1 || mes > 12 || ano < 1900) return 0;
+	return ano * 100 + mes;
+}
+
+/*
+ * Funcion: periodo_de_numero_comprobante
+ * Descripcion: Obtiene el periodo de un numero MAT-PLACA-AAAAMMDD-NNN.
+ *              El comprobante se guarda en la particion de este periodo,
+ *              asi que basta el numero para saber en que archivo esta
+ * Parametros: numero - Numero de comprobante
+ * Retorno: Periodo AAAAMM, 0 si el numero no tiene fecha
+ */
+int periodo_de_numero_comprobante(const char* numero) {
+	const char* ultimo = strrchr(numero, '-');
+	if (ultimo == NULL || ultimo - numero < 9) return 0;
+
+	const char* fecha = ultimo - 8;
+	if (fecha[-1] != '-') return 0;
+	for (int i = 0; i < 8; i++) {
+		if (fecha[i] < '0' || fecha[i] > '9') return 0;
+	}
+
+	int ano = (fecha[0] - '0') * 1000 + (fecha[1] - '0') * 100 + (fecha[2] - '0') * 10 + (fecha[3] - '0');
+	int mes = (fecha[4] - '0') * 10 + (fecha[5] - '0');
+	if (mes < 1 || mes > 12) return 0;
+	return ano * 100 + mes;
+}
+
+/*
+ * Funcion: periodo_desde_hoy
+ * Descripcion: Periodo de la fecha actual menos una cantidad de dias
+ * Parametros: dias - Dias hacia atras (0 = periodo actual)
+ * Retorno: Periodo AAAAMM
+ */
+int periodo_desde_hoy(int dias) {
+	time_t t = time(NULL) - (time_t)dias * 24 * 60 * 60;
+	struct tm* fecha = localtime(&t);
+	return (fecha->tm_year + 1900) * 100 + fecha->tm_mon + 1;
+}
+
+// ===================================================================
+// FUNCIONES DEL MANIFIESTO
+// ===================================================================
+
+/*
+ * Funcion: ruta_manifiesto
+ * Descripcion: Devuelve la ruta del manifiesto de una tabla
+ */
+static const char* ruta_manifiesto(int tabla) {
+	return tabla == PARTICION_PAGOS ? MANIFIESTO_PAGOS : MANIFIESTO_COMPROBANTES;
+}
+
+/*
+ * Funcion: insertar_periodo
+ * Descripcion: Inserta un periodo en el manifiesto en memoria manteniendo el orden
+ * Parametros: manifiesto, periodo
+ * Retorno: 1 si se agrego, 0 si ya existia o no hay espacio
+ */
+static int insertar_periodo(ManifiestoParticiones* manifiesto, int periodo) {
+	int i = manifiesto->cantidad;
+	while (i > 0 && manifiesto->periodos[i - 1] > periodo) i--;
+	if (i > 0 && manifiesto->periodos[i - 1] == periodo) return 0;
+	if (manifiesto->cantidad >= MAX_PARTICIONES) return 0;
+
+	memmove(&manifiesto->periodos[i + 1], &manifiesto->periodos[i],
+			(size_t)(manifiesto->cantidad - i) * sizeof(int));
+	manifiesto->periodos[i] = periodo;
+	manifiesto->cantidad++;
+	return 1;
+}
+
+/*
+ * Funcion: cargar_manifiesto
+ * Descripcion: Lee el manifiesto de una tabla la primera vez que se usa.
+ *              Si todavia existe el archivo anterior a las particiones,
+ *              sus lineas se reparten en los archivos mensuales
+ * Parametros: tabla
+ * Retorno: Manifiesto cargado
+ */
+static ManifiestoParticiones* cargar_manifiesto(int tabla) {
+	ManifiestoParticiones* manifiesto = &manifiestos[tabla == PARTICION_PAGOS ? PARTICION_PAGOS : PARTICION_COMPROBANTES];
+	if (manifiesto->cargado) return manifiesto;
+	manifiesto->cargado = 1;
+
+	FILE* archivo = fopen(ruta_manifiesto(tabla), "r");
+	if (archivo) {
+		char linea[32];
+		int periodo;
+		while (fgets(linea, sizeof(linea), archivo)) {
+			if (sscanf(linea, "%d", &periodo) == 1 && periodo > 0) {
+				insertar_periodo(manifiesto, periodo);
+			}
+		}
+		fclose(archivo);
+	}
+
+	particion_migrar_legado(tabla);
+	return manifiesto;
+}
+
+/*
+ * Funcion: guardar_manifiesto
+ * Descripcion: Reescribe el manifiesto completo (solo al eliminar particiones)
+ * Parametros: tabla, manifiesto
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int guardar_manifiesto(int tabla, const ManifiestoParticiones* manifiesto) {
+	FILE* archivo = fopen(ruta_manifiesto(tabla), "w");
+	if (!archivo) return 0;
+	for (int i = 0; i < manifiesto->cantidad; i++) {
+		fprintf(archivo, "%d\n", manifiesto->periodos[i]);
+	}
+	return fclose(archivo) == 0;
+}
+
+// ===================================================================
+// FUNCIONES DE PARTICIONES
+// ===================================================================
+
+/*
+ * Funcion: particion_ruta
+ * Descripcion: Arma la ruta del archivo de una particion
+ * Parametros: ruta (MAX_RUTA_PARTICION bytes), tabla, periodo (PERIODO_LEGADO = archivo anterior)
+ * Retorno: void
+ */
+void particion_ruta(char* ruta, int tabla, int periodo) {
+	if (periodo == PERIODO_LEGADO) {
+		strcpy(ruta, tabla == PARTICION_PAGOS ? ARCHIVO_PAGOS : ARCHIVO_COMPROBANTES);
+	} else if (tabla == PARTICION_PAGOS) {
+		snprintf(ruta, MAX_RUTA_PARTICION, "%s/pagos_%06d.txt", CARPETA_PAGOS, periodo);
+	} else {
+		snprintf(ruta, MAX_RUTA_PARTICION, "%s/comprobantes_%06d.txt", CARPETA_COMPROBANTES, periodo);
+	}
+}
+
+/*
+ * Funcion: particion_abrir_anexar
+ * Descripcion: Abre la particion de un periodo para agregar registros.
+ *              Si es un mes nuevo, se registra primero en el manifiesto
+ * Parametros: tabla, periodo
+ * Retorno: Archivo abierto en modo "a", NULL si hubo error
+ */
+FILE* particion_abrir_anexar(int tabla, int periodo) {
+	ManifiestoParticiones* manifiesto = cargar_manifiesto(tabla);
+	char ruta[MAX_RUTA_PARTICION];
+
+	if (periodo != PERIODO_LEGADO && insertar_periodo(manifiesto, periodo)) {
+		FILE* archivo = fopen(ruta_manifiesto(tabla), "a");
+		if (!archivo) return NULL;
+		fprintf(archivo, "%d\n", periodo);
+		fclose(archivo);
+	}
+
+	particion_ruta(ruta, tabla, periodo);
+	return fopen(ruta, "a");
+}
+
+/*
+ * Funcion: particion_listar
+ * Descripcion: Lista las particiones que pueden contener registros del
+ *              rango de periodos, de la mas antigua a la mas reciente.
+ *              El archivo anterior a las particiones, si existe, va primero
+ * Parametros:
+ *   - tabla: PARTICION_PAGOS o PARTICION_COMPROBANTES
+ *   - periodo_desde, periodo_hasta: Rango AAAAMM (0 = sin limite)
+ *   - periodos, max: Arreglo de salida
+ * Retorno: Cantidad de particiones listadas
+ */
+int particion_listar(int tabla, int periodo_desde, int periodo_hasta, int* periodos, int max) {
+	ManifiestoParticiones* manifiesto = cargar_manifiesto(tabla);
+	char ruta[MAX_RUTA_PARTICION];
+	int cantidad = 0;
+
+	particion_ruta(ruta, tabla, PERIODO_LEGADO);
+	FILE* legado = fopen(ruta, "r");
+	if (legado) {
+		fclose(legado);
+		if (cantidad < max) periodos[cantidad++] = PERIODO_LEGADO;
+	}
+
+	for (int i = 0; i < manifiesto->cantidad && cantidad < max; i++) {
+		int periodo = manifiesto->periodos[i];
+		if (periodo_desde && periodo < periodo_desde) continue;
+		if (periodo_hasta && periodo > periodo_hasta) break;
+		periodos[cantidad++] = periodo;
+	}
+	return cantidad;
+}
+
+/*
+ * Funcion: particion_eliminar
+ * Descripcion: Borra el archivo de una particion (y su resumen, si tiene)
+ *              y la quita del manifiesto
+ * Parametros: tabla, periodo
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int particion_eliminar(int tabla, int periodo) {
+	ManifiestoParticiones* manifiesto = cargar_manifiesto(tabla);
+	char ruta[MAX_RUTA_PARTICION];
+
+	particion_ruta(ruta, tabla, periodo);
+	remove(ruta);
+	if (tabla == PARTICION_PAGOS) {
+		resumen_ruta(ruta, RESUMEN_PAGOS, periodo);
+		remove(ruta);
+	}
+	if (periodo == PERIODO_LEGADO) return 1;
+
+	for (int i = 0; i < manifiesto->cantidad; i++) {
+		if (manifiesto->periodos[i] == periodo) {
+			memmove(&manifiesto->periodos[i], &manifiesto->periodos[i + 1],
+					(size_t)(manifiesto->cantidad - i - 1) * sizeof(int));
+			manifiesto->cantidad--;
+			return guardar_manifiesto(tabla, manifiesto);
+		}
+	}
+	return 1;
+}
+
+/*
+ * Funcion: recortar_particiones
+ * Descripcion: Devuelve las particiones tocadas por una migracion fallida
+ *              al tamano que tenian antes, para que un nuevo intento no
+ *              copie dos veces las mismas lineas
+ * Parametros: tabla, periodos, tamanos, cantidad
+ * Retorno: void
+ */
+static void recortar_particiones(int tabla, const int* periodos, const long* tamanos, int cantidad) {
+	for (int i = 0; i < cantidad; i++) {
+		char ruta[MAX_RUTA_PARTICION];
+		particion_ruta(ruta, tabla, periodos[i]);
+		FILE* archivo = fopen(ruta, "r+");
+		if (!archivo) continue;
+		ftruncate(fileno(archivo), tamanos[i]);
+		fclose(archivo);
+	}
+}
+
+/*
+ * Funcion: particion_migrar_legado
+ * Descripcion: Reparte las lineas del archivo anterior a las particiones
+ *              (pagos.txt o comprobantes.txt) en los archivos mensuales.
+ *              Las lineas sin fecha legible se quedan en el archivo anterior.
+ *              Si algo falla, las particiones vuelven a su tamano inicial
+ *              y el archivo anterior queda intacto
+ * Parametros: tabla
+ * Retorno: Cantidad de lineas migradas, -1 si hubo error
+ */
+int particion_migrar_legado(int tabla) {
+	char ruta[MAX_RUTA_PARTICION];
+	char ruta_temporal[MAX_RUTA_PARTICION + 4];
+	int campo_fecha = (tabla == PARTICION_PAGOS) ? 2 : 5;
+
+	particion_ruta(ruta, tabla, PERIODO_LEGADO);
+	FILE* archivo = fopen(ruta, "r");
+	if (!archivo) return 0;
+
+	snprintf(ruta_temporal, sizeof(ruta_temporal), "%s.tmp", ruta);
+	FILE* restantes = fopen(ruta_temporal, "w");
+	if (!restantes) {
+		fclose(archivo);
+		return -1;
+	}
+
+	FILE* destino = NULL;
+	int periodo_destino = 0, migradas = 0, sin_fecha = 0, error = 0;
+	static int tocados[MAX_PARTICIONES];
+	static long tamanos[MAX_PARTICIONES];
+	int cantidad_tocados = 0;
+	char linea[500];
+
+	while (fgets(linea, sizeof(linea), archivo)) {
+		// Ubicar el campo de fecha (pagos: campo 2, comprobantes: campo 5)
+		const char* campo = linea;
+		for (int i = 0; i < campo_fecha && campo; i++) {
+			campo = strchr(campo, '|');
+			if (campo) campo++;
+		}
+		int periodo = campo ? periodo_de_fecha(campo) : 0;
+
+		if (periodo == 0) {
+			if (fputs(linea, restantes) == EOF) {
+				error = 1;
+				break;
+			}
+			sin_fecha++;
+			continue;
+		}
+
+		// Las lineas suelen venir en orden de fecha: reusar el archivo abierto
+		if (periodo != periodo_destino) {
+			if (destino && fclose(destino) != 0) error = 1;
+			destino = NULL;
+			if (error) break;
+
+			// Guardar el tamano de la particion la primera vez que se toca
+			int tocado = 0;
+			for (int i = 0; i < cantidad_tocados && !tocado; i++) {
+				tocado = (tocados[i] == periodo);
+			}
+			if (!tocado) {
+				char ruta_destino[MAX_RUTA_PARTICION];
+				struct stat st;
+				if (cantidad_tocados >= MAX_PARTICIONES) {
+					error = 1;
+					break;
+				}
+				particion_ruta(ruta_destino, tabla, periodo);
+				tocados[cantidad_tocados] = periodo;
+				tamanos[cantidad_tocados++] = stat(ruta_destino, &st) == 0 ? (long)st.st_size : 0;
+			}
+			destino = particion_abrir_anexar(tabla, periodo);
+			periodo_destino = periodo;
+			if (!destino) {
+				error = 1;
+				break;
+			}
+		}
+		if (fputs(linea, destino) == EOF) {
+			error = 1;
+			break;
+		}
+		migradas++;
+	}
+
+	if (destino && fclose(destino) != 0) error = 1;
+	if (ferror(archivo)) error = 1;
+	fclose(archivo);
+	if (fclose(restantes) != 0) error = 1;
+
+	if (error) {
+		// Se conserva el archivo anterior y se quitan las lineas ya copiadas
+		recortar_particiones(tabla, tocados, tamanos, cantidad_tocados);
+		remove(ruta_temporal);
+		printf("ERROR: No se pudo migrar '%s' a particiones mensuales.\n", ruta);
+		return -1;
+	}
+
+	remove(ruta);
+	if (sin_fecha > 0) {
+		rename(ruta_temporal, ruta);
+	} else {
+		remove(ruta_temporal);
+	}
+	return migradas;
+}
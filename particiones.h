@@ -0,0 +1,58 @@
+/*
+ * particiones.h - Libreria de particiones mensuales de comprobantes y pagos
+ *
+ * Descripcion: Este archivo contiene las constantes y prototipos para
+ *              repartir comprobantes y pagos en archivos mensuales
+ *              (comprobantes_AAAAMM.txt, pagos_AAAAMM.txt). Un manifiesto
+ *              por tabla lista los meses que existen, de modo que una
+ *              consulta por rango de fechas solo abre las particiones que
+ *              pueden contener registros del rango.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef PARTICIONES_H
+#define PARTICIONES_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// ===================================================================
+// CONSTANTES DE PARTICIONES
+// ===================================================================
+
+// Tablas particionadas
+#define PARTICION_PAGOS 1                // pagos/pagos_AAAAMM.txt
+#define PARTICION_COMPROBANTES 2         // comprobantes/comprobantes_AAAAMM.txt
+
+#define MANIFIESTO_PAGOS "pagos/particiones.txt"
+#define MANIFIESTO_COMPROBANTES "comprobantes/particiones.txt"
+
+// Periodo del archivo anterior a las particiones (pagos.txt, comprobantes.txt).
+// Solo contiene las lineas cuya fecha no se pudo leer al migrar.
+#define PERIODO_LEGADO 0
+
+#define MAX_PARTICIONES 600              // 50 anos de particiones mensuales
+#define MAX_RUTA_PARTICION 64
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de periodos (AAAAMM)
+int periodo_de_fecha(const char* fecha);
+int periodo_de_numero_comprobante(const char* numero);
+int periodo_desde_hoy(int dias);
+
+// Funciones de particiones
+void particion_ruta(char* ruta, int tabla, int periodo);
+FILE* particion_abrir_anexar(int tabla, int periodo);
+int particion_listar(int tabla, int periodo_desde, int periodo_hasta, int* periodos, int max);
+int particion_eliminar(int tabla, int periodo);
+int particion_migrar_legado(int tabla);
+
+#endif // PARTICIONES_H
@@ -0,0 +1,333 @@
+/*
+ * plantillas.c - Implementacion del motor de plantillas de documentos
+ *
+ * Descripcion: Este archivo implementa la compilacion y el renderizado
+ *              de plantillas para comprobantes y certificados:
+ *              - Compilacion de la plantilla en segmentos fijos y espacios
+ *              - Formateo rapido de enteros y montos sin usar stdio
+ *              - Escritura del documento completo con un solo write
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "plantillas.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>       // Para _open, _write y _close en Windows
+#else
+#include <unistd.h>   // Para write y close en Linux/macOS
+#endif
+
+// ===================================================================
+// FUNCIONES DEL BUFFER DE SALIDA
+// ===================================================================
+
+/*
+ * Funcion: buffer_iniciar
+ * Descripcion: Deja el buffer vacio y sin memoria reservada
+ * Parametros: buffer - Buffer a iniciar
+ * Retorno: void
+ */
+void buffer_iniciar(BufferTexto* buffer) {
+	buffer->datos = NULL;
+	buffer->longitud = 0;
+	buffer->capacidad = 0;
+}
+
+/*
+ * Funcion: buffer_reservar
+ * Descripcion: Garantiza espacio para 'adicional' bytes mas. La capacidad
+ *              se duplica para que agregar muchos documentos sea barato
+ * Parametros:
+ *   - buffer: Buffer de salida
+ *   - adicional: Bytes que se van a agregar
+ * Retorno: 1 si hay espacio, 0 si no se pudo reservar memoria
+ */
+int buffer_reservar(BufferTexto* buffer, size_t adicional) {
+	if (buffer->longitud + adicional <= buffer->capacidad) return 1;
+
+	size_t nueva_capacidad = buffer->capacidad ? buffer->capacidad : TAMANO_INICIAL_BUFFER;
+	while (nueva_capacidad < buffer->longitud + adicional) {
+		nueva_capacidad *= 2;
+	}
+
+	char* nuevos_datos = realloc(buffer->datos, nueva_capacidad);
+	if (nuevos_datos == NULL) return 0;
+
+	buffer->datos = nuevos_datos;
+	buffer->capacidad = nueva_capacidad;
+	return 1;
+}
+
+/*
+ * Funcion: buffer_agregar
+ * Descripcion: Copia bytes al final del buffer
+ * Parametros: buffer, datos, longitud
+ * Retorno: 1 si fue exitoso, 0 si no hubo memoria
+ */
+int buffer_agregar(BufferTexto* buffer, const char* datos, size_t longitud) {
+	if (!buffer_reservar(buffer, longitud)) return 0;
+	memcpy(buffer->datos + buffer->longitud, datos, longitud);
+	buffer->longitud += longitud;
+	return 1;
+}
+
+/*
+ * Funcion: buffer_agregar_entero
+ * Descripcion: Agrega un entero en decimal, rellenando con ceros a la
+ *              izquierda hasta ancho_minimo (equivale a "%0Nd")
+ * Parametros: buffer, valor, ancho_minimo
+ * Retorno: 1 si fue exitoso, 0 si no hubo memoria
+ */
+int buffer_agregar_entero(BufferTexto* buffer, long long valor, int ancho_minimo) {
+	char digitos[24];
+	int n = 0;
+	int negativo = valor < 0;
+	unsigned long long resto = negativo ? 0ULL - (unsigned long long)valor : (unsigned long long)valor;
+
+	// Generar digitos en orden inverso
+	do {
+		digitos[n++] = (char)('0' + resto % 10);
+		resto /= 10;
+	} while (resto > 0);
+	while (n < ancho_minimo && n < (int)sizeof(digitos) - 1) digitos[n++] = '0';
+	if (negativo) digitos[n++] = '-';
+
+	if (!buffer_reservar(buffer, (size_t)n)) return 0;
+	char* destino = buffer->datos + buffer->longitud;
+	for (int i = 0; i < n; i++) {
+		destino[i] = digitos[n - 1 - i];
+	}
+	buffer->longitud += (size_t)n;
+	return 1;
+}
+
+/*
+ * Funcion: buffer_agregar_dinero
+ * Descripcion: Agrega un monto con dos decimales (equivale a "%.2f")
+ * Parametros: buffer, centavos - Monto en centavos
+ * Retorno: 1 si fue exitoso, 0 si no hubo memoria
+ */
+int buffer_agregar_dinero(BufferTexto* buffer, Dinero centavos) {
+	if (centavos < 0) {
+		if (!buffer_agregar(buffer, "-", 1)) return 0;
+		centavos = -centavos;
+	}
+	if (!buffer_agregar_entero(buffer, (long long)(centavos / 100), 1)) return 0;
+	if (!buffer_agregar(buffer, ".", 1)) return 0;
+	return buffer_agregar_entero(buffer, (long long)(centavos % 100), 2);
+}
+
+/*
+ * Funcion: buffer_vaciar
+ * Descripcion: Descarta el contenido pero conserva la memoria reservada
+ * Parametros: buffer
+ * Retorno: void
+ */
+void buffer_vaciar(BufferTexto* buffer) {
+	buffer->longitud = 0;
+}
+
+/*
+ * Funcion: buffer_liberar
+ * Descripcion: Libera la memoria del buffer
+ * Parametros: buffer
+ * Retorno: void
+ */
+void buffer_liberar(BufferTexto* buffer) {
+	free(buffer->datos);
+	buffer_iniciar(buffer);
+}
+
+// ===================================================================
+// FUNCIONES DE COMPILACION Y RENDERIZADO
+// ===================================================================
+
+/*
+ * Funcion: plantilla_compilar
+ * Descripcion: Divide la fuente en segmentos de texto fijo y espacios.
+ *              Los nombres de los espacios se resuelven aqui a indices
+ *              para que el renderizado no compare cadenas
+ * Parametros:
+ *   - plantilla: Plantilla a compilar
+ *   - fuente: Texto de la plantilla (debe vivir todo el programa)
+ *   - nombres: Nombres de los espacios; su posicion es el indice del valor
+ *   - num_nombres: Cantidad de nombres
+ * Retorno: 1 si fue exitoso, 0 si la plantilla es invalida
+ */
+int plantilla_compilar(Plantilla* plantilla, const char* fuente, const char* const* nombres, int num_nombres) {
+	const char* p = fuente;
+	const char* inicio_fijo = fuente;
+
+	plantilla->fuente = fuente;
+	plantilla->num_segmentos = 0;
+	plantilla->longitud_fija = 0;
+	plantilla->compilada = 0;
+
+	while (1) {
+		if (*p != '{' && *p != '\0') {
+			p++;
+			continue;
+		}
+
+		// Cerrar el tramo de texto fijo pendiente
+		if (p > inicio_fijo) {
+			if (plantilla->num_segmentos >= MAX_SEGMENTOS_PLANTILLA) return 0;
+			SegmentoPlantilla* seg = &plantilla->segmentos[plantilla->num_segmentos++];
+			seg->texto = inicio_fijo;
+			seg->longitud = (int)(p - inicio_fijo);
+			seg->espacio = -1;
+			seg->formato = FORMATO_TEXTO;
+			plantilla->longitud_fija += seg->longitud;
+		}
+		if (*p == '\0') break;
+
+		// Leer el espacio {nombre[:formato]}
+		const char* fin = strchr(p, '}');
+		if (fin == NULL) return 0;
+
+		char nombre[MAX_NOMBRE_ESPACIO];
+		int formato = FORMATO_TEXTO;
+		int largo = (int)(fin - p - 1);
+		const char* dos_puntos = memchr(p + 1, ':', (size_t)largo);
+		if (dos_puntos) {
+			const char* f = dos_puntos + 1;
+			if (strncmp(f, "d}", 2) == 0) formato = FORMATO_ENTERO;
+			else if (strncmp(f, "02}", 3) == 0) formato = FORMATO_ENTERO_2;
+			else if (strncmp(f, "04}", 3) == 0) formato = FORMATO_ENTERO_4;
+			else if (strncmp(f, "$}", 2) == 0) formato = FORMATO_DINERO;
+			else return 0;
+			largo = (int)(dos_puntos - p - 1);
+		}
+		if (largo <= 0 || largo >= MAX_NOMBRE_ESPACIO) return 0;
+		memcpy(nombre, p + 1, (size_t)largo);
+		nombre[largo] = '\0';
+
+		int indice = -1;
+		for (int i = 0; i < num_nombres; i++) {
+			if (strcmp(nombres[i], nombre) == 0) {
+				indice = i;
+				break;
+			}
+		}
+		if (indice < 0) return 0;
+
+		if (plantilla->num_segmentos >= MAX_SEGMENTOS_PLANTILLA) return 0;
+		SegmentoPlantilla* seg = &plantilla->segmentos[plantilla->num_segmentos++];
+		seg->texto = NULL;
+		seg->longitud = 0;
+		seg->espacio = indice;
+		seg->formato = formato;
+
+		p = fin + 1;
+		inicio_fijo = p;
+	}
+
+	plantilla->compilada = 1;
+	return 1;
+}
+
+/*
+ * Funcion: plantilla_renderizar
+ * Descripcion: Agrega al buffer el documento resultante de la plantilla
+ *              con los valores dados. Reserva la memoria de una sola vez
+ * Parametros:
+ *   - plantilla: Plantilla ya compilada
+ *   - valores: Valores indexados igual que los nombres de la compilacion
+ *   - salida: Buffer donde se agrega el documento
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int plantilla_renderizar(const Plantilla* plantilla, const ValorPlantilla* valores, BufferTexto* salida) {
+	if (!plantilla->compilada) return 0;
+
+	// Texto fijo mas un estimado generoso por cada espacio
+	if (!buffer_reservar(salida, (size_t)plantilla->longitud_fija + (size_t)plantilla->num_segmentos * 32)) {
+		return 0;
+	}
+
+	for (int i = 0; i < plantilla->num_segmentos; i++) {
+		const SegmentoPlantilla* seg = &plantilla->segmentos[i];
+		int ok = 1;
+
+		if (seg->espacio < 0) {
+			ok = buffer_agregar(salida, seg->texto, (size_t)seg->longitud);
+		} else {
+			const ValorPlantilla* valor = &valores[seg->espacio];
+			switch (seg->formato) {
+			case FORMATO_TEXTO:
+				if (valor->texto) ok = buffer_agregar(salida, valor->texto, strlen(valor->texto));
+				break;
+			case FORMATO_ENTERO:
+				ok = buffer_agregar_entero(salida, valor->entero, 1);
+				break;
+			case FORMATO_ENTERO_2:
+				ok = buffer_agregar_entero(salida, valor->entero, 2);
+				break;
+			case FORMATO_ENTERO_4:
+				ok = buffer_agregar_entero(salida, valor->entero, 4);
+				break;
+			case FORMATO_DINERO:
+				ok = buffer_agregar_dinero(salida, valor->dinero);
+				break;
+			}
+		}
+		if (!ok) return 0;
+	}
+	return 1;
+}
+
+// ===================================================================
+// ESCRITURA A ARCHIVO
+// ===================================================================
+
+/*
+ * Funcion: escribir_buffer_archivo
+ * Descripcion: Escribe todo el buffer en el archivo con una sola llamada
+ *              write (se repite solo si el sistema acepta una escritura
+ *              parcial). En Windows se abre en modo texto para conservar
+ *              los saltos de linea que producia fprintf
+ * Parametros:
+ *   - ruta: Ruta del archivo
+ *   - buffer: Contenido a escribir
+ *   - anexar: 1 para agregar al final, 0 para reemplazar el archivo
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int escribir_buffer_archivo(const char* ruta, const BufferTexto* buffer, int anexar) {
+#ifdef _WIN32
+	int banderas = _O_WRONLY | _O_CREAT | _O_TEXT | (anexar ? _O_APPEND : _O_TRUNC);
+	int fd = _open(ruta, banderas, _S_IREAD | _S_IWRITE);
+#else
+	int banderas = O_WRONLY | O_CREAT | (anexar ? O_APPEND : O_TRUNC);
+	int fd = open(ruta, banderas, 0644);
+#endif
+	if (fd < 0) return 0;
+
+	size_t escrito = 0;
+	while (escrito < buffer->longitud) {
+#ifdef _WIN32
+		int n = _write(fd, buffer->datos + escrito, (unsigned int)(buffer->longitud - escrito));
+#else
+		ssize_t n = write(fd, buffer->datos + escrito, buffer->longitud - escrito);
+#endif
+		if (n <= 0) {
+#ifdef _WIN32
+			_close(fd);
+#else
+			close(fd);
+#endif
+			return 0;
+		}
+		escrito += (size_t)n;
+	}
+
+#ifdef _WIN32
+	return _close(fd) == 0;
+#else
+	return close(fd) == 0;
+#endif
+}
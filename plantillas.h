@@ -0,0 +1,114 @@
+/*
+ * plantillas.h - Libreria de plantillas precompiladas para documentos
+ *
+ * Descripcion: Este archivo contiene las estructuras y prototipos del
+ *              motor de plantillas usado para generar comprobantes y
+ *              certificados. Una plantilla se compila una sola vez en
+ *              segmentos de texto fijo y espacios con formato; luego se
+ *              renderiza en un unico buffer contiguo que se escribe al
+ *              archivo con una sola llamada al sistema.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef PLANTILLAS_H
+#define PLANTILLAS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "dinero.h"
+
+// ===================================================================
+// CONSTANTES DEL MOTOR DE PLANTILLAS
+// ===================================================================
+
+#define MAX_SEGMENTOS_PLANTILLA 96     // Segmentos (texto fijo + espacios) por plantilla
+#define MAX_NOMBRE_ESPACIO 24          // Longitud maxima del nombre de un espacio
+#define TAMANO_INICIAL_BUFFER 2048     // Capacidad inicial del buffer de salida
+
+// Formatos disponibles para los espacios de una plantilla
+// Sintaxis en la plantilla: {nombre}, {nombre:d}, {nombre:02}, {nombre:04}, {nombre:$}
+#define FORMATO_TEXTO 0                // {nombre}    -> cadena de texto
+#define FORMATO_ENTERO 1               // {nombre:d}  -> entero sin relleno
+#define FORMATO_ENTERO_2 2             // {nombre:02} -> entero con 2 digitos
+#define FORMATO_ENTERO_4 3             // {nombre:04} -> entero con 4 digitos
+#define FORMATO_DINERO 4               // {nombre:$}  -> monto con 2 decimales
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: SegmentoPlantilla
+ * Descripcion: Un tramo de la plantilla compilada. Si espacio es -1 el
+ *              segmento es texto fijo (apunta dentro de la fuente);
+ *              en otro caso indica que valor insertar y con que formato
+ */
+typedef struct {
+	const char* texto;             // Inicio del texto fijo (solo si espacio == -1)
+	int longitud;                  // Longitud del texto fijo
+	int espacio;                   // Indice del valor a insertar o -1
+	int formato;                   // Formato del valor (FORMATO_*)
+} SegmentoPlantilla;
+
+/*
+ * Estructura: Plantilla
+ * Descripcion: Plantilla compilada lista para renderizar. Se declara
+ *              como variable estatica y se compila la primera vez que
+ *              se usa
+ */
+typedef struct {
+	const char* fuente;                                // Texto original de la plantilla
+	SegmentoPlantilla segmentos[MAX_SEGMENTOS_PLANTILLA];
+	int num_segmentos;                                 // Segmentos usados
+	int longitud_fija;                                 // Suma del texto fijo (para reservar memoria)
+	int compilada;                                     // 1 si ya fue compilada
+} Plantilla;
+
+/*
+ * Estructura: ValorPlantilla
+ * Descripcion: Valor que se inserta en un espacio de la plantilla.
+ *              Se usa el campo que corresponde al formato del espacio
+ */
+typedef struct {
+	const char* texto;             // Para {nombre}
+	long entero;                   // Para {nombre:d}, {nombre:02}, {nombre:04}
+	Dinero dinero;                 // Para {nombre:$} (centavos)
+} ValorPlantilla;
+
+/*
+ * Estructura: BufferTexto
+ * Descripcion: Buffer de memoria que crece segun sea necesario donde se
+ *              renderizan uno o varios documentos antes de escribirlos
+ */
+typedef struct {
+	char* datos;                   // Contenido (no termina en '\0')
+	size_t longitud;               // Bytes usados
+	size_t capacidad;              // Bytes reservados
+} BufferTexto;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de compilacion y renderizado
+int plantilla_compilar(Plantilla* plantilla, const char* fuente, const char* const* nombres, int num_nombres);
+int plantilla_renderizar(const Plantilla* plantilla, const ValorPlantilla* valores, BufferTexto* salida);
+
+// Funciones del buffer de salida
+void buffer_iniciar(BufferTexto* buffer);
+int buffer_reservar(BufferTexto* buffer, size_t adicional);
+int buffer_agregar(BufferTexto* buffer, const char* datos, size_t longitud);
+int buffer_agregar_dinero(BufferTexto* buffer, Dinero monto);
+int buffer_agregar_entero(BufferTexto* buffer, long long valor, int ancho_minimo);
+void buffer_vaciar(BufferTexto* buffer);
+void buffer_liberar(BufferTexto* buffer);
+
+// Escritura del buffer completo con una sola llamada al sistema
+int escribir_buffer_archivo(const char* ruta, const BufferTexto* buffer, int anexar);
+
+#endif // PLANTILLAS_H
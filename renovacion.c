@@ -0,0 +1,611 @@
+/*
+ * renovacion.c - Implementacion de la renovacion anual de toda la flota
+ *
+ * Descripcion: Este archivo implementa el proceso en lote de renovacion,
+ *              incluyendo:
+ *              - Lectura de vehiculos.txt por lotes, sin cargarlo completo
+ *              - Calculo en paralelo con robo de trabajo: cada hilo toma
+ *                vehiculos de su propio rango y, cuando se queda sin
+ *                trabajo, roba la mitad del rango de otro hilo
+ *              - Numeros de comprobante asignados por bloques, para que los
+ *                hilos no compitan por un contador en cada vehiculo
+ *              - Escritura con un buffer por hilo; la particion solo se
+ *                bloquea para copiar un buffer lleno
+ *              - Punto de control al cerrar cada lote para poder retomar,
+ *                que al terminar queda marcando el ano fiscal como renovado
+ *              - Registro de eventos de los comprobantes de cada lote
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "renovacion.h"
+#include "vehiculos.h"
+#include "pagos.h"
+#include "tarifas.h"
+#include "particiones.h"
+#include "hilos.h"
+#include "eventos.h"
+#include "flota_compacta.h"
+#include <stdatomic.h>
+#include <time.h>
+
+// ===================================================================
+// ESTRUCTURAS INTERNAS
+// ===================================================================
+
+/*
+ * Estructura: PuntoControlRenovacion
+ * Descripcion: Avance guardado al terminar cada lote
+ */
+typedef struct {
+	int ano_fiscal;              // Ano fiscal que se estaba renovando
+	int periodo;                 // Particion de comprobantes usada (AAAAMM)
+	long desplazamiento;         // Primer byte de vehiculos.txt sin procesar (RENOVACION_TERMINADA al final)
+	unsigned int secuencia;      // Siguiente secuencia de comprobante libre
+	long emitidos;               // Comprobantes emitidos hasta el lote
+	long tamano_particion;       // Bytes de la particion al cerrar el lote
+	long tamano_registro;        // Bytes de eventos.log al cerrar el lote (-1 = desconocido)
+} PuntoControlRenovacion;
+
+typedef struct ContextoRenovacion ContextoRenovacion;
+
+/*
+ * Estructura: TrabajadorRenovacion
+ * Descripcion: Estado de un hilo. El rango pendiente va empaquetado en un
+ *              solo entero atomico (inicio en la parte alta, fin en la
+ *              baja): el dueno avanza el inicio y los ladrones recortan el
+ *              fin, ambos con una comparacion e intercambio
+ */
+typedef struct {
+	_Atomic(unsigned long long) rango;    // (inicio << 32) | fin
+	ContextoRenovacion* contexto;
+	int id;
+	unsigned int numero_actual;           // Bloque de secuencias propio
+	unsigned int numero_fin;
+	long emitidos;
+	long robos;
+	size_t usado;                         // Bytes ocupados del buffer
+	char buffer[TAMANO_BUFFER_RENOVACION];
+} TrabajadorRenovacion;
+
+/*
+ * Estructura: ContextoRenovacion
+ * Descripcion: Datos compartidos por todos los hilos durante un lote
+ */
+struct ContextoRenovacion {
+	FlotaCompacta flota;                  // Vehiculos del lote (el manejador es su indice)
+	unsigned char* omitir;                // 1 = ya tiene comprobante de una ejecucion anterior
+	int cantidad;
+	TrabajadorRenovacion* trabajadores;
+	int hilos;
+	const TablaTarifas* tarifas;          // La misma tabla para toda la renovacion
+	FILE* salida;                         // Particion de comprobantes
+	Cerrojo cerrojo_salida;
+	atomic_uint secuencia;                // Siguiente bloque de numeros libre
+	atomic_int error;
+	struct tm fecha;                      // Fecha de los numeros de comprobante
+	char fecha_emision[20];
+	char fecha_vencimiento[20];
+};
+
+// ===================================================================
+// REPARTO DE TRABAJO ENTRE HILOS
+// ===================================================================
+
+static unsigned long long empaquetar_rango(unsigned int inicio, unsigned int fin) {
+	return ((unsigned long long)inicio << 32) | fin;
+}
+
+/*
+ * Funcion: tomar_propio
+ * Descripcion: Toma el siguiente vehiculo del rango del propio hilo
+ * Parametros: trabajador, indice (salida)
+ * Retorno: 1 si obtuvo un vehiculo, 0 si el rango esta vacio
+ */
+static int tomar_propio(TrabajadorRenovacion* trabajador, int* indice) {
+	unsigned long long rango = atomic_load(&trabajador->rango);
+	for (;;) {
+		unsigned int inicio = (unsigned int)(rango >> 32);
+		unsigned int fin = (unsigned int)rango;
+		if (inicio >= fin) return 0;
+		if (atomic_compare_exchange_weak(&trabajador->rango, &rango, empaquetar_rango(inicio + 1, fin))) {
+			*indice = (int)inicio;
+			return 1;
+		}
+	}
+}
+
+/*
+ * Funcion: robar_trabajo
+ * Descripcion: Recorre los demas hilos y se lleva la mitad final del
+ *              primer rango con trabajo pendiente. Como en un lote no
+ *              aparece trabajo nuevo, si todos los rangos estan vacios el
+ *              hilo puede terminar
+ * Parametros: trabajador - Hilo sin trabajo propio
+ * Retorno: 1 si robo trabajo, 0 si no queda nada
+ */
+static int robar_trabajo(TrabajadorRenovacion* trabajador) {
+	ContextoRenovacion* contexto = trabajador->contexto;
+
+	for (int paso = 1; paso < contexto->hilos; paso++) {
+		TrabajadorRenovacion* victima = &contexto->trabajadores[(trabajador->id + paso) % contexto->hilos];
+		unsigned long long rango = atomic_load(&victima->rango);
+		for (;;) {
+			unsigned int inicio = (unsigned int)(rango >> 32);
+			unsigned int fin = (unsigned int)rango;
+			if (inicio >= fin) break;
+
+			unsigned int mitad = (fin - inicio + 1) / 2;
+			if (atomic_compare_exchange_weak(&victima->rango, &rango, empaquetar_rango(inicio, fin - mitad))) {
+				atomic_store(&trabajador->rango, empaquetar_rango(fin - mitad, fin));
+				trabajador->robos++;
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+// ===================================================================
+// EMISION DE COMPROBANTES
+// ===================================================================
+
+/*
+ * Funcion: vaciar_buffer
+ * Descripcion: Copia el buffer del hilo a la particion de comprobantes
+ */
+static void vaciar_buffer(TrabajadorRenovacion* trabajador) {
+	ContextoRenovacion* contexto = trabajador->contexto;
+	if (trabajador->usado == 0) return;
+
+	cerrojo_tomar(&contexto->cerrojo_salida);
+	if (fwrite(trabajador->buffer, 1, trabajador->usado, contexto->salida) != trabajador->usado) {
+		atomic_store(&contexto->error, 1);
+	}
+	cerrojo_soltar(&contexto->cerrojo_salida);
+	trabajador->usado = 0;
+}
+
+/*
+ * Funcion: emitir_comprobante
+ * Descripcion: Calcula la matricula de un vehiculo y agrega su comprobante
+ *              al buffer del hilo
+ */
+static void emitir_comprobante(TrabajadorRenovacion* trabajador, int indice) {
+	ContextoRenovacion* contexto = trabajador->contexto;
+	DatosVehiculo vehiculo;
+	char numero[50];
+	char linea[400];
+
+	if (contexto->omitir[indice]) return;
+
+	// Los hilos solo leen la flota; cada uno arma su copia en la pila
+	flota_expandir(&contexto->flota, (ManejadorVehiculo)indice, &vehiculo);
+	ResultadoMatricula resultado = calcular_matricula_con_tarifas(&vehiculo, contexto->tarifas);
+
+	// Nuevo bloque de numeros cuando se acaba el propio
+	if (trabajador->numero_actual == trabajador->numero_fin) {
+		trabajador->numero_actual = atomic_fetch_add(&contexto->secuencia, BLOQUE_NUMEROS_RENOVACION);
+		trabajador->numero_fin = trabajador->numero_actual + BLOQUE_NUMEROS_RENOVACION;
+	}
+	formatear_numero_comprobante(numero, vehiculo.placa, &contexto->fecha, trabajador->numero_actual++);
+
+	int longitud = formatear_linea_comprobante(linea, sizeof(linea), vehiculo.placa, numero,
+											   vehiculo.propietario, &vehiculo, contexto->fecha_emision,
+											   contexto->fecha_vencimiento, resultado.total_matricula);
+	if (longitud <= 0 || longitud >= (int)sizeof(linea)) {
+		atomic_store(&contexto->error, 1);
+		return;
+	}
+
+	if (trabajador->usado + (size_t)longitud > sizeof(trabajador->buffer)) {
+		vaciar_buffer(trabajador);
+	}
+	memcpy(trabajador->buffer + trabajador->usado, linea, (size_t)longitud);
+	trabajador->usado += (size_t)longitud;
+	trabajador->emitidos++;
+}
+
+/*
+ * Funcion: trabajador_renovacion
+ * Descripcion: Cuerpo de cada hilo: procesa su rango, luego roba trabajo
+ *              hasta que no quede nada en el lote
+ */
+static void trabajador_renovacion(void* argumento) {
+	TrabajadorRenovacion* trabajador = argumento;
+	int indice;
+
+	for (;;) {
+		if (tomar_propio(trabajador, &indice)) {
+			emitir_comprobante(trabajador, indice);
+		} else if (!robar_trabajo(trabajador)) {
+			break;
+		}
+	}
+	vaciar_buffer(trabajador);
+}
+
+/*
+ * Funcion: procesar_lote
+ * Descripcion: Reparte el lote en rangos iguales y lo procesa con todos
+ *              los hilos. El hilo principal trabaja como el hilo 0
+ * Parametros: contexto
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int procesar_lote(ContextoRenovacion* contexto) {
+	Hilo hilos[MAX_HILOS_RENOVACION];
+	int creados = 0;
+
+	for (int h = 0; h < contexto->hilos; h++) {
+		unsigned int inicio = (unsigned int)((long)contexto->cantidad * h / contexto->hilos);
+		unsigned int fin = (unsigned int)((long)contexto->cantidad * (h + 1) / contexto->hilos);
+		atomic_store(&contexto->trabajadores[h].rango, empaquetar_rango(inicio, fin));
+	}
+
+	for (int h = 1; h < contexto->hilos; h++) {
+		if (!hilo_crear(&hilos[h], trabajador_renovacion, &contexto->trabajadores[h])) {
+			// Los rangos sin hilo los roban los demas
+			break;
+		}
+		creados = h;
+	}
+	trabajador_renovacion(&contexto->trabajadores[0]);
+	for (int h = 1; h <= creados; h++) {
+		hilo_esperar(hilos[h]);
+	}
+
+	return !atomic_load(&contexto->error);
+}
+
+// ===================================================================
+// PUNTO DE CONTROL
+// ===================================================================
+
+/*
+ * Funcion: leer_punto_control
+ * Descripcion: Lee el avance de una renovacion interrumpida
+ * Parametros: punto (salida)
+ * Retorno: 1 si existe un punto de control valido, 0 si no
+ */
+static int leer_punto_control(PuntoControlRenovacion* punto) {
+	FILE* archivo = fopen(ARCHIVO_PUNTO_CONTROL_RENOVACION, "r");
+	if (!archivo) return 0;
+
+	// Formato: ano_fiscal|periodo|desplazamiento|secuencia|emitidos|tamano_particion|tamano_registro
+	// (los puntos de control anteriores no tienen tamano_registro)
+	punto->tamano_registro = -1;
+	int leidos = fscanf(archivo, "%d|%d|%ld|%u|%ld|%ld|%ld", &punto->ano_fiscal, &punto->periodo,
+						&punto->desplazamiento, &punto->secuencia, &punto->emitidos,
+						&punto->tamano_particion, &punto->tamano_registro);
+	fclose(archivo);
+	return leidos >= 6;
+}
+
+/*
+ * Funcion: guardar_punto_control
+ * Descripcion: Guarda el avance en un archivo temporal y lo reemplaza, para
+ *              que una interrupcion nunca deje un punto de control a medias
+ * Parametros: punto
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int guardar_punto_control(const PuntoControlRenovacion* punto) {
+	FILE* archivo = fopen(ARCHIVO_TEMPORAL_RENOVACION, "w");
+	if (!archivo) return 0;
+
+	fprintf(archivo, "%d|%d|%ld|%u|%ld|%ld|%ld\n", punto->ano_fiscal, punto->periodo,
+			punto->desplazamiento, punto->secuencia, punto->emitidos, punto->tamano_particion,
+			punto->tamano_registro);
+	if (fclose(archivo) != 0) return 0;
+
+	remove(ARCHIVO_PUNTO_CONTROL_RENOVACION);
+	return rename(ARCHIVO_TEMPORAL_RENOVACION, ARCHIVO_PUNTO_CONTROL_RENOVACION) == 0;
+}
+
+static int comparar_placas(const void* a, const void* b) {
+	return strcmp((const char*)a, (const char*)b);
+}
+
+/*
+ * Funcion: cargar_placas_emitidas
+ * Descripcion: Lee las placas de los comprobantes escritos despues del
+ *              ultimo punto de control. Son del lote que se interrumpio y
+ *              no se deben volver a emitir
+ * Parametros:
+ *   - punto: Punto de control leido
+ *   - placas: Arreglo ordenado de placas (salida, se libera con free)
+ *   - cantidad: Placas leidas (salida)
+ * Retorno: 1 si la particion termina sin un salto de linea (escritura
+ *          cortada), 0 si no
+ */
+static int cargar_placas_emitidas(const PuntoControlRenovacion* punto, char (**placas)[10], int* cantidad) {
+	char ruta[MAX_RUTA_PARTICION];
+	char linea[400];
+	int capacidad = 0, linea_cortada = 0;
+
+	*placas = NULL;
+	*cantidad = 0;
+
+	particion_ruta(ruta, PARTICION_COMPROBANTES, punto->periodo);
+	FILE* archivo = fopen(ruta, "r");
+	if (!archivo) return 0;
+	fseek(archivo, punto->tamano_particion, SEEK_SET);
+
+	while (fgets(linea, sizeof(linea), archivo)) {
+		// Una linea sin salto solo cuenta si alcanzo a escribir sus 9 campos
+		linea_cortada = strchr(linea, '\n') == NULL;
+		if (linea_cortada) {
+			int separadores = 0;
+			for (char* c = linea; *c; c++) separadores += (*c == '|');
+			if (separadores < 8 || linea[strlen(linea) - 1] == '|') break;
+		}
+		if (*cantidad == capacidad) {
+			int nueva = capacidad ? capacidad * 2 : 256;
+			char (*ampliado)[10] = realloc(*placas, (size_t)nueva * sizeof(**placas));
+			if (!ampliado) break;
+			*placas = ampliado;
+			capacidad = nueva;
+		}
+		if (sscanf(linea, "%9[^|]", (*placas)[*cantidad]) == 1) {
+			(*cantidad)++;
+		}
+	}
+	fclose(archivo);
+
+	if (*cantidad > 1) {
+		qsort(*placas, (size_t)*cantidad, sizeof(**placas), comparar_placas);
+	}
+	return linea_cortada;
+}
+
+// ===================================================================
+// FUNCION PRINCIPAL DE RENOVACION
+// ===================================================================
+
+/*
+ * Funcion: leer_lote
+ * Descripcion: Lee hasta LOTE_RENOVACION vehiculos desde la posicion
+ *              actual de vehiculos.txt. Un vehiculo con valores que no
+ *              caben en el registro compacto se informa y se omite, sin
+ *              detener la renovacion del resto de la flota
+ * Parametros: archivo, contexto, placas_emitidas, cantidad_emitidas, desplazamiento (salida)
+ * Retorno: Cantidad de vehiculos leidos, -1 si falto memoria
+ */
+static int leer_lote(FILE* archivo, ContextoRenovacion* contexto, char (*placas_emitidas)[10],
+					 int cantidad_emitidas, long* desplazamiento) {
+	char linea[MAX_LINEA2];
+	DatosVehiculo vehiculo;
+	ManejadorVehiculo manejador;
+	contexto->cantidad = 0;
+	flota_vaciar(&contexto->flota);
+
+	while (contexto->cantidad < LOTE_RENOVACION && fgets(linea, sizeof(linea), archivo)) {
+		if (!leer_linea_vehiculo(linea, &vehiculo)) continue;
+		int agregado = flota_agregar(&contexto->flota, &vehiculo, &manejador);
+		if (agregado == 0) return -1;
+		if (agregado < 0) {
+			printf("Advertencia: el vehiculo %s tiene valores fuera de rango (avaluo, multas, ano,\n"
+				   "             cilindraje, meses de retraso o tipo); no se renueva.\n", vehiculo.placa);
+			continue;
+		}
+
+		contexto->omitir[manejador] = cantidad_emitidas > 0 &&
+			bsearch(vehiculo.placa, placas_emitidas, (size_t)cantidad_emitidas,
+					sizeof(*placas_emitidas), comparar_placas) != NULL;
+		contexto->cantidad++;
+	}
+	*desplazamiento = ftell(archivo);
+	return contexto->cantidad;
+}
+
+/*
+ * Funcion: total_emitidos
+ * Descripcion: Comprobantes emitidos por todos los hilos
+ */
+static long total_emitidos(const ContextoRenovacion* contexto) {
+	long total = 0;
+	for (int h = 0; h < contexto->hilos; h++) total += contexto->trabajadores[h].emitidos;
+	return total;
+}
+
+/*
+ * Funcion: ejecutar_lotes
+ * Descripcion: Procesa vehiculos.txt lote por lote desde la posicion
+ *              actual. Al cerrar cada lote registra sus comprobantes como
+ *              eventos y guarda el punto de control
+ * Parametros: contexto, archivo, punto, placas_emitidas, cantidad_emitidas,
+ *             anotado - Bytes de la particion que ya estan en el registro de eventos
+ * Retorno: 1 si llego al final del archivo, 0 si hubo error
+ */
+static int ejecutar_lotes(ContextoRenovacion* contexto, FILE* archivo, PuntoControlRenovacion* punto,
+						  char (*placas_emitidas)[10], int cantidad_emitidas, long anotado) {
+	char ruta[MAX_RUTA_PARTICION];
+	long desplazamiento;
+	int leidos;
+
+	particion_ruta(ruta, PARTICION_COMPROBANTES, punto->periodo);
+
+	while ((leidos = leer_lote(archivo, contexto, placas_emitidas, cantidad_emitidas, &desplazamiento)) > 0) {
+		long emitidos_antes = total_emitidos(contexto);
+
+		if (!procesar_lote(contexto) || fflush(contexto->salida) != 0) {
+			printf("ERROR: No se pudieron escribir los comprobantes del lote.\n");
+			return 0;
+		}
+
+		// Los bloques de numeros que quedaron a medias no se reutilizan
+		for (int h = 0; h < contexto->hilos; h++) {
+			contexto->trabajadores[h].numero_actual = contexto->trabajadores[h].numero_fin = 0;
+		}
+
+		punto->desplazamiento = desplazamiento;
+		punto->secuencia = atomic_load(&contexto->secuencia);
+		punto->emitidos += total_emitidos(contexto) - emitidos_antes;
+		punto->tamano_particion = ftell(contexto->salida);
+
+		// Antes del punto de control. Si el proceso se corta entre los dos
+		// pasos, al retomar se reconocen los eventos que ya se escribieron
+		anotado = eventos_anotar_archivo(ruta, anotado, EVENTO_COMPROBANTE);
+		if (anotado < 0) {
+			printf("ERROR: No se pudieron registrar los eventos del lote.\n");
+			return 0;
+		}
+		punto->tamano_registro = eventos_posicion_registro();
+		if (!guardar_punto_control(punto)) {
+			printf("ERROR: No se pudo guardar el punto de control.\n");
+			return 0;
+		}
+		printf("  Lote de %d vehiculos: %ld comprobantes emitidos en total\n", contexto->cantidad, punto->emitidos);
+	}
+	if (leidos < 0) {
+		printf("ERROR: No hay memoria para el lote de vehiculos.\n");
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Funcion: renovar_flota
+ * Descripcion: Emite un comprobante de matricula pendiente para cada
+ *              vehiculo de vehiculos.txt con las tarifas vigentes. Si
+ *              existe un punto de control del mismo ano fiscal, continua
+ *              desde el ultimo lote completado. Un ano fiscal ya renovado
+ *              no se vuelve a emitir
+ * Parametros: hilos - Hilos de calculo (0 = uno por procesador)
+ * Retorno: 1 si la renovacion termino, 0 si hubo error
+ */
+int renovar_flota(int hilos) {
+	PuntoControlRenovacion punto = {0};
+	char (*placas_emitidas)[10] = NULL;
+	int cantidad_emitidas = 0;
+	int exito = 0;
+	time_t inicio = time(NULL);
+
+	if (hilos <= 0) hilos = hilos_disponibles();
+	if (hilos > MAX_HILOS_RENOVACION) hilos = MAX_HILOS_RENOVACION;
+
+	// Si el registro de eventos se crea ahora, ya incluye lo que hay en las particiones
+	int registro = eventos_iniciar();
+	if (!registro) {
+		return 0;
+	}
+
+	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "r");
+	if (!archivo) {
+		printf("ERROR: No se pudo abrir '%s'.\n", ARCHIVO_VEHICULOS);
+		return 0;
+	}
+	crear_carpetas_sistema();
+
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	int periodo = periodo_desde_hoy(0);
+
+	printf("=== RENOVACION ANUAL DE MATRICULAS %d ===\n", lectura.tabla->ano_fiscal);
+	printf("Tarifas version %u, %d hilo(s)\n", lectura.tabla->version, hilos);
+
+	int reanudar = leer_punto_control(&punto);
+	if (reanudar && punto.ano_fiscal != lectura.tabla->ano_fiscal) {
+		printf("Se ignora el punto de control del ano fiscal %d.\n", punto.ano_fiscal);
+		memset(&punto, 0, sizeof(punto));
+		reanudar = 0;
+	}
+	if (reanudar && punto.desplazamiento == RENOVACION_TERMINADA) {
+		printf("La renovacion del ano fiscal %d ya se completo (%ld comprobantes).\n",
+			   punto.ano_fiscal, punto.emitidos);
+		printf("Para emitir los comprobantes otra vez borre '%s'.\n", ARCHIVO_PUNTO_CONTROL_RENOVACION);
+		fclose(archivo);
+		tarifas_leer_fin(lectura);
+		return 1;
+	}
+
+	ContextoRenovacion contexto;
+	memset(&contexto, 0, sizeof(contexto));
+	int flota_lista = flota_iniciar(&contexto.flota);
+	contexto.omitir = malloc(LOTE_RENOVACION);
+	contexto.trabajadores = calloc((size_t)hilos, sizeof(TrabajadorRenovacion));
+	contexto.hilos = hilos;
+	contexto.tarifas = lectura.tabla;
+	contexto.salida = particion_abrir_anexar(PARTICION_COMPROBANTES, periodo);
+	time_t hoy = time(NULL);
+	contexto.fecha = *localtime(&hoy);
+	obtener_fecha_actual(contexto.fecha_emision);
+	calcular_fecha_vencimiento(contexto.fecha_vencimiento, DIAS_VALIDEZ_COMPROBANTE);
+
+	if (flota_lista && contexto.omitir && contexto.trabajadores && contexto.salida) {
+		cerrojo_iniciar(&contexto.cerrojo_salida);
+		setvbuf(contexto.salida, NULL, _IOFBF, TAMANO_BUFFER_RENOVACION);
+		for (int h = 0; h < hilos; h++) {
+			contexto.trabajadores[h].contexto = &contexto;
+			contexto.trabajadores[h].id = h;
+		}
+
+		if (reanudar) {
+			printf("Retomando desde el punto de control (%ld comprobantes emitidos).\n", punto.emitidos);
+			if (cargar_placas_emitidas(&punto, &placas_emitidas, &cantidad_emitidas) && punto.periodo == periodo) {
+				fputc('\n', contexto.salida);
+			}
+			// Los comprobantes del lote interrumpido que no llegaron al registro
+			// de eventos (algunos pudieron anotarse antes del corte)
+			if (registro == 1) {
+				char ruta[MAX_RUTA_PARTICION];
+				particion_ruta(ruta, PARTICION_COMPROBANTES, punto.periodo);
+				long anotado = eventos_anotados_hasta(ruta, punto.tamano_particion, punto.tamano_registro,
+													  EVENTO_COMPROBANTE);
+				if (fflush(contexto.salida) != 0 ||
+					eventos_anotar_archivo(ruta, anotado, EVENTO_COMPROBANTE) < 0) {
+					printf("Advertencia: No se pudieron registrar los eventos del lote interrumpido.\n");
+				}
+			}
+			fseek(archivo, punto.desplazamiento, SEEK_SET);
+			// Los comprobantes del lote interrumpido ya estan en la particion
+			punto.emitidos += cantidad_emitidas;
+		} else {
+			punto.ano_fiscal = lectura.tabla->ano_fiscal;
+			punto.secuencia = (unsigned int)rand();
+		}
+		punto.periodo = periodo;
+		atomic_store(&contexto.secuencia, punto.secuencia);
+
+		fseek(contexto.salida, 0, SEEK_END);
+		exito = 1;
+		if (!reanudar) {
+			// Punto de control inicial: un corte en el primer lote tambien se retoma
+			punto.tamano_particion = ftell(contexto.salida);
+			punto.tamano_registro = eventos_posicion_registro();
+			if (!guardar_punto_control(&punto)) {
+				printf("ERROR: No se pudo guardar el punto de control.\n");
+				exito = 0;
+			}
+		}
+		exito = exito && ejecutar_lotes(&contexto, archivo, &punto, placas_emitidas, cantidad_emitidas,
+										ftell(contexto.salida));
+		cerrojo_destruir(&contexto.cerrojo_salida);
+	} else {
+		printf("ERROR: No se pudo preparar la renovacion.\n");
+	}
+
+	if (exito) {
+		long robos = 0;
+		for (int h = 0; h < hilos; h++) robos += contexto.trabajadores[h].robos;
+		// El punto de control queda como marca del ano fiscal renovado
+		punto.desplazamiento = RENOVACION_TERMINADA;
+		if (!guardar_punto_control(&punto)) {
+			printf("Advertencia: No se pudo marcar el ano fiscal %d como renovado.\n", punto.ano_fiscal);
+		}
+		printf("\nRenovacion terminada: %ld comprobantes en %ld s (%ld robos de trabajo).\n",
+			   punto.emitidos, (long)(time(NULL) - inicio), robos);
+	} else {
+		printf("Vuelva a ejecutar con %s para continuar desde el ultimo lote completo.\n", ARGUMENTO_RENOVACION);
+	}
+
+	if (contexto.salida) fclose(contexto.salida);
+	fclose(archivo);
+	flota_liberar(&contexto.flota);
+	free(contexto.omitir);
+	free(contexto.trabajadores);
+	free(placas_emitidas);
+	tarifas_leer_fin(lectura);
+	return exito;
+}
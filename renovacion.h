@@ -0,0 +1,44 @@
+/*
+ * renovacion.h - Libreria de renovacion anual de toda la flota
+ *
+ * Descripcion: Este archivo contiene las constantes y prototipos del
+ *              proceso en lote que emite un comprobante de matricula para
+ *              cada vehiculo registrado al inicio del ano fiscal. Se ejecuta
+ *              con "MiProyecto.exe --renew-all [--hilos N]", reparte el
+ *              calculo entre varios hilos y se puede retomar desde un punto
+ *              de control si se interrumpe.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef RENOVACION_H
+#define RENOVACION_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// ===================================================================
+// CONSTANTES DE RENOVACION
+// ===================================================================
+
+#define ARGUMENTO_RENOVACION "--renew-all"
+#define ARCHIVO_PUNTO_CONTROL_RENOVACION "renovacion.chk"
+#define ARCHIVO_TEMPORAL_RENOVACION "renovacion.tmp"
+#define RENOVACION_TERMINADA -1L         // Desplazamiento del punto de control de un ano ya renovado
+
+#define LOTE_RENOVACION 2048             // Vehiculos leidos de vehiculos.txt por lote
+#define BLOQUE_NUMEROS_RENOVACION 64     // Secuencias de comprobante que toma un hilo a la vez
+#define TAMANO_BUFFER_RENOVACION 65536   // Buffer de escritura de cada hilo
+#define MAX_HILOS_RENOVACION 64
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+int renovar_flota(int hilos);
+
+#endif // RENOVACION_H
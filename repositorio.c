@@ -0,0 +1,906 @@
+/*
+ * repositorio.c - Implementacion del repositorio de vehiculos, comprobantes y pagos
+ *
+ * Descripcion: Este archivo implementa el repositorio, incluyendo:
+ *              - El motor de texto: los mismos archivos de proyeccion (y
+ *                particiones) de siempre, recorridos linea por linea
+ *              - La eleccion del motor de cada tabla segun almacen.cfg
+ *              - La copia inicial de los archivos de texto a los motores
+ *                binario, SQLite o LSM, y la marca de que cada tabla quedo
+ *                al dia cuando el programa termina bien
+ *              - La comparacion de los motores con la misma carga de trabajo
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "repositorio.h"
+#include "motor_binario.h"
+#include "motor_sqlite.h"
+#include "motor_lsm.h"
+#include "vehiculos.h"
+#include "eventos.h"
+#include "particiones.h"
+#include "indice_vehiculos.h"
+#include <ctype.h>
+#include <time.h>
+#include <direct.h>      // Para _mkdir en Windows
+#include <sys/stat.h>    // Para verificar si existe la carpeta
+
+// ===================================================================
+// TABLAS Y MOTORES
+// ===================================================================
+
+const TablaRepositorio tablas_repositorio[NUM_TABLAS_REPOSITORIO] = {
+	{"vehiculos", ARCHIVO_VEHICULOS, 0, 0, ','},
+	{"comprobantes", NULL, PARTICION_COMPROBANTES, 1, '|'},
+	{"pagos", NULL, PARTICION_PAGOS, 0, '|'},
+	{"matriculados", ARCHIVO_VEHICULOS_MATRICULADOS, 0, 0, '|'}
+};
+
+static const MotorAlmacen* const motores[] = {
+	&motor_texto,
+	&motor_binario,
+#ifdef USAR_SQLITE
+	&motor_sqlite,
+#endif
+	&motor_lsm,
+};
+#define NUM_MOTORES ((int)(sizeof(motores) / sizeof(motores[0])))
+
+// Motor de cada tabla (indice TABLA_*)
+static const MotorAlmacen* motores_tabla[NUM_TABLAS_REPOSITORIO] = {
+	&motor_texto, &motor_texto, &motor_texto, &motor_texto
+};
+static int repositorio_listo = 0;
+
+/*
+ * Funcion: repositorio_clave_de_linea
+ * Descripcion: Copia el campo clave de una linea de la tabla
+ * Parametros: tabla, linea, clave (salida), tamano
+ * Retorno: 1 si la linea tiene clave, 0 si no
+ */
+int repositorio_clave_de_linea(const TablaRepositorio* tabla, const char* linea, char* clave, size_t tamano) {
+	const char* inicio = linea;
+	char fin_campo[4] = {tabla->separador, '\r', '\n', '\0'};
+
+	for (int i = 0; i < tabla->campo_clave; i++) {
+		inicio = strchr(inicio, tabla->separador);
+		if (!inicio) return 0;
+		inicio++;
+	}
+
+	size_t largo = strcspn(inicio, fin_campo);
+	if (largo == 0 || largo >= tamano) return 0;
+	memcpy(clave, inicio, largo);
+	clave[largo] = '\0';
+	return 1;
+}
+
+// ===================================================================
+// MOTOR DE TEXTO
+// ===================================================================
+
+/*
+ * Estructura: BusquedaTexto
+ * Descripcion: Clave buscada y donde se copia la ultima linea que la tiene
+ */
+typedef struct {
+	const char* clave;
+	char* valor;
+	size_t tamano;
+	int encontrado;
+} BusquedaTexto;
+
+/*
+ * Funcion: rutas_texto
+ * Descripcion: Archivos de texto de una tabla: el archivo unico o todas
+ *              las particiones del manifiesto (primero el archivo anterior
+ *              a las particiones)
+ * Parametros: tabla, periodos (salida, MAX_PARTICIONES)
+ * Retorno: Cantidad de archivos
+ */
+static int rutas_texto(const TablaRepositorio* tabla, int* periodos) {
+	if (tabla->archivo) return 1;
+	return particion_listar(tabla->particion, 0, 0, periodos, MAX_PARTICIONES);
+}
+
+/*
+ * Funcion: ruta_texto
+ * Descripcion: Ruta del i-esimo archivo de texto de una tabla
+ */
+static void ruta_texto(const TablaRepositorio* tabla, const int* periodos, int i, char* ruta) {
+	if (tabla->archivo) {
+		snprintf(ruta, MAX_RUTA_PARTICION, "%s", tabla->archivo);
+	} else {
+		particion_ruta(ruta, tabla->particion, periodos[i]);
+	}
+}
+
+/*
+ * Funcion: recorrer_texto
+ * Descripcion: Entrega cada linea con clave de los archivos de la tabla
+ */
+static long recorrer_texto(const TablaRepositorio* tabla, FuncionRegistro funcion, void* contexto) {
+	int periodos[MAX_PARTICIONES];
+	int cantidad = rutas_texto(tabla, periodos);
+	long registros = 0;
+
+	for (int i = 0; i < cantidad; i++) {
+		char ruta[MAX_RUTA_PARTICION], linea[MAX_VALOR_REGISTRO + 2], clave[MAX_CLAVE_REGISTRO];
+		ruta_texto(tabla, periodos, i, ruta);
+		FILE* archivo = fopen(ruta, "r");
+		if (!archivo) continue;
+
+		while (fgets(linea, sizeof(linea), archivo)) {
+			linea[strcspn(linea, "\r\n")] = '\0';
+			if (!repositorio_clave_de_linea(tabla, linea, clave, sizeof(clave))) continue;
+			registros++;
+			if (!funcion(clave, linea, contexto)) {
+				fclose(archivo);
+				return registros;
+			}
+		}
+		fclose(archivo);
+	}
+	return registros;
+}
+
+/*
+ * Funcion: comparar_clave_texto
+ * Descripcion: Copia la linea si tiene la clave buscada. Se sigue
+ *              recorriendo: gana la ultima linea, como en las particiones
+ */
+static int comparar_clave_texto(const char* clave, const char* valor, void* contexto) {
+	BusquedaTexto* busqueda = contexto;
+	if (strcmp(clave, busqueda->clave) == 0 && strlen(valor) < busqueda->tamano) {
+		strcpy(busqueda->valor, valor);
+		busqueda->encontrado = 1;
+	}
+	return 1;
+}
+
+static int obtener_texto(const TablaRepositorio* tabla, const char* clave, char* valor, size_t tamano) {
+	BusquedaTexto busqueda = {clave, valor, tamano, 0};
+	recorrer_texto(tabla, comparar_clave_texto, &busqueda);
+	return busqueda.encontrado;
+}
+
+/*
+ * Funcion: reescribir_texto
+ * Descripcion: Reescribe un archivo de texto cambiando las lineas de una
+ *              clave (por un temporal que luego reemplaza al archivo)
+ * Retorno: Lineas cambiadas, -1 si hubo error
+ */
+static int reescribir_texto(const TablaRepositorio* tabla, const char* ruta, const char* clave, const char* valor) {
+	char ruta_temporal[MAX_RUTA_PARTICION + 4];
+	snprintf(ruta_temporal, sizeof(ruta_temporal), "%s.tmp", ruta);
+
+	FILE* archivo = fopen(ruta, "r");
+	if (!archivo) return 0;
+	FILE* temporal = fopen(ruta_temporal, "w");
+	if (!temporal) {
+		fclose(archivo);
+		return -1;
+	}
+
+	char linea[MAX_VALOR_REGISTRO + 2], clave_linea[MAX_CLAVE_REGISTRO];
+	int cambiadas = 0, exito = 1;
+	while (exito && fgets(linea, sizeof(linea), archivo)) {
+		if (repositorio_clave_de_linea(tabla, linea, clave_linea, sizeof(clave_linea)) &&
+			strcmp(clave_linea, clave) == 0) {
+			exito = fprintf(temporal, "%s\n", valor) > 0;
+			cambiadas++;
+		} else {
+			exito = fputs(linea, temporal) >= 0;
+		}
+	}
+	fclose(archivo);
+	if (fclose(temporal) != 0) exito = 0;
+
+	if (!exito || cambiadas == 0) {
+		remove(ruta_temporal);
+		return exito ? 0 : -1;
+	}
+	remove(ruta);
+	return rename(ruta_temporal, ruta) == 0 ? cambiadas : -1;
+}
+
+static int actualizar_texto(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	int periodos[MAX_PARTICIONES];
+	int cantidad = rutas_texto(tabla, periodos);
+	int cambiadas = 0;
+
+	for (int i = 0; i < cantidad; i++) {
+		char ruta[MAX_RUTA_PARTICION];
+		ruta_texto(tabla, periodos, i, ruta);
+		int resultado = reescribir_texto(tabla, ruta, clave, valor);
+		if (resultado < 0) return 0;
+		cambiadas += resultado;
+	}
+	return cambiadas > 0;
+}
+
+static int guardar_texto(const TablaRepositorio* tabla, const char* clave, const char* valor) {
+	if (actualizar_texto(tabla, clave, valor)) return 1;
+
+	// Las tablas particionadas usan el mes del numero de comprobante
+	FILE* archivo = tabla->archivo ? fopen(tabla->archivo, "a")
+		: particion_abrir_anexar(tabla->particion, periodo_de_numero_comprobante(clave));
+	if (!archivo) return 0;
+	int exito = fprintf(archivo, "%s\n", valor) > 0;
+	if (fclose(archivo) != 0) exito = 0;
+	return exito;
+}
+
+static int vaciar_texto(const TablaRepositorio* tabla) {
+	if (tabla->archivo) {
+		FILE* archivo = fopen(tabla->archivo, "w");
+		if (!archivo) return 0;
+		return fclose(archivo) == 0;
+	}
+
+	int periodos[MAX_PARTICIONES];
+	int cantidad = particion_listar(tabla->particion, 0, 0, periodos, MAX_PARTICIONES);
+	for (int i = 0; i < cantidad; i++) {
+		if (!particion_eliminar(tabla->particion, periodos[i])) return 0;
+	}
+	return 1;
+}
+
+static int abrir_texto(const TablaRepositorio* tabla) {
+	(void)tabla;
+	return 1;
+}
+
+static int confirmar_texto(void) {
+	return 1;
+}
+
+static int cerrar_texto(void) {
+	return 1;
+}
+
+const MotorAlmacen motor_texto = {
+	"texto", 1,
+	abrir_texto, obtener_texto, guardar_texto, actualizar_texto,
+	recorrer_texto, NULL, vaciar_texto, confirmar_texto, cerrar_texto
+};
+
+// ===================================================================
+// ELECCION DEL MOTOR
+// ===================================================================
+
+/*
+ * Funcion: repositorio_buscar_motor
+ * Descripcion: Busca un motor compilado por su nombre
+ * Parametros: nombre
+ * Retorno: Motor, NULL si no existe o no se compilo
+ */
+const MotorAlmacen* repositorio_buscar_motor(const char* nombre) {
+	for (int i = 0; i < NUM_MOTORES; i++) {
+		if (strcmp(motores[i]->nombre, nombre) == 0) return motores[i];
+	}
+	return NULL;
+}
+
+/*
+ * Funcion: buscar_tabla
+ * Descripcion: Busca una tabla del repositorio por su nombre
+ * Retorno: Indice TABLA_*, -1 si no existe
+ */
+static int buscar_tabla(const char* nombre) {
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		if (strcmp(tablas_repositorio[t].nombre, nombre) == 0) return t;
+	}
+	return -1;
+}
+
+/*
+ * Funcion: leer_motores_configurados
+ * Descripcion: Lee de almacen.cfg la clave 'motor' (todas las tablas) y las
+ *              claves 'motor.<tabla>', que cambian el motor de una tabla
+ * Parametros: nombres (salida, un nombre de MAX_NOMBRE_MOTOR por tabla)
+ * Retorno: void (MOTOR_POR_DEFECTO si no hay archivo o clave)
+ */
+static void leer_motores_configurados(char (*nombres)[MAX_NOMBRE_MOTOR]) {
+	char general[MAX_NOMBRE_MOTOR] = MOTOR_POR_DEFECTO;
+	char propio[NUM_TABLAS_REPOSITORIO][MAX_NOMBRE_MOTOR];
+	memset(propio, 0, sizeof(propio));
+
+	FILE* archivo = fopen(ARCHIVO_CONFIG_ALMACEN, "r");
+	if (archivo) {
+		char linea[200];
+		size_t largo_prefijo = strlen(CLAVE_MOTOR_TABLA);
+		while (fgets(linea, sizeof(linea), archivo)) {
+			char clave[40], valor[MAX_NOMBRE_MOTOR];
+			char* inicio = linea;
+			while (isspace((unsigned char)*inicio)) inicio++;
+			if (*inicio == '\0' || *inicio == '#') continue;
+			if (sscanf(inicio, " %39[^= \t] = %19s", clave, valor) != 2) continue;
+
+			if (strcmp(clave, "motor") == 0) {
+				strcpy(general, valor);
+			} else if (strncmp(clave, CLAVE_MOTOR_TABLA, largo_prefijo) == 0) {
+				int tabla = buscar_tabla(clave + largo_prefijo);
+				if (tabla >= 0) {
+					strcpy(propio[tabla], valor);
+				} else {
+					printf("Advertencia: la tabla de '%s' en %s no existe.\n", clave, ARCHIVO_CONFIG_ALMACEN);
+				}
+			}
+		}
+		fclose(archivo);
+	}
+
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		strcpy(nombres[t], propio[t][0] ? propio[t] : general);
+	}
+}
+
+/*
+ * Funcion: crear_carpeta_datos
+ * Descripcion: Crea la carpeta de los motores binario, SQLite y LSM si no existe
+ */
+static void crear_carpeta_datos(void) {
+	struct stat st = {0};
+	if (stat(CARPETA_DATOS, &st) == -1) {
+		_mkdir(CARPETA_DATOS);
+	}
+}
+
+/*
+ * Funcion: leer_sincronizados
+ * Descripcion: Lee el motor con el que cada tabla quedo al dia con los
+ *              archivos de texto (el programa termino bien la ultima vez).
+ *              El archivo tiene una linea 'tabla motor' por tabla
+ * Parametros: nombres (salida, "" si la tabla no quedo al dia)
+ */
+static void leer_sincronizados(char (*nombres)[MAX_NOMBRE_MOTOR]) {
+	memset(nombres, 0, NUM_TABLAS_REPOSITORIO * MAX_NOMBRE_MOTOR);
+	FILE* archivo = fopen(ARCHIVO_SINCRONIZADO, "r");
+	if (!archivo) return;
+
+	char tabla[40], motor[MAX_NOMBRE_MOTOR];
+	while (fscanf(archivo, "%39s %19s", tabla, motor) == 2) {
+		int t = buscar_tabla(tabla);
+		if (t >= 0) strcpy(nombres[t], motor);
+	}
+	fclose(archivo);
+}
+
+/*
+ * Funcion: copiar_registro
+ * Descripcion: Guarda en el motor de la tabla un registro del motor de texto
+ */
+static int copiar_registro(const char* clave, const char* valor, void* contexto) {
+	int tabla = *(const int*)contexto;
+	return motores_tabla[tabla]->guardar(&tablas_repositorio[tabla], clave, valor);
+}
+
+/*
+ * Funcion: importar_desde_texto
+ * Descripcion: Vacia una tabla en su motor y le copia los registros de los
+ *              archivos de texto
+ * Parametros: tabla - Indice TABLA_*
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+static int importar_desde_texto(int tabla) {
+	const MotorAlmacen* motor = motores_tabla[tabla];
+	const TablaRepositorio* datos = &tablas_repositorio[tabla];
+	int exito = motor->vaciar(datos);
+	long registros = exito ? recorrer_texto(datos, copiar_registro, &tabla) : 0;
+	exito = exito && motor->confirmar();
+	printf("    %-14s %-8s %ld registros\n", datos->nombre, motor->nombre, registros);
+	if (!exito) printf("ERROR: No se pudo copiar la tabla '%s' al motor '%s'.\n", datos->nombre, motor->nombre);
+	return exito;
+}
+
+/*
+ * Funcion: motores_en_uso
+ * Descripcion: Motores distintos de las tablas, sin el de texto
+ * Parametros: lista (salida, NUM_TABLAS_REPOSITORIO)
+ * Retorno: Cantidad de motores
+ */
+static int motores_en_uso(const MotorAlmacen** lista) {
+	int cantidad = 0;
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		const MotorAlmacen* motor = motores_tabla[t];
+		int repetido = motor->usa_proyecciones;
+		for (int i = 0; !repetido && i < cantidad; i++) {
+			repetido = lista[i] == motor;
+		}
+		if (!repetido) lista[cantidad++] = motor;
+	}
+	return cantidad;
+}
+
+/*
+ * Funcion: volver_a_texto
+ * Descripcion: Deja las tablas de un motor con el motor de texto, despues
+ *              de un error al abrirlo o al copiarle los archivos
+ */
+static void volver_a_texto(const MotorAlmacen* motor) {
+	printf("ERROR: El motor '%s' no esta disponible; sus tablas usan '%s'.\n", motor->nombre, motor_texto.nombre);
+	motor->cerrar();
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		if (motores_tabla[t] == motor) motores_tabla[t] = &motor_texto;
+	}
+}
+
+/*
+ * Funcion: repositorio_iniciar
+ * Descripcion: Elige el motor de cada tabla segun almacen.cfg y lo abre.
+ *              Una tabla que no quedo al dia la ultima vez (se cambio su
+ *              motor o el programa no termino bien) se vuelve a copiar
+ *              desde los archivos de texto. Si un motor no esta disponible
+ *              sus tablas usan el de texto
+ * Parametros: Ninguno
+ * Retorno: 1 si fue exitoso, 0 si alguna tabla tuvo que volver al motor de texto
+ */
+int repositorio_iniciar(void) {
+	if (repositorio_listo) return 1;
+	repositorio_listo = 1;
+
+	char nombres[NUM_TABLAS_REPOSITORIO][MAX_NOMBRE_MOTOR];
+	char sincronizados[NUM_TABLAS_REPOSITORIO][MAX_NOMBRE_MOTOR];
+	leer_motores_configurados(nombres);
+
+	// La marca se borra al iniciar: si el programa no termina bien, no queda
+	leer_sincronizados(sincronizados);
+	remove(ARCHIVO_SINCRONIZADO);
+
+	int exito = 1, al_dia[NUM_TABLAS_REPOSITORIO];
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		const MotorAlmacen* motor = repositorio_buscar_motor(nombres[t]);
+		if (!motor) {
+			printf("Advertencia: el motor '%s' de %s no esta disponible; se usa '%s'.\n",
+				   nombres[t], ARCHIVO_CONFIG_ALMACEN, motor_texto.nombre);
+			motor = &motor_texto;
+		}
+		motores_tabla[t] = motor;
+		al_dia[t] = strcmp(sincronizados[t], motor->nombre) == 0;
+	}
+
+	crear_carpeta_datos();
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		const MotorAlmacen* motor = motores_tabla[t];
+		if (motor->usa_proyecciones) continue;
+		int resultado = motor->abrir(&tablas_repositorio[t]);
+		if (resultado == 0) {
+			volver_a_texto(motor);
+			exito = 0;
+		} else if (resultado == 2) {
+			al_dia[t] = 0;
+		}
+	}
+
+	int cargando = 0;
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		const MotorAlmacen* motor = motores_tabla[t];
+		if (motor->usa_proyecciones || al_dia[t]) continue;
+		if (!cargando) printf("Cargando los archivos de texto en los motores de almacenamiento...\n");
+		cargando = 1;
+		if (!importar_desde_texto(t)) {
+			volver_a_texto(motor);
+			exito = 0;
+		}
+	}
+	return exito;
+}
+
+/*
+ * Funcion: repositorio_cerrar
+ * Descripcion: Confirma y cierra los motores y deja la marca de las tablas
+ *              que quedaron al dia con los archivos de texto
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void repositorio_cerrar(void) {
+	if (!repositorio_listo) return;
+	repositorio_listo = 0;
+
+	const MotorAlmacen* motores_abiertos[NUM_TABLAS_REPOSITORIO];
+	int exito[NUM_TABLAS_REPOSITORIO];
+	int cantidad = motores_en_uso(motores_abiertos);
+	if (cantidad == 0) return;
+
+	for (int i = 0; i < cantidad; i++) {
+		exito[i] = motores_abiertos[i]->confirmar();
+		if (!motores_abiertos[i]->cerrar()) exito[i] = 0;
+	}
+
+	FILE* archivo = fopen(ARCHIVO_SINCRONIZADO, "w");
+	if (!archivo) return;
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		for (int i = 0; i < cantidad; i++) {
+			if (motores_abiertos[i] == motores_tabla[t] && exito[i]) {
+				fprintf(archivo, "%s %s\n", tablas_repositorio[t].nombre, motores_tabla[t]->nombre);
+			}
+		}
+	}
+	fclose(archivo);
+}
+
+/*
+ * Funcion: repositorio_recargar
+ * Descripcion: Vuelve a copiar los archivos de texto a los motores,
+ *              despues de un cambio que no pasa por el registro de eventos
+ *              (por ejemplo al archivar un ano en el historico)
+ * Parametros: Ninguno
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int repositorio_recargar(void) {
+	int exito = 1;
+	repositorio_iniciar();
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		if (!motores_tabla[t]->usa_proyecciones && !importar_desde_texto(t)) exito = 0;
+	}
+	return exito;
+}
+
+/*
+ * Funcion: repositorio_nombre_motor
+ * Descripcion: Nombre del motor de una tabla
+ */
+const char* repositorio_nombre_motor(int tabla) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return "";
+	repositorio_iniciar();
+	return motores_tabla[tabla]->nombre;
+}
+
+/*
+ * Funcion: repositorio_usa_proyecciones
+ * Descripcion: Indica si el motor de una tabla guarda sus datos en los
+ *              mismos archivos de proyeccion (no hace falta copiarle nada)
+ */
+int repositorio_usa_proyecciones(int tabla) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return 1;
+	repositorio_iniciar();
+	return motores_tabla[tabla]->usa_proyecciones;
+}
+
+// ===================================================================
+// OPERACIONES POR CLAVE
+// ===================================================================
+
+int repositorio_obtener(int tabla, const char* clave, char* valor, size_t tamano) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return 0;
+	repositorio_iniciar();
+	return motores_tabla[tabla]->obtener(&tablas_repositorio[tabla], clave, valor, tamano);
+}
+
+int repositorio_guardar(int tabla, const char* clave, const char* valor) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return 0;
+	repositorio_iniciar();
+	return motores_tabla[tabla]->guardar(&tablas_repositorio[tabla], clave, valor);
+}
+
+int repositorio_actualizar(int tabla, const char* clave, const char* valor) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return 0;
+	repositorio_iniciar();
+	return motores_tabla[tabla]->actualizar(&tablas_repositorio[tabla], clave, valor);
+}
+
+long repositorio_recorrer(int tabla, FuncionRegistro funcion, void* contexto) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return -1;
+	repositorio_iniciar();
+	return motores_tabla[tabla]->recorrer(&tablas_repositorio[tabla], funcion, contexto);
+}
+
+/*
+ * Estructura: FiltroPrefijo
+ * Descripcion: Funcion original y prefijo al filtrar un recorrido completo
+ */
+typedef struct {
+	const char* prefijo;
+	size_t largo;
+	FuncionRegistro funcion;
+	void* contexto;
+	long entregados;
+} FiltroPrefijo;
+
+static int filtrar_prefijo(const char* clave, const char* valor, void* contexto) {
+	FiltroPrefijo* filtro = contexto;
+	if (strncmp(clave, filtro->prefijo, filtro->largo) != 0) return 1;
+	filtro->entregados++;
+	return filtro->funcion(clave, valor, filtro->contexto);
+}
+
+/*
+ * Funcion: repositorio_recorrer_prefijo
+ * Descripcion: Entrega los registros cuya clave empieza con un prefijo. Los
+ *              motores con las claves en orden (SQLite y LSM) leen solo ese
+ *              rango; los demas recorren la tabla y filtran
+ * Parametros: tabla, prefijo, funcion, contexto
+ * Retorno: Registros entregados, -1 si hubo error
+ */
+long repositorio_recorrer_prefijo(int tabla, const char* prefijo, FuncionRegistro funcion, void* contexto) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return -1;
+	repositorio_iniciar();
+	const MotorAlmacen* motor = motores_tabla[tabla];
+	if (motor->recorrer_prefijo) {
+		return motor->recorrer_prefijo(&tablas_repositorio[tabla], prefijo, funcion, contexto);
+	}
+
+	FiltroPrefijo filtro = {prefijo, strlen(prefijo), funcion, contexto, 0};
+	if (motor->recorrer(&tablas_repositorio[tabla], filtrar_prefijo, &filtro) < 0) return -1;
+	return filtro.entregados;
+}
+
+/*
+ * Estructura: RecorridoOrdenado
+ * Descripcion: Ordenamiento y funcion original al recorrer en orden
+ */
+typedef struct {
+	OrdenExterno orden;
+	const TablaRepositorio* tabla;
+	int criterio;
+	int campo;
+	FuncionRegistro funcion;
+	void* contexto;
+} RecorridoOrdenado;
+
+static int agregar_a_orden(const char* clave, const char* valor, void* contexto) {
+	(void)clave;
+	RecorridoOrdenado* recorrido = contexto;
+	unsigned char clave_orden[MAX_ANCHO_CLAVE];
+	orden_clave_de_campo(clave_orden, recorrido->criterio, valor, recorrido->tabla->separador, recorrido->campo);
+	return orden_agregar(&recorrido->orden, clave_orden, valor);
+}
+
+static int entregar_ordenada(const char* linea, void* contexto) {
+	RecorridoOrdenado* recorrido = contexto;
+	char clave[MAX_CLAVE_REGISTRO];
+	if (!repositorio_clave_de_linea(recorrido->tabla, linea, clave, sizeof(clave))) clave[0] = '\0';
+	return recorrido->funcion(clave, linea, recorrido->contexto);
+}
+
+/*
+ * Funcion: repositorio_recorrer_ordenado
+ * Descripcion: Entrega los registros de una tabla ordenados por un campo
+ *              de la linea, con el ordenamiento externo: la memoria usada
+ *              no depende del tamano de la tabla
+ * Parametros:
+ *   - tabla: TABLA_*
+ *   - criterio: ORDEN_POR_* (ORDEN_ARCHIVO = recorrido normal)
+ *   - campo: Numero del campo de la linea con la placa, el monto o la fecha
+ *   - funcion, contexto: Reciben cada registro
+ * Retorno: Registros entregados, -1 si hubo error
+ */
+long repositorio_recorrer_ordenado(int tabla, int criterio, int campo, FuncionRegistro funcion, void* contexto) {
+	if (tabla < 0 || tabla >= NUM_TABLAS_REPOSITORIO) return -1;
+	if (criterio == ORDEN_ARCHIVO) return repositorio_recorrer(tabla, funcion, contexto);
+
+	RecorridoOrdenado recorrido;
+	if (!orden_iniciar(&recorrido.orden, orden_ancho_clave(criterio), 0, 0)) return -1;
+	recorrido.tabla = &tablas_repositorio[tabla];
+	recorrido.criterio = criterio;
+	recorrido.campo = campo;
+	recorrido.funcion = funcion;
+	recorrido.contexto = contexto;
+
+	long entregados = -1;
+	if (repositorio_recorrer(tabla, agregar_a_orden, &recorrido) >= 0 && recorrido.orden.exito) {
+		entregados = orden_terminar(&recorrido.orden, entregar_ordenada, &recorrido);
+	}
+	orden_liberar(&recorrido.orden);
+	return entregados;
+}
+
+int repositorio_confirmar(void) {
+	const MotorAlmacen* lista[NUM_TABLAS_REPOSITORIO];
+	int exito = 1;
+	repositorio_iniciar();
+	int cantidad = motores_en_uso(lista);
+	for (int i = 0; i < cantidad; i++) {
+		if (!lista[i]->confirmar()) exito = 0;
+	}
+	return exito;
+}
+
+// ===================================================================
+// FUNCIONES DE PROYECCIONES
+// ===================================================================
+
+/*
+ * Funcion: repositorio_proyectar
+ * Descripcion: Copia al motor una linea recien escrita en un archivo de
+ *              proyeccion. Con el motor de texto no hace nada: la linea ya
+ *              esta en su archivo
+ * Parametros: tabla, linea
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int repositorio_proyectar(int tabla, const char* linea) {
+	char clave[MAX_CLAVE_REGISTRO];
+	if (repositorio_usa_proyecciones(tabla)) return 1;
+	if (!repositorio_clave_de_linea(&tablas_repositorio[tabla], linea, clave, sizeof(clave))) return 1;
+	return repositorio_guardar(tabla, clave, linea);
+}
+
+/*
+ * Funcion: repositorio_vaciar_proyecciones
+ * Descripcion: Vacia todas las tablas del motor antes de reconstruir las
+ *              proyecciones desde el registro de eventos
+ * Parametros: Ninguno
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int repositorio_vaciar_proyecciones(void) {
+	int exito = 1;
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		if (repositorio_usa_proyecciones(t)) continue;
+		if (!motores_tabla[t]->vaciar(&tablas_repositorio[t])) exito = 0;
+	}
+	return exito;
+}
+
+// ===================================================================
+// CONSULTAS
+// ===================================================================
+
+/*
+ * Funcion: repositorio_buscar_vehiculo
+ * Descripcion: Busca un vehiculo por placa. Con el motor de texto se usa
+ *              el indice de placas sobre vehiculos.txt
+ * Parametros: placa, vehiculo (salida)
+ * Retorno: 1 si lo encontro, 0 si no
+ */
+int repositorio_buscar_vehiculo(const char* placa, DatosVehiculo* vehiculo) {
+	char linea[MAX_VALOR_REGISTRO];
+	if (repositorio_usa_proyecciones(TABLA_VEHICULOS)) return indice_buscar_placa(placa, vehiculo);
+	return repositorio_obtener(TABLA_VEHICULOS, placa, linea, sizeof(linea)) &&
+		   leer_linea_vehiculo(linea, vehiculo);
+}
+
+// ===================================================================
+// COMPARACION DE MOTORES
+// ===================================================================
+
+/*
+ * Estructura: ResultadoComparacion
+ * Descripcion: Segundos de cada fase de la prueba de un motor
+ */
+typedef struct {
+	double guardar;
+	double obtener;
+	double actualizar;
+	double recorrer;
+	int encontrados;
+	long recorridos;
+	int exito;
+} ResultadoComparacion;
+
+static const TablaRepositorio tabla_prueba = {"prueba", CARPETA_DATOS "/prueba.txt", 0, 0, '|'};
+
+/*
+ * Funcion: registro_prueba
+ * Descripcion: Arma la clave y la linea del registro i de la prueba
+ */
+static void registro_prueba(int i, int estado, char* clave, char* valor) {
+	sprintf(clave, "PRB-%07d", i);
+	sprintf(valor, "%s|17%08d|Propietario de prueba %d|PARTICULAR|LIVIANO|2020|15000.00|1600|%d",
+			clave, i, i, estado);
+}
+
+/*
+ * Funcion: siguiente_aleatorio
+ * Descripcion: Generador congruencial: la misma secuencia para cada motor
+ */
+static unsigned int siguiente_aleatorio(unsigned int* estado) {
+	*estado = *estado * 1103515245u + 12345u;
+	return (*estado >> 8) & 0xFFFFFFu;
+}
+
+static int contar_registro(const char* clave, const char* valor, void* contexto) {
+	(void)clave;
+	(void)valor;
+	(*(long*)contexto)++;
+	return 1;
+}
+
+/*
+ * Funcion: comparar_motor
+ * Descripcion: Ejecuta la misma carga sobre un motor: guardar n registros
+ *              en orden desordenado, n lecturas al azar, n/10
+ *              actualizaciones al azar y un recorrido completo
+ */
+static void comparar_motor(const MotorAlmacen* motor, int n, ResultadoComparacion* resultado) {
+	char clave[MAX_CLAVE_REGISTRO], valor[MAX_VALOR_REGISTRO];
+	unsigned int azar = 20250101u;
+	clock_t inicio;
+
+	memset(resultado, 0, sizeof(*resultado));
+	if (!motor->abrir(&tabla_prueba) || !motor->vaciar(&tabla_prueba)) return;
+
+	// 7919 es primo: i * 7919 % n recorre todos los registros si n no es multiplo
+	int paso = (n % 7919 == 0) ? 1 : 7919;
+	int exito = 1;
+	inicio = clock();
+	for (int i = 0; exito && i < n; i++) {
+		int numero = (int)(((long long)i * paso) % n);
+		registro_prueba(numero, 0, clave, valor);
+		exito = motor->guardar(&tabla_prueba, clave, valor);
+	}
+	exito = exito && motor->confirmar();
+	resultado->guardar = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+
+	inicio = clock();
+	for (int i = 0; exito && i < n; i++) {
+		char leido[MAX_VALOR_REGISTRO];
+		registro_prueba((int)(siguiente_aleatorio(&azar) % (unsigned int)n), 0, clave, valor);
+		if (motor->obtener(&tabla_prueba, clave, leido, sizeof(leido)) && strcmp(leido, valor) == 0) {
+			resultado->encontrados++;
+		}
+	}
+	resultado->obtener = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+
+	inicio = clock();
+	for (int i = 0; exito && i < n / 10; i++) {
+		registro_prueba((int)(siguiente_aleatorio(&azar) % (unsigned int)n), 1, clave, valor);
+		exito = motor->actualizar(&tabla_prueba, clave, valor);
+	}
+	exito = exito && motor->confirmar();
+	resultado->actualizar = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+
+	inicio = clock();
+	resultado->recorridos = 0;
+	if (exito) motor->recorrer(&tabla_prueba, contar_registro, &resultado->recorridos);
+	resultado->recorrer = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+
+	motor->vaciar(&tabla_prueba);
+	motor->confirmar();
+	resultado->exito = exito && resultado->encontrados == n && resultado->recorridos == n;
+}
+
+/*
+ * Funcion: menu_comparar_motores
+ * Descripcion: Compara los motores compilados con la misma carga de
+ *              trabajo sobre una tabla de prueba en la carpeta datos
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_comparar_motores(void) {
+	char buffer[20];
+	int n = REGISTROS_COMPARACION;
+
+	limpiar_pantalla();
+	printf("=== COMPARACION DE MOTORES DE ALMACENAMIENTO ===\n\n");
+	printf("Motores vigentes (%s):", ARCHIVO_CONFIG_ALMACEN);
+	for (int t = 0; t < NUM_TABLAS_REPOSITORIO; t++) {
+		printf(" %s=%s", tablas_repositorio[t].nombre, repositorio_nombre_motor(t));
+	}
+	printf("\n");
+	printf("Registros de prueba [%d]: ", REGISTROS_COMPARACION);
+	if (fgets(buffer, sizeof(buffer), stdin)) {
+		int leido;
+		if (sscanf(buffer, "%d", &leido) == 1 && leido > 0) n = leido;
+	}
+
+	crear_carpeta_datos();
+	printf("\nCarga: %d guardar, %d obtener, %d actualizar y un recorrido.\n\n", n, n, n / 10);
+	printf("%-10s %12s %12s %12s %12s  %s\n", "MOTOR", "GUARDAR(s)", "OBTENER(s)", "ACTUALIZ.(s)", "RECORRER(s)", "RESULTADO");
+	printf("---------------------------------------------------------------------------\n");
+
+	const MotorAlmacen* abiertos[NUM_TABLAS_REPOSITORIO];
+	int cantidad_abiertos = motores_en_uso(abiertos);
+	for (int i = 0; i < NUM_MOTORES; i++) {
+		ResultadoComparacion resultado;
+		comparar_motor(motores[i], n, &resultado);
+		printf("%-10s %12.3f %12.3f %12.3f %12.3f  %s\n", motores[i]->nombre, resultado.guardar,
+			   resultado.obtener, resultado.actualizar, resultado.recorrer, resultado.exito ? "OK" : "ERROR");
+
+		// Los motores que no usa ninguna tabla no quedan abiertos
+		int en_uso = 0;
+		for (int j = 0; j < cantidad_abiertos; j++) {
+			if (abiertos[j] == motores[i]) en_uso = 1;
+		}
+		if (!en_uso) motores[i]->cerrar();
+	}
+	printf("---------------------------------------------------------------------------\n");
+	remove(tabla_prueba.archivo);
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
@@ -0,0 +1,132 @@
+/*
+ * repositorio.h - Libreria del repositorio de vehiculos, comprobantes y pagos
+ *
+ * Descripcion: Este archivo contiene las tablas, la interfaz de los motores
+ *              de almacenamiento y los prototipos del repositorio. Cada
+ *              registro es la misma linea de texto que guardan los archivos
+ *              de siempre y se busca por su clave (placa, numero de
+ *              comprobante o numero de certificado). El motor se elige en
+ *              almacen.cfg, para todas las tablas o para una sola:
+ *                  texto   - Los archivos de proyeccion (por defecto)
+ *                  binario - Un archivo de registros por tabla con indice hash
+ *                  sqlite  - Una base SQLite (compilar con -DUSAR_SQLITE)
+ *                  lsm     - Tabla en memoria y archivos ordenados por niveles
+ *              Los archivos de texto siguen siendo las proyecciones del
+ *              registro de eventos; los otros motores reciben una copia de
+ *              cada registro y atienden las consultas por clave.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef REPOSITORIO_H
+#define REPOSITORIO_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "matricula.h"
+#include "orden_externo.h"
+
+// ===================================================================
+// CONSTANTES DEL REPOSITORIO
+// ===================================================================
+
+#define ARCHIVO_CONFIG_ALMACEN "almacen.cfg"           // motor = texto | binario | sqlite | lsm
+#define CLAVE_MOTOR_TABLA "motor."                     // motor.<tabla> = ... cambia el motor de una tabla
+#define CARPETA_DATOS "datos"                          // Archivos de los motores binario, SQLite y LSM
+#define ARCHIVO_SINCRONIZADO "datos/sincronizado.txt"  // Motor al dia con los archivos de texto
+#define MOTOR_POR_DEFECTO "texto"
+
+#define MAX_CLAVE_REGISTRO 50            // Igual que numero_comprobante
+#define MAX_VALOR_REGISTRO 500           // Igual que MAX_DATOS_EVENTO
+#define MAX_NOMBRE_MOTOR 20
+
+// Tablas del repositorio
+#define TABLA_VEHICULOS 0                // vehiculos.txt, clave placa
+#define TABLA_COMPROBANTES 1             // Particiones de comprobantes, clave numero
+#define TABLA_PAGOS 2                    // Particiones de pagos, clave numero de comprobante
+#define TABLA_MATRICULADOS 3             // vehiculos_matriculados.txt, clave certificado
+#define NUM_TABLAS_REPOSITORIO 4
+
+// Comparacion de motores
+#define REGISTROS_COMPARACION 2000       // Registros por defecto de la prueba
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: TablaRepositorio
+ * Descripcion: Donde guarda cada motor una tabla y cual campo de la linea
+ *              es la clave
+ */
+typedef struct {
+	const char* nombre;          // Nombre en los otros motores y en almacen.cfg
+	const char* archivo;         // Archivo del motor de texto (NULL = particionada)
+	int particion;               // PARTICION_* si el archivo de texto esta particionado
+	int campo_clave;             // Campo de la linea que es la clave
+	char separador;              // Separador de campos de la linea
+} TablaRepositorio;
+
+// Funcion llamada por cada registro al recorrer una tabla (0 = detener)
+typedef int (*FuncionRegistro)(const char* clave, const char* valor, void* contexto);
+
+/*
+ * Estructura: MotorAlmacen
+ * Descripcion: Operaciones de un motor de almacenamiento. Todas reciben la
+ *              tabla; los valores son lineas sin salto de linea
+ */
+typedef struct {
+	const char* nombre;
+	int usa_proyecciones;        // 1 si sus datos son los archivos de proyeccion
+	int (*abrir)(const TablaRepositorio* tabla);       // 1 abierta, 2 recien creada, 0 error
+	int (*obtener)(const TablaRepositorio* tabla, const char* clave, char* valor, size_t tamano);
+	int (*guardar)(const TablaRepositorio* tabla, const char* clave, const char* valor);     // Agrega o reemplaza
+	int (*actualizar)(const TablaRepositorio* tabla, const char* clave, const char* valor);  // Solo si existe
+	long (*recorrer)(const TablaRepositorio* tabla, FuncionRegistro funcion, void* contexto);
+	long (*recorrer_prefijo)(const TablaRepositorio* tabla, const char* prefijo,  // NULL = recorrer y filtrar
+							 FuncionRegistro funcion, void* contexto);
+	int (*vaciar)(const TablaRepositorio* tabla);
+	int (*confirmar)(void);      // Lleva al disco lo escrito desde la ultima confirmacion
+	int (*cerrar)(void);         // 1 si todo quedo en el disco, 0 si no
+} MotorAlmacen;
+
+extern const MotorAlmacen motor_texto;
+extern const TablaRepositorio tablas_repositorio[NUM_TABLAS_REPOSITORIO];
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones del motor
+const MotorAlmacen* repositorio_buscar_motor(const char* nombre);
+int repositorio_iniciar(void);
+void repositorio_cerrar(void);
+int repositorio_recargar(void);
+const char* repositorio_nombre_motor(int tabla);
+int repositorio_usa_proyecciones(int tabla);
+
+// Operaciones por clave
+int repositorio_obtener(int tabla, const char* clave, char* valor, size_t tamano);
+int repositorio_guardar(int tabla, const char* clave, const char* valor);
+int repositorio_actualizar(int tabla, const char* clave, const char* valor);
+long repositorio_recorrer(int tabla, FuncionRegistro funcion, void* contexto);
+long repositorio_recorrer_prefijo(int tabla, const char* prefijo, FuncionRegistro funcion, void* contexto);
+long repositorio_recorrer_ordenado(int tabla, int criterio, int campo, FuncionRegistro funcion, void* contexto);
+int repositorio_confirmar(void);
+
+// Funciones de proyecciones
+int repositorio_clave_de_linea(const TablaRepositorio* tabla, const char* linea, char* clave, size_t tamano);
+int repositorio_proyectar(int tabla, const char* linea);
+int repositorio_vaciar_proyecciones(void);
+
+// Consultas
+int repositorio_buscar_vehiculo(const char* placa, DatosVehiculo* vehiculo);
+
+// Funciones de interfaz
+void menu_comparar_motores(void);
+
+#endif // REPOSITORIO_H
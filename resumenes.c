@@ -0,0 +1,721 @@
+/*
+ * resumenes.c - Implementacion de los resumenes estadisticos aproximados
+ *
+ * Descripcion: Este archivo implementa los resumenes de pagos y
+ *              vehiculos, incluyendo:
+ *              - t-digest para percentiles de montos, con centroides
+ *                pequenos en los extremos y grandes en el centro
+ *              - HyperLogLog para contar cedulas distintas por dia
+ *              - Actualizacion con las lineas agregadas desde la ultima
+ *                vez, usando el tamano del archivo ya resumido
+ *              - Combinacion de resumenes de varias particiones
+ *              - Reporte de avaluos y pagos
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "resumenes.h"
+#include "particiones.h"
+#include "pagos.h"
+#include "vehiculos.h"
+#include <sys/stat.h>
+#include <math.h>
+
+#define PI_RESUMEN 3.14159265358979323846
+#define MAX_LINEA_RESUMEN 512
+
+// ===================================================================
+// ESTRUCTURAS INTERNAS
+// ===================================================================
+
+/*
+ * Estructura: DescripcionResumen
+ * Descripcion: Campos que se resumen de cada tabla
+ */
+typedef struct {
+	char separador;
+	int campo_monto;
+	int campo_cedula;
+	int campo_fecha;             // -1 si la linea no tiene fecha
+} DescripcionResumen;
+
+static const DescripcionResumen tablas_resumen[3] = {
+	{0, 0, 0, -1},
+	{'|', 3, 6, 2},              // numero|placa|fecha_pago|monto|tipo|referencia|cedula|nombre
+	{',', 6, 1, -1}              // placa,cedula,nombre,tipo,subtipo,ano,avaluo,cilindraje
+};
+
+/*
+ * Estructura: CabeceraResumen
+ * Descripcion: Inicio del archivo de un resumen. Le siguen los centroides
+ *              y los registros HyperLogLog de los dias con pagos
+ */
+typedef struct {
+	char magia[4];
+	int32_t centroides;
+	int64_t tamano_cubierto;
+	int64_t registros;
+	int64_t suma;
+	double peso_total;
+	double minimo;
+	double maximo;
+	int64_t registros_dia[MAX_DIAS_RESUMEN];
+} CabeceraResumen;
+
+// ===================================================================
+// PERCENTILES (T-DIGEST)
+// ===================================================================
+
+/*
+ * Funcion: escala_k
+ * Descripcion: Posicion de un cuantil en la escala k del t-digest. Un
+ *              centroide puede abarcar una unidad de k: cerca de 0 y de 1
+ *              la escala crece rapido y los centroides quedan pequenos
+ */
+static double escala_k(double cuantil) {
+	return COMPRESION_CUANTILES / (2 * PI_RESUMEN) * asin(2 * cuantil - 1);
+}
+
+/*
+ * Funcion: cuantil_de_k
+ * Descripcion: Inversa de escala_k
+ */
+static double cuantil_de_k(double k) {
+	if (k >= COMPRESION_CUANTILES / 4.0) return 1;
+	return (sin(k * 2 * PI_RESUMEN / COMPRESION_CUANTILES) + 1) / 2;
+}
+
+static int comparar_centroides(const void* a, const void* b) {
+	double x = ((const Centroide*)a)->media;
+	double y = ((const Centroide*)b)->media;
+	return (x > y) - (x < y);
+}
+
+/*
+ * Funcion: compactar_cuantiles
+ * Descripcion: Junta los valores pendientes con los centroides. Se
+ *              ordena todo por media y se recorre una vez, uniendo cada
+ *              centroide con el siguiente mientras el peso acumulado no
+ *              pase el limite de la escala k
+ */
+static void compactar_cuantiles(ResumenCuantiles* resumen) {
+	Centroide todos[MAX_CENTROIDES + MAX_PENDIENTES_CUANTILES];
+	int cantidad = resumen->cantidad;
+
+	if (resumen->cantidad_pendientes == 0) return;
+	memcpy(todos, resumen->centroides, (size_t)cantidad * sizeof(Centroide));
+	memcpy(todos + cantidad, resumen->pendientes, (size_t)resumen->cantidad_pendientes * sizeof(Centroide));
+	cantidad += resumen->cantidad_pendientes;
+	qsort(todos, (size_t)cantidad, sizeof(Centroide), comparar_centroides);
+
+	double total = resumen->peso_total;
+	double acumulado = 0;
+	double limite = total * cuantil_de_k(escala_k(0) + 1);
+	Centroide actual = todos[0];
+
+	resumen->cantidad = 0;
+	for (int i = 1; i < cantidad; i++) {
+		if (acumulado + actual.peso + todos[i].peso <= limite || resumen->cantidad == MAX_CENTROIDES - 1) {
+			actual.peso += todos[i].peso;
+			actual.media += (todos[i].media - actual.media) * todos[i].peso / actual.peso;
+		} else {
+			acumulado += actual.peso;
+			resumen->centroides[resumen->cantidad++] = actual;
+			limite = total * cuantil_de_k(escala_k(acumulado / total) + 1);
+			actual = todos[i];
+		}
+	}
+	resumen->centroides[resumen->cantidad++] = actual;
+	resumen->cantidad_pendientes = 0;
+}
+
+/*
+ * Funcion: cuantiles_iniciar
+ * Descripcion: Deja un resumen de percentiles vacio
+ * Parametros: resumen
+ * Retorno: void
+ */
+void cuantiles_iniciar(ResumenCuantiles* resumen) {
+	resumen->cantidad = 0;
+	resumen->cantidad_pendientes = 0;
+	resumen->peso_total = 0;
+	resumen->minimo = 0;
+	resumen->maximo = 0;
+}
+
+/*
+ * Funcion: cuantiles_agregar
+ * Descripcion: Agrega un valor (o un centroide de otro resumen) con su peso
+ * Parametros: resumen, valor, peso - Cantidad de valores que representa
+ * Retorno: void
+ */
+void cuantiles_agregar(ResumenCuantiles* resumen, double valor, double peso) {
+	if (peso <= 0) return;
+	if (resumen->cantidad_pendientes == MAX_PENDIENTES_CUANTILES) compactar_cuantiles(resumen);
+
+	if (resumen->peso_total == 0) {
+		resumen->minimo = valor;
+		resumen->maximo = valor;
+	} else if (valor < resumen->minimo) {
+		resumen->minimo = valor;
+	} else if (valor > resumen->maximo) {
+		resumen->maximo = valor;
+	}
+	resumen->pendientes[resumen->cantidad_pendientes].media = valor;
+	resumen->pendientes[resumen->cantidad_pendientes].peso = peso;
+	resumen->cantidad_pendientes++;
+	resumen->peso_total += peso;
+}
+
+/*
+ * Funcion: cuantiles_combinar
+ * Descripcion: Agrega a un resumen todos los valores de otro. El
+ *              resultado es el resumen de la union de los dos conjuntos
+ * Parametros: destino, origen
+ * Retorno: void
+ */
+void cuantiles_combinar(ResumenCuantiles* destino, const ResumenCuantiles* origen) {
+	if (origen->peso_total == 0) return;
+
+	double minimo = origen->minimo, maximo = origen->maximo;
+	for (int i = 0; i < origen->cantidad; i++) {
+		cuantiles_agregar(destino, origen->centroides[i].media, origen->centroides[i].peso);
+	}
+	for (int i = 0; i < origen->cantidad_pendientes; i++) {
+		cuantiles_agregar(destino, origen->pendientes[i].media, origen->pendientes[i].peso);
+	}
+	// Las medias de los centroides no llegan a los extremos del origen
+	if (minimo < destino->minimo) destino->minimo = minimo;
+	if (maximo > destino->maximo) destino->maximo = maximo;
+}
+
+/*
+ * Funcion: cuantiles_valor
+ * Descripcion: Valor aproximado de un cuantil. Se interpola entre los
+ *              centros de los centroides vecinos, y entre el minimo o el
+ *              maximo y el primer o el ultimo centroide
+ * Parametros: resumen, cuantil - Entre 0 y 1 (0.5 = mediana)
+ * Retorno: Valor del cuantil, 0 si el resumen esta vacio
+ */
+double cuantiles_valor(ResumenCuantiles* resumen, double cuantil) {
+	compactar_cuantiles(resumen);
+	if (resumen->cantidad == 0) return 0;
+	if (cuantil <= 0) return resumen->minimo;
+	if (cuantil >= 1) return resumen->maximo;
+
+	const Centroide* c = resumen->centroides;
+	double objetivo = cuantil * resumen->peso_total;
+	double acumulado = 0;
+
+	if (objetivo < c[0].peso / 2) {
+		return resumen->minimo + (c[0].media - resumen->minimo) * objetivo / (c[0].peso / 2);
+	}
+	for (int i = 0; i + 1 < resumen->cantidad; i++) {
+		double centro = acumulado + c[i].peso / 2;
+		double siguiente = acumulado + c[i].peso + c[i + 1].peso / 2;
+		if (objetivo < siguiente) {
+			return c[i].media + (c[i + 1].media - c[i].media) * (objetivo - centro) / (siguiente - centro);
+		}
+		acumulado += c[i].peso;
+	}
+
+	const Centroide* ultimo = &c[resumen->cantidad - 1];
+	double centro = resumen->peso_total - ultimo->peso / 2;
+	return ultimo->media + (resumen->maximo - ultimo->media) * (objetivo - centro) / (ultimo->peso / 2);
+}
+
+// ===================================================================
+// CEDULAS DISTINTAS (HYPERLOGLOG)
+// ===================================================================
+
+/*
+ * Funcion: hash_distintos
+ * Descripcion: Hash de 64 bits de un texto: FNV-1a y la mezcla final de
+ *              MurmurHash3, para que todos los bits dependan de todo el
+ *              texto (los bits altos eligen el registro)
+ */
+static uint64_t hash_distintos(const char* texto) {
+	uint64_t hash = 14695981039346656037ull;
+	for (; *texto; texto++) {
+		hash ^= (unsigned char)*texto;
+		hash *= 1099511628211ull;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+/*
+ * Funcion: ceros_iniciales
+ * Descripcion: Bits en 0 antes del primer 1 de una palabra distinta de 0
+ */
+static int ceros_iniciales(uint64_t palabra) {
+#ifdef __GNUC__
+	return __builtin_clzll(palabra);
+#else
+	int ceros = 0;
+	while (!(palabra & 0x8000000000000000ull)) {
+		palabra <<= 1;
+		ceros++;
+	}
+	return ceros;
+#endif
+}
+
+/*
+ * Funcion: distintos_iniciar
+ * Descripcion: Deja un contador de distintos vacio
+ * Parametros: resumen
+ * Retorno: void
+ */
+void distintos_iniciar(ResumenDistintos* resumen) {
+	memset(resumen->registros, 0, sizeof(resumen->registros));
+}
+
+/*
+ * Funcion: distintos_agregar
+ * Descripcion: Cuenta un texto. Agregar el mismo texto otra vez no cambia
+ *              el resumen
+ * Parametros: resumen, texto
+ * Retorno: void
+ */
+void distintos_agregar(ResumenDistintos* resumen, const char* texto) {
+	uint64_t hash = hash_distintos(texto);
+	uint32_t registro = (uint32_t)(hash >> (64 - BITS_DISTINTOS));
+	// El bit agregado limita la racha cuando los bits restantes son todos 0
+	uint64_t resto = (hash << BITS_DISTINTOS) | ((uint64_t)1 << (BITS_DISTINTOS - 1));
+	uint8_t racha = (uint8_t)(ceros_iniciales(resto) + 1);
+
+	if (racha > resumen->registros[registro]) resumen->registros[registro] = racha;
+}
+
+/*
+ * Funcion: distintos_combinar
+ * Descripcion: Agrega a un contador los textos de otro. Un texto contado
+ *              en los dos se cuenta una sola vez
+ * Parametros: destino, origen
+ * Retorno: void
+ */
+void distintos_combinar(ResumenDistintos* destino, const ResumenDistintos* origen) {
+	for (int i = 0; i < REGISTROS_DISTINTOS; i++) {
+		if (origen->registros[i] > destino->registros[i]) destino->registros[i] = origen->registros[i];
+	}
+}
+
+/*
+ * Funcion: distintos_estimar
+ * Descripcion: Estimacion de la cantidad de textos distintos. Con pocos
+ *              textos (muchos registros en 0) se usa el conteo lineal,
+ *              que es casi exacto
+ * Parametros: resumen
+ * Retorno: Cantidad aproximada de textos distintos
+ */
+double distintos_estimar(const ResumenDistintos* resumen) {
+	double m = REGISTROS_DISTINTOS;
+	double suma = 0;
+	int ceros = 0;
+
+	for (int i = 0; i < REGISTROS_DISTINTOS; i++) {
+		suma += ldexp(1.0, -resumen->registros[i]);
+		if (resumen->registros[i] == 0) ceros++;
+	}
+
+	double estimacion = 0.7213 / (1 + 1.079 / m) * m * m / suma;
+	if (estimacion <= 2.5 * m && ceros > 0) {
+		estimacion = m * log(m / ceros);
+	}
+	return estimacion;
+}
+
+// ===================================================================
+// RESUMENES DE PARTICION
+// ===================================================================
+
+/*
+ * Funcion: resumen_crear
+ * Descripcion: Reserva un resumen vacio (unos 140 KB)
+ * Retorno: Resumen a liberar con free, NULL si no hay memoria
+ */
+ResumenParticion* resumen_crear(void) {
+	ResumenParticion* resumen = malloc(sizeof(ResumenParticion));
+	if (resumen) resumen_vaciar(resumen);
+	return resumen;
+}
+
+/*
+ * Funcion: resumen_vaciar
+ * Descripcion: Deja un resumen como el de un archivo vacio
+ * Parametros: resumen
+ * Retorno: void
+ */
+void resumen_vaciar(ResumenParticion* resumen) {
+	memset(resumen, 0, sizeof(ResumenParticion));
+	cuantiles_iniciar(&resumen->montos);
+}
+
+/*
+ * Funcion: resumen_combinar
+ * Descripcion: Agrega a un resumen los datos de otro, por ejemplo el de
+ *              otra particion o el de otra agencia
+ * Parametros: destino, origen
+ * Retorno: void
+ */
+void resumen_combinar(ResumenParticion* destino, const ResumenParticion* origen) {
+	destino->registros += origen->registros;
+	destino->suma += origen->suma;
+	cuantiles_combinar(&destino->montos, &origen->montos);
+	for (int dia = 0; dia < MAX_DIAS_RESUMEN; dia++) {
+		if (origen->registros_dia[dia] == 0) continue;
+		destino->registros_dia[dia] += origen->registros_dia[dia];
+		distintos_combinar(&destino->cedulas[dia], &origen->cedulas[dia]);
+	}
+}
+
+/*
+ * Funcion: resumen_ruta
+ * Descripcion: Arma la ruta del archivo de resumen de una tabla
+ * Parametros: ruta (MAX_RUTA_PARTICION bytes), tabla, periodo - Solo para pagos
+ * Retorno: void
+ */
+void resumen_ruta(char* ruta, int tabla, int periodo) {
+	if (tabla == RESUMEN_VEHICULOS) {
+		strcpy(ruta, ARCHIVO_RESUMEN_VEHICULOS);
+	} else if (periodo == PERIODO_LEGADO) {
+		snprintf(ruta, MAX_RUTA_PARTICION, "%s/resumen_legado.bin", CARPETA_PAGOS);
+	} else {
+		snprintf(ruta, MAX_RUTA_PARTICION, "%s/resumen_%06d.bin", CARPETA_PAGOS, periodo);
+	}
+}
+
+/*
+ * Funcion: ruta_datos
+ * Descripcion: Ruta del archivo que resume cada tabla
+ */
+static void ruta_datos(char* ruta, int tabla, int periodo) {
+	if (tabla == RESUMEN_VEHICULOS) {
+		strcpy(ruta, ARCHIVO_VEHICULOS);
+	} else {
+		particion_ruta(ruta, PARTICION_PAGOS, periodo);
+	}
+}
+
+/*
+ * Funcion: resumen_cargar
+ * Descripcion: Lee un resumen guardado con resumen_guardar
+ * Parametros: ruta, resumen (salida)
+ * Retorno: 1 si fue exitoso, 0 si no existe o esta danado
+ */
+int resumen_cargar(const char* ruta, ResumenParticion* resumen) {
+	CabeceraResumen cabecera;
+	FILE* archivo = fopen(ruta, "rb");
+
+	resumen_vaciar(resumen);
+	if (!archivo) return 0;
+
+	int exito = fread(&cabecera, sizeof(cabecera), 1, archivo) == 1 &&
+				memcmp(cabecera.magia, MAGIA_RESUMEN, 4) == 0 &&
+				cabecera.centroides >= 0 && cabecera.centroides <= MAX_CENTROIDES &&
+				fread(resumen->montos.centroides, sizeof(Centroide), (size_t)cabecera.centroides, archivo) ==
+					(size_t)cabecera.centroides;
+	for (int dia = 0; exito && dia < MAX_DIAS_RESUMEN; dia++) {
+		resumen->registros_dia[dia] = (long)cabecera.registros_dia[dia];
+		if (cabecera.registros_dia[dia] > 0) {
+			exito = fread(resumen->cedulas[dia].registros, REGISTROS_DISTINTOS, 1, archivo) == 1;
+		}
+	}
+	fclose(archivo);
+
+	if (!exito) {
+		resumen_vaciar(resumen);
+		return 0;
+	}
+	resumen->tamano_cubierto = (long)cabecera.tamano_cubierto;
+	resumen->registros = (long)cabecera.registros;
+	resumen->suma = cabecera.suma;
+	resumen->montos.cantidad = cabecera.centroides;
+	resumen->montos.peso_total = cabecera.peso_total;
+	resumen->montos.minimo = cabecera.minimo;
+	resumen->montos.maximo = cabecera.maximo;
+	return 1;
+}
+
+/*
+ * Funcion: resumen_guardar
+ * Descripcion: Guarda un resumen en un archivo temporal y lo renombra,
+ *              para que una lectura nunca encuentre un resumen a medias.
+ *              Solo se guardan los registros de los dias con datos
+ * Parametros: ruta, resumen - Se compactan sus percentiles pendientes
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int resumen_guardar(const char* ruta, ResumenParticion* resumen) {
+	char ruta_temporal[MAX_RUTA_PARTICION + 4];
+	CabeceraResumen cabecera;
+
+	compactar_cuantiles(&resumen->montos);
+	memset(&cabecera, 0, sizeof(cabecera));
+	memcpy(cabecera.magia, MAGIA_RESUMEN, 4);
+	cabecera.centroides = resumen->montos.cantidad;
+	cabecera.tamano_cubierto = resumen->tamano_cubierto;
+	cabecera.registros = resumen->registros;
+	cabecera.suma = resumen->suma;
+	cabecera.peso_total = resumen->montos.peso_total;
+	cabecera.minimo = resumen->montos.minimo;
+	cabecera.maximo = resumen->montos.maximo;
+	for (int dia = 0; dia < MAX_DIAS_RESUMEN; dia++) {
+		cabecera.registros_dia[dia] = resumen->registros_dia[dia];
+	}
+
+	snprintf(ruta_temporal, sizeof(ruta_temporal), "%s.tmp", ruta);
+	FILE* archivo = fopen(ruta_temporal, "wb");
+	if (!archivo) return 0;
+
+	int exito = fwrite(&cabecera, sizeof(cabecera), 1, archivo) == 1 &&
+				fwrite(resumen->montos.centroides, sizeof(Centroide), (size_t)resumen->montos.cantidad, archivo) ==
+					(size_t)resumen->montos.cantidad;
+	for (int dia = 0; exito && dia < MAX_DIAS_RESUMEN; dia++) {
+		if (resumen->registros_dia[dia] > 0) {
+			exito = fwrite(resumen->cedulas[dia].registros, REGISTROS_DISTINTOS, 1, archivo) == 1;
+		}
+	}
+	if (fclose(archivo) != 0) exito = 0;
+	if (!exito) {
+		remove(ruta_temporal);
+		return 0;
+	}
+	remove(ruta);
+	return rename(ruta_temporal, ruta) == 0;
+}
+
+/*
+ * Funcion: campo_linea
+ * Descripcion: Copia el campo numero 'indice' de una linea sin el salto
+ *              de linea final
+ */
+static int campo_linea(const char* linea, char separador, int indice, char* destino, size_t tamano) {
+	for (int i = 0; i < indice; i++) {
+		linea = strchr(linea, separador);
+		if (!linea) return 0;
+		linea++;
+	}
+	size_t largo = strcspn(linea, separador == '|' ? "|\r\n" : ",\r\n");
+	if (largo >= tamano) largo = tamano - 1;
+	memcpy(destino, linea, largo);
+	destino[largo] = '\0';
+	return 1;
+}
+
+/*
+ * Funcion: agregar_linea
+ * Descripcion: Agrega al resumen el monto y la cedula de una linea. Las
+ *              lineas sin un monto legible no se cuentan
+ */
+static void agregar_linea(ResumenParticion* resumen, int tabla, const char* linea) {
+	const DescripcionResumen* descripcion = &tablas_resumen[tabla];
+	char monto_texto[MAX_TEXTO_DINERO], cedula[20], fecha[24];
+	Dinero monto;
+	int dia = 0;
+
+	if (!campo_linea(linea, descripcion->separador, descripcion->campo_monto, monto_texto, sizeof(monto_texto)) ||
+		!dinero_leer(monto_texto, &monto)) {
+		return;
+	}
+	if (descripcion->campo_fecha >= 0 &&
+		campo_linea(linea, descripcion->separador, descripcion->campo_fecha, fecha, sizeof(fecha))) {
+		int d, m, a;
+		if (sscanf(fecha, "%d/%d/%d", &d, &m, &a) == 3 && d >= 1 && d < MAX_DIAS_RESUMEN) dia = d;
+	}
+
+	resumen->registros++;
+	resumen->suma += monto;
+	cuantiles_agregar(&resumen->montos, (double)monto, 1);
+	resumen->registros_dia[dia]++;
+	if (campo_linea(linea, descripcion->separador, descripcion->campo_cedula, cedula, sizeof(cedula)) && cedula[0]) {
+		distintos_agregar(&resumen->cedulas[dia], cedula);
+	}
+}
+
+/*
+ * Funcion: resumen_actualizar
+ * Descripcion: Pone al dia el resumen guardado de un archivo y lo
+ *              devuelve. Como las particiones solo crecen, normalmente se
+ *              leen unicamente las lineas nuevas; si el archivo se acorto
+ *              o no hay resumen, se arma desde el principio
+ * Parametros: tabla (RESUMEN_*), periodo, resumen (salida)
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int resumen_actualizar(int tabla, int periodo, ResumenParticion* resumen) {
+	char ruta[MAX_RUTA_PARTICION], ruta_resumen[MAX_RUTA_PARTICION];
+	struct stat st;
+
+	ruta_datos(ruta, tabla, periodo);
+	resumen_ruta(ruta_resumen, tabla, periodo);
+	if (stat(ruta, &st) != 0) {
+		resumen_vaciar(resumen);
+		return 1;
+	}
+	if (!resumen_cargar(ruta_resumen, resumen) || (long)st.st_size < resumen->tamano_cubierto) {
+		resumen_vaciar(resumen);
+	}
+	if ((long)st.st_size == resumen->tamano_cubierto) return 1;
+
+	FILE* archivo = fopen(ruta, "rb");
+	if (!archivo) return 0;
+	fseek(archivo, resumen->tamano_cubierto, SEEK_SET);
+
+	char linea[MAX_LINEA_RESUMEN];
+	long posicion = resumen->tamano_cubierto;
+	while (fgets(linea, sizeof(linea), archivo)) {
+		size_t largo = strlen(linea);
+		if (linea[largo - 1] != '\n') break;   // Linea a medio escribir
+		agregar_linea(resumen, tabla, linea);
+		posicion += (long)largo;
+	}
+	fclose(archivo);
+
+	resumen->tamano_cubierto = posicion;
+	return resumen_guardar(ruta_resumen, resumen);
+}
+
+/*
+ * Funcion: resumen_rango
+ * Descripcion: Combina los resumenes de las particiones de un rango de
+ *              meses, poniendo al dia cada uno. El archivo anterior a las
+ *              particiones no tiene fechas y solo entra sin rango
+ * Parametros:
+ *   - tabla: RESUMEN_PAGOS o RESUMEN_VEHICULOS (sin particiones)
+ *   - periodo_desde, periodo_hasta: Rango AAAAMM (0 = sin limite)
+ *   - resumen: Salida
+ * Retorno: Cantidad de particiones combinadas, -1 si hubo error
+ */
+int resumen_rango(int tabla, int periodo_desde, int periodo_hasta, ResumenParticion* resumen) {
+	if (tabla == RESUMEN_VEHICULOS) {
+		return resumen_actualizar(tabla, 0, resumen) ? 1 : -1;
+	}
+
+	int periodos[MAX_PARTICIONES];
+	int cantidad = particion_listar(PARTICION_PAGOS, periodo_desde, periodo_hasta, periodos, MAX_PARTICIONES);
+	ResumenParticion* particion = resumen_crear();
+	int combinadas = 0;
+
+	resumen_vaciar(resumen);
+	if (!particion) return -1;
+	for (int i = 0; i < cantidad; i++) {
+		if (periodos[i] == PERIODO_LEGADO && (periodo_desde || periodo_hasta)) continue;
+		if (!resumen_actualizar(tabla, periodos[i], particion)) {
+			combinadas = -1;
+			break;
+		}
+		resumen_combinar(resumen, particion);
+		combinadas++;
+	}
+	free(particion);
+	return combinadas;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+/*
+ * Funcion: mostrar_percentiles
+ * Descripcion: Imprime los percentiles habituales de un resumen de montos
+ */
+static void mostrar_percentiles(ResumenCuantiles* montos) {
+	static const int percentiles[] = {10, 25, 50, 75, 90, 99};
+
+	for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+		char etiqueta[20];
+		Dinero valor = (Dinero)llround(cuantiles_valor(montos, percentiles[i] / 100.0));
+		snprintf(etiqueta, sizeof(etiqueta), "Percentil %d:", percentiles[i]);
+		printf("  %-35s $%.2f\n", etiqueta, dinero_a_decimal(valor));
+	}
+}
+
+/*
+ * Funcion: cedulas_distintas
+ * Descripcion: Cedulas distintas de todos los dias de un resumen
+ */
+static double cedulas_distintas(const ResumenParticion* resumen) {
+	ResumenDistintos todas;
+	distintos_iniciar(&todas);
+	for (int dia = 0; dia < MAX_DIAS_RESUMEN; dia++) {
+		if (resumen->registros_dia[dia] > 0) distintos_combinar(&todas, &resumen->cedulas[dia]);
+	}
+	return distintos_estimar(&todas);
+}
+
+/*
+ * Funcion: menu_estadisticas
+ * Descripcion: Muestra los percentiles de avaluos de la flota y, para un
+ *              rango de meses, los percentiles de los montos pagados y
+ *              los pagadores distintos. Con un solo mes se muestra el
+ *              detalle por dia
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_estadisticas(void) {
+	char buffer[100];
+	int desde = 0, hasta = 0;
+
+	limpiar_pantalla();
+	printf("=== ESTADISTICAS DE AVALUOS Y PAGOS ===\n\n");
+
+	printf("Desde (AAAAMM, Enter sin limite): ");
+	if (fgets(buffer, sizeof(buffer), stdin) && sscanf(buffer, "%d", &desde) != 1) desde = 0;
+	printf("Hasta (AAAAMM, Enter sin limite): ");
+	if (fgets(buffer, sizeof(buffer), stdin) && sscanf(buffer, "%d", &hasta) != 1) hasta = 0;
+
+	ResumenParticion* resumen = resumen_crear();
+	if (!resumen) {
+		printf("\nNo hay memoria suficiente para los resumenes.\n");
+		printf("\nPresione Enter para continuar...");
+		getchar();
+		return;
+	}
+
+	printf("\nAVALUOS DE LA FLOTA:\n");
+	printf("-------------------------------------------------------\n");
+	if (resumen_rango(RESUMEN_VEHICULOS, 0, 0, resumen) < 0 || resumen->registros == 0) {
+		printf("  No hay vehiculos registrados.\n");
+	} else {
+		printf("  %-35s %ld\n", "Vehiculos:", resumen->registros);
+		printf("  %-35s %.0f\n", "Propietarios distintos (aprox.):", cedulas_distintas(resumen));
+		printf("  %-35s $%.2f\n", "Promedio:", dinero_a_decimal(resumen->suma / resumen->registros));
+		mostrar_percentiles(&resumen->montos);
+	}
+
+	printf("\nPAGOS DE MATRICULA:\n");
+	printf("-------------------------------------------------------\n");
+	int particiones = resumen_rango(RESUMEN_PAGOS, desde, hasta, resumen);
+	if (particiones < 0) {
+		printf("  No se pudieron leer los resumenes de pagos.\n");
+	} else if (resumen->registros == 0) {
+		printf("  No hay pagos en el rango.\n");
+	} else {
+		printf("  %-35s %d\n", "Meses:", particiones);
+		printf("  %-35s %ld\n", "Pagos:", resumen->registros);
+		printf("  %-35s $%.2f\n", "Total recaudado:", dinero_a_decimal(resumen->suma));
+		printf("  %-35s %.0f\n", "Pagadores distintos (aprox.):", cedulas_distintas(resumen));
+		mostrar_percentiles(&resumen->montos);
+
+		// El detalle por dia solo tiene sentido dentro de un mismo mes
+		if (desde != 0 && desde == hasta) {
+			printf("\n  %-12s %10s %22s\n", "Dia", "Pagos", "Pagadores distintos");
+			for (int dia = 1; dia < MAX_DIAS_RESUMEN; dia++) {
+				if (resumen->registros_dia[dia] == 0) continue;
+				printf("  %02d/%02d/%04d   %10ld %22.0f\n", dia, desde % 100, desde / 100,
+					   resumen->registros_dia[dia], distintos_estimar(&resumen->cedulas[dia]));
+			}
+		}
+	}
+	free(resumen);
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
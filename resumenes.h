@@ -0,0 +1,134 @@
+/*
+ * resumenes.h - Libreria de resumenes estadisticos aproximados
+ *
+ * Descripcion: Este archivo contiene las estructuras y prototipos de los
+ *              resumenes de cada particion de pagos y de vehiculos.txt.
+ *              Un resumen guarda, en pocos KB y sin ordenar los datos, los
+ *              percentiles aproximados de los montos (t-digest) y la
+ *              cantidad aproximada de cedulas distintas de cada dia
+ *              (HyperLogLog). Los resumenes se ponen al dia con las lineas
+ *              nuevas cada vez que se escribe la particion, se guardan
+ *              junto a ella y se pueden combinar: el resumen de un rango
+ *              de meses, o de los datos de otra agencia, es la
+ *              combinacion de sus resumenes.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef RESUMENES_H
+#define RESUMENES_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "dinero.h"
+
+// ===================================================================
+// CONSTANTES DE RESUMENES
+// ===================================================================
+
+// Tablas resumidas
+#define RESUMEN_PAGOS 1                  // pagos/resumen_AAAAMM.bin (monto y cedula_pagador)
+#define RESUMEN_VEHICULOS 2              // resumen_vehiculos.bin (avaluo y cedula del propietario)
+
+#define ARCHIVO_RESUMEN_VEHICULOS "resumen_vehiculos.bin"
+#define MAGIA_RESUMEN "RSM1"
+
+// Percentiles (t-digest): el error es menor en los extremos que en la mediana
+#define COMPRESION_CUANTILES 100
+#define MAX_CENTROIDES COMPRESION_CUANTILES
+#define MAX_PENDIENTES_CUANTILES 400     // Valores acumulados antes de compactar
+
+// Cedulas distintas (HyperLogLog): error tipico de 1.04 / sqrt(REGISTROS_DISTINTOS) = 1.6%
+#define BITS_DISTINTOS 12
+#define REGISTROS_DISTINTOS (1 << BITS_DISTINTOS)
+
+#define MAX_DIAS_RESUMEN 32              // Dia 1-31; 0 = sin fecha legible
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: Centroide
+ * Descripcion: Grupo de valores cercanos representado por su media
+ */
+typedef struct {
+	double media;
+	double peso;
+} Centroide;
+
+/*
+ * Estructura: ResumenCuantiles
+ * Descripcion: t-digest. Los centroides cerca de los extremos agrupan
+ *              pocos valores y los del centro muchos, asi que los
+ *              percentiles altos y bajos son casi exactos
+ */
+typedef struct {
+	Centroide centroides[MAX_CENTROIDES];    // Ordenados por media
+	int cantidad;
+	Centroide pendientes[MAX_PENDIENTES_CUANTILES];
+	int cantidad_pendientes;
+	double peso_total;                       // Incluye los pendientes
+	double minimo;
+	double maximo;
+} ResumenCuantiles;
+
+/*
+ * Estructura: ResumenDistintos
+ * Descripcion: HyperLogLog. Cada registro guarda la racha de ceros mas
+ *              larga de los hash que cayeron en el. Combinar es tomar el
+ *              maximo de cada registro
+ */
+typedef struct {
+	uint8_t registros[REGISTROS_DISTINTOS];
+} ResumenDistintos;
+
+/*
+ * Estructura: ResumenParticion
+ * Descripcion: Resumen de un archivo de datos (una particion de pagos o
+ *              vehiculos.txt). Los conteos y la suma son exactos
+ */
+typedef struct {
+	long tamano_cubierto;                    // Bytes del archivo ya resumidos
+	long registros;
+	Dinero suma;
+	ResumenCuantiles montos;                 // Centavos
+	long registros_dia[MAX_DIAS_RESUMEN];
+	ResumenDistintos cedulas[MAX_DIAS_RESUMEN];
+} ResumenParticion;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Percentiles
+void cuantiles_iniciar(ResumenCuantiles* resumen);
+void cuantiles_agregar(ResumenCuantiles* resumen, double valor, double peso);
+void cuantiles_combinar(ResumenCuantiles* destino, const ResumenCuantiles* origen);
+double cuantiles_valor(ResumenCuantiles* resumen, double cuantil);
+
+// Cedulas distintas
+void distintos_iniciar(ResumenDistintos* resumen);
+void distintos_agregar(ResumenDistintos* resumen, const char* texto);
+void distintos_combinar(ResumenDistintos* destino, const ResumenDistintos* origen);
+double distintos_estimar(const ResumenDistintos* resumen);
+
+// Resumenes de particion
+ResumenParticion* resumen_crear(void);
+void resumen_vaciar(ResumenParticion* resumen);
+void resumen_combinar(ResumenParticion* destino, const ResumenParticion* origen);
+void resumen_ruta(char* ruta, int tabla, int periodo);
+int resumen_cargar(const char* ruta, ResumenParticion* resumen);
+int resumen_guardar(const char* ruta, ResumenParticion* resumen);
+int resumen_actualizar(int tabla, int periodo, ResumenParticion* resumen);
+int resumen_rango(int tabla, int periodo_desde, int periodo_hasta, ResumenParticion* resumen);
+
+// Funciones de interfaz
+void menu_estadisticas(void);
+
+#endif // RESUMENES_H
@@ -0,0 +1,334 @@
+/*
+ * simulacion.c - Implementacion de la simulacion de recaudacion
+ *
+ * Descripcion: Este archivo implementa la evaluacion de escenarios de
+ *              tarifas sobre toda la flota, incluyendo:
+ *              - Lectura de escenarios.cfg (secciones [nombre] con los
+ *                conceptos que cambian respecto a las tarifas vigentes)
+ *              - Lectura de vehiculos.txt por lotes de avaluos contiguos
+ *              - Impuestos sobre el avaluo: para cada escenario se suma el
+ *                impuesto de cada vehiculo, redondeado al centavo como al
+ *                matricular, con varias sumas parciales
+ *              - Tasas fijas: se cuentan vehiculos por provincia y clase
+ *                tarifaria y cada combinacion se calcula una vez con la
+ *                misma formula de calcular_matricula_completa
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "simulacion.h"
+#include "matricula.h"
+#include "vehiculos.h"
+#include <ctype.h>
+#include <time.h>
+
+// ===================================================================
+// DATOS INTERNOS
+// ===================================================================
+
+// Vehiculo que representa a cada clase tarifaria (CLASE_*) para calcular
+// sus tasas fijas con calcular_matricula_con_tarifas
+static const struct {
+	const char* tipo;
+	const char* subtipo;
+	int cilindraje;
+} representantes_clase[NUM_CLASES_TARIFA] = {
+	{"PARTICULAR", "MOTOCICLETA", 200},
+	{"PARTICULAR", "MOTOCICLETA", 201},
+	{"COMERCIAL", "LIVIANO", 1500},
+	{"COMERCIAL", "PESADO", 1500},
+	{"PARTICULAR", "PESADO", 1500},
+	{"PARTICULAR", "LIVIANO", 1500},
+	{"PARTICULAR", "LIVIANO", 2500},
+	{"PARTICULAR", "LIVIANO", 2501}
+};
+
+static const char* const nombres_recaudacion[NUM_CONCEPTOS_RECAUDACION] = {
+	"Impuesto propiedad", "Impuesto rodaje", "SPPAT", "Tasa ANT",
+	"Tasa prefectura", "Revision tecnica", "Adhesivo"
+};
+
+// ===================================================================
+// FUNCIONES DE ESCENARIOS
+// ===================================================================
+
+/*
+ * Funcion: cargar_escenarios
+ * Descripcion: Lee un archivo de escenarios. Cada seccion [nombre] parte
+ *              de las tarifas base y cambia los conceptos que indica
+ *              (mismas claves que tarifas.cfg). El escenario 0 es la base
+ * Parametros:
+ *   - ruta: Archivo de escenarios
+ *   - base: Tarifas vigentes
+ *   - escenarios, max: Arreglo de salida
+ * Retorno: Cantidad de escenarios (incluida la base), 0 si hubo error
+ */
+int cargar_escenarios(const char* ruta, const TablaTarifas* base, EscenarioTarifas* escenarios, int max) {
+	FILE* archivo = fopen(ruta, "r");
+	if (!archivo) {
+		printf("ERROR: No se pudo abrir '%s'.\n", ruta);
+		return 0;
+	}
+
+	memset(&escenarios[0], 0, sizeof(EscenarioTarifas));
+	strcpy(escenarios[0].nombre, "TARIFAS VIGENTES");
+	escenarios[0].tarifas = *base;
+
+	int cantidad = 1, numero_linea = 0, exito = 1;
+	char linea[200];
+
+	while (fgets(linea, sizeof(linea), archivo)) {
+		char clave[60], texto[60];
+		numero_linea++;
+
+		char* inicio = linea;
+		while (isspace((unsigned char)*inicio)) inicio++;
+		if (*inicio == '\0' || *inicio == '#') continue;
+
+		if (*inicio == '[') {
+			if (cantidad == max) {
+				printf("ERROR: %s linea %d: se admiten hasta %d escenarios.\n", ruta, numero_linea, max - 1);
+				exito = 0;
+				break;
+			}
+			EscenarioTarifas* escenario = &escenarios[cantidad];
+			memset(escenario, 0, sizeof(EscenarioTarifas));
+			if (sscanf(inicio, "[%39[^]]]", escenario->nombre) != 1) {
+				printf("ERROR: %s linea %d: se esperaba [nombre].\n", ruta, numero_linea);
+				exito = 0;
+				break;
+			}
+			escenario->tarifas = *base;
+			cantidad++;
+			continue;
+		}
+
+		if (cantidad == 1) {
+			printf("ERROR: %s linea %d: los valores deben ir dentro de un [escenario].\n", ruta, numero_linea);
+			exito = 0;
+			break;
+		}
+
+		char* fin;
+		int concepto = -1;
+		double valor = 0;
+		if (sscanf(inicio, " %59[^= \t] = %59s", clave, texto) == 2) {
+			valor = strtod(texto, &fin);
+			if (fin != texto && valor >= 0) concepto = tarifas_concepto_de_clave(clave);
+		}
+		if (concepto < 0) {
+			printf("ERROR: %s linea %d: se esperaba 'concepto = valor'.\n", ruta, numero_linea);
+			exito = 0;
+			break;
+		}
+		tarifas_asignar_concepto(&escenarios[cantidad - 1].tarifas, concepto, valor);
+	}
+	fclose(archivo);
+
+	return exito ? cantidad : 0;
+}
+
+// ===================================================================
+// FUNCIONES DE SIMULACION
+// ===================================================================
+
+/*
+ * Funcion: sumar_impuestos
+ * Descripcion: Suma los impuestos a la propiedad y de rodaje de un lote
+ *              para un escenario. Cada impuesto se redondea al centavo por
+ *              vehiculo, igual que calcular_impuesto_propiedad y
+ *              calcular_impuesto_rodaje, asi la recaudacion simulada es la
+ *              suma de lo que pagaria cada vehiculo. Usa
+ *              CARRILES_SIMULACION sumas parciales independientes; como son
+ *              centavos enteros la suma es exacta en cualquier orden
+ * Parametros: avaluos, cantidad, tarifas, suma_propiedad, suma_rodaje (salida)
+ * Retorno: void
+ */
+static void sumar_impuestos(const Dinero* avaluos, int cantidad, const TablaTarifas* tarifas,
+							Dinero* suma_propiedad, Dinero* suma_rodaje) {
+	Dinero limite_propiedad = dinero_desde_decimal(tarifas->limite_propiedad);
+	Dinero limite_rodaje = dinero_desde_decimal(tarifas->limite_rodaje);
+	TasaDinero tasa_propiedad = tasa_desde_porcentaje(tarifas->porcentaje_propiedad);
+	TasaDinero tasa_rodaje = tasa_desde_porcentaje(tarifas->porcentaje_rodaje);
+	Dinero parcial_propiedad[CARRILES_SIMULACION] = {0};
+	Dinero parcial_rodaje[CARRILES_SIMULACION] = {0};
+
+	for (int i = 0; i < cantidad; i++) {
+		int c = i % CARRILES_SIMULACION;
+		Dinero exceso_propiedad = avaluos[i] - limite_propiedad;
+		Dinero exceso_rodaje = avaluos[i] - limite_rodaje;
+		if (exceso_propiedad > 0) parcial_propiedad[c] += dinero_porcentaje(exceso_propiedad, tasa_propiedad);
+		if (exceso_rodaje > 0) parcial_rodaje[c] += dinero_porcentaje(exceso_rodaje, tasa_rodaje);
+	}
+
+	for (int c = 0; c < CARRILES_SIMULACION; c++) {
+		*suma_propiedad += parcial_propiedad[c];
+		*suma_rodaje += parcial_rodaje[c];
+	}
+}
+
+/*
+ * Funcion: simular_recaudacion
+ * Descripcion: Calcula la recaudacion de cada escenario sobre todos los
+ *              vehiculos de vehiculos.txt (sin multas ni mora). Cada lote
+ *              de avaluos se recorre una vez por escenario mientras sigue
+ *              en la cache
+ * Parametros: escenarios, cantidad
+ * Retorno: Vehiculos simulados, -1 si no se pudo leer vehiculos.txt
+ */
+long simular_recaudacion(EscenarioTarifas* escenarios, int cantidad) {
+	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "r");
+	if (!archivo) {
+		printf("ERROR: No se pudo abrir '%s'.\n", ARCHIVO_VEHICULOS);
+		return -1;
+	}
+
+	Dinero* avaluos = malloc(LOTE_SIMULACION * sizeof(Dinero));
+	Dinero* impuestos = calloc((size_t)cantidad * 2, sizeof(Dinero));   // propiedad, rodaje por escenario
+	long conteo[NUM_PROVINCIAS][NUM_CLASES_TARIFA] = {{0}};
+	long vehiculos = 0;
+	char linea[MAX_LINEA2];
+
+	if (!avaluos || !impuestos) {
+		free(avaluos);
+		free(impuestos);
+		fclose(archivo);
+		return -1;
+	}
+
+	int en_lote = 0, fin_archivo = 0;
+	while (!fin_archivo) {
+		DatosVehiculo vehiculo;
+		if (fgets(linea, sizeof(linea), archivo)) {
+			if (!leer_linea_vehiculo(linea, &vehiculo)) continue;
+			avaluos[en_lote++] = vehiculo.avaluo;
+			conteo[tarifas_indice_provincia(vehiculo.placa)]
+				  [clase_tarifa_vehiculo(vehiculo.tipo, vehiculo.subtipo, vehiculo.cilindraje)]++;
+		} else {
+			fin_archivo = 1;
+		}
+
+		if (en_lote == LOTE_SIMULACION || (fin_archivo && en_lote > 0)) {
+			for (int s = 0; s < cantidad; s++) {
+				sumar_impuestos(avaluos, en_lote, &escenarios[s].tarifas, &impuestos[2 * s], &impuestos[2 * s + 1]);
+			}
+			vehiculos += en_lote;
+			en_lote = 0;
+		}
+	}
+	fclose(archivo);
+
+	for (int s = 0; s < cantidad; s++) {
+		EscenarioTarifas* escenario = &escenarios[s];
+		memset(escenario->recaudacion, 0, sizeof(escenario->recaudacion));
+		escenario->recaudacion[RECAUDACION_PROPIEDAD] = impuestos[2 * s];
+		escenario->recaudacion[RECAUDACION_RODAJE] = impuestos[2 * s + 1];
+
+		// Tasas fijas: una vez por cada provincia y clase con vehiculos
+		for (int p = 0; p < NUM_PROVINCIAS; p++) {
+			for (int k = 0; k < NUM_CLASES_TARIFA; k++) {
+				if (conteo[p][k] == 0) continue;
+
+				DatosVehiculo representante = {0};
+				representante.placa[0] = (char)('A' + p);
+				strcpy(representante.tipo, representantes_clase[k].tipo);
+				strcpy(representante.subtipo, representantes_clase[k].subtipo);
+				representante.cilindraje = representantes_clase[k].cilindraje;
+
+				ResultadoMatricula r = calcular_matricula_con_tarifas(&representante, &escenario->tarifas);
+				escenario->recaudacion[RECAUDACION_SPPAT] += r.tasa_sppat * conteo[p][k];
+				escenario->recaudacion[RECAUDACION_ANT] += r.tasa_ant * conteo[p][k];
+				escenario->recaudacion[RECAUDACION_PREFECTURA] += r.tasa_prefectura * conteo[p][k];
+				escenario->recaudacion[RECAUDACION_RTV] += r.valor_rtv * conteo[p][k];
+				escenario->recaudacion[RECAUDACION_ADHESIVO] += r.valor_adhesivo * conteo[p][k];
+			}
+		}
+	}
+
+	free(avaluos);
+	free(impuestos);
+	return vehiculos;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+static Dinero total_recaudacion(const EscenarioTarifas* escenario) {
+	return dinero_sumar(escenario->recaudacion, NUM_CONCEPTOS_RECAUDACION);
+}
+
+/*
+ * Funcion: ejecutar_simulacion
+ * Descripcion: Carga los escenarios, simula la recaudacion y muestra la
+ *              diferencia total y por concepto de cada escenario frente a
+ *              las tarifas vigentes
+ * Parametros: ruta - Archivo de escenarios
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int ejecutar_simulacion(const char* ruta) {
+	EscenarioTarifas* escenarios = malloc(MAX_ESCENARIOS * sizeof(EscenarioTarifas));
+	if (!escenarios) return 0;
+
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	int cantidad = cargar_escenarios(ruta, lectura.tabla, escenarios, MAX_ESCENARIOS);
+	unsigned int version = lectura.tabla->version;
+	tarifas_leer_fin(lectura);
+
+	if (cantidad == 0) {
+		free(escenarios);
+		return 0;
+	}
+
+	clock_t inicio = clock();
+	long vehiculos = simular_recaudacion(escenarios, cantidad);
+	double segundos = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+	if (vehiculos < 0) {
+		free(escenarios);
+		return 0;
+	}
+
+	printf("=== SIMULACION DE RECAUDACION ===\n\n");
+	printf("Vehiculos: %ld   Escenarios: %d   Tarifas base: version %u   Tiempo: %.2f s\n\n",
+		   vehiculos, cantidad - 1, version, segundos);
+
+	Dinero base = total_recaudacion(&escenarios[0]);
+	printf("%-28s %16s %16s %9s\n", "ESCENARIO", "RECAUDACION", "DIFERENCIA", "%");
+	printf("-----------------------------------------------------------------------\n");
+	printf("%-28s %16.2f\n", escenarios[0].nombre, dinero_a_decimal(base));
+
+	for (int s = 1; s < cantidad; s++) {
+		Dinero total = total_recaudacion(&escenarios[s]);
+		printf("%-28s %16.2f %+16.2f %+8.2f%%\n", escenarios[s].nombre, dinero_a_decimal(total),
+			   dinero_a_decimal(total - base), base > 0 ? (double)(total - base) * 100.0 / (double)base : 0.0);
+
+		for (int c = 0; c < NUM_CONCEPTOS_RECAUDACION; c++) {
+			Dinero diferencia = escenarios[s].recaudacion[c] - escenarios[0].recaudacion[c];
+			if (diferencia != 0) {
+				printf("    %-24s %16.2f %+16.2f\n", nombres_recaudacion[c],
+					   dinero_a_decimal(escenarios[s].recaudacion[c]), dinero_a_decimal(diferencia));
+			}
+		}
+	}
+	printf("-----------------------------------------------------------------------\n");
+
+	free(escenarios);
+	return 1;
+}
+
+/*
+ * Funcion: menu_simulacion_recaudacion
+ * Descripcion: Ejecuta la simulacion con escenarios.cfg desde el menu
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_simulacion_recaudacion(void) {
+	limpiar_pantalla();
+	ejecutar_simulacion(ARCHIVO_ESCENARIOS);
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
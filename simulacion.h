@@ -0,0 +1,73 @@
+/*
+ * simulacion.h - Libreria de simulacion de recaudacion por escenarios
+ *
+ * Descripcion: Este archivo contiene las constantes, estructuras y
+ *              prototipos para evaluar varios juegos de tarifas candidatos
+ *              ("que pasa si el limite de propiedad sube a $25.000?")
+ *              sobre toda la flota de vehiculos.txt en una sola pasada, y
+ *              reportar la diferencia de recaudacion de cada escenario
+ *              frente a las tarifas vigentes.
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef SIMULACION_H
+#define SIMULACION_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "tarifas.h"
+#include "dinero.h"
+
+// ===================================================================
+// CONSTANTES DE SIMULACION
+// ===================================================================
+
+#define ARGUMENTO_SIMULACION "--simular"
+#define ARCHIVO_ESCENARIOS "escenarios.cfg"   // Escenarios: secciones [nombre] con clave = valor
+
+#define MAX_ESCENARIOS 32
+#define LOTE_SIMULACION 4096     // Avaluos por lote (16 KiB: caben en la cache L1)
+#define CARRILES_SIMULACION 8    // Sumas parciales independientes
+
+// Conceptos de recaudacion reportados por escenario
+enum {
+	RECAUDACION_PROPIEDAD,
+	RECAUDACION_RODAJE,
+	RECAUDACION_SPPAT,
+	RECAUDACION_ANT,
+	RECAUDACION_PREFECTURA,
+	RECAUDACION_RTV,
+	RECAUDACION_ADHESIVO,
+	NUM_CONCEPTOS_RECAUDACION
+};
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: EscenarioTarifas
+ * Descripcion: Tarifas vigentes con los cambios de un escenario, y la
+ *              recaudacion que producen sobre la flota
+ */
+typedef struct {
+	char nombre[40];
+	TablaTarifas tarifas;
+	Dinero recaudacion[NUM_CONCEPTOS_RECAUDACION];   // Centavos
+} EscenarioTarifas;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+int cargar_escenarios(const char* ruta, const TablaTarifas* base, EscenarioTarifas* escenarios, int max);
+long simular_recaudacion(EscenarioTarifas* escenarios, int cantidad);
+int ejecutar_simulacion(const char* ruta);
+void menu_simulacion_recaudacion(void);
+
+#endif // SIMULACION_H
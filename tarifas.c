@@ -0,0 +1,601 @@
+/*
+ * tarifas.c - Implementacion de las tablas de tarifas versionadas
+ *
+ * Descripcion: Este archivo implementa la carga y publicacion de tarifas,
+ *              incluyendo:
+ *              - Lectura de tarifas.cfg (clave = valor, con version)
+ *              - Tasas de prefectura por provincia (letra de la placa)
+ *              - Publicacion por intercambio atomico del puntero vigente
+ *              - Periodo de gracia con dos contadores de lectores antes
+ *                de liberar la tabla anterior
+ *              - Recarga automatica cuando cambia la fecha del archivo
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#include "tarifas.h"
+#include "matricula.h"   // Valores de fabrica (macros) e invalidacion de la cache
+#include "vehiculos.h"   // Para limpiar_pantalla
+#include "hilos.h"       // Para ceder_procesador
+#include <stddef.h>
+#include <stdatomic.h>
+#include <ctype.h>
+#include <sys/stat.h>
+
+// ===================================================================
+// ESTADO DE LA TABLA VIGENTE
+// ===================================================================
+
+// Todas las provincias parten de la tasa nacional, sin recargo
+#define PROVINCIA_FABRICA \
+	{{TASA_PREFECTURA_PARTICULAR, TASA_PREFECTURA_COMERCIAL, TASA_PREFECTURA_MOTOCICLETA}, 0.0}
+
+// Tarifas de fabrica: las macros de matricula.h. Nunca se liberan
+static const TablaTarifas tarifas_fabrica = {
+	0, ANO_FISCAL,
+	LIMITE_PROPIEDAD, LIMITE_RODAJE, PORCENTAJE_PROPIEDAD, PORCENTAJE_RODAJE,
+	TASA_ANT_PARTICULAR, TASA_ANT_COMERCIAL, TASA_ANT_MOTOCICLETA,
+	TASA_PREFECTURA_PARTICULAR, TASA_PREFECTURA_COMERCIAL, TASA_PREFECTURA_MOTOCICLETA,
+	VALOR_RTV_LIVIANO, VALOR_RTV_PESADO, VALOR_RTV_MOTOCICLETA, VALOR_ADHESIVO,
+	SPPAT_MOTO_HASTA_200, SPPAT_MOTO_MAS_200,
+	SPPAT_LIVIANO_HASTA_1500, SPPAT_LIVIANO_1501_2500, SPPAT_LIVIANO_MAS_2500,
+	SPPAT_PESADO, SPPAT_COMERCIAL,
+	RECARGO_ANUAL_PORCENTAJE,
+	{
+		ANO_FISCAL, 1,
+		{
+			{LIMITE_PROPIEDAD}, {LIMITE_RODAJE}, {PORCENTAJE_PROPIEDAD}, {PORCENTAJE_RODAJE},
+			{TASA_ANT_PARTICULAR}, {TASA_ANT_COMERCIAL}, {TASA_ANT_MOTOCICLETA},
+			{TASA_PREFECTURA_PARTICULAR}, {TASA_PREFECTURA_COMERCIAL}, {TASA_PREFECTURA_MOTOCICLETA},
+			{VALOR_RTV_LIVIANO}, {VALOR_RTV_PESADO}, {VALOR_RTV_MOTOCICLETA}, {VALOR_ADHESIVO},
+			{SPPAT_MOTO_HASTA_200}, {SPPAT_MOTO_MAS_200},
+			{SPPAT_LIVIANO_HASTA_1500}, {SPPAT_LIVIANO_1501_2500}, {SPPAT_LIVIANO_MAS_2500},
+			{SPPAT_PESADO}, {SPPAT_COMERCIAL},
+			{RECARGO_ANUAL_PORCENTAJE}
+		}
+	},
+	{
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA,
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA,
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA,
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA,
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA,
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA, PROVINCIA_FABRICA,
+		PROVINCIA_FABRICA, PROVINCIA_FABRICA
+	}
+};
+
+// Provincia de cada letra inicial de placa (D y F no estan asignadas)
+static const char* const nombres_provincia[NUM_PROVINCIAS] = {
+	"Azuay", "Bolivar", "Carchi", "", "Esmeraldas", "", "Guayas", "Chimborazo",
+	"Imbabura", "Santo Domingo", "Sucumbios", "Loja", "Manabi", "Napo", "El Oro",
+	"Pichincha", "Orellana", "Los Rios", "Pastaza", "Tungurahua", "Canar",
+	"Morona Santiago", "Galapagos", "Cotopaxi", "Santa Elena", "Zamora Chinchipe"
+};
+
+static _Atomic(const TablaTarifas*) tabla_vigente = &tarifas_fabrica;
+
+// Los lectores se anotan en el contador de la paridad actual. Al publicar
+// se cambia la paridad y se espera que el contador anterior llegue a cero
+static atomic_uint epoca_lectores;
+static atomic_int lectores[2];
+
+// Solo una publicacion a la vez (publicar es raro; leer es lo frecuente)
+static atomic_flag publicando = ATOMIC_FLAG_INIT;
+
+// Fecha de modificacion de tarifas.cfg en la ultima verificacion
+static time_t ultima_modificacion = 0;
+
+// Campos numericos que se pueden escribir en tarifas.cfg, en el mismo
+// orden que los CONCEPTO_* del calendario
+typedef struct {
+	const char* clave;
+	size_t desplazamiento;
+} CampoTarifa;
+
+static const CampoTarifa campos_tarifa[] = {
+	{"limite_propiedad", offsetof(TablaTarifas, limite_propiedad)},
+	{"limite_rodaje", offsetof(TablaTarifas, limite_rodaje)},
+	{"porcentaje_propiedad", offsetof(TablaTarifas, porcentaje_propiedad)},
+	{"porcentaje_rodaje", offsetof(TablaTarifas, porcentaje_rodaje)},
+	{"tasa_ant_particular", offsetof(TablaTarifas, tasa_ant_particular)},
+	{"tasa_ant_comercial", offsetof(TablaTarifas, tasa_ant_comercial)},
+	{"tasa_ant_motocicleta", offsetof(TablaTarifas, tasa_ant_motocicleta)},
+	{"tasa_prefectura_particular", offsetof(TablaTarifas, tasa_prefectura_particular)},
+	{"tasa_prefectura_comercial", offsetof(TablaTarifas, tasa_prefectura_comercial)},
+	{"tasa_prefectura_motocicleta", offsetof(TablaTarifas, tasa_prefectura_motocicleta)},
+	{"valor_rtv_liviano", offsetof(TablaTarifas, valor_rtv_liviano)},
+	{"valor_rtv_pesado", offsetof(TablaTarifas, valor_rtv_pesado)},
+	{"valor_rtv_motocicleta", offsetof(TablaTarifas, valor_rtv_motocicleta)},
+	{"valor_adhesivo", offsetof(TablaTarifas, valor_adhesivo)},
+	{"sppat_moto_hasta_200", offsetof(TablaTarifas, sppat_moto_hasta_200)},
+	{"sppat_moto_mas_200", offsetof(TablaTarifas, sppat_moto_mas_200)},
+	{"sppat_liviano_hasta_1500", offsetof(TablaTarifas, sppat_liviano_hasta_1500)},
+	{"sppat_liviano_1501_2500", offsetof(TablaTarifas, sppat_liviano_1501_2500)},
+	{"sppat_liviano_mas_2500", offsetof(TablaTarifas, sppat_liviano_mas_2500)},
+	{"sppat_pesado", offsetof(TablaTarifas, sppat_pesado)},
+	{"sppat_comercial", offsetof(TablaTarifas, sppat_comercial)},
+	{"recargo_anual_porcentaje", offsetof(TablaTarifas, recargo_anual_porcentaje)},
+};
+
+#define NUM_CAMPOS_TARIFA (sizeof(campos_tarifa) / sizeof(campos_tarifa[0]))
+_Static_assert(NUM_CAMPOS_TARIFA == NUM_CONCEPTOS_TARIFA, "campos_tarifa y CONCEPTO_* deben coincidir");
+
+/*
+ * Estructura: SobreescrituraTarifa
+ * Descripcion: Valor de un concepto leido en una seccion [AAAA]
+ */
+typedef struct {
+	int ano;
+	int concepto;
+	double valor;
+} SobreescrituraTarifa;
+
+// Claves permitidas en una seccion [provincia X]: las tres tasas de
+// prefectura (en el orden PREFECTURA_*) y el recargo provincial
+static const char* const claves_provincia[] = {
+	"tasa_prefectura_particular", "tasa_prefectura_comercial", "tasa_prefectura_motocicleta",
+	"recargo_prefectura"
+};
+
+#define NUM_CLAVES_PROVINCIA (sizeof(claves_provincia) / sizeof(claves_provincia[0]))
+#define MAX_SOBREESCRITURAS_PROVINCIA (NUM_PROVINCIAS * NUM_CLAVES_PROVINCIA)
+
+/*
+ * Estructura: SobreescrituraProvincia
+ * Descripcion: Valor leido en una seccion [provincia X]
+ */
+typedef struct {
+	int provincia;
+	int campo;          // Indice en claves_provincia
+	double valor;
+} SobreescrituraProvincia;
+
+// ===================================================================
+// FUNCIONES DE LECTURA
+// ===================================================================
+
+/*
+ * Funcion: tarifas_leer_inicio
+ * Descripcion: Abre una seccion de lectura. Todo un calculo debe usar la
+ *              misma tabla, asi que se obtiene una vez y se pasa a las
+ *              funciones de calculo
+ * Parametros: Ninguno
+ * Retorno: Lectura con la tabla vigente
+ */
+LecturaTarifas tarifas_leer_inicio(void) {
+	LecturaTarifas lectura;
+	lectura.paridad = (int)(atomic_load(&epoca_lectores) & 1u);
+	atomic_fetch_add(&lectores[lectura.paridad], 1);
+	lectura.tabla = atomic_load(&tabla_vigente);
+	return lectura;
+}
+
+/*
+ * Funcion: tarifas_leer_fin
+ * Descripcion: Cierra una seccion de lectura; la tabla ya no se debe usar
+ * Parametros: lectura - Valor devuelto por tarifas_leer_inicio
+ * Retorno: void
+ */
+void tarifas_leer_fin(LecturaTarifas lectura) {
+	atomic_fetch_sub(&lectores[lectura.paridad], 1);
+}
+
+/*
+ * Funcion: tarifas_version_vigente
+ * Descripcion: Version de la tabla publicada en este momento
+ * Parametros: Ninguno
+ * Retorno: Numero de version (0 = valores de fabrica)
+ */
+unsigned int tarifas_version_vigente(void) {
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	unsigned int version = lectura.tabla->version;
+	tarifas_leer_fin(lectura);
+	return version;
+}
+
+/*
+ * Funcion: tarifas_ano_fiscal
+ * Descripcion: Ano fiscal de la tabla publicada en este momento
+ * Parametros: Ninguno
+ * Retorno: Ano fiscal
+ */
+int tarifas_ano_fiscal(void) {
+	LecturaTarifas lectura = tarifas_leer_inicio();
+	int ano = lectura.tabla->ano_fiscal;
+	tarifas_leer_fin(lectura);
+	return ano;
+}
+
+/*
+ * Funcion: tarifas_indice_ano
+ * Descripcion: Posicion de un ano dentro del calendario de una tabla. Los
+ *              anos anteriores al calendario usan el primer ano cargado y
+ *              los posteriores usan el ultimo
+ * Parametros: tabla, ano
+ * Retorno: Indice para CalendarioTarifas.valores[concepto][indice]
+ */
+int tarifas_indice_ano(const TablaTarifas* tabla, int ano) {
+	int indice = ano - tabla->calendario.ano_inicial;
+	if (indice < 0) return 0;
+	if (indice >= tabla->calendario.cantidad_anos) return tabla->calendario.cantidad_anos - 1;
+	return indice;
+}
+
+/*
+ * Funcion: tarifas_indice_provincia
+ * Descripcion: Provincia de una placa segun su primera letra. Las placas
+ *              sin letra mayuscula inicial usan PROVINCIA_POR_DEFECTO
+ * Parametros: placa - Placa del vehiculo
+ * Retorno: Indice para TablaTarifas.provincias
+ */
+int tarifas_indice_provincia(const char* placa) {
+	unsigned int indice = (unsigned int)((unsigned char)placa[0] - 'A');
+	return indice < NUM_PROVINCIAS ? (int)indice : PROVINCIA_POR_DEFECTO;
+}
+
+/*
+ * Funcion: tarifas_nombre_provincia
+ * Descripcion: Nombre de la provincia de un indice
+ * Parametros: provincia - Indice (0 = A ... 25 = Z)
+ * Retorno: Nombre, o cadena vacia si la letra no esta asignada
+ */
+const char* tarifas_nombre_provincia(int provincia) {
+	if (provincia < 0 || provincia >= NUM_PROVINCIAS) return "";
+	return nombres_provincia[provincia];
+}
+
+// ===================================================================
+// FUNCIONES DE PUBLICACION
+// ===================================================================
+
+/*
+ * Funcion: campo_concepto
+ * Descripcion: Direccion del campo de un concepto dentro de la tabla
+ */
+static double* campo_concepto(TablaTarifas* tabla, int concepto) {
+	return (double*)((char*)tabla + campos_tarifa[concepto].desplazamiento);
+}
+
+/*
+ * Funcion: tarifas_concepto_de_clave
+ * Descripcion: Concepto tarifario de una clave de tarifas.cfg
+ * Parametros: clave - Por ejemplo "limite_propiedad"
+ * Retorno: CONCEPTO_* o -1 si la clave no existe
+ */
+int tarifas_concepto_de_clave(const char* clave) {
+	for (int concepto = 0; concepto < NUM_CONCEPTOS_TARIFA; concepto++) {
+		if (strcmp(clave, campos_tarifa[concepto].clave) == 0) return concepto;
+	}
+	return -1;
+}
+
+/*
+ * Funcion: tarifas_asignar_concepto
+ * Descripcion: Cambia un concepto del ano fiscal vigente en una tabla que
+ *              todavia no se publica (por ejemplo, un escenario simulado).
+ *              Si es una tasa de prefectura, cada provincia conserva su
+ *              diferencia con la tasa nacional
+ * Parametros: tabla, concepto (CONCEPTO_*), valor
+ * Retorno: void
+ */
+void tarifas_asignar_concepto(TablaTarifas* tabla, int concepto, double valor) {
+	double* campo = campo_concepto(tabla, concepto);
+	double diferencia = valor - *campo;
+
+	*campo = valor;
+	tabla->calendario.valores[concepto][tarifas_indice_ano(tabla, tabla->ano_fiscal)] = valor;
+
+	if (concepto >= CONCEPTO_TASA_PREFECTURA_PARTICULAR && concepto <= CONCEPTO_TASA_PREFECTURA_MOTOCICLETA) {
+		for (int p = 0; p < NUM_PROVINCIAS; p++) {
+			tabla->provincias[p].tasa_prefectura[concepto - CONCEPTO_TASA_PREFECTURA_PARTICULAR] += diferencia;
+		}
+	}
+}
+
+/*
+ * Funcion: construir_calendario
+ * Descripcion: Arma el calendario por ano. Cada ano parte de las tarifas
+ *              del ano fiscal vigente y aplica los valores de su seccion
+ *              [AAAA]. Los campos de la tabla quedan con el ano vigente
+ * Parametros: tabla, sobreescrituras, cantidad
+ * Retorno: 1 si fue exitoso, 0 si los anos no caben en el calendario
+ */
+static int construir_calendario(TablaTarifas* tabla, const SobreescrituraTarifa* sobreescrituras, int cantidad) {
+	CalendarioTarifas* calendario = &tabla->calendario;
+	int ano_min = tabla->ano_fiscal, ano_max = tabla->ano_fiscal;
+
+	for (int i = 0; i < cantidad; i++) {
+		if (sobreescrituras[i].ano < ano_min) ano_min = sobreescrituras[i].ano;
+		if (sobreescrituras[i].ano > ano_max) ano_max = sobreescrituras[i].ano;
+	}
+	if (ano_max - ano_min + 1 > MAX_ANOS_TARIFA) {
+		printf("ERROR: El calendario de tarifas admite hasta %d anos (%d-%d).\n",
+			   MAX_ANOS_TARIFA, ano_min, ano_max);
+		return 0;
+	}
+
+	calendario->ano_inicial = ano_min;
+	calendario->cantidad_anos = ano_max - ano_min + 1;
+	for (int c = 0; c < NUM_CONCEPTOS_TARIFA; c++) {
+		double base = *campo_concepto(tabla, c);
+		for (int a = 0; a < calendario->cantidad_anos; a++) {
+			calendario->valores[c][a] = base;
+		}
+	}
+	for (int i = 0; i < cantidad; i++) {
+		calendario->valores[sobreescrituras[i].concepto][sobreescrituras[i].ano - ano_min] = sobreescrituras[i].valor;
+	}
+
+	// Una seccion del ano vigente tambien cambia los campos de la tabla
+	int vigente = tabla->ano_fiscal - ano_min;
+	for (int c = 0; c < NUM_CONCEPTOS_TARIFA; c++) {
+		*campo_concepto(tabla, c) = calendario->valores[c][vigente];
+	}
+	return 1;
+}
+
+/*
+ * Funcion: construir_provincias
+ * Descripcion: Cada provincia parte de las tasas de prefectura del ano
+ *              vigente, sin recargo, y aplica los valores de su seccion
+ *              [provincia X]
+ * Parametros: tabla, sobreescrituras, cantidad
+ * Retorno: void
+ */
+static void construir_provincias(TablaTarifas* tabla, const SobreescrituraProvincia* sobreescrituras, int cantidad) {
+	for (int p = 0; p < NUM_PROVINCIAS; p++) {
+		tabla->provincias[p].tasa_prefectura[PREFECTURA_PARTICULAR] = tabla->tasa_prefectura_particular;
+		tabla->provincias[p].tasa_prefectura[PREFECTURA_COMERCIAL] = tabla->tasa_prefectura_comercial;
+		tabla->provincias[p].tasa_prefectura[PREFECTURA_MOTOCICLETA] = tabla->tasa_prefectura_motocicleta;
+		tabla->provincias[p].recargo = 0.0;
+	}
+	for (int i = 0; i < cantidad; i++) {
+		TarifaProvincia* provincia = &tabla->provincias[sobreescrituras[i].provincia];
+		if (sobreescrituras[i].campo < NUM_CATEGORIAS_PREFECTURA) {
+			provincia->tasa_prefectura[sobreescrituras[i].campo] = sobreescrituras[i].valor;
+		} else {
+			provincia->recargo = sobreescrituras[i].valor;
+		}
+	}
+}
+
+/*
+ * Funcion: tarifas_cargar_archivo
+ * Descripcion: Lee un archivo de tarifas "clave = valor". Las claves que
+ *              no aparecen conservan el valor de fabrica. Las lineas que
+ *              empiezan con '#' son comentarios. Despues de una linea
+ *              [AAAA] los valores son los de ese ano fiscal, y despues de
+ *              una linea [provincia X] son las tasas de prefectura de las
+ *              placas que empiezan con X
+ * Parametros:
+ *   - ruta: Archivo de tarifas
+ *   - tabla: Tabla donde se guardan los valores leidos
+ * Retorno: 1 si fue exitoso, 0 si el archivo no existe o tiene errores
+ */
+int tarifas_cargar_archivo(const char* ruta, TablaTarifas* tabla) {
+	FILE* archivo = fopen(ruta, "r");
+	if (!archivo) return 0;
+
+	*tabla = tarifas_fabrica;
+	int version_leida = 0, numero_linea = 0, exito = 1;
+	int ano_seccion = 0;        // 0 = valores del ano fiscal vigente
+	int provincia_seccion = -1; // -1 = no es una seccion de provincia
+	char linea[200];
+
+	SobreescrituraTarifa sobreescrituras[MAX_SOBREESCRITURAS_TARIFA];
+	int cantidad_sobreescrituras = 0;
+	SobreescrituraProvincia valores_provincia[MAX_SOBREESCRITURAS_PROVINCIA];
+	int cantidad_provincia = 0;
+
+	while (fgets(linea, sizeof(linea), archivo)) {
+		char clave[60], texto[60];
+		numero_linea++;
+
+		char* inicio = linea;
+		while (isspace((unsigned char)*inicio)) inicio++;
+		if (*inicio == '\0' || *inicio == '#') continue;
+
+		// Inicio de la seccion de una provincia o de un ano fiscal
+		if (*inicio == '[') {
+			char letra;
+			if (sscanf(inicio, "[provincia %c]", &letra) == 1) {
+				if (letra < 'A' || letra > 'Z') {
+					printf("ERROR: %s linea %d: la provincia debe ser una letra A-Z.\n", ruta, numero_linea);
+					exito = 0;
+					break;
+				}
+				provincia_seccion = letra - 'A';
+				ano_seccion = 0;
+				continue;
+			}
+			if (sscanf(inicio, "[%d]", &ano_seccion) != 1 || ano_seccion < 1990 || ano_seccion > 2100) {
+				printf("ERROR: %s linea %d: se esperaba una seccion [AAAA] o [provincia X].\n", ruta, numero_linea);
+				exito = 0;
+				break;
+			}
+			provincia_seccion = -1;
+			continue;
+		}
+
+		if (sscanf(inicio, " %59[^= \t] = %59s", clave, texto) != 2) {
+			printf("ERROR: %s linea %d: se esperaba 'clave = valor'.\n", ruta, numero_linea);
+			exito = 0;
+			break;
+		}
+
+		char* fin;
+		double valor = strtod(texto, &fin);
+		if (fin == texto || valor < 0) {
+			printf("ERROR: %s linea %d: valor invalido para '%s'.\n", ruta, numero_linea, clave);
+			exito = 0;
+			break;
+		}
+
+		if (provincia_seccion >= 0) {
+			int campo;
+			for (campo = 0; campo < (int)NUM_CLAVES_PROVINCIA; campo++) {
+				if (strcmp(clave, claves_provincia[campo]) == 0) break;
+			}
+			if (campo == (int)NUM_CLAVES_PROVINCIA) {
+				printf("ERROR: %s linea %d: '%s' no se puede usar en una provincia.\n", ruta, numero_linea, clave);
+				exito = 0;
+				break;
+			}
+			if (cantidad_provincia == (int)MAX_SOBREESCRITURAS_PROVINCIA) {
+				printf("ERROR: %s linea %d: demasiados valores por provincia.\n", ruta, numero_linea);
+				exito = 0;
+				break;
+			}
+			valores_provincia[cantidad_provincia].provincia = provincia_seccion;
+			valores_provincia[cantidad_provincia].campo = campo;
+			valores_provincia[cantidad_provincia].valor = valor;
+			cantidad_provincia++;
+			continue;
+		}
+
+		if (ano_seccion == 0 && strcmp(clave, "version") == 0) {
+			tabla->version = (unsigned int)valor;
+			version_leida = tabla->version > 0;
+			continue;
+		}
+		if (ano_seccion == 0 && strcmp(clave, "ano_fiscal") == 0) {
+			tabla->ano_fiscal = (int)valor;
+			continue;
+		}
+
+		int concepto = tarifas_concepto_de_clave(clave);
+		if (concepto < 0) {
+			printf("ERROR: %s linea %d: clave desconocida '%s'.\n", ruta, numero_linea, clave);
+			exito = 0;
+			break;
+		}
+
+		if (ano_seccion == 0) {
+			*campo_concepto(tabla, concepto) = valor;
+		} else if (cantidad_sobreescrituras < MAX_SOBREESCRITURAS_TARIFA) {
+			sobreescrituras[cantidad_sobreescrituras].ano = ano_seccion;
+			sobreescrituras[cantidad_sobreescrituras].concepto = concepto;
+			sobreescrituras[cantidad_sobreescrituras].valor = valor;
+			cantidad_sobreescrituras++;
+		} else {
+			printf("ERROR: %s linea %d: demasiados valores por ano.\n", ruta, numero_linea);
+			exito = 0;
+			break;
+		}
+	}
+	fclose(archivo);
+
+	if (exito && !construir_calendario(tabla, sobreescrituras, cantidad_sobreescrituras)) {
+		exito = 0;
+	}
+	if (exito) {
+		construir_provincias(tabla, valores_provincia, cantidad_provincia);
+	}
+
+	if (exito && !version_leida) {
+		printf("ERROR: %s no indica 'version' (debe ser mayor a cero).\n", ruta);
+		exito = 0;
+	}
+	return exito;
+}
+
+/*
+ * Funcion: tarifas_publicar
+ * Descripcion: Publica una copia inmutable de la tabla. El puntero vigente
+ *              se reemplaza de forma atomica y luego se espera el periodo
+ *              de gracia: se cambia la paridad de los lectores dos veces,
+ *              esperando cada vez que el contador anterior quede en cero.
+ *              Asi ningun lector que obtuvo la tabla anterior sigue activo
+ *              cuando se libera
+ * Parametros: nueva - Tabla a publicar (se copia)
+ * Retorno: 1 si fue exitoso, 0 si no hay memoria
+ */
+int tarifas_publicar(const TablaTarifas* nueva) {
+	TablaTarifas* copia = malloc(sizeof(TablaTarifas));
+	if (!copia) return 0;
+	*copia = *nueva;
+
+	while (atomic_flag_test_and_set(&publicando)) {
+		ceder_procesador();
+	}
+
+	const TablaTarifas* anterior = atomic_exchange(&tabla_vigente, (const TablaTarifas*)copia);
+
+	// Periodo de gracia
+	for (int vuelta = 0; vuelta < 2; vuelta++) {
+		unsigned int paridad = atomic_fetch_xor(&epoca_lectores, 1u) & 1u;
+		while (atomic_load(&lectores[paridad]) != 0) {
+			ceder_procesador();
+		}
+	}
+
+	if (anterior != &tarifas_fabrica) {
+		free((void*)anterior);
+	}
+	atomic_flag_clear(&publicando);
+
+	// Los resultados guardados con la version anterior ya no sirven
+	invalidar_cache_matricula_completa();
+	return 1;
+}
+
+/*
+ * Funcion: tarifas_verificar_recarga
+ * Descripcion: Revisa si tarifas.cfg cambio desde la ultima verificacion.
+ *              Si cambio y trae una version mayor a la vigente, la publica.
+ *              Se llama desde el hilo del menu antes de cada operacion
+ * Parametros: Ninguno
+ * Retorno: 1 si se publico una version nueva, 0 si no hubo cambios, -1 si hubo error
+ */
+int tarifas_verificar_recarga(void) {
+	struct stat st;
+	if (stat(ARCHIVO_TARIFAS, &st) != 0 || st.st_mtime == ultima_modificacion) {
+		return 0;
+	}
+	ultima_modificacion = st.st_mtime;
+
+	TablaTarifas nueva;
+	if (!tarifas_cargar_archivo(ARCHIVO_TARIFAS, &nueva)) {
+		return -1;
+	}
+	if (nueva.version <= tarifas_version_vigente()) {
+		return 0;
+	}
+	return tarifas_publicar(&nueva) ? 1 : -1;
+}
+
+// ===================================================================
+// FUNCIONES DE INTERFAZ
+// ===================================================================
+
+/*
+ * Funcion: menu_recargar_tarifas
+ * Descripcion: Fuerza la lectura de tarifas.cfg y muestra la version vigente
+ * Parametros: Ninguno
+ * Retorno: void
+ */
+void menu_recargar_tarifas(void) {
+	limpiar_pantalla();
+	printf("=== RECARGAR TARIFAS ===\n\n");
+	printf("Version vigente: %u (ano fiscal %d)\n", tarifas_version_vigente(), tarifas_ano_fiscal());
+
+	// Forzar la lectura aunque la fecha del archivo no haya cambiado
+	ultima_modificacion = 0;
+	int resultado = tarifas_verificar_recarga();
+
+	if (resultado == 1) {
+		printf("Tarifas actualizadas a la version %u.\n", tarifas_version_vigente());
+	} else if (resultado == 0) {
+		printf("No hay una version nueva en '%s'.\n", ARCHIVO_TARIFAS);
+		printf("Para publicar cambios aumente el numero de 'version'.\n");
+	} else {
+		printf("Se mantienen las tarifas de la version %u.\n", tarifas_version_vigente());
+	}
+
+	printf("\nPresione Enter para continuar...");
+	getchar();
+}
@@ -0,0 +1,188 @@
+/*
+ * tarifas.h - Libreria de tablas de tarifas versionadas
+ *
+ * Descripcion: Este archivo contiene la estructura y los prototipos de la
+ *              tabla de tarifas vigente. Las tarifas se leen de un archivo
+ *              de configuracion versionado (tarifas.cfg) y se publican como
+ *              una tabla inmutable. Un cambio de version reemplaza el
+ *              puntero de forma atomica: los calculos en curso terminan con
+ *              la tabla anterior y los nuevos ven la nueva, sin bloqueos en
+ *              la lectura. La tabla anterior se libera cuando ya no quedan
+ *              lectores que la puedan estar usando (periodo de gracia).
+ *
+ * Autores: Mathias, Jhostin, Christian
+ * Fecha: 2025
+ * Materia: Programacion I - ICCD144
+ * Universidad: Escuela Politecnica Nacional
+ */
+
+#ifndef TARIFAS_H
+#define TARIFAS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+// ===================================================================
+// CONSTANTES DE TARIFAS
+// ===================================================================
+
+#define ARCHIVO_TARIFAS "tarifas.cfg"    // Configuracion versionada de tarifas
+#define MAX_ANOS_TARIFA 16               // Anos fiscales en el calendario de tarifas
+#define MAX_SOBREESCRITURAS_TARIFA 512   // Valores por ano leidos de secciones [AAAA]
+#define NUM_PROVINCIAS 26                // Una entrada por letra inicial de placa (A-Z)
+#define PROVINCIA_POR_DEFECTO ('P' - 'A') // Pichincha, para placas sin letra valida
+
+/*
+ * Conceptos tarifarios del calendario por ano. El orden es el mismo de los
+ * campos double de TablaTarifas y de la lista de claves de tarifas.cfg
+ */
+enum {
+	CONCEPTO_LIMITE_PROPIEDAD,
+	CONCEPTO_LIMITE_RODAJE,
+	CONCEPTO_PORCENTAJE_PROPIEDAD,
+	CONCEPTO_PORCENTAJE_RODAJE,
+	CONCEPTO_TASA_ANT_PARTICULAR,
+	CONCEPTO_TASA_ANT_COMERCIAL,
+	CONCEPTO_TASA_ANT_MOTOCICLETA,
+	CONCEPTO_TASA_PREFECTURA_PARTICULAR,
+	CONCEPTO_TASA_PREFECTURA_COMERCIAL,
+	CONCEPTO_TASA_PREFECTURA_MOTOCICLETA,
+	CONCEPTO_VALOR_RTV_LIVIANO,
+	CONCEPTO_VALOR_RTV_PESADO,
+	CONCEPTO_VALOR_RTV_MOTOCICLETA,
+	CONCEPTO_VALOR_ADHESIVO,
+	CONCEPTO_SPPAT_MOTO_HASTA_200,
+	CONCEPTO_SPPAT_MOTO_MAS_200,
+	CONCEPTO_SPPAT_LIVIANO_HASTA_1500,
+	CONCEPTO_SPPAT_LIVIANO_1501_2500,
+	CONCEPTO_SPPAT_LIVIANO_MAS_2500,
+	CONCEPTO_SPPAT_PESADO,
+	CONCEPTO_SPPAT_COMERCIAL,
+	CONCEPTO_RECARGO_ANUAL_PORCENTAJE,
+	NUM_CONCEPTOS_TARIFA
+};
+
+// Categorias de la tasa de prefectura. El orden es el mismo de los
+// CONCEPTO_TASA_PREFECTURA_*
+enum {
+	PREFECTURA_PARTICULAR,
+	PREFECTURA_COMERCIAL,
+	PREFECTURA_MOTOCICLETA,
+	NUM_CATEGORIAS_PREFECTURA
+};
+
+// ===================================================================
+// ESTRUCTURAS DE DATOS
+// ===================================================================
+
+/*
+ * Estructura: TarifaProvincia
+ * Descripcion: Tasas de la prefectura de una provincia. La provincia se
+ *              obtiene de la primera letra de la placa (P = Pichincha,
+ *              G = Guayas, A = Azuay, ...)
+ */
+typedef struct {
+	double tasa_prefectura[NUM_CATEGORIAS_PREFECTURA];   // Por categoria PREFECTURA_*
+	double recargo;                                      // Recargo fijo provincial
+} TarifaProvincia;
+
+/*
+ * Estructura: CalendarioTarifas
+ * Descripcion: Tarifas de varios anos fiscales. Cada concepto es un
+ *              arreglo contiguo indexado por (ano - ano_inicial), de modo
+ *              que recorrer anos para toda una flota lee pocas lineas de
+ *              cache y el compilador puede vectorizar el ciclo
+ */
+typedef struct {
+	int ano_inicial;                     // Primer ano del calendario
+	int cantidad_anos;                   // Anos cargados (1..MAX_ANOS_TARIFA)
+	double valores[NUM_CONCEPTOS_TARIFA][MAX_ANOS_TARIFA];
+} CalendarioTarifas;
+
+/*
+ * Estructura: TablaTarifas
+ * Descripcion: Todas las tarifas usadas en el calculo de matricula. Una
+ *              vez publicada la tabla no se modifica
+ */
+typedef struct {
+	unsigned int version;                // Version del archivo de tarifas (0 = valores de fabrica)
+	int ano_fiscal;                      // Ano fiscal de las tarifas
+
+	// Impuestos sobre el avaluo
+	double limite_propiedad;
+	double limite_rodaje;
+	double porcentaje_propiedad;
+	double porcentaje_rodaje;
+
+	// Tasas ANT
+	double tasa_ant_particular;
+	double tasa_ant_comercial;
+	double tasa_ant_motocicleta;
+
+	// Tasas de prefectura
+	double tasa_prefectura_particular;
+	double tasa_prefectura_comercial;
+	double tasa_prefectura_motocicleta;
+
+	// Revision tecnica y adhesivo
+	double valor_rtv_liviano;
+	double valor_rtv_pesado;
+	double valor_rtv_motocicleta;
+	double valor_adhesivo;
+
+	// Tasas SPPAT
+	double sppat_moto_hasta_200;
+	double sppat_moto_mas_200;
+	double sppat_liviano_hasta_1500;
+	double sppat_liviano_1501_2500;
+	double sppat_liviano_mas_2500;
+	double sppat_pesado;
+	double sppat_comercial;
+
+	// Recargos por mora
+	double recargo_anual_porcentaje;
+
+	// Tarifas de los anos fiscales anteriores (incluye el ano fiscal vigente)
+	CalendarioTarifas calendario;
+
+	// Tasas de prefectura por provincia, indexadas por placa[0] - 'A'
+	TarifaProvincia provincias[NUM_PROVINCIAS];
+} TablaTarifas;
+
+/*
+ * Estructura: LecturaTarifas
+ * Descripcion: Seccion de lectura abierta sobre la tabla vigente. La tabla
+ *              sigue siendo valida hasta llamar a tarifas_leer_fin
+ */
+typedef struct {
+	const TablaTarifas* tabla;           // Tabla que se debe usar en todo el calculo
+	int paridad;                         // Contador de lectores usado (interno)
+} LecturaTarifas;
+
+// ===================================================================
+// PROTOTIPOS DE FUNCIONES
+// ===================================================================
+
+// Funciones de lectura (sin bloqueos)
+LecturaTarifas tarifas_leer_inicio(void);
+void tarifas_leer_fin(LecturaTarifas lectura);
+unsigned int tarifas_version_vigente(void);
+int tarifas_ano_fiscal(void);
+int tarifas_indice_ano(const TablaTarifas* tabla, int ano);
+int tarifas_indice_provincia(const char* placa);
+const char* tarifas_nombre_provincia(int provincia);
+
+// Funciones de conceptos tarifarios
+int tarifas_concepto_de_clave(const char* clave);
+void tarifas_asignar_concepto(TablaTarifas* tabla, int concepto, double valor);
+
+// Funciones de publicacion
+int tarifas_cargar_archivo(const char* ruta, TablaTarifas* tabla);
+int tarifas_publicar(const TablaTarifas* nueva);
+int tarifas_verificar_recarga(void);
+
+// Funciones de interfaz
+void menu_recargar_tarifas(void);
+
+#endif // TARIFAS_H
@@ -14,6 +14,14 @@
  */
 
 #include "vehiculos.h" 
+#include "almacen_documentos.h" // Copia de certificados en el almacen
+#include "particiones.h"  // Comprobantes repartidos en archivos mensuales
+#include "indice_vehiculos.h" // Busqueda por placa sin recorrer vehiculos.txt
+#include "eventos.h"  // Registro unico de eventos por placa
+#include "expediente.h" // Datos de matriculacion de una placa en una sola consulta
+#include "matriculas_pagadas.h" // Formato unico de matriculas_pagadas.txt
+#include "repositorio.h" // Consultas por clave en el motor de almacen.cfg
+#include "conjuntos_estado.h" // Vehiculos por estado como mapas de bits
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h> 
@@ -145,19 +153,8 @@ int validar_cilindraje(int cilindraje) {
  * Retorno: 1 si existe, 0 si no existe
  */
 int vehiculo_ya_existe(const char* placa) {
-	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "r");
-	if (archivo == NULL) return 0;
-	
-	char linea[MAX_LINEA2], placa_archivo[10];
-	while (fgets(linea, sizeof(linea), archivo)) {
-		sscanf(linea, "%9[^,]", placa_archivo);
-		if (strcmp(placa_archivo, placa) == 0) {
-			fclose(archivo);
-			return 1;
-		}
-	}
-	fclose(archivo);
-	return 0;
+	DatosVehiculo vehiculo;
+	return repositorio_buscar_vehiculo(placa, &vehiculo);
 }
 
 /*
@@ -180,11 +177,11 @@ int validar_nombre(const char* nombre) {
 /*
  * Funcion: validar_valor
  * Descripcion: Valida que el valor del vehiculo este dentro del rango permitido
- * Parametros: valor - Valor del vehiculo a validar
+ * Parametros: valor - Valor del vehiculo a validar (centavos)
  * Retorno: 1 si es valido, 0 si no es valido
  */
-int validar_valor(float valor) {
-	return (valor >= MIN_AVALUO && valor <= MAX_AVALUO);
+int validar_valor(Dinero valor) {
+	return (valor >= dinero_desde_decimal(MIN_AVALUO) && valor <= dinero_desde_decimal(MAX_AVALUO));
 }
 
 
@@ -197,7 +194,7 @@ int validar_valor(float valor) {
 int registrar_vehiculo(void) {
 	char placa[10] = "", cedula[15] = "", nombre[50] = "", tipo[20] = "", subtipo[20] = "";
 	int anio = 0, cilindraje = 0;
-	float valor = 0.0;
+	Dinero valor = 0;
 	char buffer[100];
 	int paso_actual = 1;
 	
@@ -211,7 +208,7 @@ int registrar_vehiculo(void) {
 		if (strlen(nombre) > 0) printf("3. Propietario: %s\n", nombre);
 		if (strlen(tipo) > 0) printf("4. Tipo/Subtipo: %s / %s\n", tipo, subtipo);
 		if (anio > 0) printf("5. Ano: %d\n", anio);
-		if (valor > 0) printf("6. Avaluo: $%.2f\n", valor);
+		if (valor > 0) printf("6. Avaluo: $%.2f\n", dinero_a_decimal(valor));
 		printf("---------------------------------------------------\n\n");
 		
 		switch(paso_actual) {
@@ -328,9 +325,9 @@ int registrar_vehiculo(void) {
 			}
 			break;
 		case 5: // Ano
-			printf("Ingrese el ano del vehiculo (1990-%d): ", ANO_FISCAL);
+			printf("Ingrese el ano del vehiculo (1990-%d): ", tarifas_ano_fiscal());
 			if (fgets(buffer, sizeof(buffer), stdin)) { if(sscanf(buffer, "%d", &anio) != 1) anio = 0; }
-			if (anio < 1990 || anio > ANO_FISCAL) {
+			if (anio < 1990 || anio > tarifas_ano_fiscal()) {
 				printf("\nERROR: Ano fuera del rango permitido.\nPresione Enter para reintentar...");
 				getchar();
 				anio = 0;
@@ -338,11 +335,11 @@ int registrar_vehiculo(void) {
 			break;
 		case 6: // Valor
 			printf("Ingrese el avaluo ($%.2f - $%.2f): ", MIN_AVALUO, MAX_AVALUO);
-			if (fgets(buffer, sizeof(buffer), stdin)) { if(sscanf(buffer, "%f", &valor) != 1) valor = 0.0; }
+			if (fgets(buffer, sizeof(buffer), stdin)) { if(!dinero_leer(buffer, &valor)) valor = 0; }
 			if (!validar_valor(valor)) {
 				printf("\nERROR: Valor fuera del rango permitido.\nPresione Enter para reintentar...");
 				getchar();
-				valor = 0.0;
+				valor = 0;
 			} else { paso_actual++; }
 			break;
 		case 7: // Cilindraje
@@ -357,14 +354,19 @@ int registrar_vehiculo(void) {
 		}
 	}
 	
-	// --- Guardar en Archivo ---
-	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "a");
-	if (archivo == NULL) {
-		printf("\nERROR CRITICO: No se pudo abrir el archivo %s.\n", ARCHIVO_VEHICULOS);
+	// --- Guardar como evento (se agrega tambien a vehiculos.txt) ---
+	char linea[MAX_DATOS_EVENTO];
+	char valor_texto[MAX_TEXTO_DINERO];
+	snprintf(linea, sizeof(linea), "%s,%s,%s,%s,%s,%d,%s,%d", placa, cedula, nombre, tipo, subtipo, anio,
+			 dinero_formatear(valor, valor_texto), cilindraje);
+	if (!evento_registrar(EVENTO_REGISTRO, placa, linea)) {
+		printf("\nERROR CRITICO: No se pudo guardar el vehiculo en %s.\n", ARCHIVO_EVENTOS);
 		return 0;
 	}
-	fprintf(archivo, "%s,%s,%s,%s,%s,%d,%.2f,%d\n", placa, cedula, nombre, tipo, subtipo, anio, valor, cilindraje);
-	fclose(archivo);
+	
+	// Un calculo anterior de esta placa ya no corresponde a los datos guardados
+	invalidar_cache_matricula(placa);
+	indice_vehiculos_actualizar();
 	
 	limpiar_pantalla();
 	printf("=== VEHICULO REGISTRADO CON EXITO ===\n\n");
@@ -378,26 +380,39 @@ int registrar_vehiculo(void) {
 
 /*
  * Funcion: buscar_vehiculo
- * Descripcion: Busca un vehiculo por placa y muestra su informacion
+ * Descripcion: Busca un vehiculo por placa y muestra su informacion. Una
+ *              placa incompleta o con comodines (PCO-94??) lista todas las
+ *              que coinciden; un texto sin digitos se busca como nombre del
+ *              propietario
  * Parametros: Ninguno
  * Retorno: 1 si se encontro el vehiculo, 0 si no se encontro
  */
 int buscar_vehiculo(void) {
-	char placa_buscar[10], linea[MAX_LINEA2];
-	char placa[10], cedula[15], nombre[50], tipo[20], subtipo[20];
-	int anio, cilindraje;
-	float valor;
+	char placa_buscar[20];
 	char buffer[100];
+	char plantilla[9];
 	
 	limpiar_pantalla();
 	printf("=== BUSCAR VEHICULO POR PLACA ===\n");
 	do {
 		limpiar_pantalla();
-		printf("Ingrese la placa a buscar (formato ABC-1234): ");
-		if (fgets(buffer, sizeof(buffer), stdin)) sscanf(buffer, "%9s", placa_buscar);
-		else continue;
+		printf("Ingrese la placa (ABC-1234), parte de ella con comodines (PCO-94*, *1234) o el nombre del propietario: ");
+		if (!fgets(buffer, sizeof(buffer), stdin)) continue;
+		buffer[strcspn(buffer, "\n")] = '\0';
+		
+		// Los nombres no llevan digitos, guiones ni comodines: buscar por propietario
+		if (strpbrk(buffer, "0123456789-?_*") == NULL) {
+			return buscar_vehiculo_por_nombre(buffer);
+		}
+		
+		if (sscanf(buffer, "%19s", placa_buscar) != 1) continue;
 		convertir_a_mayusculas(placa_buscar);
 		
+		// Placa incompleta o con comodines: listar todas las que coinciden
+		if (!validar_placa(placa_buscar) && plantilla_patron_placa(placa_buscar, plantilla)) {
+			return buscar_vehiculo_por_patron(placa_buscar);
+		}
+		
 		if (!validar_placa(placa_buscar)) {
 			printf("   ERROR: Formato de placa incorrecto. Intente de nuevo.\n");
 			continue;
@@ -405,87 +420,191 @@ int buscar_vehiculo(void) {
 		break;
 	} while (1);
 	
-	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "r");
-	if (archivo == NULL) {
+	DatosVehiculo vehiculo;
+	if (!repositorio_buscar_vehiculo(placa_buscar, &vehiculo)) {
+		printf("\nVehiculo con placa '%s' no fue encontrado.\n", placa_buscar);
+		return 0;
+	}
+	
+	printf("\n--- VEHICULO ENCONTRADO ---\n");
+	printf(" Placa:        %s\n", vehiculo.placa);
+	printf(" Propietario:  %s\n", vehiculo.propietario);
+	printf(" Cedula:       %s\n", vehiculo.cedula);
+	printf(" Tipo:         %s\n", vehiculo.tipo);
+	printf(" Subtipo:      %s\n", vehiculo.subtipo);
+	printf(" Ano:          %d\n", vehiculo.ano);
+	printf(" Valor:        $%.2f\n", dinero_a_decimal(vehiculo.avaluo));
+	printf(" Cilindraje:   %d cc\n", vehiculo.cilindraje);
+	printf("---------------------------\n");
+	return 1;
+}
+
+/*
+ * Funcion: buscar_vehiculo_por_patron
+ * Descripcion: Muestra los vehiculos cuya placa cumple un patron con
+ *              comodines ('?' un caracter, '*' el resto) o un prefijo
+ * Parametros: patron - Por ejemplo PCO-94??, PCO-94 o *1234
+ * Retorno: 1 si encontro vehiculos, 0 si no
+ */
+int buscar_vehiculo_por_patron(const char* patron) {
+	DatosVehiculo resultados[MAX_RESULTADOS_PATRON];
+	char plantilla[9];
+	
+	if (!plantilla_patron_placa(patron, plantilla)) {
+		printf("\nPatron de placa '%s' incorrecto.\n", patron);
+		return 0;
+	}
+	
+	int cantidad = indice_buscar_patron_placa(patron, resultados, MAX_RESULTADOS_PATRON);
+	if (cantidad <= 0) {
+		printf("\nNo hay vehiculos con placa %s.\n", plantilla);
+		return 0;
+	}
+	
+	printf("\n--- PLACAS QUE COINCIDEN CON %s ---\n", plantilla);
+	printf(" %-10s %-12s %-12s %-12s %s\n", "PLACA", "TIPO", "SUBTIPO", "CEDULA", "PROPIETARIO");
+	int mostrados = cantidad < MAX_RESULTADOS_PATRON ? cantidad : MAX_RESULTADOS_PATRON;
+	for (int i = 0; i < mostrados; i++) {
+		printf(" %-10s %-12s %-12s %-12s %s\n", resultados[i].placa, resultados[i].tipo,
+			   resultados[i].subtipo, resultados[i].cedula, resultados[i].propietario);
+	}
+	if (cantidad > mostrados) {
+		printf(" ... y %d placas mas. Agregue caracteres al patron para acotar.\n", cantidad - mostrados);
+	}
+	printf("---------------------------\n");
+	return 1;
+}
+
+/*
+ * Funcion: buscar_vehiculo_por_nombre
+ * Descripcion: Muestra los vehiculos cuyo propietario tiene un nombre
+ *              parecido al buscado, del mas parecido al menos parecido.
+ *              Tolera errores de escritura, tildes y espacios de mas
+ * Parametros: nombre - Nombre (o parte del nombre) del propietario
+ * Retorno: 1 si encontro vehiculos, 0 si no
+ */
+int buscar_vehiculo_por_nombre(const char* nombre) {
+	ResultadoNombre resultados[MAX_RESULTADOS_NOMBRE];
+	char normalizado[MAX_NOMBRE_NORMALIZADO];
+	
+	if (normalizar_nombre(nombre, normalizado, sizeof(normalizado)) == 0) {
+		printf("\nIngrese una placa o un nombre para buscar.\n");
+		return 0;
+	}
+	
+	int cantidad = indice_buscar_nombre(nombre, resultados, MAX_RESULTADOS_NOMBRE);
+	if (cantidad < 0) {
 		printf("No hay vehiculos registrados o no se pudo abrir el archivo %s.\n", ARCHIVO_VEHICULOS);
 		return 0;
 	}
+	if (cantidad == 0) {
+		printf("\nNo se encontraron propietarios con un nombre parecido a '%s'.\n", normalizado);
+		return 0;
+	}
 	
-	while (fgets(linea, sizeof(linea), archivo)) {
-		int items_leidos = sscanf(linea, "%9[^,],%14[^,],%49[^,],%19[^,],%19[^,],%d,%f,%d",
-								  placa, cedula, nombre, tipo, subtipo, &anio, &valor, &cilindraje);
-		
-		if (items_leidos == 8 && strcmp(placa, placa_buscar) == 0) {
-			printf("\n--- VEHICULO ENCONTRADO ---\n");
-			printf(" Placa:        %s\n", placa);
-			printf(" Propietario:  %s\n", nombre);
-			printf(" Cedula:       %s\n", cedula);
-			printf(" Tipo:         %s\n", tipo);
-			printf(" Subtipo:      %s\n", subtipo);
-			printf(" Ano:          %d\n", anio);
-			printf(" Valor:        $%.2f\n", valor);
-			printf(" Cilindraje:   %d cc\n", cilindraje);
-			printf("---------------------------\n");
-			fclose(archivo);
-			return 1;
-		}
+	printf("\n--- PROPIETARIOS PARECIDOS A '%s' ---\n", normalizado);
+	printf(" %-9s %-10s %-12s %s\n", "PARECIDO", "PLACA", "CEDULA", "PROPIETARIO");
+	for (int i = 0; i < cantidad; i++) {
+		printf(" %7.0f%%  %-10s %-12s %s\n", resultados[i].similitud * 100.0,
+			   resultados[i].vehiculo.placa, resultados[i].vehiculo.cedula, resultados[i].vehiculo.propietario);
 	}
-	fclose(archivo);
-	printf("\nVehiculo con placa '%s' no fue encontrado.\n", placa_buscar);
-	return 0;
+	printf("---------------------------\n");
+	return 1;
 }
 
 /**Aqui lo que se hace es que se busca los datos del vehiculo que usurio desea mediante la placa , se abre el txt y se procede
 a guardar lso datos en la estructura daatos vehiculos**/
 
 int obtener_datos_vehiculo_para_calculo_desde_archivo(const char* placa_buscada, DatosVehiculo* vehiculo_data) {
-	FILE* archivo = fopen(ARCHIVO_VEHICULOS, "r");
-	if (archivo == NULL) {
+	if (repositorio_usa_proyecciones(TABLA_VEHICULOS) && !indice_vehiculos_actualizar()) {
 		printf("Error: No se pudo abrir el archivo de vehiculos en '%s'.\n", ARCHIVO_VEHICULOS);
 		return 0;
 	}
-	char linea[MAX_LINEA2];
+	return repositorio_buscar_vehiculo(placa_buscada, vehiculo_data);
+}
+
+/*
+ * Funcion: leer_linea_vehiculo
+ * Descripcion: Convierte una linea de vehiculos.txt en los datos usados
+ *              para el calculo de matricula (sin multas ni mora)
+ * Parametros: linea, vehiculo_data (salida)
+ * Retorno: 1 si la linea tiene los 8 campos, 0 si no
+ */
+int leer_linea_vehiculo(const char* linea, DatosVehiculo* vehiculo_data) {
 	char placa_leida[10], cedula[15], nombre[50], tipo_str[20], subtipo_str[20];
+	char avaluo_texto[MAX_TEXTO_DINERO];
 	int anio, cilindraje;
-	float avaluo;
-	
-	while (fgets(linea, sizeof(linea), archivo)) {
-		int items_leidos = sscanf(linea, "%9[^,],%14[^,],%49[^,],%19[^,],%19[^,],%d,%f,%d",
-								  placa_leida, cedula, nombre, tipo_str, subtipo_str,
-								  &anio, &avaluo, &cilindraje);
-		
-		if (items_leidos == 8 && strcmp(placa_leida, placa_buscada) == 0) {
-			strcpy(vehiculo_data->placa, placa_leida);
-			strcpy(vehiculo_data->cedula, cedula);
-			strcpy(vehiculo_data->propietario, nombre);
-			strcpy(vehiculo_data->tipo, tipo_str);
-			strcpy(vehiculo_data->subtipo, subtipo_str);
-			vehiculo_data->ano = anio;
-			vehiculo_data->avaluo = avaluo;
-			vehiculo_data->cilindraje = cilindraje;
-			vehiculo_data->tiene_multas = 0;
-			vehiculo_data->valor_multas = 0.0;
-			vehiculo_data->meses_retraso = 0;
-			fclose(archivo);
-			return 1;
-		}
-	}
-	fclose(archivo);
-	return 0;
+	Dinero avaluo;
+	
+	int items_leidos = sscanf(linea, "%9[^,],%14[^,],%49[^,],%19[^,],%19[^,],%d,%23[^,],%d",
+							  placa_leida, cedula, nombre, tipo_str, subtipo_str,
+							  &anio, avaluo_texto, &cilindraje);
+	if (items_leidos != 8 || !dinero_leer(avaluo_texto, &avaluo)) return 0;
+	
+	strcpy(vehiculo_data->placa, placa_leida);
+	strcpy(vehiculo_data->cedula, cedula);
+	strcpy(vehiculo_data->propietario, nombre);
+	strcpy(vehiculo_data->tipo, tipo_str);
+	strcpy(vehiculo_data->subtipo, subtipo_str);
+	vehiculo_data->ano = anio;
+	vehiculo_data->avaluo = avaluo;
+	vehiculo_data->cilindraje = cilindraje;
+	vehiculo_data->tiene_multas = 0;
+	vehiculo_data->valor_multas = 0;
+	vehiculo_data->meses_retraso = 0;
+	return 1;
 }
 
 // ===================================================================
 // FUNCIONES DE CONSULTA Y REPORTES
 // ===================================================================
 
+/*
+ * Funcion: mostrar_linea_matriculado
+ * Descripcion: Muestra un vehiculo matriculado al recorrer el repositorio
+ * Parametros: clave, linea, contexto - Contador de vehiculos mostrados
+ * Retorno: 1 para seguir recorriendo
+ */
+static int mostrar_linea_matriculado(const char* clave, const char* linea, void* contexto) {
+    (void)clave;
+    int* contador = contexto;
+    
+    // Parsear la linea del vehiculo matriculado
+    char certificado[50], placa[20], cedula[15], propietario[100], tipo[20];
+    char subtipo[20], fecha_matricula[20], estado[20];
+    char valor[MAX_TEXTO_DINERO];
+    int ano, cilindraje;
+    
+    // Formato: certificado|placa|cedula|propietario|tipo|ano|valor|cilindraje|subtipo|fecha_matricula|estado
+    if (sscanf(linea, "%49[^|]|%19[^|]|%14[^|]|%99[^|]|%19[^|]|%d|%23[^|]|%d|%19[^|]|%19[^|]|%19[^\n]",
+               certificado, placa, cedula, propietario, tipo, &ano, valor, &cilindraje, 
+               subtipo, fecha_matricula, estado) == 11) {
+        
+        (*contador)++;
+        
+        // Formatear tipo completo
+        char tipo_completo[100];
+        snprintf(tipo_completo, sizeof(tipo_completo), "%s-%s", tipo, subtipo);
+        
+        // Mostrar la linea del vehiculo matriculado
+        printf("%-12s %-20.20s %-25.25s %-15.15s %-12s %-15s\n",
+               placa, certificado, propietario, tipo_completo, fecha_matricula, estado);
+    }
+    return 1;
+}
+
 /*
  * Funcion: mostrar_vehiculos_matriculados
  * Descripcion: Muestra un listado de todos los vehiculos que tienen
- *              comprobantes de matricula generados
+ *              comprobantes de matricula generados, en el orden de
+ *              registro o por placa, valor o fecha de matricula
  * Parametros: ninguno
  * Retorno: void
  */
 void mostrar_vehiculos_matriculados() {
+    // Campo de la linea para cada criterio: placa, valor y fecha_matricula
+    static const int campos_orden[] = {0, 1, 6, 9};
+    
     system("cls");
     printf("\n");
     printf("===========================================================================\n");
@@ -494,49 +613,21 @@ void mostrar_vehiculos_matriculados() {
     printf("===========================================================================\n");
     printf("\n");
     
-    // Verificar si existe el archivo de vehiculos matriculados
-    FILE* archivo = fopen("vehiculos_matriculados.txt", "r");
-    if (!archivo) {
-        printf("No se encontraron vehiculos matriculados.\n");
-        printf("El archivo de vehiculos matriculados no existe.\n");
-        printf("\nPresione Enter para continuar...");
-        getchar();
-        return;
-    }
+    int criterio = orden_pedir_criterio("Valor");
+    printf("\n");
     
     printf("%-12s %-20s %-25s %-15s %-12s %-15s\n", 
            "PLACA", "CERTIFICADO", "PROPIETARIO", "TIPO VEHICULO", "FECHA", "ESTADO");
     printf("---------------------------------------------------------------------------\n");
     
-    char linea[500];
+    // Los vehiculos matriculados salen del motor de almacen.cfg; si se pidio
+    // un orden, pasan por el ordenamiento externo
     int contador = 0;
-    
-    while (fgets(linea, sizeof(linea), archivo)) {
-        // Parsear la linea del vehiculo matriculado
-        char certificado[50], placa[20], cedula[15], propietario[100], tipo[20];
-        char subtipo[20], fecha_matricula[20], estado[20];
-        int ano, cilindraje;
-        float valor;
-        
-        // Formato: certificado|placa|cedula|propietario|tipo|ano|valor|cilindraje|subtipo|fecha_matricula|estado
-        if (sscanf(linea, "%49[^|]|%19[^|]|%14[^|]|%99[^|]|%19[^|]|%d|%f|%d|%19[^|]|%19[^|]|%19[^\n]",
-                   certificado, placa, cedula, propietario, tipo, &ano, &valor, &cilindraje, 
-                   subtipo, fecha_matricula, estado) == 11) {
-            
-            contador++;
-            
-            // Formatear tipo completo
-            char tipo_completo[100];
-            snprintf(tipo_completo, sizeof(tipo_completo), "%s-%s", tipo, subtipo);
-            
-            // Mostrar la linea del vehiculo matriculado
-            printf("%-12s %-20.20s %-25.25s %-15.15s %-12s %-15s\n",
-                   placa, certificado, propietario, tipo_completo, fecha_matricula, estado);
-        }
+    if (repositorio_recorrer_ordenado(TABLA_MATRICULADOS, criterio, campos_orden[criterio],
+                                      mostrar_linea_matriculado, &contador) < 0) {
+        printf("No se pudo ordenar el listado (memoria o archivos temporales).\n");
     }
     
-    fclose(archivo);
-    
     if (contador == 0) {
         printf("No se encontraron vehiculos matriculados.\n");
     } else {
@@ -564,9 +655,10 @@ void mostrar_reporte_detallado_vehiculos() {
     printf("===========================================================================\n");
     printf("\n");
     
-    // Verificar si existe el archivo de comprobantes
-    FILE* archivo = fopen("comprobantes/comprobantes.txt", "r");
-    if (!archivo) {
+    // Verificar si existen comprobantes (todas las particiones mensuales)
+    int periodos[MAX_PARTICIONES];
+    int particiones = particion_listar(PARTICION_COMPROBANTES, 0, 0, periodos, MAX_PARTICIONES);
+    if (particiones == 0) {
         printf("No se encontraron vehiculos matriculados.\n");
         printf("El archivo de comprobantes no existe.\n");
         printf("\nPresione Enter para continuar...");
@@ -576,68 +668,86 @@ void mostrar_reporte_detallado_vehiculos() {
     
     char linea[500];
     int contador = 0;
-    float total_recaudado = 0;
+    Dinero total_recaudado = 0;
     int pagados = 0, pendientes = 0, vencidos = 0;
     
-    while (fgets(linea, sizeof(linea), archivo)) {
-        // Parsear la linea del comprobante
-        char placa[20], numero_comprobante[50], propietario[100], tipo[50], subtipo[50];
-        char fecha_emision[20], fecha_vencimiento[20];
-        float total;
-        int estado;
+    // La revision de cada placa se busca en el conjunto de revisiones
+    // aprobadas en vez de leer revisiones.txt por cada comprobante
+    int conjuntos_listos = conjuntos_estado_actualizar();
+    const MapaBits* revisiones = conjunto_estado(CONJUNTO_REVISION_APROBADA);
+    
+    for (int p = 0; p < particiones; p++) {
+        char ruta[MAX_RUTA_PARTICION];
+        particion_ruta(ruta, PARTICION_COMPROBANTES, periodos[p]);
+        FILE* archivo = fopen(ruta, "r");
+        if (!archivo) {
+            continue;
+        }
         
-        if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%f|%d",
-                   placa, numero_comprobante, propietario, tipo, subtipo, 
-                   fecha_emision, fecha_vencimiento, &total, &estado) == 9) {
-            
-            contador++;
-            
-            printf("===========================================================================\n");
-            printf("VEHICULO #%d\n", contador);
-            printf("===========================================================================\n");
-            printf("  Placa:                %s\n", placa);
-            printf("  Numero de Comprobante: %s\n", numero_comprobante);
-            printf("  Propietario:          %s\n", propietario);
-            printf("  Tipo de Vehiculo:     %s - %s\n", tipo, subtipo);
-            printf("  Fecha de Emision:     %s\n", fecha_emision);
-            printf("  Fecha de Vencimiento: %s\n", fecha_vencimiento);
-            printf("  Total a Pagar:        $%.2f\n", total);
+        while (fgets(linea, sizeof(linea), archivo)) {
+            // Parsear la linea del comprobante
+            char placa[20], numero_comprobante[50], propietario[100], tipo[50], subtipo[50];
+            char fecha_emision[20], fecha_vencimiento[20], total_texto[MAX_TEXTO_DINERO];
+            Dinero total;
+            int estado;
             
-            // Determinar estado y contabilizar
-            char estado_str[20];
-            switch(estado) {
-                case 0: 
-                    strcpy(estado_str, "PENDIENTE DE PAGO"); 
-                    pendientes++;
-                    break;
-                case 1: 
-                    strcpy(estado_str, "PAGADO"); 
-                    pagados++;
-                    total_recaudado += total;
-                    break;
-                case 2: 
-                    strcpy(estado_str, "VENCIDO"); 
-                    vencidos++;
-                    break;
-                default: 
-                    strcpy(estado_str, "ESTADO DESCONOCIDO");
+            if (sscanf(linea, "%19[^|]|%49[^|]|%99[^|]|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%23[^|]|%d",
+                       placa, numero_comprobante, propietario, tipo, subtipo, 
+                       fecha_emision, fecha_vencimiento, total_texto, &estado) == 9 &&
+                dinero_leer(total_texto, &total)) {
+                
+                contador++;
+                
+                printf("===========================================================================\n");
+                printf("VEHICULO #%d\n", contador);
+                printf("===========================================================================\n");
+                printf("  Placa:                %s\n", placa);
+                printf("  Numero de Comprobante: %s\n", numero_comprobante);
+                printf("  Propietario:          %s\n", propietario);
+                printf("  Tipo de Vehiculo:     %s - %s\n", tipo, subtipo);
+                printf("  Fecha de Emision:     %s\n", fecha_emision);
+                printf("  Fecha de Vencimiento: %s\n", fecha_vencimiento);
+                printf("  Total a Pagar:        $%.2f\n", dinero_a_decimal(total));
+                
+                // Determinar estado y contabilizar
+                char estado_str[20];
+                switch(estado) {
+                    case 0: 
+                        strcpy(estado_str, "PENDIENTE DE PAGO"); 
+                        pendientes++;
+                        break;
+                    case 1: 
+                        strcpy(estado_str, "PAGADO"); 
+                        pagados++;
+                        total_recaudado += total;
+                        break;
+                    case 2: 
+                        strcpy(estado_str, "VENCIDO"); 
+                        vencidos++;
+                        break;
+                    default: 
+                        strcpy(estado_str, "ESTADO DESCONOCIDO");
+                }
+                
+                printf("  Estado:               %s\n", estado_str);
+                
+                // Verificar estado de revision tecnica
+                uint32_t id;
+                int revision = conjuntos_listos ? conjuntos_id_placa(placa, &id) && mapa_contiene(revisiones, id)
+                                                : vehiculo_tiene_revision(placa);
+                if (revision) {
+                    printf("  Revision Tecnica:     APROBADA\n");
+                } else {
+                    printf("  Revision Tecnica:     PENDIENTE\n");
+                }
+                
+                printf("\n");
             }
-            
-            printf("  Estado:               %s\n", estado_str);
-            
-            // Verificar estado de revision tecnica
-            if (vehiculo_tiene_revision(placa)) {
-                printf("  Revision Tecnica:     APROBADA\n");
-            } else {
-                printf("  Revision Tecnica:     PENDIENTE\n");
-            }
-            
-            printf("\n");
         }
+        
+        fclose(archivo);
     }
     
-    fclose(archivo);
-    
     if (contador == 0) {
         printf("No se encontraron vehiculos matriculados.\n");
     } else {
@@ -648,7 +758,7 @@ void mostrar_reporte_detallado_vehiculos() {
         printf("  Comprobantes Pagados:            %d\n", pagados);
         printf("  Comprobantes Pendientes:         %d\n", pendientes);
         printf("  Comprobantes Vencidos:           %d\n", vencidos);
-        printf("  Total Recaudado:                 $%.2f\n", total_recaudado);
+        printf("  Total Recaudado:                 $%.2f\n", dinero_a_decimal(total_recaudado));
         printf("  Porcentaje de Pago:              %.1f%%\n", 
                contador > 0 ? (float)pagados / contador * 100 : 0);
         printf("===========================================================================\n");
@@ -658,6 +768,113 @@ void mostrar_reporte_detallado_vehiculos() {
     getchar();
 }
 
+/*
+ * Funcion: mostrar_placa_de_conjunto
+ * Descripcion: Muestra una placa al recorrer el resultado de una consulta
+ */
+static int mostrar_placa_de_conjunto(uint32_t id, void* contexto) {
+    int* mostradas = contexto;
+    printf("%s%s", (*mostradas)++ ? ", " : "      ", conjuntos_placa(id));
+    return *mostradas < MAX_PLACAS_REPORTE;
+}
+
+/*
+ * Funcion: mostrar_consulta_conjunto
+ * Descripcion: Muestra cuantos vehiculos tiene el resultado de una
+ *              consulta y las primeras placas
+ * Parametros: titulo, conjunto
+ * Retorno: void
+ */
+static void mostrar_consulta_conjunto(const char* titulo, const MapaBits* conjunto) {
+    long cantidad = mapa_cardinalidad(conjunto);
+    int mostradas = 0;
+    
+    printf("  %-40s %ld\n", titulo, cantidad);
+    if (cantidad > 0) {
+        mapa_recorrer(conjunto, mostrar_placa_de_conjunto, &mostradas);
+        printf("%s\n", cantidad > mostradas ? ", ..." : "");
+    }
+}
+
+/*
+ * Funcion: mostrar_reporte_estados
+ * Descripcion: Reporte de vehiculos por estado. Cada pregunta es una
+ *              operacion entre conjuntos (AND, OR, ANDNOT) y un conteo
+ *              de bits, sobre los conjuntos armados una sola vez
+ * Parametros: ninguno
+ * Retorno: void
+ */
+void mostrar_reporte_estados() {
+    system("cls");
+    printf("\n");
+    printf("===========================================================================\n");
+    printf("                    REPORTE DE VEHICULOS POR ESTADO\n");
+    printf("                       AGENCIA NACIONAL DE TRANSITO\n");
+    printf("===========================================================================\n");
+    printf("\n");
+    
+    if (!conjuntos_estado_actualizar()) {
+        printf("No hay memoria suficiente para armar los conjuntos de estados.\n");
+        printf("\nPresione Enter para continuar...");
+        getchar();
+        return;
+    }
+    
+    const MapaBits* registrados = conjunto_estado(CONJUNTO_REGISTRADO);
+    const MapaBits* pagados = conjunto_estado(CONJUNTO_PAGADO);
+    const MapaBits* pendientes = conjunto_estado(CONJUNTO_PENDIENTE);
+    const MapaBits* vencidos = conjunto_estado(CONJUNTO_VENCIDO);
+    const MapaBits* revisiones = conjunto_estado(CONJUNTO_REVISION_APROBADA);
+    const MapaBits* matriculados = conjunto_estado(CONJUNTO_MATRICULADO);
+    
+    printf("  %-40s %ld\n", "Vehiculos registrados:", mapa_cardinalidad(registrados));
+    printf("  %-40s %ld\n", "Comprobante pagado:", mapa_cardinalidad(pagados));
+    printf("  %-40s %ld\n", "Comprobante pendiente:", mapa_cardinalidad(pendientes));
+    printf("  %-40s %ld\n", "Comprobante vencido:", mapa_cardinalidad(vencidos));
+    printf("  %-40s %ld\n", "Revision tecnica aprobada:", mapa_cardinalidad(revisiones));
+    printf("  %-40s %ld\n", "Matriculados:", mapa_cardinalidad(matriculados));
+    printf("\n---------------------------------------------------------------------------\n");
+    
+    MapaBits sin_revision, pagados_con_revision, listos, con_pago_o_pendiente, con_comprobante, sin_comprobante;
+    MapaBits pendientes_vencidos;
+    int exito = mapa_y_no(pagados, revisiones, &sin_revision);
+    exito = mapa_y(pagados, revisiones, &pagados_con_revision) && exito;
+    exito = mapa_y_no(&pagados_con_revision, matriculados, &listos) && exito;
+    exito = mapa_o(pagados, pendientes, &con_pago_o_pendiente) && exito;
+    exito = mapa_o(&con_pago_o_pendiente, vencidos, &con_comprobante) && exito;
+    exito = mapa_y_no(registrados, &con_comprobante, &sin_comprobante) && exito;
+    exito = mapa_y(pendientes, vencidos, &pendientes_vencidos) && exito;
+    
+    if (!exito) {
+        printf("No hay memoria suficiente para las consultas.\n");
+    } else {
+        mostrar_consulta_conjunto("Pagados sin revision aprobada:", &sin_revision);
+        mostrar_consulta_conjunto("Pagados y con revision, sin matricula:", &listos);
+        mostrar_consulta_conjunto("Registrados sin comprobante:", &sin_comprobante);
+        mostrar_consulta_conjunto("Pendientes y vencidos:", &pendientes_vencidos);
+        
+        // Pendientes y vencidos de cada tipo y subtipo: solo se cuentan
+        for (int i = 0; i < conjuntos_cantidad_categorias(); i++) {
+            const CategoriaEstado* categoria = conjuntos_categoria(i);
+            long cantidad = mapa_cardinalidad_y(&pendientes_vencidos, &categoria->vehiculos);
+            printf("    %-10s %-27s %ld de %ld\n", categoria->es_subtipo ? "Subtipo" : "Tipo",
+                   categoria->nombre, cantidad, mapa_cardinalidad(&categoria->vehiculos));
+        }
+    }
+    printf("===========================================================================\n");
+    
+    mapa_liberar(&sin_revision);
+    mapa_liberar(&pagados_con_revision);
+    mapa_liberar(&listos);
+    mapa_liberar(&con_pago_o_pendiente);
+    mapa_liberar(&con_comprobante);
+    mapa_liberar(&sin_comprobante);
+    mapa_liberar(&pendientes_vencidos);
+    
+    printf("\nPresione Enter para continuar...");
+    getchar();
+}
+
 // ===================================================================
 // IMPLEMENTACION DE FUNCIONES PARA REVISIONES TECNICAS SIMPLIFICADAS
 // ===================================================================
@@ -739,20 +956,17 @@ int registrar_revision_simple() {
 		}
 	}
 	
-	// Guardar en archivo
-	FILE* archivo = fopen(ARCHIVO_REVISIONES, "a");
-	if (archivo == NULL) {
-		printf("\nError: No se pudo abrir el archivo de revisiones.\n");
+	// Guardar como evento (se agrega tambien a revisiones.txt)
+	char linea[MAX_DATOS_EVENTO];
+	snprintf(linea, sizeof(linea), "%s,%s,%d,%s",
+			revision.placa, revision.fecha_revision, 
+			revision.aprobada, revision.observaciones);
+	if (!evento_registrar(EVENTO_REVISION, revision.placa, linea)) {
+		printf("\nError: No se pudo guardar la revision.\n");
 		pausar();
 		return 0;
 	}
 	
-	fprintf(archivo, "%s,%s,%d,%s\n",
-			revision.placa, revision.fecha_revision, 
-			revision.aprobada, revision.observaciones);
-	
-	fclose(archivo);
-	
 	// Mostrar resultado
 	printf("\n=== REVISION TECNICA REGISTRADA ===\n");
 	printf("Placa: %s\n", revision.placa);
@@ -869,16 +1083,19 @@ void proceso_matriculacion() {
 	char placa[10], buffer[100];
 	DatosVehiculo vehiculo_data;
 	ResultadoMatricula resultado;
+	ExpedienteVehiculo expediente;
 	
 	limpiar_pantalla();
 	printf("=== PROCESO DE MATRICULACION VEHICULAR ===\n");
 	printf("===========================================\n\n");
 	
-	// Paso 1: Solicitar placa
+	// Paso 1: Solicitar placa (los indices se ponen al dia mientras tanto)
+	expediente_precargar();
 	printf("PASO 1: IDENTIFICACION DEL VEHICULO\n");
 	printf("-----------------------------------\n");
 	printf("Ingrese la placa del vehiculo: ");
 	if (!fgets(buffer, sizeof(buffer), stdin)) {
+		expediente_esperar_precarga();
 		printf("Error al leer la placa.\n");
 		pausar();
 		return;
@@ -886,8 +1103,8 @@ void proceso_matriculacion() {
 	sscanf(buffer, "%9s", placa);
 	convertir_a_mayusculas(placa);
 	
-	// Verificar que el vehiculo existe
-	if (!vehiculo_ya_existe(placa)) {
+	// Vehiculo y revisiones en una sola consulta
+	if (!expediente_obtener(placa, &expediente)) {
 		printf("\nError: El vehiculo con placa %s no esta registrado.\n", placa);
 		printf("Debe registrar el vehiculo primero.\n");
 		pausar();
@@ -900,7 +1117,7 @@ void proceso_matriculacion() {
 	printf("\nPASO 2: VERIFICACION DE REVISION TECNICA\n");
 	printf("----------------------------------------\n");
 	
-	if (!vehiculo_tiene_revision(placa)) {
+	if (!expediente.revision_aprobada) {
 		printf("El vehiculo NO tiene revision tecnica aprobada.\n");
 		printf("Desea registrar la revision tecnica ahora? (S/N): ");
 		if (!fgets(buffer, sizeof(buffer), stdin)) {
@@ -926,13 +1143,12 @@ void proceso_matriculacion() {
 			}
 			
 			// Guardar revision aprobada
-			FILE* archivo = fopen(ARCHIVO_REVISIONES, "a");
-			if (archivo) {
-				time_t t = time(NULL);
-				struct tm tm = *localtime(&t);
-				fprintf(archivo, "%s,%02d/%02d/%04d,1,Registro durante matriculacion\n",
-						placa, tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900);
-				fclose(archivo);
+			char linea[MAX_DATOS_EVENTO];
+			time_t t = time(NULL);
+			struct tm tm = *localtime(&t);
+			snprintf(linea, sizeof(linea), "%s,%02d/%02d/%04d,1,Registro durante matriculacion",
+					placa, tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900);
+			if (evento_registrar(EVENTO_REVISION, placa, linea)) {
 				printf("Revision tecnica registrada como APROBADA.\n");
 			}
 		} else {
@@ -948,23 +1164,19 @@ void proceso_matriculacion() {
 	printf("\nPASO 3: CALCULO DE MATRICULA\n");
 	printf("----------------------------\n");
 	
-	if (!obtener_datos_vehiculo_para_calculo_desde_archivo(placa, &vehiculo_data)) {
-		printf("Error: No se pudieron obtener los datos del vehiculo.\n");
-		pausar();
-		return;
-	}
+	vehiculo_data = expediente.vehiculo;
 	
 	// Calcular matricula
-	resultado = calcular_matricula_completa(vehiculo_data);
+	resultado = calcular_matricula_cacheada(&vehiculo_data);
 	
 	printf("Calculando matricula para %s...\n", placa);
 	printf("\nRESUMEN DEL CALCULO:\n");
-	printf("Impuesto a la Propiedad: $%.2f\n", resultado.impuesto_propiedad);
-	printf("Impuesto de Rodaje: $%.2f\n", resultado.impuesto_rodaje);
+	printf("Impuesto a la Propiedad: $%.2f\n", dinero_a_decimal(resultado.impuesto_propiedad));
+	printf("Impuesto de Rodaje: $%.2f\n", dinero_a_decimal(resultado.impuesto_rodaje));
 	printf("Tasas y servicios: $%.2f\n", 
-		   resultado.tasa_sppat + resultado.tasa_ant + resultado.tasa_prefectura + 
-		   resultado.valor_rtv + resultado.valor_adhesivo);
-	printf("TOTAL A PAGAR: $%.2f\n", resultado.total_matricula);
+		   dinero_a_decimal(resultado.tasa_sppat + resultado.tasa_ant + resultado.tasa_prefectura + 
+		   resultado.valor_rtv + resultado.valor_adhesivo));
+	printf("TOTAL A PAGAR: $%.2f\n", dinero_a_decimal(resultado.total_matricula));
 	
 	// Paso 4: Confirmar y procesar pago
 	printf("\nPASO 4: PROCESAMIENTO DE PAGO\n");
@@ -998,25 +1210,106 @@ void proceso_matriculacion() {
 	printf("Numero de Comprobante: %s\n", numero_comprobante);
 	printf("Placa: %s\n", placa);
 	printf("Fecha: %02d/%02d/%04d\n", tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900);
-	printf("Total Pagado: $%.2f\n", resultado.total_matricula);
+	printf("Total Pagado: $%.2f\n", dinero_a_decimal(resultado.total_matricula));
 	printf("Estado: PAGADO\n");
 	printf("=======================================\n");
 	printf("SU VEHICULO YA PUEDE CIRCULAR LEGALMENTE\n");
 	printf("=======================================\n");
 	
 	// Guardar en archivo de comprobantes pagados
-	FILE* archivo_pagados = fopen("matriculas_pagadas.txt", "a");
-	if (archivo_pagados) {
-		fprintf(archivo_pagados, "%s,%s,%02d/%02d/%04d,%.2f,PAGADO\n",
-				numero_comprobante, placa, tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900,
-				resultado.total_matricula);
-		fclose(archivo_pagados);
-	}
+	char linea_pagado[MAX_DATOS_EVENTO];
+	MatriculaPagada registro;
+	snprintf(registro.numero_comprobante, sizeof(registro.numero_comprobante), "%s", numero_comprobante);
+	snprintf(registro.placa, sizeof(registro.placa), "%s", placa);
+	strftime(registro.fecha_pago, sizeof(registro.fecha_pago), "%d/%m/%Y", &tm);
+	registro.monto = resultado.total_matricula;
+	formatear_matricula_pagada(linea_pagado, sizeof(linea_pagado), &registro);
+	evento_registrar(EVENTO_MATRICULA_PAGADA, placa, linea_pagado);
 	
 	printf("\nMatriculacion completada exitosamente!\n");
 	pausar();
 }
 
+// ===================================================================
+// PLANTILLA DEL CERTIFICADO DE MATRICULACION
+// ===================================================================
+
+// Nombres de los espacios de la plantilla; el orden define el indice del valor
+enum {
+	CE_NUMERO, CE_PLACA, CE_TIPO, CE_SUBTIPO, CE_ANO, CE_AVALUO, CE_CILINDRAJE,
+	CE_CEDULA, CE_NOMBRE, CE_DIA, CE_MES, CE_ANO_EMISION, CE_ANO_VALIDEZ, CE_NUM_ESPACIOS
+};
+
+static const char* const nombres_certificado[CE_NUM_ESPACIOS] = {
+	"numero", "placa", "tipo", "subtipo", "ano", "avaluo", "cilindraje",
+	"cedula", "nombre", "dia", "mes", "ano_emision", "ano_validez"
+};
+
+static const char* const fuente_certificado =
+	"=======================================================\n"
+	"           CERTIFICADO DE MATRICULACION\n"
+	"           AGENCIA NACIONAL DE TRANSITO\n"
+	"                    ECUADOR\n"
+	"=======================================================\n\n"
+	"DATOS DEL VEHICULO:\n"
+	"-------------------------------------------------------\n"
+	"Numero de Certificado: {numero}\n"
+	"Placa: {placa}\n"
+	"Tipo: {tipo}\n"
+	"Subtipo: {subtipo}\n"
+	"Ano: {ano:d}\n"
+	"Avaluo: ${avaluo:$}\n"
+	"Cilindraje: {cilindraje:d} cc\n\n"
+	"DATOS DEL PROPIETARIO:\n"
+	"-------------------------------------------------------\n"
+	"Cedula: {cedula}\n"
+	"Nombre: {nombre}\n\n"
+	"CERTIFICACION:\n"
+	"-------------------------------------------------------\n"
+	"Fecha de matriculacion: {dia:02}/{mes:02}/{ano_emision:04}\n"
+	"Valido hasta: {dia:02}/{mes:02}/{ano_validez:04}\n"
+	"Estado: MATRICULADO\n\n"
+	"=======================================================\n"
+	"      SU VEHICULO ESTA LEGALMENTE MATRICULADO\n"
+	"           PUEDE CIRCULAR SIN RESTRICCIONES\n"
+	"=======================================================\n";
+
+static Plantilla plantilla_certificado;
+
+/*
+ * Funcion: renderizar_certificado
+ * Descripcion: Renderiza el certificado de matriculacion al final del buffer
+ * Parametros:
+ *   - salida: Buffer donde se agrega el certificado
+ *   - vehiculo: Datos del vehiculo matriculado
+ *   - numero_matricula: Numero del certificado
+ *   - fecha: Fecha de matriculacion
+ * Retorno: 1 si fue exitoso, 0 si hubo error
+ */
+int renderizar_certificado(BufferTexto* salida, const DatosVehiculo* vehiculo, const char* numero_matricula, const struct tm* fecha) {
+	if (!plantilla_certificado.compilada &&
+		!plantilla_compilar(&plantilla_certificado, fuente_certificado, nombres_certificado, CE_NUM_ESPACIOS)) {
+		return 0;
+	}
+	
+	ValorPlantilla valores[CE_NUM_ESPACIOS] = {{0}};
+	valores[CE_NUMERO].texto = numero_matricula;
+	valores[CE_PLACA].texto = vehiculo->placa;
+	valores[CE_TIPO].texto = vehiculo->tipo;
+	valores[CE_SUBTIPO].texto = vehiculo->subtipo;
+	valores[CE_ANO].entero = vehiculo->ano;
+	valores[CE_AVALUO].dinero = vehiculo->avaluo;
+	valores[CE_CILINDRAJE].entero = vehiculo->cilindraje;
+	valores[CE_CEDULA].texto = vehiculo->cedula;
+	valores[CE_NOMBRE].texto = vehiculo->propietario;
+	valores[CE_DIA].entero = fecha->tm_mday;
+	valores[CE_MES].entero = fecha->tm_mon + 1;
+	valores[CE_ANO_EMISION].entero = fecha->tm_year + 1900;
+	valores[CE_ANO_VALIDEZ].entero = fecha->tm_year + 1901;
+	
+	return plantilla_renderizar(&plantilla_certificado, valores, salida);
+}
+
 /*
  * Funcion: proceso_matriculacion_final
  * Descripcion: Matricula final del vehiculo verificando que tenga pago y revision tecnica
@@ -1036,9 +1329,11 @@ void proceso_matriculacion_final() {
 	printf("=======================================================\n");
 	printf("\n");
 	
-	// Solicitar placa del vehiculo
+	// Solicitar placa del vehiculo (los indices se ponen al dia mientras tanto)
+	expediente_precargar();
 	printf("Ingrese la placa del vehiculo a matricular: ");
 	if (!fgets(buffer, sizeof(buffer), stdin)) {
+		expediente_esperar_precarga();
 		printf("Error al leer la placa del vehiculo.\n");
 		printf("\nPresione Enter para continuar...");
 		getchar();
@@ -1050,35 +1345,19 @@ void proceso_matriculacion_final() {
 	strcpy(placa, buffer);
 	convertir_a_mayusculas(placa);
 	
-	// Verificar que el vehiculo existe
-	if (!obtener_datos_vehiculo_para_calculo_desde_archivo(placa, &vehiculo)) {
+	// Vehiculo, pago y revision en una sola consulta
+	ExpedienteVehiculo expediente;
+	if (!expediente_obtener(placa, &expediente)) {
 		printf("Error: Vehiculo con placa '%s' no encontrado.\n", placa);
 		printf("Debe registrar el vehiculo primero.\n");
 		printf("\nPresione Enter para continuar...");
 		getchar();
 		return;
 	}
+	vehiculo = expediente.vehiculo;
 	
 	// Verificar que el vehiculo tenga pago realizado
-	FILE* archivo_pagos = fopen("matriculas_pagadas.txt", "r");
-	int pago_encontrado = 0;
-	if (archivo_pagos) {
-		char linea[200];
-		while (fgets(linea, sizeof(linea), archivo_pagos)) {
-			char placa_archivo[20];
-			// Probar ambos formatos: nuevo (|) y viejo (,)
-			if (sscanf(linea, "%*[^|]|%[^|]", placa_archivo) == 1 || 
-				sscanf(linea, "%*[^,],%[^,]", placa_archivo) == 1) {
-				if (strcmp(placa_archivo, placa) == 0) {
-					pago_encontrado = 1;
-					break;
-				}
-			}
-		}
-		fclose(archivo_pagos);
-	}
-	
-	if (!pago_encontrado) {
+	if (!expediente.pago_registrado) {
 		printf("Error: El vehiculo '%s' no tiene el pago de matricula registrado.\n", placa);
 		printf("Debe procesar el pago primero en el modulo de pagos.\n");
 		printf("\nPresione Enter para continuar...");
@@ -1087,7 +1366,7 @@ void proceso_matriculacion_final() {
 	}
 	
 	// Verificar que el vehiculo tenga revision tecnica aprobada
-	if (!vehiculo_tiene_revision(placa)) {
+	if (!expediente.revision_aprobada) {
 		printf("Error: El vehiculo '%s' no tiene revision tecnica aprobada.\n", placa);
 		printf("Debe pasar la revision tecnica primero.\n");
 		printf("\nPresione Enter para continuar...");
@@ -1102,6 +1381,15 @@ void proceso_matriculacion_final() {
 	printf("Propietario: %s\n", vehiculo.propietario);
 	printf("Pago: VERIFICADO\n");
 	printf("Revision tecnica: APROBADA\n");
+	printf("Ultima revision: %s (%s)\n", expediente.ultima_revision.fecha_revision,
+		   expediente.ultima_revision.aprobada ? "APROBADA" : "NO APROBADA");
+	if (expediente.comprobantes_pendientes > 0) {
+		printf("Comprobantes pendientes: %d (ultimo %s)\n",
+			   expediente.comprobantes_pendientes, expediente.ultimo_comprobante);
+	}
+	if (expediente.matriculado) {
+		printf("Certificado anterior: %s\n", expediente.ultimo_certificado);
+	}
 	printf("-------------------------------------------------------\n");
 	
 	printf("\nProceder con la matriculacion final? (S/N): ");
@@ -1145,7 +1433,7 @@ void proceso_matriculacion_final() {
 	printf("Tipo: %s\n", vehiculo.tipo);
 	printf("Subtipo: %s\n", vehiculo.subtipo);
 	printf("Ano: %d\n", vehiculo.ano);
-	printf("Avaluo: $%.2f\n", vehiculo.avaluo);
+	printf("Avaluo: $%.2f\n", dinero_a_decimal(vehiculo.avaluo));
 	printf("Cilindraje: %d cc\n", vehiculo.cilindraje);
 	printf("\n");
 	printf("DATOS DEL PROPIETARIO:\n");
@@ -1166,63 +1454,32 @@ void proceso_matriculacion_final() {
 	printf("           PUEDE CIRCULAR SIN RESTRICCIONES\n");
 	printf("=======================================================\n");
 	
-	// Guardar certificado en archivo
-	FILE* archivo_matriculados = fopen("vehiculos_matriculados.txt", "a");
-	if (archivo_matriculados) {
-		fprintf(archivo_matriculados, "%s|%s|%s|%s|%s|%d|%.2f|%d|%s|%02d/%02d/%04d|MATRICULADO\n",
-				numero_matricula, vehiculo.placa, vehiculo.cedula, vehiculo.propietario,
-				vehiculo.tipo, vehiculo.ano, vehiculo.avaluo, vehiculo.cilindraje,
-				vehiculo.subtipo, fecha->tm_mday, fecha->tm_mon + 1, fecha->tm_year + 1900);
-		fclose(archivo_matriculados);
-		printf("\nCertificado guardado en archivo 'vehiculos_matriculados.txt'\n");
+	// Guardar certificado como evento (se agrega tambien a vehiculos_matriculados.txt)
+	char linea_certificado[MAX_DATOS_EVENTO];
+	char avaluo_texto[MAX_TEXTO_DINERO];
+	snprintf(linea_certificado, sizeof(linea_certificado), "%s|%s|%s|%s|%s|%d|%s|%d|%s|%02d/%02d/%04d|MATRICULADO",
+			numero_matricula, vehiculo.placa, vehiculo.cedula, vehiculo.propietario,
+			vehiculo.tipo, vehiculo.ano, dinero_formatear(vehiculo.avaluo, avaluo_texto), vehiculo.cilindraje,
+			vehiculo.subtipo, fecha->tm_mday, fecha->tm_mon + 1, fecha->tm_year + 1900);
+	if (evento_registrar(EVENTO_MATRICULA, vehiculo.placa, linea_certificado)) {
+		printf("\nCertificado guardado en archivo '%s'\n", ARCHIVO_VEHICULOS_MATRICULADOS);
 	} else {
 		printf("\nAdvertencia: No se pudo guardar el certificado en archivo.\n");
 	}
 	
 	printf("\nDesea guardar una copia del certificado? (S/N): ");
 	if (fgets(buffer, sizeof(buffer), stdin) && (buffer[0] == 'S' || buffer[0] == 's')) {
-		// Crear carpeta si no existe
-		system("mkdir certificados 2>nul");
-		
-		char nombre_archivo[100];
-		sprintf(nombre_archivo, "certificados/certificado_%s_%04d%02d%02d.txt", 
-				placa, fecha->tm_year + 1900, fecha->tm_mon + 1, fecha->tm_mday);
-		
-		FILE* archivo_cert = fopen(nombre_archivo, "w");
-		if (archivo_cert) {
-			fprintf(archivo_cert, "=======================================================\n");
-			fprintf(archivo_cert, "           CERTIFICADO DE MATRICULACION\n");
-			fprintf(archivo_cert, "           AGENCIA NACIONAL DE TRANSITO\n");
-			fprintf(archivo_cert, "                    ECUADOR\n");
-			fprintf(archivo_cert, "=======================================================\n\n");
-			fprintf(archivo_cert, "DATOS DEL VEHICULO:\n");
-			fprintf(archivo_cert, "-------------------------------------------------------\n");
-			fprintf(archivo_cert, "Numero de Certificado: %s\n", numero_matricula);
-			fprintf(archivo_cert, "Placa: %s\n", vehiculo.placa);
-			fprintf(archivo_cert, "Tipo: %s\n", vehiculo.tipo);
-			fprintf(archivo_cert, "Subtipo: %s\n", vehiculo.subtipo);
-			fprintf(archivo_cert, "Ano: %d\n", vehiculo.ano);
-			fprintf(archivo_cert, "Avaluo: $%.2f\n", vehiculo.avaluo);
-			fprintf(archivo_cert, "Cilindraje: %d cc\n\n", vehiculo.cilindraje);
-			fprintf(archivo_cert, "DATOS DEL PROPIETARIO:\n");
-			fprintf(archivo_cert, "-------------------------------------------------------\n");
-			fprintf(archivo_cert, "Cedula: %s\n", vehiculo.cedula);
-			fprintf(archivo_cert, "Nombre: %s\n\n", vehiculo.propietario);
-			fprintf(archivo_cert, "CERTIFICACION:\n");
-			fprintf(archivo_cert, "-------------------------------------------------------\n");
-			fprintf(archivo_cert, "Fecha de matriculacion: %02d/%02d/%04d\n", 
-					fecha->tm_mday, fecha->tm_mon + 1, fecha->tm_year + 1900);
-			fprintf(archivo_cert, "Valido hasta: %02d/%02d/%04d\n", 
-					fecha->tm_mday, fecha->tm_mon + 1, fecha->tm_year + 1901);
-			fprintf(archivo_cert, "Estado: MATRICULADO\n\n");
-			fprintf(archivo_cert, "=======================================================\n");
-			fprintf(archivo_cert, "      SU VEHICULO ESTA LEGALMENTE MATRICULADO\n");
-			fprintf(archivo_cert, "           PUEDE CIRCULAR SIN RESTRICCIONES\n");
-			fprintf(archivo_cert, "=======================================================\n");
-			
-			fclose(archivo_cert);
-			printf("Certificado guardado en '%s'\n", nombre_archivo);
+		// Renderizar el certificado en memoria y agregarlo al almacen de documentos
+		BufferTexto documento;
+		buffer_iniciar(&documento);
+		if (renderizar_certificado(&documento, &vehiculo, numero_matricula, fecha) &&
+			almacen_agregar_documento(numero_matricula, DOCUMENTO_CERTIFICADO, &documento)) {
+			printf("Certificado %s guardado en el almacen de documentos.\n", numero_matricula);
+			printf("Puede exportarlo desde el menu de archivo y administracion.\n");
+		} else {
+			printf("Advertencia: No se pudo guardar la copia del certificado.\n");
 		}
+		buffer_liberar(&documento);
 	}
 	
 	printf("\nMatriculacion final completada exitosamente!\n");
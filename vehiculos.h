@@ -26,6 +26,7 @@
 // Configuracion de archivos
 #define ARCHIVO_VEHICULOS "vehiculos.txt"    // Archivo de almacenamiento
 #define MAX_LINEA2 250                       // Longitud maxima de linea
+#define MAX_PLACAS_REPORTE 10                // Placas listadas por consulta del reporte de estados
 
 // Limites de avaluo vehicular
 #define MIN_AVALUO 500.00                    // Avaluo minimo permitido
@@ -62,6 +63,8 @@ typedef struct {
  */
 int registrar_vehiculo(void);    // Registra un nuevo vehiculo en el sistema
 int buscar_vehiculo(void);       // Busca un vehiculo por placa
+int buscar_vehiculo_por_nombre(const char* nombre); // Busca por nombre del propietario
+int buscar_vehiculo_por_patron(const char* patron); // Busca placas con comodines o prefijo
 
 // ===================================================================
 // PROTOTIPOS DE FUNCIONES DE VALIDACION
@@ -74,7 +77,7 @@ int validar_placa(const char* placa);         // Valida formato de placa
 int validar_cedula(const char* cedula);       // Valida cedula ecuatoriana
 int validar_cilindraje(int cilindraje);       // Valida rango de cilindraje
 int validar_nombre(const char* nombre);       // Valida nombre del propietario
-int validar_valor(float valor);               // Valida rango de avaluo
+int validar_valor(Dinero valor);              // Valida rango de avaluo (centavos)
 
 // ===================================================================
 // PROTOTIPOS DE FUNCIONES AUXILIARES
@@ -91,10 +94,12 @@ void convertir_a_mayusculas(char* cadena);    // Convierte texto a mayusculas
  * Funcion para integracion con sistema de calculos
  */
 int obtener_datos_vehiculo_para_calculo_desde_archivo(const char* placa, DatosVehiculo* vehiculo_data);
+int leer_linea_vehiculo(const char* linea, DatosVehiculo* vehiculo_data);
 
 // Funciones de consulta y reportes
 void mostrar_vehiculos_matriculados();
 void mostrar_reporte_detallado_vehiculos();
+void mostrar_reporte_estados();
 
 // ===================================================================
 // PROTOTIPOS DE FUNCIONES PARA REVISIONES TECNICAS SIMPLIFICADAS
@@ -112,6 +117,8 @@ int consultar_revision_vehiculo();                             // Consulta revis
  */
 void proceso_matriculacion();                                  // Menu principal integrado
 void proceso_matriculacion_final();                           // Matriculacion final del vehiculo
+int renderizar_certificado(BufferTexto* salida, const DatosVehiculo* vehiculo,
+                           const char* numero_matricula, const struct tm* fecha); // Certificado en buffer
 
 #endif // VEHICULOS_H
 